@@ -0,0 +1,4 @@
+#!/bin/sh
+# genie has to be on the path, there is only a windows binary in Tools
+cd "$(dirname "$0")/.."
+genie --platform-linux --64bit gmake
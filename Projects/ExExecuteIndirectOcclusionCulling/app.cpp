@@ -10,6 +10,12 @@
 #include <cfc/gpu/gfx_d3d12.h>
 
 #include <cfc/stl/stl_threading.hpp>
+#include <cfc/stl/jobsystem.h>
+#include <cfc/core/frame_allocator.h>
+#include <cfc/core/profiling.h>
+#include <cfc/core/counters.h>
+#include <cfc/core/memory_tracker.h>
+#include <cfc/math/math_simd.h>
 
 // local includes
 #include "scene.h"
@@ -18,14 +24,27 @@
 
 // defines
 #define NUM_BACK_BUFFER_FRAMES 2
+#define NUM_PIPELINED_FRAMES 2		// cpu frames in flight, the visibility stage of frame N overlaps recording and presenting frame N - 1
 #define CB_ALIGNMENT_IN_BYTES 256
 
 #define CAMERA_SPEED_MULTIPLIER 10.0f
 
+#define DEFAULT_SCENE_MANIFEST "scenes/sponza_grid.json"
+
 #define IM_ARRAYSIZE(_ARR)  ((int)(sizeof(_ARR)/sizeof(*_ARR)))
 
 
 // [[ CODE ]]
+// cpu side data of a frame in flight, filled by the update stage and handed to the visibility and record stages
+struct pipelined_frame
+{
+	view_state ViewState;
+	cfc::math::matrix4f InversePrevViewMatrix;
+	scene::OcclusionTypes OcclusionType = scene::OcclusionTypes::None;
+	scene_visibility Visibility;
+	bool Valid = false;
+};
+
 struct gfx_state
 {
 	gfx_state() : gfx(d12_gfx) {}
@@ -55,9 +74,6 @@ public:
 	scene scene;
 	scene::OcclusionTypes occlusionType = scene::OcclusionTypes::Gpu;
 
-	stl_thread m_thLoading;
-	bool m_sceneLoaded = false;
-
 	// camera info
 	u32 m_currentCamera = cameras::Camera1;
 	camera m_cameras[cameras::Count];
@@ -66,12 +82,24 @@ public:
 
 	cfc::math::matrix4f m_inversePrevViewMatrix;
 
-	usize m_resViewStateConstantBuffer = cfc::invalid_index;
-	usize m_resPrevViewStateConstantBuffer = cfc::invalid_index;
+	// frame pipeline, update (main thread) -> visibility (job system) -> record (main thread)
+	pipelined_frame m_frames[NUM_PIPELINED_FRAMES];
+	u64 m_frameNumber = 0;
+	cfc::core::threading::job_counter m_visibilityDone;
+	bool m_reloadSceneRequested = false;
+
+	cfc::gfx_resource_handle m_resViewStateConstantBuffer;
+	cfc::gfx_resource_handle m_resPrevViewStateConstantBuffer;
 
 	f32 m_frameTimeReadOnly = 0.0f;
 	f32 m_perfCaptureTimer = 0.0f;
+	usize m_counterFrameTime = cfc::invalid_index;
+	cfc::memory_tag_stats m_cpuMemoryStats[cfc::memory_tag::Count];
+	cfc::gfx_memory_stats m_gpuMemoryStats[(usize)cfc::gfx_memory_category::COUNT];
+
+	char m_sceneManifestFile[260] = DEFAULT_SCENE_MANIFEST;
 
+	i32 m_textureStreamingBudgetInMB = 256;
 	bool m_wireFrame = false;
 	bool m_useVertexShaderAsCompute = false;
 	bool m_doDownsampleAfterReproject = true;
@@ -83,6 +111,8 @@ public:
 	void init(cfc::context& ctx)
 	{
 		context = &ctx;
+		stl_assert(context->Counters != nullptr);
+		m_counterFrameTime = context->Counters->Register("Frame Time (ms)", cfc::profiling::counter_type::Value);
 
 		// due to the current order of operations, OnResize event for this app needs to be registered before gfx init, gfx _resize needs to run before app to keep gfx info correct for current resize
 		evResize = [this](cfc::window::eventData ev) { gfx.WaitForGpu(); resize(); };
@@ -95,7 +125,10 @@ public:
 		for (usize i = 0; i < gfx.GetBackbufferFrameQuantity(); i++)
 			gfxCmdLists[i] = gfx.GetCommandList(gfx.AddCommandList());
 
-		ImGui_ImplGfx_Init(context, &gfx);
+		{
+			cfc::memory_tag_scope tag(cfc::memory_tag::UI);
+			ImGui_ImplGfx_Init(context, &gfx);
+		}
 
 		// create resource stream
 		gfxResources = gfx.GetResourceStream(gfx.AddResourceStream());
@@ -131,17 +164,27 @@ public:
 
 		gfxResources->WaitForFinish();
 
-		m_thLoading = stl_thread(
-		[this]() {
-#if DRAW_SPONZA
-			this->scene.Load(context, gfx, "crytek_sponza/sponza.obj");
-#else
-			this->scene.Load(context, gfx, "cube/cube.obj");
-#endif
-			m_sceneLoaded = true;
-		});
-
-		m_thLoading.detach();
+		loadScene();
+	}
+
+	void loadScene()
+	{
+		scene_manifest manifest;
+		if (!manifest.LoadFromFile(context, m_sceneManifestFile))
+		{
+			// the layout the demo used before scene manifests existed
+			context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevWarning, "Falling back to the default sponza grid.");
+			manifest.CreateGrid("crytek_sponza/sponza.obj", 4, 4, 4.0f, 2.5f, 0.001f);
+		}
+
+		m_gpuOcclusionCullingEnabled = manifest.Settings.OcclusionCulling;
+		m_doDownsampleAfterReproject = manifest.Settings.DownsampleAfterReproject;
+		m_useVertexShaderAsCompute = manifest.Settings.ComputeAsVertexShader;
+		m_wireFrame = manifest.Settings.WireFrame;
+		m_textureStreamingBudgetInMB = (i32)manifest.Settings.TextureStreamingBudgetInMB;
+
+		// meshes show up as they arrive, the scene is finalized from the render loop (see scene::UpdateLoading)
+		scene.LoadAsync(context, gfx, manifest);
 	}
 
 	void release()
@@ -163,11 +206,13 @@ public:
 
 	void update(const f32 deltaTimeSeconds)
 	{
+		CFC_PROFILE_SCOPE("App Update");
 		static f32 g_tempMovementTime = 0;
 		g_tempMovementTime += deltaTimeSeconds;
 
 		view_state& viewState = m_cameras[m_currentCamera].GetViewState();
-		m_inversePrevViewMatrix = (viewState.ProjectionMatrix * viewState.ViewMatrix).Inverted();
+		// the view is rigid and the projection perspective, both have closed form inverses
+		cfc::math::simd::InverseViewProjection(cfc::math::simd::mat4(viewState.ViewMatrix), cfc::math::simd::mat4(viewState.ProjectionMatrix)).Store(m_inversePrevViewMatrix.M);
 		
 		// update camera (constant buffer) through cpu->gpu upload buffer
 		float speedMul = context->Window->IsKeyDown(' ') ? CAMERA_SPEED_MULTIPLIER : 1.0f;
@@ -204,89 +249,159 @@ public:
 
 		scene.SetDebugRenderMode(m_debugRenderMode);
 
-		occlusionType = m_gpuOcclusionCullingEnabled ? scene::OcclusionTypes::Gpu : scene::OcclusionTypes::None;
+		scene.SetTextureStreamingBudget((usize)m_textureStreamingBudgetInMB * 1024 * 1024);
 
-		// potentially do performance capture
-		if (m_sceneLoaded && m_allowForPeriodicPerformanceCaptures)
-		{
-			// collect min, max and average
-			static float minVals[9] = { FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
-			static float maxVals[9] = { -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
-			static float average[9] = { 0, 0, 0, 0, 0, 0, 0, 0, 0 };
-			static float frameCounter = 1;
+		// gpu occlusion culling needs the fully loaded scene
+		occlusionType = (m_gpuOcclusionCullingEnabled && scene.IsLoaded()) ? scene::OcclusionTypes::Gpu : scene::OcclusionTypes::None;
 
-			stl_vector<cfc::gfx_gpu_timer_query> timerQueries;
+		// frame and gpu timings, the gpu timings are of the frame that was read back last
+		cfc::profiling::counter_registry& counters = *context->Counters;
+		counters.Set(m_counterFrameTime, deltaTimeSeconds * 1000.0);
+		if (scene.IsRenderable())
+		{
+			stl_frame_vector<cfc::gfx_gpu_timer_query> timerQueries;
 			scene.GatherFrameTimerQueries(gfx, occlusionType, timerQueries);
 			for (u32 i = 0; i < timerQueries.size(); ++i)
 			{
-				minVals[i] = min(minVals[i], (f32)gfx.GetTimerQueryResultInMS(timerQueries[i]));
-				maxVals[i] = max(maxVals[i], (f32)gfx.GetTimerQueryResultInMS(timerQueries[i]));
-				average[i] += (f32)gfx.GetTimerQueryResultInMS(timerQueries[i]);
+				char counterName[96];
+				snprintf(counterName, sizeof(counterName), "GPU %s (ms)", timerQueries[i].GetDescription());
+				counters.Set(counters.Register(counterName, cfc::profiling::counter_type::Value), gfx.GetTimerQueryResultInMS(timerQueries[i]));
 			}
+		}
+
+		// cpu memory per tag and gpu memory per category, sampling once per frame keeps the cpu peaks
+		const f64 bytesToMB = 1.0 / (1024.0 * 1024.0);
+		for (u32 i = 0; i < cfc::memory_tag::Count; ++i)
+		{
+			const cfc::memory_tag_stats memoryStats = cfc::memory_tracker::GetStats((cfc::memory_tag::Enumeration)i);
+			m_cpuMemoryStats[i] = memoryStats;
+
+			char counterName[64];
+			snprintf(counterName, sizeof(counterName), "CPU Memory %s (MB)", cfc::memory_tag::ToString((cfc::memory_tag::Enumeration)i));
+			counters.Set(counters.Register(counterName, cfc::profiling::counter_type::Value), memoryStats.CurrentBytes * bytesToMB);
+		}
+		const char* gpuMemoryNames[] = { "Static Resources", "Dynamic Resources", "Textures", "Render Targets" };
+		for (u32 i = 0; i < (u32)cfc::gfx_memory_category::COUNT; ++i)
+		{
+			const cfc::gfx_memory_stats memoryStats = gfx.GetMemoryStats((cfc::gfx_memory_category)i);
+			m_gpuMemoryStats[i] = memoryStats;
+
+			char counterName[64];
+			snprintf(counterName, sizeof(counterName), "GPU Memory %s (MB)", gpuMemoryNames[i]);
+			counters.Set(counters.Register(counterName, cfc::profiling::counter_type::Value), memoryStats.CurrentBytes * bytesToMB);
+		}
 
+		// potentially do performance capture, logs the statistics of the counter history
+		if (scene.IsLoaded() && m_allowForPeriodicPerformanceCaptures)
+		{
 			if (m_perfCaptureTimer >= 2.0f)
 			{
-				printf("Total Draw Time & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms\\\\\n", minVals[0], maxVals[0], average[0] / frameCounter, 0.0f, 0.0f, 0.0f);
-				
-				if (timerQueries.size() > 1)
-				{
-					printf("Clear UAV & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms\\\\\n", minVals[1], maxVals[1], average[1] / frameCounter, 0.0f, 0.0f, 0.0f);
-					printf("Reproject & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms\\\\\n", minVals[2], maxVals[2], average[2] / frameCounter, 0.0f, 0.0f, 0.0f);
-					printf("Downsample Reproject & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms\\\\\n", minVals[3], maxVals[3], average[3] / frameCounter, 0.0f, 0.0f, 0.0f);
-					printf("Copy Reproject to Depth & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms\\\\\n", minVals[4], maxVals[4], average[4] / frameCounter, 0.0f, 0.0f, 0.0f);
-					printf("Rasterize Occludees & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms\\\\\n", minVals[5], maxVals[5], average[5] / frameCounter, 0.0f, 0.0f, 0.0f);
-					printf("Clear Append Buffer & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms\\\\\n", minVals[6], maxVals[6], average[6] / frameCounter, 0.0f, 0.0f, 0.0f);
-					printf("Gather Visible Objects & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms\\\\\n", minVals[7], maxVals[7], average[7] / frameCounter, 0.0f, 0.0f, 0.0f);
-					printf("Draw Visible Objects & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms & %2.3fms\\\\\n", minVals[8], maxVals[8], average[8] / frameCounter, 0.0f, 0.0f, 0.0f);
-				}
-				printf("\n");
-
+				logCounters();
 				m_perfCaptureTimer = 0.0f;
-				for (u32 i = 0; i < 9; ++i)
-				{
-					minVals[i] = FLT_MAX;
-					maxVals[i] = -FLT_MAX;
-					average[i] = 0;
-				}
 			}
 
 			m_perfCaptureTimer += deltaTimeSeconds;
-
 		}
 
 		m_frameTimeReadOnly = deltaTimeSeconds;
+
+		// hand the view of this frame to the later stages
+		pipelined_frame& frame = m_frames[m_frameNumber % NUM_PIPELINED_FRAMES];
+		frame.ViewState = m_cameras[m_currentCamera].GetViewState();
+		frame.ViewState.ScreenWidth = gfx.GetBackbufferWidth();
+		frame.ViewState.ScreenHeight = gfx.GetBackbufferHeight();
+		frame.InversePrevViewMatrix = m_inversePrevViewMatrix;
+		frame.OcclusionType = occlusionType;
+		frame.Valid = true;
 	}
 
 	void render()
 	{
+		CFC_PROFILE_SCOPE("App Render");
+		pipelined_frame& current = m_frames[m_frameNumber % NUM_PIPELINED_FRAMES];
+		pipelined_frame& previous = m_frames[(m_frameNumber + NUM_PIPELINED_FRAMES - 1) % NUM_PIPELINED_FRAMES];
+
+		// loader results are applied before any stage reads the scene
+		scene.UpdateLoading(gfx);
+
+		// visibility stage of this frame runs on the job system while this thread records and presents the previous frame
+		current.Visibility.Valid = false;
+		if (scene.IsRenderable())
+			context->Jobs->Run([this, &current]() { CFC_PROFILE_SCOPE("Scene Visibility"); scene.UpdateVisibility(current.OcclusionType, current.ViewState, current.Visibility); }, &m_visibilityDone);
+
+		if (previous.Valid)
+		{
+			record(previous);
+			previous.Valid = false;
+		}
+
+		// hand off, the mip requests of this frame reach the streamer before the frame is recorded
+		{
+			CFC_PROFILE_SCOPE("App Wait Visibility");
+			context->Jobs->Wait(m_visibilityDone);
+		}
+		if (current.Visibility.Valid)
+			scene.UpdateTextureStreaming(gfx);
+
+		if (m_reloadSceneRequested)
+		{
+			m_reloadSceneRequested = false;
+
+			// NOTE: render targets and descriptor heaps are released immediately, the gpu has to be idle
+			gfx.WaitForGpu();
+			scene.Unload(gfx);
+			loadScene();
+
+			// frames in flight reference meshes of the unloaded scene
+			for (u32 i = 0; i < NUM_PIPELINED_FRAMES; ++i)
+				m_frames[i].Visibility.Valid = false;
+		}
+
+		context->Counters->EndFrame();
+		m_frameNumber++;
+	}
+
+	void logCounters()
+	{
+		const cfc::profiling::counter_registry& counters = *context->Counters;
+		for (usize i = 0; i < counters.GetCounterQuantity(); ++i)
+		{
+			const cfc::profiling::counter_stats stats = counters.GetStats(i);
+			context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevProfiling, "%-48s avg %10.3f  p50 %10.3f  p95 %10.3f  p99 %10.3f  max %10.3f", counters.GetName(i), stats.Average, stats.P50, stats.P95, stats.P99, stats.Max);
+		}
+	}
+
+	void record(const pipelined_frame& frame)
+	{
+		CFC_PROFILE_SCOPE("App Record");
 		const usize frameIndex = gfx.GetBackbufferFrameIndex();
 
-		view_state& viewState = m_cameras[m_currentCamera].GetViewState();
-		viewState.ScreenWidth = gfx.GetBackbufferWidth();
-		viewState.ScreenHeight = gfx.GetBackbufferHeight();
-		gfxResources->UpdateDynamicResource(m_resViewStateConstantBuffer, sizeof(view_state), &viewState, CB_ALIGNMENT_IN_BYTES * frameIndex);
+		// partially loaded scenes can become renderable after the visibility stage of this frame ran
+		const bool renderScene = scene.IsRenderable() && frame.Visibility.Valid;
 
-		gfxResources->UpdateDynamicResource(m_resPrevViewStateConstantBuffer, sizeof(cfc::math::matrix4f), &m_inversePrevViewMatrix, CB_ALIGNMENT_IN_BYTES * frameIndex);
+		gfxResources->UpdateDynamicResource(m_resViewStateConstantBuffer, sizeof(view_state), &frame.ViewState, CB_ALIGNMENT_IN_BYTES * frameIndex);
+
+		gfxResources->UpdateDynamicResource(m_resPrevViewStateConstantBuffer, sizeof(cfc::math::matrix4f), &frame.InversePrevViewMatrix, CB_ALIGNMENT_IN_BYTES * frameIndex);
 		gfxResources->Flush();
 
 		// get current command list
 		cfc::gfx_command_list& currentCmdList = *gfxCmdLists[frameIndex];
 		currentCmdList.Reset();
 
-		currentCmdList.ExecuteBarrier(cfc::gpu_resourcebarrier_desc::Transition(gfx.GetBackbufferRTResource(), cfc::gpu_resourcestate::Present, cfc::gpu_resourcestate::RenderTarget));
+		currentCmdList.ExecuteTransitionBarrier(gfx.GetBackbufferRTResource(), cfc::gpu_resourcestate::Present, cfc::gpu_resourcestate::RenderTarget);
 
-		if (m_sceneLoaded)
-			scene.Render(gfx, currentCmdList, occlusionType, m_resViewStateConstantBuffer, m_resPrevViewStateConstantBuffer, viewState);
+		if (renderScene)
+			scene.Render(gfx, currentCmdList, frame.OcclusionType, m_resViewStateConstantBuffer, m_resPrevViewStateConstantBuffer, frame.Visibility);
 
-		currentCmdList.ExecuteBarrier(cfc::gpu_resourcebarrier_desc::Transition(gfx.GetBackbufferRTResource(), cfc::gpu_resourcestate::RenderTarget, cfc::gpu_resourcestate::Present));
+		currentCmdList.ExecuteTransitionBarrier(gfx.GetBackbufferRTResource(), cfc::gpu_resourcestate::RenderTarget, cfc::gpu_resourcestate::Present);
 
 		currentCmdList.Close();
 
-		gfx.ExecuteCommandLists(currentCmdList.GetIndex());
+		gfx.ExecuteCommandLists(currentCmdList.GetHandle());
 
 		renderUI();
 
-		if (m_sceneLoaded)
+		if (renderScene)
 		{
 			// resolves current frame queries
 			gfx.ResolveTimerQueries();
@@ -300,6 +415,8 @@ public:
 
 	void renderUI()
 	{
+		CFC_PROFILE_SCOPE("App UI");
+		cfc::memory_tag_scope tag(cfc::memory_tag::UI);
 		// render UI
 		ImGui_ImplGfx_NewFrame();
 
@@ -318,18 +435,40 @@ public:
 			}
 		}
 
-		if (!m_sceneLoaded)
+		if (scene.GetLoadState() == scene::LoadStates::Loading)
+		{
+			const scene_load_progress progress = scene.GetLoadProgress();
+			ImGui::TextColored(ImVec4(1, 0, 0, 1), "Loading scene (%.1fs).. meshes %d/%d processed %d/%d uploaded, textures %d/%d processed %d/%d uploaded", progress.ElapsedSeconds,
+				progress.NumMeshesProcessed, progress.NumMeshes, progress.NumMeshesUploaded, progress.NumMeshes,
+				progress.NumTexturesProcessed, progress.NumTextures, progress.NumTexturesUploaded, progress.NumTextures);
+			ImGui::ProgressBar(progress.GetFraction());
+			if (ImGui::Button("Cancel loading"))
+				scene.CancelLoading();
+		}
+		else if (scene.GetLoadState() == scene::LoadStates::Cancelled)
+		{
+			ImGui::TextColored(ImVec4(1, 0, 0, 1), "Loading scene cancelled.");
+		}
+		else if (scene.IsLoaded())
+		{
+			ImGui::Text("Scene loaded in %.2fs", scene.GetLoadProgress().ElapsedSeconds);
+		}
+
+		ImGui::InputText("Scene manifest", m_sceneManifestFile, sizeof(m_sceneManifestFile));
+		ImGui::SameLine();
+		if (ImGui::Button("Load scene"))
 		{
-			ImGui::TextColored(ImVec4(1, 0, 0, 1), "Loading scene (%s)..", scene.GetStatus().c_str());
+			// the visibility stage is still running, the scene is reloaded once it finished (see render)
+			m_reloadSceneRequested = true;
 		}
 
 		float fasterThan60hz = (1.0f / m_frameTimeReadOnly) <= 0.016 ? 1.0 : 0.0;
 		float slowerThan60hz = 1.0 - fasterThan60hz;
 		ImGui::TextColored(ImVec4(fasterThan60hz, slowerThan60hz, 0, 1), "FPS %f fps   DT %f ms \n", 1.0f / m_frameTimeReadOnly, m_frameTimeReadOnly * 1000.0f);
 
-		if (m_sceneLoaded)
+		if (scene.IsRenderable())
 		{
-			stl_vector<cfc::gfx_gpu_timer_query> timerQueries;
+			stl_frame_vector<cfc::gfx_gpu_timer_query> timerQueries;
 			scene.GatherFrameTimerQueries(gfx, occlusionType, timerQueries);
 
 			float indirectRenderingEnabled = m_gpuOcclusionCullingEnabled ? 1.0 : 0.0;
@@ -340,13 +479,65 @@ public:
 				for (u32 i = 1; i < timerQueries.size(); ++i)
 					ImGui::Text("Time: %f ms Desc: %s \n", (f32)gfx.GetTimerQueryResultInMS(timerQueries[i]), timerQueries[i].GetDescription());
 			}
+
+			const cfc::gfx_texture_streamer_stats streamingStats = scene.GetTextureStreamingStats();
+			const f32 bytesToMB = 1.0f / (1024.0f * 1024.0f);
+			ImGui::Text("Textures: %.1f MB resident, %.1f MB requested, %.1f MB all mips (%d uploads pending)", streamingStats.ResidentBytes * bytesToMB, streamingStats.RequestedBytes * bytesToMB, streamingStats.FullyResidentBytes * bytesToMB, streamingStats.NumPendingUploads);
+			ImGui::Text("Textures: %.1f MB non resident mips in system memory", streamingStats.CPUBytes * bytesToMB);
+		}
+
+		const cfc::linear_allocator_stats frameAllocatorStats = cfc::frame_allocator::GetGlobalStats();
+		ImGui::Text("Frame allocators: %.1f KB high water, %.1f KB capacity (%d heap allocations)", frameAllocatorStats.HighWaterBytes / 1024.0f, frameAllocatorStats.CapacityBytes / 1024.0f, frameAllocatorStats.NumHeapAllocations);
+
+		if (ImGui::CollapsingHeader("Memory"))
+		{
+			const f32 bytesToMB = 1.0f / (1024.0f * 1024.0f);
+			for (u32 i = 0; i < cfc::memory_tag::Count; ++i)
+				ImGui::Text("CPU %-9s %8.2f MB current, %8.2f MB peak (%llu allocations, %llu frees)", cfc::memory_tag::ToString((cfc::memory_tag::Enumeration)i), m_cpuMemoryStats[i].CurrentBytes * bytesToMB, m_cpuMemoryStats[i].PeakBytes * bytesToMB, (unsigned long long)m_cpuMemoryStats[i].NumAllocations, (unsigned long long)m_cpuMemoryStats[i].NumFrees);
+
+			const char* gpuMemoryNames[] = { "Static", "Dynamic", "Textures", "Targets" };
+			for (u32 i = 0; i < (u32)cfc::gfx_memory_category::COUNT; ++i)
+				ImGui::Text("GPU %-9s %8.2f MB current, %8.2f MB peak (%llu resources)", gpuMemoryNames[i], m_gpuMemoryStats[i].CurrentBytes * bytesToMB, m_gpuMemoryStats[i].PeakBytes * bytesToMB, (unsigned long long)m_gpuMemoryStats[i].NumResources);
+		}
+
+		if (ImGui::CollapsingHeader("Performance Counters"))
+		{
+			const cfc::profiling::counter_registry& counters = *context->Counters;
+
+			const cfc::profiling::counter_stats tested = counters.GetStats(counters.Find("Cull Objects Tested"));
+			const cfc::profiling::counter_stats inFrustum = counters.GetStats(counters.Find("Cull Objects In Frustum"));
+			if (tested.Average > 0.0)
+				ImGui::Text("Frustum culling rejects %.1f%% of the tested objects", 100.0 * (1.0 - inFrustum.Average / tested.Average));
+
+			f32 history[CFC_COUNTER_HISTORY];
+			for (usize i = 0; i < counters.GetCounterQuantity(); ++i)
+			{
+				const cfc::profiling::counter_stats stats = counters.GetStats(i);
+				ImGui::Text("%s: last %.3f p50 %.3f p95 %.3f p99 %.3f max %.3f", counters.GetName(i), stats.Last, stats.P50, stats.P95, stats.P99, stats.Max);
+
+				const usize numSamples = counters.GetHistory(i, history, CFC_COUNTER_HISTORY);
+				ImGui::PushID((int)i);
+				ImGui::PlotLines("##history", history, (int)numSamples, 0, nullptr, FLT_MAX, FLT_MAX, ImVec2(0, 40));
+				ImGui::PopID();
+			}
+
+			if (ImGui::Button("Save counters (counters.csv)"))
+				counters.SaveCSV(*context, "counters.csv");
+			ImGui::SameLine();
+			if (ImGui::Button("Save counters (counters.json)"))
+				counters.SaveJSON(*context, "counters.json");
 		}
 
+		// the last seconds of cpu and gpu zones, open in chrome://tracing or ui.perfetto.dev
+		if (ImGui::Button("Save trace (trace.json)"))
+			cfc::profiling::profiler::SaveChromeTrace(*context, "trace.json");
+
 		ImGui::Checkbox("Render Using Execute Indirect (click here)", &m_gpuOcclusionCullingEnabled);
 		ImGui::Checkbox("Toggle wireframe (click here)", &m_wireFrame);
 		ImGui::Checkbox("Toggle downsample after reproject (click here)", &m_doDownsampleAfterReproject);
 		ImGui::Checkbox("Toggle vertex as compute (NO AMD SUPPORT!) (click here)", &m_useVertexShaderAsCompute);
 		ImGui::Checkbox("Allow for periodic perf captures (click here)", &m_allowForPeriodicPerformanceCaptures);
+		ImGui::SliderInt("Texture streaming budget (MB)", &m_textureStreamingBudgetInMB, 16, 1024);
 
 		const char* cameraNames[] = { "Camera 1. 'Lions Head'", "Camera 2. 'Into Sponza'", "Camera 3. 'Edge Overview Camera'", "Camera 4. 'Top Down Camera'", "Camera 5. 'Auto Fly Camera'", "Camera 6. 'User Movement Camera'" };
 		if (ImGui::Button("Camera View Select.."))
@@ -402,6 +593,8 @@ void app_main(cfc::context* bcontext)
 
 	try
 	{
+		CFC_PROFILE_THREAD_NAME("Main");
+
 		stl_unique_ptr<gfx_state> gfx(new gfx_state());
 		gfx->init(context);
 
@@ -409,10 +602,14 @@ void app_main(cfc::context* bcontext)
 		double prevDeltaSeconds = context.Timing->GetTimeSeconds();
 		while (context.Window->IsRequestingStop() == false && g_requestStop == false)
 		{
+			CFC_PROFILE_SCOPE("Frame");
 			double curDeltaSeconds = context.Timing->GetTimeSeconds();
 
 			float delta = (float)(curDeltaSeconds - prevDeltaSeconds);
 
+			// transient allocations of the previous frame (timer query lists, ui strings) are released at once
+			cfc::frame_allocator::GetThreadAllocator().Reset();
+
 			gfx->update(delta);
 
 			gfx->render();
@@ -0,0 +1,399 @@
+// engine includes
+#include <cfc/base.h>
+
+#include <cfc/core/io.h>
+#include <cfc/core/logging.h>
+#include <cfc/core/timing.h>
+#include <cfc/core/window.h>
+#include <cfc/core/counters.h>
+#include <cfc/core/frame_allocator.h>
+#include <cfc/stl/stl_threading.hpp>
+#include <cfc/stl/jobsystem.h>
+#include <cfc/math/math_simd.h>
+#include <cfc/gpu/texture_compress.h>
+
+#include <algorithm>
+
+// local includes
+#include "sceneManifest.h"
+#include "sceneAssets.h"
+#include "sceneCulling.h"
+#include "worldGenerator.h"
+#include "camera.h"
+
+
+// defines
+#define CAMERA_SPEED_MULTIPLIER 10.0f
+
+#define DEFAULT_SCENE_MANIFEST "scenes/sponza_grid.json"
+
+// runs without a window script, or with a script that never quits, stop after this many frames
+#define HEADLESS_MAX_FRAMES 600
+
+// material of meshes without one while loading, they get the default material once all models are loaded
+#define HEADLESS_NO_MATERIAL 0xFFFFFFFF
+
+
+// [[ CODE ]]
+// The demo without a renderer (linux): loads the scene manifest (or generates a world when it has nothing to draw), runs the
+// texture pipeline (decode, mipgen, compress, cache) on the job system and culls the draws against the camera of every frame.
+// The camera is driven by the window, which plays back the script given on the command line.
+struct headless_state
+{
+private:
+	cfc::context* context = nullptr;
+
+	camera m_camera;
+	cfc::math::quatf m_cameraRotation;
+
+	// per draw (a mesh of an instance), the world bounds in SoA for the batch cull
+	u32 m_numDraws = 0;
+	stl_vector<float> m_cullBounds[6];
+	stl_vector<u32> m_drawMaterials;
+	stl_vector<u8> m_drawInFrustum;
+
+	// per mesh of all models
+	stl_vector<float> m_meshBounds[6];
+	stl_vector<u32> m_meshMaterials;
+	stl_vector<u32> m_modelMeshBegin;
+
+	// per material, the last entry is the default material of meshes without one
+	stl_vector<stl_string> m_materialTextures;
+	stl_vector<cfc::texture_compressed_mip_chain> m_textureChains;
+	stl_vector<u8> m_materialVisible;
+
+	usize m_counterFrameTime = cfc::invalid_index;
+	usize m_counterCullTime = cfc::invalid_index;
+	scene_cull_counters m_cullCounters;
+	usize m_counterTexturesVisible = cfc::invalid_index;
+	usize m_counterTextureMemoryVisible = cfc::invalid_index;
+
+public:
+	bool init(cfc::context& ctx)
+	{
+		context = &ctx;
+		stl_assert(context->Counters != nullptr && context->Jobs != nullptr && context->Window != nullptr);
+
+		cfc::profiling::counter_registry& counters = *context->Counters;
+		m_counterFrameTime = counters.Register("Frame Time (ms)", cfc::profiling::counter_type::Value);
+		m_counterCullTime = counters.Register("Cull Time (ms)", cfc::profiling::counter_type::Value);
+		m_cullCounters.Registry = context->Counters;
+		m_cullCounters.ObjectsTested = counters.Register("Cull Objects Tested");
+		m_cullCounters.ObjectsInFrustum = counters.Register("Cull Objects In Frustum");
+		m_counterTexturesVisible = counters.Register("Textures Visible");
+		m_counterTextureMemoryVisible = counters.Register("Texture Memory Visible (MB)", cfc::profiling::counter_type::Value);
+
+		if (!loadScene())
+			return false;
+
+		loadTextures();
+		return true;
+	}
+
+	void update(const f32 deltaTimeSeconds)
+	{
+		cfc::window& window = *context->Window;
+
+		// same controls as the windowed demo
+		float speedMul = window.IsKeyDown(' ') ? CAMERA_SPEED_MULTIPLIER : 1.0f;
+		cfc::math::vector3f camPosition = m_camera.GetPosition();
+		camPosition += m_cameraRotation.GetLocalX() * (window.IsKeyDown('A') ? speedMul : (window.IsKeyDown('D') ? -speedMul : 0.0f));
+		camPosition += m_cameraRotation.GetLocalZ() * (window.IsKeyDown('W') ? speedMul : (window.IsKeyDown('S') ? -speedMul : 0.0f));
+		camPosition += m_cameraRotation.GetLocalY() * (window.IsKeyDown('E') ? speedMul : (window.IsKeyDown('Q') ? -speedMul : 0.0f));
+
+		if (window.IsCursorDown(2, 0))
+		{
+			m_cameraRotation *= cfc::math::quatf().CreateAxisAngleQuat(cfc::math::vector3f(0.0f, 1.0f, 0.0f), window.GetCursorDeltaX()*0.01f);
+			m_cameraRotation *= cfc::math::quatf().CreateAxisAngleQuat(m_cameraRotation.GetLocalX(), window.GetCursorDeltaY()*-0.01f);
+			m_cameraRotation.NormalizeQuat();
+		}
+		m_camera.SetPosition(camPosition);
+		m_camera.LookAt(camPosition + m_cameraRotation.GetLocalZ(), m_cameraRotation.GetLocalY());
+
+		const view_state viewState = m_camera.GetViewState();
+		const double cullStartSeconds = context->Timing->GetTimeSeconds();
+		scene_culling::CullDraws(*context->Jobs, viewState.ProjectionMatrix * viewState.ViewMatrix, m_cullBounds, nullptr, m_numDraws, m_drawInFrustum.data(), m_cullCounters);
+		const double cullEndSeconds = context->Timing->GetTimeSeconds();
+
+		// the textures the visible draws would stream in
+		m_materialVisible.assign(m_materialVisible.size(), 0);
+		for (u32 i = 0; i < m_numDraws; ++i)
+		{
+			if (m_drawInFrustum[i])
+				m_materialVisible[m_drawMaterials[i]] = 1;
+		}
+
+		i64 numTexturesVisible = 0;
+		usize textureBytesVisible = 0;
+		for (usize i = 0; i < m_textureChains.size(); ++i)
+		{
+			if (!m_materialVisible[i] || m_textureChains[i].Data.empty())
+				continue;
+			numTexturesVisible++;
+			textureBytesVisible += m_textureChains[i].Data.size();
+		}
+
+		cfc::profiling::counter_registry& counters = *context->Counters;
+		counters.Set(m_counterFrameTime, deltaTimeSeconds * 1000.0);
+		counters.Set(m_counterCullTime, (cullEndSeconds - cullStartSeconds) * 1000.0);
+		counters.Add(m_counterTexturesVisible, numTexturesVisible);
+		counters.Set(m_counterTextureMemoryVisible, textureBytesVisible / (1024.0 * 1024.0));
+		counters.EndFrame();
+	}
+
+	void logCounters()
+	{
+		const cfc::profiling::counter_registry& counters = *context->Counters;
+		for (usize i = 0; i < counters.GetCounterQuantity(); ++i)
+		{
+			const cfc::profiling::counter_stats stats = counters.GetStats(i);
+			context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevProfiling, "%-48s avg %10.3f  p50 %10.3f  p95 %10.3f  p99 %10.3f  max %10.3f", counters.GetName(i), stats.Average, stats.P50, stats.P95, stats.P99, stats.Max);
+		}
+	}
+
+private:
+	bool loadScene()
+	{
+		scene_manifest manifest;
+		if (!manifest.LoadFromFile(context, DEFAULT_SCENE_MANIFEST) || !loadModels(manifest))
+		{
+			// NOTE: the demo content is not required, the generated world only has procedural models
+			context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevWarning, "Falling back to a generated world.");
+			manifest.Clear();
+			manifest.Name = "generated world";
+			const world_generator_stats stats = world_generator::Generate(world_generator_desc(), manifest);
+			context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevInfo, "Generated %d blocks, %d occluders, %d occludees (%.0f world units wide).", stats.NumBlocks, stats.NumOccluders, stats.NumOccludees, stats.WorldSize);
+			if (!loadModels(manifest))
+				return false;
+		}
+
+		// give every instance its range of draws
+		const u32 numInstances = manifest.GetInstanceQuantity();
+		u64 numDraws = 0;
+		for (u32 i = 0; i < numInstances; ++i)
+		{
+			const u32 modelIndex = manifest.InstanceModels[i];
+			numDraws += m_modelMeshBegin[modelIndex + 1] - m_modelMeshBegin[modelIndex];
+		}
+
+		if (numDraws == 0 || numDraws >= 0xFFFFFFFF)
+		{
+			context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevError, "Scene (%s) has an unsupported amount of draws (%llu).", manifest.Name.c_str(), numDraws);
+			return false;
+		}
+
+		m_numDraws = (u32)numDraws;
+		for (u32 i = 0; i < 6; ++i)
+			m_cullBounds[i].resize(m_numDraws);
+		m_drawMaterials.resize(m_numDraws);
+		m_drawInFrustum.assign(m_numDraws, 0);
+
+		// the meshes of a model are transformed together, their bounds are consecutive for both the model and the instance
+		u32 drawIndex = 0;
+		for (u32 i = 0; i < numInstances; ++i)
+		{
+			const u32 modelIndex = manifest.InstanceModels[i];
+			const u32 meshBegin = m_modelMeshBegin[modelIndex];
+			const u32 numMeshes = m_modelMeshBegin[modelIndex + 1] - meshBegin;
+
+			cfc::math::simd::aabb_arrays localBounds, worldBounds;
+			float** localArrays = &localBounds.MinX;
+			float** worldArrays = &worldBounds.MinX;
+			for (u32 j = 0; j < 6; ++j)
+			{
+				localArrays[j] = m_meshBounds[j].data() + meshBegin;
+				worldArrays[j] = m_cullBounds[j].data() + drawIndex;
+			}
+			cfc::math::simd::TransformAABBs(cfc::math::simd::mat4(manifest.InstanceTransforms[i].Mat), localBounds, worldBounds, numMeshes);
+
+			for (u32 j = 0; j < numMeshes; ++j)
+				m_drawMaterials[drawIndex + j] = m_meshMaterials[meshBegin + j];
+			drawIndex += numMeshes;
+		}
+
+		// the camera starts in the middle of the scene, looking down +z
+		float sceneMin[3], sceneMax[3];
+		for (u32 j = 0; j < 3; ++j)
+		{
+			sceneMin[j] = *std::min_element(m_cullBounds[j].begin(), m_cullBounds[j].end());
+			sceneMax[j] = *std::max_element(m_cullBounds[3 + j].begin(), m_cullBounds[3 + j].end());
+		}
+		const cfc::math::vector3f cameraStartPosition((sceneMin[0] + sceneMax[0]) * 0.5f, (sceneMin[1] + sceneMax[1]) * 0.5f, (sceneMin[2] + sceneMax[2]) * 0.5f);
+		m_cameraRotation = cfc::math::quatf(0.0f, 0.0f, 0.0f, 1.0f);
+		m_camera = camera(55.0f, 36.0f, 24.0f, cameraStartPosition);
+		m_camera.LookAt(cameraStartPosition + m_cameraRotation.GetLocalZ(), m_cameraRotation.GetLocalY());
+
+		context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevInfo, "Scene (%s): %u models, %u instances, %u draws, %u materials.", manifest.Name.c_str(), manifest.GetModelQuantity(), numInstances, m_numDraws, (u32)m_materialTextures.size() - 1);
+		return true;
+	}
+
+	// bounds and materials of every mesh, returns false when no model has anything to draw
+	bool loadModels(const scene_manifest& manifest)
+	{
+		const u32 numModels = manifest.GetModelQuantity();
+		for (u32 i = 0; i < 6; ++i)
+			m_meshBounds[i].clear();
+		m_meshMaterials.clear();
+		m_materialTextures.clear();
+		m_modelMeshBegin.resize(numModels + 1);
+
+		stl_vector<u32> meshMaterialIds;
+		for (u32 m = 0; m < numModels; ++m)
+		{
+			const stl_string& modelFile = manifest.Models[m].File;
+			m_modelMeshBegin[m] = (u32)m_meshMaterials.size();
+
+			// NOTE: + 1 append to lastIndexOfFolderDivide makes sure to include '/' character as folder divide
+			stl_string basePath;
+			usize lastIndexOfFolderDivide = modelFile.find_last_of('/');
+			if (lastIndexOfFolderDivide != std::string::npos)
+				basePath = modelFile.substr(0, lastIndexOfFolderDivide + 1);
+
+			stl_vector<tinyobj::shape_t> meshes;
+			stl_vector<tinyobj::material_t> materials;
+			stl_string error;
+			if (world_generator::IsProceduralModel(modelFile.c_str()))
+			{
+				meshes.resize(1);
+				if (!world_generator::CreateProceduralMesh(modelFile.c_str(), meshes[0].mesh.positions, meshes[0].mesh.texcoords, meshes[0].mesh.indices))
+					error = "unknown procedural shape";
+			}
+			else
+			{
+				error = scene_assets::LoadObj(*context->IO, modelFile, basePath, meshes, materials);
+			}
+
+			if (error != "" || meshes.empty())
+			{
+				// NOTE: instances of a model that failed to load draw nothing
+				context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevError, "Could not load OBJ (%s): %s", modelFile.c_str(), error.c_str());
+				continue;
+			}
+
+			// material ids are local to the OBJ, offset them into the appended material list
+			// NOTE: like the renderer, only the first id of a mesh is used
+			const u32 materialOffset = (u32)m_materialTextures.size();
+			for (usize i = 0; i < meshes.size(); ++i)
+			{
+				aabb bounds;
+				scene_assets::ComputeBounds(meshes[i].mesh.positions, bounds);
+				for (u32 j = 0; j < 3; ++j)
+				{
+					m_meshBounds[j].push_back(bounds.Min[j]);
+					m_meshBounds[3 + j].push_back(bounds.Max[j]);
+				}
+
+				const stl_vector<int>& materialIds = meshes[i].mesh.material_ids;
+				m_meshMaterials.push_back(!materialIds.empty() && materialIds[0] >= 0 ? materialOffset + (u32)materialIds[0] : HEADLESS_NO_MATERIAL);
+			}
+
+			for (usize i = 0; i < materials.size(); ++i)
+				m_materialTextures.push_back(materials[i].diffuse_texname != "" ? basePath + materials[i].diffuse_texname : stl_string());
+		}
+		m_modelMeshBegin[numModels] = (u32)m_meshMaterials.size();
+
+		// meshes without material use the default material (last entry)
+		const u32 defaultMaterial = (u32)m_materialTextures.size();
+		m_materialTextures.push_back(stl_string());
+		for (usize i = 0; i < m_meshMaterials.size(); ++i)
+		{
+			if (m_meshMaterials[i] == HEADLESS_NO_MATERIAL)
+				m_meshMaterials[i] = defaultMaterial;
+		}
+		return !m_meshMaterials.empty();
+	}
+
+	// the albedo textures of all materials, the files are read by the io workers and the textures are processed as jobs
+	void loadTextures()
+	{
+		const double startTimeSeconds = context->Timing->GetTimeSeconds();
+		const u32 numMaterials = (u32)m_materialTextures.size();
+		m_textureChains.resize(numMaterials);
+		m_materialVisible.assign(numMaterials, 0);
+
+		stl_vector<u32> texturedMaterials;
+		for (u32 i = 0; i < numMaterials; ++i)
+		{
+			if (m_materialTextures[i] != "")
+				texturedMaterials.push_back(i);
+		}
+
+		const u32 numTextures = (u32)texturedMaterials.size();
+		if (numTextures == 0)
+			return;
+
+		// source and cache file of every texture
+		stl_vector<stl_string> cachePaths(numTextures);
+		stl_vector<cfc::io_read_request> reads(numTextures * 2);
+		stl_vector<cfc::iobuffer> files(numTextures * 2);
+		for (u32 i = 0; i < numTextures; ++i)
+		{
+			cachePaths[i] = m_materialTextures[texturedMaterials[i]] + TEXTURE_CACHE_EXTENSION;
+			reads[i * 2 + 0].Path = m_materialTextures[texturedMaterials[i]].c_str();
+			reads[i * 2 + 1].Path = cachePaths[i].c_str();
+		}
+
+		cfc::io_batch textureReads;
+		context->IO->ReadAsync(reads.data(), reads.size(), textureReads, [&files](cfc::io_read_result& result)
+		{
+			if (result.Succeeded)
+				files[result.RequestIndex] = result.Buffer;
+		});
+		textureReads.Wait();
+
+		// NOTE: a job per texture, LoadAlbedoTexture compresses single threaded
+		stl_atomic_int numLoaded{ 0 };
+		context->Jobs->ParallelFor(0, numTextures, [this, &texturedMaterials, &files, &numLoaded](u32 first, u32 last)
+		{
+			for (u32 i = first; i < last; ++i)
+			{
+				// the uncompressed mip chain lives in the frame allocator of this worker
+				cfc::frame_allocator_scope transientScope;
+
+				const u32 materialIndex = texturedMaterials[i];
+				if (scene_assets::LoadAlbedoTexture(context, m_materialTextures[materialIndex], files[i * 2 + 0], files[i * 2 + 1], m_textureChains[materialIndex]))
+					numLoaded++;
+				else
+					context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevWarning, "Could not load texture (%s).", m_materialTextures[materialIndex].c_str());
+
+				files[i * 2 + 0] = cfc::iobuffer();
+				files[i * 2 + 1] = cfc::iobuffer();
+			}
+		}, 1);
+
+		usize textureBytes = 0;
+		for (u32 i = 0; i < numMaterials; ++i)
+			textureBytes += m_textureChains[i].Data.size();
+
+		context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevInfo, "Textures: %d of %u loaded (%.1f MB) in %.2f seconds.", numLoaded.load(), numTextures, textureBytes / (1024.0 * 1024.0), context->Timing->GetTimeSeconds() - startTimeSeconds);
+	}
+};
+
+void app_main(cfc::context* bcontext)
+{
+	cfc::context context(*bcontext);
+	stl_assert(context.Window != nullptr);
+
+	headless_state headless;
+	if (!headless.init(context))
+		return;
+
+	// * Main loop, ends on the quit of the window script
+	double prevDeltaSeconds = context.Timing->GetTimeSeconds();
+	for (u32 frame = 0; frame < HEADLESS_MAX_FRAMES && context.Window->IsRequestingStop() == false; ++frame)
+	{
+		double curDeltaSeconds = context.Timing->GetTimeSeconds();
+
+		float delta = (float)(curDeltaSeconds - prevDeltaSeconds);
+
+		// transient allocations of the previous frame are released at once
+		cfc::frame_allocator::GetThreadAllocator().Reset();
+
+		headless.update(delta);
+
+		context.Window->Update();
+		prevDeltaSeconds = curDeltaSeconds;
+	}
+
+	headless.logCounters();
+}
@@ -7,9 +7,9 @@
 camera::camera(float focalLengthInMM /* = 50.0f */, float sensorWidthInMM /*= 36.0f */, float sensorHeightInMM /*= 24.0f*/, cfc::math::vector3f pos /* = cfc::math::vector3f() */)
 	:
 m_viewState()
-,m_focalLengthMM(focalLengthInMM)
 ,m_position(pos)
 ,m_lookAt()
+,m_focalLengthMM(focalLengthInMM)
 ,m_sensorWidthInMM(sensorWidthInMM)
 ,m_sensorHeightInMM(sensorHeightInMM)
 {
@@ -1,3 +1,20 @@
+-- the demo renders with direct3d 12, linux builds the headless app (scene, culling and the texture pipeline without a renderer)
+if _OPTIONS["platform-linux"] then
+	project ("CFC.Project." .. ext_project_name .. ".Headless")
+		targetname  ("CFC.Project." .. ext_project_name .. ".Headless")
+		language    "C++"
+		kind        "ConsoleApp"
+		flags       { "No64BitChecks", "StaticRuntime" } -- disabled: "ExtraWarnings", 
+
+		debugargs   { "" }
+		debugdir    ( "Content" )
+
+		ext_add_libraries()
+		files       { "appHeadless.cpp", "camera.*", "occlusion.h", "sceneAssets.*", "sceneCulling.*", "sceneManifest.*", "worldGenerator.*" }
+		ext_set_project_defaults()
+	return
+end
+
 project ("CFC.Project." .. ext_project_name)
 	targetname  ("CFC.Project." .. ext_project_name)
 	language    "C++"
@@ -9,4 +26,5 @@ project ("CFC.Project." .. ext_project_name)
 	
 	ext_add_libraries()
 	ext_add_cpp_files(".")
+	excludes    { "appHeadless.cpp" }
 	ext_set_project_defaults()
\ No newline at end of file
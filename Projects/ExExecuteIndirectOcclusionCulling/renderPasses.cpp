@@ -253,12 +253,12 @@ bool reproject_depth_buffer::Load(cfc::context* const context, cfc::gfx& gfx, u3
 	offset += sprintf(shaderDefines + offset, "#define HALF_SCREEN_HEIGHT %d \n", gfx.GetBackbufferHeight() / HALF_SCREEN_DIV);
 	m_shrComputeCS = gfx.AddShaderFromFile(*context, "reprojectDepth.hlsl", "CSMain", "cs_5_0", shaderDefines);
 	
-	if (m_shrComputeCS == cfc::invalid_index)
+	if (!m_shrComputeCS.IsValid())
 		return false;
 	
 	m_shrComputeProgram = gfx.AddComputeProgram(m_shrComputeCS);
 
-	if (m_shrComputeProgram == cfc::invalid_index)
+	if (!m_shrComputeProgram.IsValid())
 		return false;
 
 	cfc::gfx_cmpprogram_desc dsc;
@@ -307,12 +307,12 @@ bool down_sample_reproject_depth_buffer::Load(cfc::context* const context, cfc::
 	offset += sprintf(shaderDefines + offset, "#define NUM_THREADS_Z %d \n", numThreadsZ);
 	m_shrComputeCS = gfx.AddShaderFromFile(*context, "reprojectDepthDownSample.hlsl", "CSMain", "cs_5_0", shaderDefines);
 
-	if (m_shrComputeCS == cfc::invalid_index)
+	if (!m_shrComputeCS.IsValid())
 		return false;
 
 	m_shrComputeProgram = gfx.AddComputeProgram(m_shrComputeCS);
 
-	if (m_shrComputeProgram == cfc::invalid_index)
+	if (!m_shrComputeProgram.IsValid())
 		return false;
 
 	cfc::gfx_cmpprogram_desc dsc;
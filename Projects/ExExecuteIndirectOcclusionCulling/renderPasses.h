@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cfc/base.h>
+#include <cfc/gpu/gfx_handle.h>
 
 // forward declare
 namespace cfc
@@ -20,7 +21,7 @@ class render_pass
 	virtual void Unload(cfc::gfx& gfx) = 0;
 	virtual void Begin(cfc::gfx_command_list* const cmndList) = 0;
 
-	virtual usize GetShaderProgram() const = 0;
+	virtual cfc::gfx_program_handle GetShaderProgram() const = 0;
 };
 
 class compute_pass
@@ -33,7 +34,7 @@ class compute_pass
 	virtual u32 GetNumThreadsY() const = 0;
 	virtual u32 GetNumThreadsZ() const = 0;
 
-	virtual usize GetShaderProgram() const = 0;
+	virtual cfc::gfx_program_handle GetShaderProgram() const = 0;
 };
 
 
@@ -47,12 +48,12 @@ public:
 
 	virtual void Begin(cfc::gfx_command_list* const cmdList) override;
 
-	virtual usize GetShaderProgram() const override { return m_shrDrawBBoxVisibilityProgram; }
+	virtual cfc::gfx_program_handle GetShaderProgram() const override { return m_shrDrawBBoxVisibilityProgram; }
 
 private:
-	usize m_shrDrawBBoxVisibilityVS = cfc::invalid_index;
-	usize m_shrDrawBBoxVisibilityPS = cfc::invalid_index;
-	usize m_shrDrawBBoxVisibilityProgram = cfc::invalid_index;
+	cfc::gfx_shader_handle m_shrDrawBBoxVisibilityVS;
+	cfc::gfx_shader_handle m_shrDrawBBoxVisibilityPS;
+	cfc::gfx_program_handle m_shrDrawBBoxVisibilityProgram;
 	usize m_shrDrawBBoxVisibilityProgramState = cfc::invalid_index;
 };
 
@@ -66,12 +67,12 @@ public:
 
 	virtual void Begin(cfc::gfx_command_list* const cmdList) override;
 
-	virtual usize GetShaderProgram() const override { return m_shrDrawOpaqueProgram; }
+	virtual cfc::gfx_program_handle GetShaderProgram() const override { return m_shrDrawOpaqueProgram; }
 
 private:
-	usize m_shrDrawOpaqueVS = cfc::invalid_index;
-	usize m_shrDrawOpaquePS = cfc::invalid_index;
-	usize m_shrDrawOpaqueProgram = cfc::invalid_index;
+	cfc::gfx_shader_handle m_shrDrawOpaqueVS;
+	cfc::gfx_shader_handle m_shrDrawOpaquePS;
+	cfc::gfx_program_handle m_shrDrawOpaqueProgram;
 	usize m_shrDrawOpaqueProgramState = cfc::invalid_index;
 };
 
@@ -85,12 +86,12 @@ public:
 
 	virtual void Begin(cfc::gfx_command_list* const cmdList) override;
 
-	virtual usize GetShaderProgram() const override { return m_shrDrawOpaqueProgram; }
+	virtual cfc::gfx_program_handle GetShaderProgram() const override { return m_shrDrawOpaqueProgram; }
 
 private:
-	usize m_shrDrawOpaqueVS = cfc::invalid_index;
-	usize m_shrDrawOpaquePS = cfc::invalid_index;
-	usize m_shrDrawOpaqueProgram = cfc::invalid_index;
+	cfc::gfx_shader_handle m_shrDrawOpaqueVS;
+	cfc::gfx_shader_handle m_shrDrawOpaquePS;
+	cfc::gfx_program_handle m_shrDrawOpaqueProgram;
 	usize m_shrDrawOpaqueProgramState = cfc::invalid_index;
 };
 
@@ -104,15 +105,15 @@ public:
 
 	virtual void Begin(cfc::gfx_command_list* const cmdList) override;
 
-	virtual usize GetShaderProgram() const override { return m_shrComputeProgram; }
+	virtual cfc::gfx_program_handle GetShaderProgram() const override { return m_shrComputeProgram; }
 
 	virtual u32 GetNumThreadsX() const override { return m_numThreadsX; };
 	virtual u32 GetNumThreadsY() const override { return m_numThreadsY; };
 	virtual u32 GetNumThreadsZ() const override { return m_numThreadsZ; };
 
 private:
-	usize m_shrComputeCS = cfc::invalid_index;
-	usize m_shrComputeProgram = cfc::invalid_index;
+	cfc::gfx_shader_handle m_shrComputeCS;
+	cfc::gfx_program_handle m_shrComputeProgram;
 	usize m_shrComputeProgramState = cfc::invalid_index;
 	u32 m_numThreadsX = 0;
 	u32 m_numThreadsY = 0;
@@ -129,12 +130,12 @@ public:
 
 	virtual void Begin(cfc::gfx_command_list* const cmdList) override;
 
-	virtual usize GetShaderProgram() const override { return m_shrCollectVisibleProgram; }
+	virtual cfc::gfx_program_handle GetShaderProgram() const override { return m_shrCollectVisibleProgram; }
 
 private:
-	usize m_shrCollectVisibleVS = cfc::invalid_index;
-	usize m_shrCollectVisiblePS = cfc::invalid_index;
-	usize m_shrCollectVisibleProgram = cfc::invalid_index;
+	cfc::gfx_shader_handle m_shrCollectVisibleVS;
+	cfc::gfx_shader_handle m_shrCollectVisiblePS;
+	cfc::gfx_program_handle m_shrCollectVisibleProgram;
 	usize m_shrCollectVisibleProgramState = cfc::invalid_index;
 };
 
@@ -148,15 +149,15 @@ public:
 
 	virtual void Begin(cfc::gfx_command_list* const cmdList) override;
 
-	virtual usize GetShaderProgram() const override { return m_shrComputeProgram; }
+	virtual cfc::gfx_program_handle GetShaderProgram() const override { return m_shrComputeProgram; }
 
 	virtual u32 GetNumThreadsX() const override { return m_numThreadsX; };
 	virtual u32 GetNumThreadsY() const override { return m_numThreadsY; };
 	virtual u32 GetNumThreadsZ() const override { return m_numThreadsZ; };
 
 private:
-	usize m_shrComputeCS = cfc::invalid_index;
-	usize m_shrComputeProgram = cfc::invalid_index;
+	cfc::gfx_shader_handle m_shrComputeCS;
+	cfc::gfx_program_handle m_shrComputeProgram;
 	usize m_shrComputeProgramState = cfc::invalid_index;
 	u32 m_numThreadsX = 0;
 	u32 m_numThreadsY = 0;
@@ -173,15 +174,15 @@ public:
 
 	virtual void Begin(cfc::gfx_command_list* const cmdList) override;
 
-	virtual usize GetShaderProgram() const override { return m_shrComputeProgram; }
+	virtual cfc::gfx_program_handle GetShaderProgram() const override { return m_shrComputeProgram; }
 
 	virtual u32 GetNumThreadsX() const override { return m_numThreadsX; };
 	virtual u32 GetNumThreadsY() const override { return m_numThreadsY; };
 	virtual u32 GetNumThreadsZ() const override { return m_numThreadsZ; };
 
 private:
-	usize m_shrComputeCS = cfc::invalid_index;
-	usize m_shrComputeProgram = cfc::invalid_index;
+	cfc::gfx_shader_handle m_shrComputeCS;
+	cfc::gfx_program_handle m_shrComputeProgram;
 	usize m_shrComputeProgramState = cfc::invalid_index;
 	u32 m_numThreadsX = 0;
 	u32 m_numThreadsY = 0;
@@ -198,12 +199,12 @@ public:
 
 	virtual void Begin(cfc::gfx_command_list* const cmdList) override;
 
-	virtual usize GetShaderProgram() const override { return m_shrCopyDepthProgram; }
+	virtual cfc::gfx_program_handle GetShaderProgram() const override { return m_shrCopyDepthProgram; }
 
 private:
-	usize m_shrCopyDepthVS = cfc::invalid_index;
-	usize m_shrCopyDepthPS = cfc::invalid_index;
-	usize m_shrCopyDepthProgram = cfc::invalid_index;
+	cfc::gfx_shader_handle m_shrCopyDepthVS;
+	cfc::gfx_shader_handle m_shrCopyDepthPS;
+	cfc::gfx_program_handle m_shrCopyDepthProgram;
 	usize m_shrCopyDepthProgramState = cfc::invalid_index;
 };
 
@@ -217,11 +218,11 @@ public:
 
 	virtual void Begin(cfc::gfx_command_list* const cmdList) override;
 
-	virtual usize GetShaderProgram() const override { return m_shrProgram; }
+	virtual cfc::gfx_program_handle GetShaderProgram() const override { return m_shrProgram; }
 
 private:
-	usize m_shrVS = cfc::invalid_index;
-	usize m_shrPS = cfc::invalid_index;
-	usize m_shrProgram = cfc::invalid_index;
+	cfc::gfx_shader_handle m_shrVS;
+	cfc::gfx_shader_handle m_shrPS;
+	cfc::gfx_program_handle m_shrProgram;
 	usize m_shrProgramState = cfc::invalid_index;
 };
\ No newline at end of file
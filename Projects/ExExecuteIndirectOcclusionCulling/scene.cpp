@@ -1,488 +1,46 @@
 #include "scene.h"
 
-#include <dependencies/stb/stb_obj_loader.h>
-#include <dependencies/stb/stb_image.h>
-#include <dependencies/stb/stb_image_mipmap.h>
-#include <dependencies/collision/libcollision.h>
-
 #include <cfc/stl/stl_string.hpp>
 #include <cfc/stl/stl_unique_ptr.hpp>
-#include <cfc/stl/stl_string_advanced.hpp>
+
+#include <cfc/core/memory_tracker.h>
+
+#include <cfc/math/math_simd.h>
 
 #include <cfc/gpu/gfx.h>
 #include <cfc/gpu/gfx_d3d12.h>
 #include <cfc/gpu/gpu_d3d12.h>
 
+#include <float.h>
 
 #include "camera.h"
-
-#define REQUEST_RGBA_4_COMPONENTS 4
+#include "sceneCulling.h"
 
 #define CB_ALIGNMENT_IN_BYTES 256
 
 
-static const u32 g_numVerticesCube = 8;
-static const u32 g_numIndicesCube = 36;
-static const u32 g_indexBufferDataCube[] = { 0, 1, 2, 2, 1, 3,		// front face
-											 4, 0, 6, 6, 0, 2,		// left face
-											 5, 4, 7, 7, 4, 6,		// back face
-											 1, 5, 3, 3, 5, 7,		// right face
-											 4, 5, 0, 0, 5, 1,		// top face
-											 2, 3, 6, 6, 3, 7 };		// bottom face
-
-
-struct vert_pos_uv
-{
-	float X, Y, Z;
-	float U, V;
-};
-
-struct vert_pos
-{
-	float X, Y, Z;
-};
-
-struct indirectDrawOpaqueArgs
-{
-	cfc::gpu_dx12_cmdlist_indirect_api::dx12_indirect_command_descriptors::ICIndexBufferViewArgs IBV;
-	cfc::gpu_dx12_cmdlist_indirect_api::dx12_indirect_command_descriptors::ICVertexBufferViewArgs VBV;
-	u32 ModelMatrixIndex;
-	u32 AlbedoTextureDescriptorTableIdx;
-	cfc::gpu_dx12_cmdlist_indirect_api::dx12_indirect_command_descriptors::ICDrawIndexedInstancedArgs Draw;
-	u32 _padding;
-};
-
-
-
-void generateCubePositions(vert_pos inOut[8])
-{
-	// build unit cube (size xyz=1, center xyz=0)
-	for (u32 i = 0; i < 8; ++i)
-	{
-		// generate xyz offsets by bit field exploitation
-		const float xOffset = (float)((i & 1) >> 0); // 01010101...
-		const float yOffset = (float)((i & 2) >> 1); // 00110011...
-		const float zOffset = (float)((i & 4) >> 2); // 00001111...
-
-		inOut[i].X = -0.5f + xOffset;
-		inOut[i].Y = -0.5f + yOffset;
-		inOut[i].Z = -0.5f + zOffset;
-	}
-}
-
-float ucharColorChannelToFloat(unsigned char x)
-{
-	return (float)x / 255.0f;
-}
-
-unsigned char floatColorChannelToUChar(float x)
-{
-	return (unsigned char)(x * 255.0f);
-}
-
-void scene::Load(cfc::context* const context, cfc::gfx& gfx, stl_string sceneFile)
+void scene::Unload(cfc::gfx& gfx)
 {
-	cfc::gfx_resource_stream* gfxResourceStream = gfx.GetResourceStream(gfx.AddResourceStream());
-
-	m_opaqueRenderingDescHeap = gfx.GetDescriptorHeap(gfx.AddDescriptorHeap());
-	m_depthBufferDescHeap = gfx.GetDescriptorHeap(gfx.AddDescriptorHeap());
-
-	char resourceNameBuffer[128];
-
-	// DX12 INTEROP
-	cfc::gfx_dx12& dx12Gfx = static_cast<cfc::gfx_dx12&>(gfx);
-	cfc::gpu_dx12_context& dx12Context = *reinterpret_cast<cfc::gpu_dx12_context*>(dx12Gfx.DX12_GetContext());
-
-	// load render passes
-	setStatus(stl_string_advanced::sprintf("Loading render passes."));
-	m_downSampleReprojectedDepthBufferCmp.Load(context, gfx, 32, 32);
-	m_reprojectDepthBufferCmp.Load(context, gfx, 32, 32);
-	m_copyReprojectDepthBuffer.Load(context, gfx);
-	m_renderVisibilityGfx.Load(context, gfx);
-	m_collectVisibleDrawCallsCmp.Load(context, gfx, 1024);
-	m_collectVisibleDrawCallsCmpLowOverhead.Load(context, gfx);
-	m_renderOpaqueGfx.Load(context, gfx);
-	m_debugFullScreenTexQuad.Load(context, gfx);
-	m_debugOpaqueWireFrameGfx.Load(context, gfx);
-
-	// timer query groups indirect
-	m_timerQueryIndirectDrawFrame.resize(gfx.GetTimerQueryFrameDelayQuantity());
-	m_timerQueryClearUav.resize(gfx.GetTimerQueryFrameDelayQuantity());
-	m_timerQueryReprojectDepth.resize(gfx.GetTimerQueryFrameDelayQuantity());
-	m_timerQueryDownSampleReprojectedDepth.resize(gfx.GetTimerQueryFrameDelayQuantity());
-	m_timerQueryCopyUAVToDepth.resize(gfx.GetTimerQueryFrameDelayQuantity());
-	m_timerQueryDrawAABBs.resize(gfx.GetTimerQueryFrameDelayQuantity());
-	m_timerQueryClearAppendBufferPass.resize(gfx.GetTimerQueryFrameDelayQuantity());
-	m_timerQueryAquireVisibleObjects.resize(gfx.GetTimerQueryFrameDelayQuantity());
-	m_timerQueryIndirectDraw.resize(gfx.GetTimerQueryFrameDelayQuantity());
-
-	// timer query groups direct
-	m_timerQueryDirectDraw.resize(gfx.GetTimerQueryFrameDelayQuantity());
-
-	// get base path of obj file for material loading
-	stl_string basePath = "";	
-
-	// NOTE: + 1 append to lastIndexOfFolderDivide makes sure to include '/' character as folder divide
-	usize lastIndexOfFolderDivide = sceneFile.find_last_of('/');
-	if (lastIndexOfFolderDivide != std::string::npos)
-		basePath = sceneFile.substr(0, lastIndexOfFolderDivide + 1);
-
-	// load meshes and materials for visual fidelity
-	setStatus(stl_string_advanced::sprintf("Loading OBJ (%s)", sceneFile.c_str()));
-	stl_vector<tinyobj::shape_t> meshes;
-	stl_vector<tinyobj::material_t> materials;
-	stl_assert(tinyobj::LoadObj(meshes, materials, sceneFile.c_str(), basePath.c_str()) == "");
-
-	u32 gridSize = GRID_SIZE;
-	u32 numLoadedMeshes = (u32)meshes.size();
-	m_maxNumMeshesToRender = numLoadedMeshes * gridSize * gridSize;
-	m_vertexBuffers.resize(m_maxNumMeshesToRender);
-	m_indexBuffers.resize(m_maxNumMeshesToRender);
-	m_materialIds.resize(m_maxNumMeshesToRender);
-	m_modelMatrices.resize(m_maxNumMeshesToRender);
-	m_aabbs.resize(m_maxNumMeshesToRender);
-	m_final_aabbs.resize(m_maxNumMeshesToRender);
-	for (u32 y = 0; y < gridSize; ++y)
-	{
-		for (u32 x = 0; x < gridSize; ++x)
-		{
-			for (u32 i = 0; i < numLoadedMeshes; ++i)
-			{
-				setStatus(stl_string_advanced::sprintf("Processing mesh (%d/%d/%d).", x, y, i));
-				const u32 gridIndex = y * gridSize * numLoadedMeshes + x * numLoadedMeshes + i;
-
-				tinyobj::mesh_t& mesh = meshes[i].mesh;
-
-				const usize numVertices = mesh.positions.size() / 3;
-
-				// interleave vertex data (positions, uvs)
-				stl_vector<vert_pos_uv> vertices(numVertices);
-				for (usize v = 0; v < numVertices; ++v)
-				{
-					vertices[v].X = mesh.positions[v * 3 + 0];
-					vertices[v].Y = mesh.positions[v * 3 + 1];
-					vertices[v].Z = mesh.positions[v * 3 + 2];
-
-					// NOTE: V gets flipped to conform to DX UV space (bottom left 0,0)
-					vertices[v].U = mesh.texcoords[v * 2 + 0];
-					vertices[v].V = 1.0f - mesh.texcoords[v * 2 + 1];
-				}
-				m_vertexBuffers[gridIndex].SizeInBytes = (u32)(numVertices * sizeof(vert_pos_uv));
-				m_vertexBuffers[gridIndex].StrideInBytes = sizeof(vert_pos_uv);
-				m_vertexBuffers[gridIndex].GFXResourceIndex = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::VertexBuffer, &vertices[0], m_vertexBuffers[gridIndex].SizeInBytes);
-
-				sprintf(resourceNameBuffer, "m_vertexBuffers[%d]", gridIndex);
-				dx12Context.ResourceSetName(m_vertexBuffers[gridIndex].GFXResourceIndex, resourceNameBuffer);
-
-				// flip winding order
-				const u32 numIndices = (u32)mesh.indices.size();
-				const u32 numFaces = (u32)mesh.indices.size() / 3;
-
-				stl_vector<u32> indices(mesh.indices);
-				for (usize j = 0; j < numFaces; ++j)
-				{
-					const usize index = j * 3;
-					std::swap(indices[index], indices[index + 2]);
-				}
-
-				m_indexBuffers[gridIndex].SizeInBytes = numIndices * sizeof(u32);
-				m_indexBuffers[gridIndex].NumIndices = numIndices;
-				m_indexBuffers[gridIndex].GFXResourceIndex = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::IndexBuffer, &indices[0], m_indexBuffers[gridIndex].SizeInBytes);
-
-				sprintf(resourceNameBuffer, "m_indexBuffers[%d]", gridIndex);
-				dx12Context.ResourceSetName(m_indexBuffers[gridIndex].GFXResourceIndex, resourceNameBuffer);
-
-				// we only support the first ID at the moment
-				m_materialIds[gridIndex] = mesh.material_ids[0];
-
-				// setup a simple grid model matrix offset
-				memset(m_modelMatrices[gridIndex].Mat, 0, sizeof(mat4_simple));
-				m_modelMatrices[gridIndex].Mat[0] = MODEL_SCALE;
-				m_modelMatrices[gridIndex].Mat[5] = MODEL_SCALE;
-				m_modelMatrices[gridIndex].Mat[10] = MODEL_SCALE;
-				m_modelMatrices[gridIndex].Mat[12] = (-(float)gridSize * 0.5f + (float)x) * 4; //xpos
-				m_modelMatrices[gridIndex].Mat[13] = 0; //ypos
-				m_modelMatrices[gridIndex].Mat[14] = (-(float)gridSize * 0.5f + (float)y) * 2.5f; //zpos
-				m_modelMatrices[gridIndex].Mat[15] = MODEL_SCALE;
-
-				// generate aabbs
-				// NOTE: for the maximum we cant use FLT_MIN since FLT_MIN returns the minimum positive value!
-				float min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
-				float max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
-
-				for (u32 v = 0; v < numVertices; ++v)
-				{
-					const u32 index = v * 3;
-					for (u32 j = 0; j < 3; ++j)
-					{
-						min[j] = min[j] < mesh.positions[index + j] ? min[j] : mesh.positions[index + j];
-						max[j] = max[j] > mesh.positions[index + j] ? max[j] : mesh.positions[index + j];
-					}
-				}
-
-				memcpy(m_aabbs[gridIndex].Min, min, sizeof(float) * 3);
-				memcpy(m_aabbs[gridIndex].Max, max, sizeof(float) * 3);
-
-				m_final_aabbs[gridIndex] = m_aabbs[gridIndex];
-				collision::PrimAABB& finalAABB = (collision::PrimAABB&)m_final_aabbs[gridIndex];
-				finalAABB.Transform(finalAABB, (collision::mat44f&)m_modelMatrices[gridIndex]);
-			}
-			gfxResourceStream->Flush();
-		}
-	}
-
-	m_modelMatricesGFXResourceIndex = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::SRVBuffer, &m_modelMatrices[0], sizeof(mat4_simple) * m_maxNumMeshesToRender);
-	dx12Context.ResourceSetName(m_modelMatricesGFXResourceIndex, "m_modelMatricesGFXResourceIndex");
-
-	gfxResourceStream->Flush();
-
-	m_albedoTextureGFXResourceIndex.reserve(materials.size() + 1);
-
-	// generate default texture
-	const u32 whiteTextureDataRGBA[4]{ 0xFF00FFFF, 0xFF00FFFF, 0xFF00FFFF, 0xFF00FFFF };
-	const u32 texDescTableIndexDefault = (u32)m_albedoTextureGFXResourceIndex.size();
-	m_defaultMaterial.AlbedoGFXResourceDescTableIndex = texDescTableIndexDefault;
-	m_albedoTextureGFXResourceIndex.push_back(gfxResourceStream->AddTexture(cfc::gfx_texture_creation_desc(&whiteTextureDataRGBA, cfc::gpu_format_type::Rgba8UnormSrgb, 2, 2)));
-	m_opaqueRenderingDescHeap->SetSRVTexture(texDescTableIndexDefault, m_albedoTextureGFXResourceIndex[texDescTableIndexDefault]);
-
-	dx12Context.ResourceSetName(m_albedoTextureGFXResourceIndex[texDescTableIndexDefault], "default texture");
-
-	gfxResourceStream->Flush();
-
-	// load materials
-	m_materials.resize(materials.size());
-	for (u32 i = 0; i < materials.size(); ++i)
-	{
-		tinyobj::material_t& material = materials[i];
-
-		stl_string albedoTexturePath = basePath + material.diffuse_texname;
-
-		setStatus(stl_string_advanced::sprintf("Loading texture (%s).", albedoTexturePath.c_str()));
-
-		// load albedo texture
-		i32 width, height, numComponents = 0;
-		stbi_uc* image = stbi_load(albedoTexturePath.c_str(), &width, &height, &numComponents, REQUEST_RGBA_4_COMPONENTS);
-		m_materials[i].AlbedoGFXResourceDescTableIndex = m_defaultMaterial.AlbedoGFXResourceDescTableIndex;
-
-		if (image == nullptr)
-			continue;
-
-		// only supply premul alpha when texture contains alpha
-		if (numComponents == REQUEST_RGBA_4_COMPONENTS)
-		{
-			const usize numPixels = width * height;
-			for (u32 x = 0; x < numPixels; ++x)
-			{
-				const u32 pixelIndex = x * numComponents;
-				const float alpha = ucharColorChannelToFloat(image[pixelIndex + 3]);
-				for (u32 c = 0; c < 3; ++c)
-				{
-					const float preMulColorChannel = ucharColorChannelToFloat(image[pixelIndex + c]) * alpha;
-					image[pixelIndex + c] = floatColorChannelToUChar(preMulColorChannel);
-				}
-			}
-		}
-
-		setStatus( stl_string_advanced::sprintf("Generating mips for texture (%s).", albedoTexturePath.c_str()));
-
-		// generate mips
-		int channels = 4;
-		int mipLevels = stbi_mipmap_info_quantity(width, height);
-		int mipBytes = stbi_mipmap_info_bytes(width, height, channels, 0, mipLevels);
-		stl_unique_ptr<unsigned char[]> nimage(new unsigned char[mipBytes]);
-
-		// - level 0
-		memcpy(&nimage[0], image, width*height * channels);
-
-		// - level 1-n
-		for (int i = 1; i < mipLevels; i++)
-		{
-			int w, h;
-			stbi_mipmap_info_dimensions(width, height, i - 1, &w, &h);
-			int offsetSource = stbi_mipmap_info_bytes(width, height, channels, 0, i-1);
-			int offsetDest = offsetSource + stbi_mipmap_info_bytes(width, height, channels, i-1, 1);
-			stbi_mipmap_image(&nimage[offsetSource], w, h, channels, &nimage[offsetDest], 2, 2);
-		}
-
-
-		const u32 texDescTableIndex = (u32)m_albedoTextureGFXResourceIndex.size();
-		m_materials[i].AlbedoGFXResourceDescTableIndex = texDescTableIndex;
-		m_albedoTextureGFXResourceIndex.push_back(gfxResourceStream->AddTexture(cfc::gfx_texture_creation_desc(&nimage[0], cfc::gpu_format_type::Rgba8UnormSrgb, width, height, mipLevels)));
-		//m_albedoTextureGFXResourceIndex.push_back(gfxResourceStream->AddTexture(cfc::gfx_texture_creation_desc(image, cfc::gpu_format_type::Rgba8UnormSrgb, width, height, 1));
-		m_opaqueRenderingDescHeap->SetSRVTexture(texDescTableIndex, m_albedoTextureGFXResourceIndex[texDescTableIndex]);
-
-		sprintf(resourceNameBuffer, "opaque texture [%d]", i);
-		dx12Context.ResourceSetName(m_albedoTextureGFXResourceIndex[texDescTableIndex], resourceNameBuffer);
-
-		gfxResourceStream->Flush();
-
-		free(image);
-	}
-
-	setStatus(stl_string_advanced::sprintf("Finalizing."));
-
-	// generate visibility mesh (aabb)
-	vert_pos visibilityAABBMeshVerts[g_numVerticesCube];
-	generateCubePositions(visibilityAABBMeshVerts);
-
-	m_aabbVertexBuffer.SizeInBytes = sizeof(vert_pos) * g_numVerticesCube;
-	m_aabbVertexBuffer.StrideInBytes = sizeof(vert_pos);
-	m_aabbVertexBuffer.GFXResourceIndex = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::VertexBuffer, visibilityAABBMeshVerts, m_aabbVertexBuffer.SizeInBytes);
-	
-	dx12Context.ResourceSetName(m_aabbVertexBuffer.GFXResourceIndex, "m_aabbVertexBuffer");
-
-	m_aabbIndexBuffer.NumIndices = g_numIndicesCube;
-	m_aabbIndexBuffer.SizeInBytes = g_numIndicesCube * sizeof(u32);
-	m_aabbIndexBuffer.GFXResourceIndex = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::IndexBuffer, g_indexBufferDataCube, m_aabbIndexBuffer.SizeInBytes);
-
-	dx12Context.ResourceSetName(m_aabbIndexBuffer.GFXResourceIndex, "m_aabbIndexBuffer");
-
-	// generate aabb transform matrices
-	m_aabbTransScaleMatrices.resize(m_aabbs.size());
-	for (u32 i = 0; i < m_aabbs.size(); ++i)
-	{
-		for (u32 j = 0; j < 3; ++j)
-		{
-			// calculate scale
-			float scale = m_aabbs[i].Max[j] - m_aabbs[i].Min[j];
-			m_aabbTransScaleMatrices[i].Mat[j * 5] = scale;
-			
-			// calculate center position
-			m_aabbTransScaleMatrices[i].Mat[12 + j] = m_aabbs[i].Min[j] + scale * 0.5f;
-		}
-		m_aabbTransScaleMatrices[i].Mat[15] = 1.0f;
-	}
-	m_aabbTransScaleMatricesGFXResourceIndex = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::SRVBuffer, &m_aabbTransScaleMatrices[0], sizeof(mat4_simple) * m_aabbTransScaleMatrices.size());
-
-	dx12Context.ResourceSetName(m_aabbTransScaleMatricesGFXResourceIndex, "m_aabbTransScaleMatrices");
-
-	// create visibility UAV
-	stl_vector<u32> visibilityBuffer(m_aabbs.size());
-	m_visibilityBufferGFXResourceIndex.resize(gfx.GetBackbufferFrameQuantity());
-	for (u32 i = 0; i < gfx.GetBackbufferFrameQuantity(); ++i)
-	{
-		m_visibilityBufferGFXResourceIndex[i] = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::UAVBuffer, &visibilityBuffer[0], sizeof(u32) * visibilityBuffer.size());
-
-		sprintf(resourceNameBuffer, "m_visibilityBufferGFXResourceIndex[%d]", i);
-		dx12Context.ResourceSetName(m_visibilityBufferGFXResourceIndex[i], resourceNameBuffer);
-	}
-	
-	gfxResourceStream->Flush();
-
-	// DX12 INTEROP
-	usize rootSignatureIdx = dx12Gfx.DX12_GetRootSignatureIdxFromProgram(m_renderOpaqueGfx.GetShaderProgram());
-	
-	m_opaqueIndirectCmdList = new cfc::gpu_dx12_cmdlist_indirect_api(dx12Context);
-	m_opaqueIndirectCmdList->ICIASetIndexBuffer();
-	m_opaqueIndirectCmdList->ICIASetVertexBuffers(0, 1);
-	m_opaqueIndirectCmdList->ICSetRoot32BitConstants(2, 2, 0);
-	m_opaqueIndirectCmdList->ICDrawIndexedInstanced();
-
-	// note since we are using RootConstants in the indirect command list, we need to set a root signature.
-	bool indirectTemplateCompiled = m_opaqueIndirectCmdList->CompileIC(rootSignatureIdx);
-
-	// create indirect draw commands for opaque pass
-	m_opaqueIndirectCmdListRef.resize(gfx.GetBackbufferFrameQuantity());
-	m_opaqueIndirectCmdListAppend.resize(gfx.GetBackbufferFrameQuantity());
-
-	stl_vector<indirectDrawOpaqueArgs> indirectDrawOpaque;
-	indirectDrawOpaque.resize(m_maxNumMeshesToRender);
-	for (u32 i = 0; i < m_maxNumMeshesToRender; ++i)
-	{
-		indirectDrawOpaque[i].IBV.BufferLocation = dx12Context.ResourceGetGPUAddress(m_indexBuffers[i].GFXResourceIndex);
-		indirectDrawOpaque[i].IBV.SizeInBytes = m_indexBuffers[i].SizeInBytes;
-		indirectDrawOpaque[i].IBV.Format = (u32)cfc::gpu_format_type::R32Uint;
-
-		indirectDrawOpaque[i].VBV.BufferLocation = dx12Context.ResourceGetGPUAddress(m_vertexBuffers[i].GFXResourceIndex);
-		indirectDrawOpaque[i].VBV.SizeInBytes = m_vertexBuffers[i].SizeInBytes;
-		indirectDrawOpaque[i].VBV.StrideInBytes = m_vertexBuffers[i].StrideInBytes;
-
-		indirectDrawOpaque[i].ModelMatrixIndex = i;
-		indirectDrawOpaque[i].AlbedoTextureDescriptorTableIdx = m_materials[m_materialIds[i]].AlbedoGFXResourceDescTableIndex;
-
-		indirectDrawOpaque[i].Draw.IndexCountPerInstance = m_indexBuffers[i].NumIndices;
-		indirectDrawOpaque[i].Draw.InstanceCount = 1;
-		indirectDrawOpaque[i].Draw.BaseVertexLocation = 0;
-		indirectDrawOpaque[i].Draw.StartIndexLocation = 0;
-		indirectDrawOpaque[i].Draw.StartInstanceLocation = 0;
-	}
-	
-	m_opaqueIndirectCmdListAppendDescTableOffset.resize(gfx.GetBackbufferFrameQuantity());
-	for (u32 i = 0; i < gfx.GetBackbufferFrameQuantity(); ++i)
-	{
-		m_opaqueIndirectCmdListRef[i] = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::SRVBuffer, &indirectDrawOpaque[0], sizeof(indirectDrawOpaqueArgs) * indirectDrawOpaque.size());
-		
-		// note that we add a u32 for the append buffer count
-		m_opaqueIndirectCmdListAppend[i].CounterOffsetInBytes = (u32)(sizeof(indirectDrawOpaqueArgs) * indirectDrawOpaque.size());
-		m_opaqueIndirectCmdListAppend[i].CounterOffsetInBytes = ((m_opaqueIndirectCmdListAppend[i].CounterOffsetInBytes + 4095) / 4096) * 4096;
-		m_opaqueIndirectCmdListAppend[i].AppendBufferGFXResourceIndex = gfxResourceStream->AddDynamicResource(cfc::gfx_resource_type::UAVBuffer, m_opaqueIndirectCmdListAppend[i].CounterOffsetInBytes + sizeof(u32), false);
-		gfxResourceStream->UpdateDynamicResource(m_opaqueIndirectCmdListAppend[i].AppendBufferGFXResourceIndex, sizeof(indirectDrawOpaqueArgs) * indirectDrawOpaque.size(), &indirectDrawOpaque[0]);
-
-		m_opaqueIndirectCmdListAppendDescTableOffset[i] = m_albedoTextureGFXResourceIndex.size() + i;
+	if (m_loader == nullptr)
+		return;
 
-		m_opaqueRenderingDescHeap->SetUAVBuffer(m_opaqueIndirectCmdListAppendDescTableOffset[i], m_opaqueIndirectCmdListAppend[i].AppendBufferGFXResourceIndex, sizeof(indirectDrawOpaqueArgs), 0, m_maxNumMeshesToRender, m_opaqueIndirectCmdListAppend[i].CounterOffsetInBytes, m_opaqueIndirectCmdListAppend[i].AppendBufferGFXResourceIndex);
+	// stop the loading stages, everything they created so far is released below
+	releaseLoader();
 
-		sprintf(resourceNameBuffer, "m_opaqueIndirectCmdListRef[%d]", i);
-		dx12Context.ResourceSetName(m_opaqueIndirectCmdListRef[i], resourceNameBuffer);
-
-		sprintf(resourceNameBuffer, "m_opaqueIndirectCmdListAppend[%d]", i);
-		dx12Context.ResourceSetName(m_opaqueIndirectCmdListAppend[i].AppendBufferGFXResourceIndex, resourceNameBuffer);
-	}
-
-	u32 zero[] = { 0,0,0,0 };
-	m_opaqueIndirectCmdListAppend[0].AppendBufferCounterResetGfxResourceIndex = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::CopySource, &zero, sizeof(zero));
-	m_opaqueIndirectCmdListAppend[1].AppendBufferCounterResetGfxResourceIndex = m_opaqueIndirectCmdListAppend[0].AppendBufferCounterResetGfxResourceIndex;
-
-	dx12Context.ResourceSetName(m_opaqueIndirectCmdListAppend[0].AppendBufferCounterResetGfxResourceIndex, "m_opaqueIndirectCmdListAppendCounterResetBuffer");
-
-	m_debugRT = gfx.AddRenderTarget2D(gfx.GetBackbufferWidth(), gfx.GetBackbufferHeight(), cfc::gpu_format_type::Rgba8UnormSrgb);
-	dx12Context.ResourceSetName(m_debugRT, "m_debugRT");
-
-	gfxResourceStream->Flush();
-
-	u32* tmpDepthBufferFill = new u32[gfx.GetBackbufferWidth() * gfx.GetBackbufferHeight()];
-
-	memset(tmpDepthBufferFill, 0xFF, sizeof(u32) * gfx.GetBackbufferWidth() * gfx.GetBackbufferHeight());
-	m_occlusionDepthBufferHalfRes.Width = gfx.GetBackbufferWidth() / HALF_SCREEN_DIV;
-	m_occlusionDepthBufferHalfRes.Height = gfx.GetBackbufferHeight() / HALF_SCREEN_DIV;
-	m_occlusionDepthBufferHalfRes.UAVRTResource = gfxResourceStream->AddTexture(cfc::gfx_texture_creation_desc(tmpDepthBufferFill, cfc::gpu_format_type::R32Typeless, (i32)m_occlusionDepthBufferHalfRes.Width, (i32)m_occlusionDepthBufferHalfRes.Height, 1, 1, true));
-	dx12Context.ResourceSetName(m_occlusionDepthBufferHalfRes.UAVRTResource, "m_occlusionDepthBufferHalfRes");
-
-	gfxResourceStream->Flush();
-
-	m_occlusionDepthBufferQuarterRes.Width = gfx.GetBackbufferWidth() / QUART_SCREEN_DIV;
-	m_occlusionDepthBufferQuarterRes.Height = gfx.GetBackbufferHeight() / QUART_SCREEN_DIV;
-	m_occlusionDepthBufferQuarterRes.UAVRTResource = gfxResourceStream->AddTexture(cfc::gfx_texture_creation_desc(tmpDepthBufferFill, cfc::gpu_format_type::R32Typeless, (i32)m_occlusionDepthBufferQuarterRes.Width, (i32)m_occlusionDepthBufferQuarterRes.Height, 1, 1, true));
-	dx12Context.ResourceSetName(m_occlusionDepthBufferQuarterRes.UAVRTResource, "m_occlusionDepthBufferQuarterRes");
-
-	delete[] tmpDepthBufferFill;
-
-	m_depthBufferDescHeap->SetSRVTexture(0, gfx.GetBackbufferDSResource(), cfc::gpu_format_type::R24UnormX8Typeless);
-	m_depthBufferDescHeap->SetUAVTexture(1, m_occlusionDepthBufferHalfRes.UAVRTResource, cfc::gpu_format_type::R32Uint);
-	m_depthBufferDescHeap->SetSRVTexture(2, m_occlusionDepthBufferHalfRes.UAVRTResource, cfc::gpu_format_type::R32Float);
-	m_depthBufferDescHeap->SetUAVTexture(3, m_occlusionDepthBufferQuarterRes.UAVRTResource, cfc::gpu_format_type::R32Float);
-	m_depthBufferDescHeap->SetSRVTexture(4, m_occlusionDepthBufferQuarterRes.UAVRTResource, cfc::gpu_format_type::R32Float);
-	m_depthBufferDescHeap->SetSRVTexture(5, gfx.GetRenderTargetResource(m_debugRT), cfc::gpu_format_type::Rgba8UnormSrgb);
-
-	gfxResourceStream->Flush();
-
-	gfxResourceStream->WaitForFinish();
-
-	gfx.RemoveResourceStream(gfxResourceStream->GetIndex());
-
-	m_status = stl_string_advanced::sprintf("Finished loading.");
-}
-
-void scene::Unload(cfc::gfx& gfx)
-{
-	for (u32 i = 0; i < m_vertexBuffers.size(); ++i)
-		gfx.RemoveResource(m_vertexBuffers[i].GFXResourceIndex);
+	// NOTE: instances share the buffers of their model's meshes, only the source buffers own them
+	// NOTE: meshes that were not uploaded before cancelling have no buffers
+	for (u32 i = 0; i < m_sourceVertexBuffers.size(); ++i)
+		if (m_sourceVertexBuffers[i].GFXResourceIndex.IsValid())
+			gfx.RemoveResource(m_sourceVertexBuffers[i].GFXResourceIndex);
 	gfx.RemoveResource(m_aabbVertexBuffer.GFXResourceIndex);
+	m_sourceVertexBuffers.resize(0);
 	m_vertexBuffers.resize(0);
 
-	for (u32 i = 0; i < m_indexBuffers.size(); ++i)
-		gfx.RemoveResource(m_indexBuffers[i].GFXResourceIndex);
+	for (u32 i = 0; i < m_sourceIndexBuffers.size(); ++i)
+		if (m_sourceIndexBuffers[i].GFXResourceIndex.IsValid())
+			gfx.RemoveResource(m_sourceIndexBuffers[i].GFXResourceIndex);
 	gfx.RemoveResource(m_aabbIndexBuffer.GFXResourceIndex);
+	m_sourceIndexBuffers.resize(0);
 	m_indexBuffers.resize(0);
 
 	gfx.RemoveResource(m_modelMatricesGFXResourceIndex);
@@ -493,7 +51,13 @@ void scene::Unload(cfc::gfx& gfx)
 		gfx.RemoveResource(m_albedoTextureGFXResourceIndex[i]);
 	m_albedoTextureGFXResourceIndex.resize(0);
 
+	m_textureStreamer.Shutdown(gfx);
+	m_materialStreamedTexture.resize(0);
+	m_uvDensities.resize(0);
+
 	m_materials.resize(0);
+	m_meshResident.resize(0);
+	m_maxNumMeshesToRender = 0;
 
 	gfx.RemoveResource(m_aabbTransScaleMatricesGFXResourceIndex);
 
@@ -505,18 +69,26 @@ void scene::Unload(cfc::gfx& gfx)
 		gfx.RemoveResource(m_opaqueIndirectCmdListRef[i]);
 	m_opaqueIndirectCmdListRef.resize(0);
 
+	if (!m_opaqueIndirectCmdListAppend.empty())
+		gfx.RemoveResource(m_opaqueIndirectCmdListAppend[0].AppendBufferCounterResetGfxResourceIndex);
+
 	for (u32 i = 0; i < m_opaqueIndirectCmdListAppend.size(); ++i)
 		gfx.RemoveResource(m_opaqueIndirectCmdListAppend[i].AppendBufferGFXResourceIndex);
 	m_opaqueIndirectCmdListAppend.resize(0);
 
-	gfx.RemoveResource(m_opaqueIndirectCmdListAppend[0].AppendBufferCounterResetGfxResourceIndex);
-
-	gfx.RemoveResource(m_occlusionDepthBufferHalfRes.UAVRTResource);
-	gfx.RemoveResource(m_occlusionDepthBufferQuarterRes.UAVRTResource);
+	// only created when loading finished
+	if (m_loadState == LoadStates::Loaded)
+	{
+		gfx.RemoveResource(m_occlusionDepthBufferHalfRes.UAVRTResource);
+		gfx.RemoveResource(m_occlusionDepthBufferQuarterRes.UAVRTResource);
 
-	gfx.RemoveRenderTarget(m_debugRT);
+		gfx.RemoveRenderTarget(m_debugRT);
+		m_debugRT = cfc::gfx_render_target_handle();
+	}
 
 	m_aabbs.resize(0);
+	for (u32 i = 0; i < 6; ++i)
+		m_cullBounds[i].resize(0);
 	m_aabbTransScaleMatrices.resize(0);
 
 	m_downSampleReprojectedDepthBufferCmp.Unload(gfx);
@@ -544,13 +116,23 @@ void scene::Unload(cfc::gfx& gfx)
 	m_timerQueryDirectDraw.resize(0);
 
 	delete m_opaqueIndirectCmdList;
+	m_opaqueIndirectCmdList = nullptr;
 
-	gfx.RemoveDescriptorHeap(m_opaqueRenderingDescHeap->GetIndex());
-	gfx.RemoveDescriptorHeap(m_depthBufferDescHeap->GetIndex());
+	gfx.RemoveDescriptorHeap(m_opaqueRenderingDescHeap->GetHandle());
+	gfx.RemoveDescriptorHeap(m_depthBufferDescHeap->GetHandle());
+	m_opaqueRenderingDescHeap = nullptr;
+	m_depthBufferDescHeap = nullptr;
+
+	m_loadState = LoadStates::Idle;
+	m_renderable = false;
 }
 
 void scene::Resize(cfc::gfx& gfx)
 {
+	// the size dependent resources are created when loading finishes
+	if (m_loadState != LoadStates::Loaded)
+		return;
+
 	// DX12 INTEROP
 	cfc::gfx_dx12& dx12Gfx = static_cast<cfc::gfx_dx12&>(gfx);
 	cfc::gpu_dx12_context& dx12Context = *reinterpret_cast<cfc::gpu_dx12_context*>(dx12Gfx.DX12_GetContext());
@@ -558,7 +140,7 @@ void scene::Resize(cfc::gfx& gfx)
 	cfc::gfx_resource_stream* gfxResourceStream = gfx.GetResourceStream(gfx.AddResourceStream());
 
 	m_debugRT = gfx.AddRenderTarget2D(gfx.GetBackbufferWidth(), gfx.GetBackbufferHeight(), cfc::gpu_format_type::Rgba8UnormSrgb);
-	dx12Context.ResourceSetName(m_debugRT, "m_debugRT");
+	dx12Context.ResourceSetName(dx12Gfx.DX12_GetResourceIdx(gfx.GetRenderTargetResource(m_debugRT)), "m_debugRT");
 
 	gfxResourceStream->Flush();
 
@@ -568,14 +150,14 @@ void scene::Resize(cfc::gfx& gfx)
 	m_occlusionDepthBufferHalfRes.Width = gfx.GetBackbufferWidth() / HALF_SCREEN_DIV;
 	m_occlusionDepthBufferHalfRes.Height = gfx.GetBackbufferHeight() / HALF_SCREEN_DIV;
 	m_occlusionDepthBufferHalfRes.UAVRTResource = gfxResourceStream->AddTexture(cfc::gfx_texture_creation_desc(tmpDepthBufferFill, cfc::gpu_format_type::R32Typeless, (i32)m_occlusionDepthBufferHalfRes.Width, (i32)m_occlusionDepthBufferHalfRes.Height, 1, 1, true));
-	dx12Context.ResourceSetName(m_occlusionDepthBufferHalfRes.UAVRTResource, "m_occlusionDepthBufferHalfRes");
+	dx12Context.ResourceSetName(dx12Gfx.DX12_GetResourceIdx(m_occlusionDepthBufferHalfRes.UAVRTResource), "m_occlusionDepthBufferHalfRes");
 
 	gfxResourceStream->Flush();
 
 	m_occlusionDepthBufferQuarterRes.Width = gfx.GetBackbufferWidth() / QUART_SCREEN_DIV;
 	m_occlusionDepthBufferQuarterRes.Height = gfx.GetBackbufferHeight() / QUART_SCREEN_DIV;
 	m_occlusionDepthBufferQuarterRes.UAVRTResource = gfxResourceStream->AddTexture(cfc::gfx_texture_creation_desc(tmpDepthBufferFill, cfc::gpu_format_type::R32Typeless, (i32)m_occlusionDepthBufferQuarterRes.Width, (i32)m_occlusionDepthBufferQuarterRes.Height, 1, 1, true));
-	dx12Context.ResourceSetName(m_occlusionDepthBufferQuarterRes.UAVRTResource, "m_occlusionDepthBufferQuarterRes");
+	dx12Context.ResourceSetName(dx12Gfx.DX12_GetResourceIdx(m_occlusionDepthBufferQuarterRes.UAVRTResource), "m_occlusionDepthBufferQuarterRes");
 
 	delete[] tmpDepthBufferFill;
 
@@ -591,10 +173,10 @@ void scene::Resize(cfc::gfx& gfx)
 
 	gfxResourceStream->WaitForFinish();
 
-	gfx.RemoveResourceStream(gfxResourceStream->GetIndex());
+	gfx.RemoveResourceStream(gfxResourceStream->GetHandle());
 }
 
-void scene::GatherFrameTimerQueries(cfc::gfx& gfx, OcclusionTypes occlusionType, stl_vector<cfc::gfx_gpu_timer_query>& timerQueriesOUT) const
+void scene::GatherFrameTimerQueries(cfc::gfx& gfx, OcclusionTypes occlusionType, stl_frame_vector<cfc::gfx_gpu_timer_query>& timerQueriesOUT) const
 {
 	const usize queryTimerResolvedFrame = gfx.GetTimerQueryResolvedFrameIndex();
 
@@ -621,24 +203,19 @@ void scene::GatherFrameTimerQueries(cfc::gfx& gfx, OcclusionTypes occlusionType,
 	}
 }
 
-stl_string scene::GetStatus()
-{
-	stl_string ret;
-	m_mtxStatus.lock();
-	ret = m_status;
-	m_mtxStatus.unlock();
-	return ret;
-}
-
-void scene::Render(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, OcclusionTypes occlusionType, usize viewStateGfxResourceIndex, usize prevViewStateGfxResourceIndex, view_state& view)
+void scene::Render(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, OcclusionTypes occlusionType, cfc::gfx_resource_handle viewStateGfxResourceIndex, cfc::gfx_resource_handle prevViewStateGfxResourceIndex, const scene_visibility& visibility)
 {
 	const usize queryTimerResolvedFrame = gfx.GetTimerQueryResolvedFrameIndex();
 
+	// the occlusion culling resources only exist once loading finished, partially loaded scenes are drawn directly
+	if (m_loadState != LoadStates::Loaded)
+		occlusionType = OcclusionTypes::None;
+
 	switch (occlusionType)
 	{
 		case OcclusionTypes::None:
 		{
-			renderNoOcclusion(gfx, cmdList, viewStateGfxResourceIndex, view);
+			renderNoOcclusion(gfx, cmdList, viewStateGfxResourceIndex, visibility);
 			break;
 		}
 		case OcclusionTypes::Gpu:
@@ -649,7 +226,171 @@ void scene::Render(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, OcclusionTypes
 	}
 }
 
-void scene::renderNoOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, usize viewStateGfxResourceIndex, view_state& view)
+void scene::UpdateVisibility(OcclusionTypes occlusionType, const view_state& view, scene_visibility& visibilityOUT)
+{
+	if (m_loadState != LoadStates::Loaded)
+		occlusionType = OcclusionTypes::None;
+
+	scene_frame_state& frame = visibilityOUT.Frame;
+	frame.ViewProjectionMatrix = view.ProjectionMatrix * view.ViewMatrix;
+
+	const cfc::math::simd::mat4 inverseView = cfc::math::simd::InverseAffine(cfc::math::simd::mat4(view.ViewMatrix));
+	frame.CameraPosition[0] = inverseView.M[12];
+	frame.CameraPosition[1] = inverseView.M[13];
+	frame.CameraPosition[2] = inverseView.M[14];
+
+	frame.WorldUnitsPerPixelAtUnitDistance = 2.0f / (view.ProjectionMatrix.MM[1][1] * view.ScreenHeight);
+	frame.GatherDirectDraws = occlusionType == OcclusionTypes::None;
+
+	// NOTE: only resized when the mesh quantity changes, the frame graph itself does not allocate
+	if (visibilityOUT.MeshInFrustum.size() != m_maxNumMeshesToRender)
+		visibilityOUT.MeshInFrustum.resize(m_maxNumMeshesToRender);
+
+	m_visibilityTarget = &visibilityOUT;
+	m_textureStreamer.BeginFrame();
+	m_frameGraph.Execute(*m_jobs);
+	m_visibilityTarget = nullptr;
+
+	visibilityOUT.Valid = true;
+}
+
+void scene_counters::Register(cfc::profiling::counter_registry* registry)
+{
+	Registry = registry;
+	if (Registry == nullptr)
+		return;
+
+	ObjectsTested = Registry->Register("Cull Objects Tested");
+	ObjectsInFrustum = Registry->Register("Cull Objects In Frustum");
+	ObjectsDrawn = Registry->Register("Draw Objects");
+	TrianglesSubmitted = Registry->Register("Draw Triangles");
+}
+
+void scene::UpdateTextureStreaming(cfc::gfx& gfx)
+{
+	cfc::memory_tag_scope tag(cfc::memory_tag::Textures);
+	m_textureStreamer.Update(gfx);
+}
+
+#pragma region Frame Graph
+void scene::buildFrameGraph()
+{
+	// cull -> texture mip requests
+	//      -> direct draw list
+	const u32 cull = m_frameGraph.AddNode([this]() { cullMeshes(); });
+	const u32 textureMips = m_frameGraph.AddNode([this]() { requestTextureMips(); });
+	const u32 directDraws = m_frameGraph.AddNode([this]() { gatherDirectDraws(); });
+
+	m_frameGraph.AddDependency(textureMips, cull);
+	m_frameGraph.AddDependency(directDraws, cull);
+}
+
+void scene::cullMeshes()
+{
+	scene_cull_counters cullCounters;
+	cullCounters.Registry = m_counters.Registry;
+	cullCounters.ObjectsTested = m_counters.ObjectsTested;
+	cullCounters.ObjectsInFrustum = m_counters.ObjectsInFrustum;
+
+	// meshes still in flight in the loader are never in the frustum
+	scene_culling::CullDraws(*m_jobs, m_visibilityTarget->Frame.ViewProjectionMatrix, m_cullBounds, m_meshResident.data(), m_maxNumMeshesToRender,
+		m_visibilityTarget->MeshInFrustum.data(), cullCounters);
+}
+
+void scene::requestTextureMips()
+{
+	const scene_frame_state& frame = m_visibilityTarget->Frame;
+	const u8* meshInFrustum = m_visibilityTarget->MeshInFrustum.data();
+	const u32 numTextures = (u32)m_textureStreamer.GetTextureQuantity();
+	if (numTextures == 0)
+		return;
+
+	// NOTE: requests are based on the view frustum, objects rejected by the gpu occlusion pass still request their mips
+	m_jobs->ParallelFor(0, m_maxNumMeshesToRender, [this, &frame, meshInFrustum, numTextures](u32 first, u32 last)
+	{
+		// the finest request per texture of this range (smallest uv density), merged into the streamer once per range
+		cfc::frame_allocator_scope transientScope;
+		stl_frame_vector<f32> rangeDensities(numTextures, FLT_MAX);
+		stl_frame_vector<u32> rangeTextures;
+
+		for (u32 i = first; i < last; ++i)
+		{
+			if (!meshInFrustum[i] || m_materialIds[i] >= m_materials.size() || m_materialStreamedTexture[m_materialIds[i]] == cfc::invalid_index)
+				continue;
+
+			// distance to the closest point on the bounding box, clamped to the near plane
+			float distanceSq = 0.0f;
+			for (u32 j = 0; j < 3; ++j)
+			{
+				const float below = m_final_aabbs[i].Min[j] - frame.CameraPosition[j];
+				const float above = frame.CameraPosition[j] - m_final_aabbs[i].Max[j];
+				const float d = below > 0.0f ? below : (above > 0.0f ? above : 0.0f);
+				distanceSq += d * d;
+			}
+			const float distance = distanceSq > 0.01f ? sqrtf(distanceSq) : 0.1f;
+
+			const u32 textureIndex = (u32)m_materialStreamedTexture[m_materialIds[i]];
+			const f32 density = m_uvDensities[i] * distance * frame.WorldUnitsPerPixelAtUnitDistance;
+			if (rangeDensities[textureIndex] == FLT_MAX)
+				rangeTextures.push_back(textureIndex);
+			rangeDensities[textureIndex] = density < rangeDensities[textureIndex] ? density : rangeDensities[textureIndex];
+		}
+
+		std::lock_guard<stl_mutex> lock(m_textureRequestLock);
+		for (usize i = 0; i < rangeTextures.size(); ++i)
+			m_textureStreamer.RequestMipFromUVDensity(rangeTextures[i], rangeDensities[rangeTextures[i]]);
+	}, SCENE_CULL_GRAIN_SIZE);
+}
+
+void scene::gatherDirectDraws()
+{
+	scene_visibility& visibility = *m_visibilityTarget;
+
+	// NOTE: the capacity is kept between frames
+	visibility.DirectDraws.clear();
+	if (!visibility.Frame.GatherDirectDraws)
+		return;
+
+	// count the draws of every block, an exclusive prefix sum gives each block its output offset, then every block writes
+	// its draws in mesh order
+	const u32 numBlocks = (m_maxNumMeshesToRender + SCENE_CULL_GRAIN_SIZE - 1) / SCENE_CULL_GRAIN_SIZE;
+	m_directDrawBlockOffsets.resize(numBlocks + 1);
+	const u8* meshInFrustum = visibility.MeshInFrustum.data();
+	m_jobs->ParallelFor(0, numBlocks, [this, meshInFrustum](u32 first, u32 last)
+	{
+		for (u32 block = first; block < last; ++block)
+		{
+			const u32 end = (block + 1) * SCENE_CULL_GRAIN_SIZE < m_maxNumMeshesToRender ? (block + 1) * SCENE_CULL_GRAIN_SIZE : m_maxNumMeshesToRender;
+			u32 numDraws = 0;
+			for (u32 i = block * SCENE_CULL_GRAIN_SIZE; i < end; ++i)
+				numDraws += meshInFrustum[i];
+			m_directDrawBlockOffsets[block + 1] = numDraws;
+		}
+	}, 1);
+
+	m_directDrawBlockOffsets[0] = 0;
+	for (u32 block = 0; block < numBlocks; ++block)
+		m_directDrawBlockOffsets[block + 1] += m_directDrawBlockOffsets[block];
+
+	visibility.DirectDraws.resize(m_directDrawBlockOffsets[numBlocks]);
+	u32* directDraws = visibility.DirectDraws.data();
+	m_jobs->ParallelFor(0, numBlocks, [this, meshInFrustum, directDraws](u32 first, u32 last)
+	{
+		for (u32 block = first; block < last; ++block)
+		{
+			const u32 end = (block + 1) * SCENE_CULL_GRAIN_SIZE < m_maxNumMeshesToRender ? (block + 1) * SCENE_CULL_GRAIN_SIZE : m_maxNumMeshesToRender;
+			u32* out = directDraws + m_directDrawBlockOffsets[block];
+			for (u32 i = block * SCENE_CULL_GRAIN_SIZE; i < end; ++i)
+			{
+				if (meshInFrustum[i])
+					*out++ = i;
+			}
+		}
+	}, 1);
+}
+#pragma endregion
+
+void scene::renderNoOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, cfc::gfx_resource_handle viewStateGfxResourceIndex, const scene_visibility& visibility)
 {
 	const usize frameIndex = gfx.GetBackbufferFrameIndex();
 	const usize timerQueryWriteIndex = gfx.GetTimerQueryWriteFrameIndex();
@@ -665,9 +406,6 @@ void scene::renderNoOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, usi
 	cmdList.GFXSetViewports(cfc::gpu_viewport(0, 0, (f32)gfx.GetBackbufferWidth(), (f32)gfx.GetBackbufferHeight()));
 	cmdList.GFXSetScissorRects(cfc::gpu_rectangle(0, 0, gfx.GetBackbufferWidth(), gfx.GetBackbufferHeight()));
 	cmdList.GFXSetRenderTargets(gfx.GetBackbufferRTVOffset(), gfx.GetBackbufferDSVOffset());
-	
-	collision::PrimFrustum frustum;
-	frustum.SetMatrix(view.ProjectionMatrix * view.ViewMatrix);
 
 	{
 		m_renderOpaqueGfx.Begin(&cmdList);
@@ -676,16 +414,16 @@ void scene::renderNoOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, usi
 			cmdList.GFXSetRootParameterCBV(1, viewStateGfxResourceIndex, CB_ALIGNMENT_IN_BYTES * frameIndex);
 
 			cmdList.SetDescriptorHeap(m_opaqueRenderingDescHeap);
-			cmdList.GFXSetDescriptorTableCbvSrvUav(3, m_defaultMaterial.AlbedoGFXResourceDescTableIndex);
+			cmdList.GFXSetDescriptorTableCbvSrvUav(3, m_textureStreamer.GetDescriptorTable(gfx.GetGlobalFrameIndex()));
 
 			cmdList.GFXSetRootParameterSRV(0, m_modelMatricesGFXResourceIndex);
 
-			// do draws
-			for (u32 i = 0; i < m_maxNumMeshesToRender; ++i)
+			// do draws, culled by the visibility stage
+			u64 numTriangles = 0;
+			for (usize d = 0; d < visibility.DirectDraws.size(); ++d)
 			{
-				collision::PrimAABB* bbox = ((collision::PrimAABB*)&m_final_aabbs[i]);
-				if (frustum.Test(*bbox) == false)
-					continue;
+				const u32 i = visibility.DirectDraws[d];
+				numTriangles += m_indexBuffers[i].NumIndices / 3;
 
 				u32 meshIndexOpaqueValue[2] = { i, m_materials[m_materialIds[i]].AlbedoGFXResourceDescTableIndex };
 				cmdList.GFXSetRootParameterConstants(2, meshIndexOpaqueValue, 2);
@@ -693,12 +431,15 @@ void scene::renderNoOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, usi
 				cmdList.GFXSetVertexBuffer(0, m_vertexBuffers[i].GFXResourceIndex, 0, m_vertexBuffers[i].StrideInBytes, m_vertexBuffers[i].SizeInBytes);
 				cmdList.GFXDrawIndexedInstanced(m_indexBuffers[i].NumIndices, 1, 0, 0, 0);
 			}
+
+			m_counters.Add(m_counters.ObjectsDrawn, (i64)visibility.DirectDraws.size());
+			m_counters.Add(m_counters.TrianglesSubmitted, (i64)numTriangles);
 		}
 	}
 	m_timerQueryDirectDraw[timerQueryWriteIndex].End();
 }
 
-void scene::renderGPUOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, usize viewStateGfxResourceIndex, usize prevViewStateGfxResourceIndex)
+void scene::renderGPUOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, cfc::gfx_resource_handle viewStateGfxResourceIndex, cfc::gfx_resource_handle prevViewStateGfxResourceIndex)
 {
 	const usize frameIndex = gfx.GetBackbufferFrameIndex();
 	const usize timerQueryWriteIndex = gfx.GetTimerQueryWriteFrameIndex();
@@ -715,7 +456,7 @@ void scene::renderGPUOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, us
 	// SETUP DEBUG DRAW RT
 	if (m_debugRenderMode != DebugRenderMode::NoDebugRender)
 	{
-		cmdList.ExecuteBarrier(cfc::gpu_resourcebarrier_desc::Transition(gfx.GetRenderTargetResource(m_debugRT), cfc::gpu_resourcestate::PixelShaderResource, cfc::gpu_resourcestate::RenderTarget));
+		cmdList.ExecuteTransitionBarrier(gfx.GetRenderTargetResource(m_debugRT), cfc::gpu_resourcestate::PixelShaderResource, cfc::gpu_resourcestate::RenderTarget);
 		const usize debugRTVOffset = gfx.GetRenderTargetRTVOffset(m_debugRT);
 		cmdList.GFXSetRenderTargets(&debugRTVOffset, 1, cfc::invalid_index);
 	}
@@ -724,7 +465,7 @@ void scene::renderGPUOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, us
 		cmdList.GFXSetRenderTargets(nullptr, 0, cfc::invalid_index);
 	}
 
-	cmdList.ExecuteBarrier(cfc::gpu_resourcebarrier_desc::Transition(m_occlusionDepthBufferHalfRes.UAVRTResource, cfc::gpu_resourcestate::PixelShaderResource | cfc::gpu_resourcestate::NonPixelShaderResource, cfc::gpu_resourcestate::UnorderedAccess));
+	cmdList.ExecuteTransitionBarrier(m_occlusionDepthBufferHalfRes.UAVRTResource, cfc::gpu_resourcestate::PixelShaderResource | cfc::gpu_resourcestate::NonPixelShaderResource, cfc::gpu_resourcestate::UnorderedAccess);
 
 	// CLEAR UAV
 	{
@@ -732,12 +473,12 @@ void scene::renderGPUOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, us
 		{
 			// DX12 specific, note that we use the DX12 gpu commands directly
 			cfc::gfx_dx12& dx12Gfx = static_cast<cfc::gfx_dx12&>(gfx);
-			cfc::gpu_dx12_cmdlist_direct_api& dx12CmdList = *reinterpret_cast<cfc::gpu_dx12_cmdlist_direct_api*>(dx12Gfx.DX12_GetDirectCommandListAPI(cmdList.GetIndex()));
+			cfc::gpu_dx12_cmdlist_direct_api& dx12CmdList = *reinterpret_cast<cfc::gpu_dx12_cmdlist_direct_api*>(dx12Gfx.DX12_GetDirectCommandListAPI(cmdList.GetHandle()));
 
 			float zero = 0.0;
 			u32 floatZeroAsUint = reinterpret_cast<u32&>(zero);
 			u32 values[4] = { floatZeroAsUint, floatZeroAsUint, floatZeroAsUint, floatZeroAsUint };
-			dx12CmdList.ClearUnorderedAccessViewUint(m_depthBufferDescHeap->GetUAVGPUDescriptorHandle(1), m_depthBufferDescHeap->GetUAVCPUDescriptorHandle(1), m_occlusionDepthBufferHalfRes.UAVRTResource, values, 0, NULL);
+			dx12CmdList.ClearUnorderedAccessViewUint(m_depthBufferDescHeap->GetUAVGPUDescriptorHandle(1), m_depthBufferDescHeap->GetUAVCPUDescriptorHandle(1), dx12Gfx.DX12_GetResourceIdx(m_occlusionDepthBufferHalfRes.UAVRTResource), values, 0, NULL);
 		}
 
 		m_timerQueryClearUav[timerQueryWriteIndex].End();
@@ -745,7 +486,7 @@ void scene::renderGPUOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, us
 
 	//cmdList.ExecuteBarrier(cfc::gpu_resourcebarrier_desc::UAV(m_occlusionDepthBufferHalfRes.UAVRTResource));
 
-	cmdList.ExecuteBarrier(cfc::gpu_resourcebarrier_desc::Transition(gfx.GetBackbufferDSResource(), cfc::gpu_resourcestate::DepthWrite, cfc::gpu_resourcestate::NonPixelShaderResource | cfc::gpu_resourcestate::PixelShaderResource));
+	cmdList.ExecuteTransitionBarrier(gfx.GetBackbufferDSResource(), cfc::gpu_resourcestate::DepthWrite, cfc::gpu_resourcestate::NonPixelShaderResource | cfc::gpu_resourcestate::PixelShaderResource);
 
 	// DEBUG RENDER DEPTH BUFFER
 	if (m_debugRenderMode == DebugRenderMode::RenderDebugAll || m_debugRenderMode == DebugRenderMode::RenderDebugPreviousDepth)
@@ -770,7 +511,7 @@ void scene::renderGPUOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, us
 		m_timerQueryReprojectDepth[timerQueryWriteIndex].End();
 	}
 
-	cmdList.ExecuteBarrier(cfc::gpu_resourcebarrier_desc::Transition(m_occlusionDepthBufferHalfRes.UAVRTResource, cfc::gpu_resourcestate::UnorderedAccess, cfc::gpu_resourcestate::PixelShaderResource | cfc::gpu_resourcestate::NonPixelShaderResource));
+	cmdList.ExecuteTransitionBarrier(m_occlusionDepthBufferHalfRes.UAVRTResource, cfc::gpu_resourcestate::UnorderedAccess, cfc::gpu_resourcestate::PixelShaderResource | cfc::gpu_resourcestate::NonPixelShaderResource);
 
 	// DEBUG RENDER REPROJECTED DEPTH
 	if (m_debugRenderMode == DebugRenderMode::RenderDebugAll || m_debugRenderMode == DebugRenderMode::RenderDebugReprojectedDepth)
@@ -781,7 +522,7 @@ void scene::renderGPUOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, us
 	// DOWN SAMPLE REPROJECTED Z BUFFER 1/4 res orig res
 	if (m_enableReprojectedDownSample)
 	{
-		cmdList.ExecuteBarrier(cfc::gpu_resourcebarrier_desc::Transition(m_occlusionDepthBufferQuarterRes.UAVRTResource, cfc::gpu_resourcestate::PixelShaderResource | cfc::gpu_resourcestate::NonPixelShaderResource, cfc::gpu_resourcestate::UnorderedAccess));
+		cmdList.ExecuteTransitionBarrier(m_occlusionDepthBufferQuarterRes.UAVRTResource, cfc::gpu_resourcestate::PixelShaderResource | cfc::gpu_resourcestate::NonPixelShaderResource, cfc::gpu_resourcestate::UnorderedAccess);
 
 		{
 			m_timerQueryDownSampleReprojectedDepth[timerQueryWriteIndex].Begin(&cmdList, "Down Sample Reprojected Depth");
@@ -798,7 +539,7 @@ void scene::renderGPUOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, us
 			m_timerQueryDownSampleReprojectedDepth[timerQueryWriteIndex].End();
 		}
 
-		cmdList.ExecuteBarrier(cfc::gpu_resourcebarrier_desc::Transition(m_occlusionDepthBufferQuarterRes.UAVRTResource, cfc::gpu_resourcestate::UnorderedAccess, cfc::gpu_resourcestate::PixelShaderResource | cfc::gpu_resourcestate::NonPixelShaderResource));
+		cmdList.ExecuteTransitionBarrier(m_occlusionDepthBufferQuarterRes.UAVRTResource, cfc::gpu_resourcestate::UnorderedAccess, cfc::gpu_resourcestate::PixelShaderResource | cfc::gpu_resourcestate::NonPixelShaderResource);
 
 		// DEBUG RENDER DOWNSAMPLED Z BUFFER
 		if (m_debugRenderMode == DebugRenderMode::RenderDebugAll || m_debugRenderMode == DebugRenderMode::RenderDebugReprojectedDownSample)
@@ -821,7 +562,7 @@ void scene::renderGPUOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, us
 		cmdList.GFXSetScissorRects(cfc::gpu_rectangle(0, 0, m_occlusionDepthBufferHalfRes.Width, m_occlusionDepthBufferHalfRes.Height));
 	}
 
-	cmdList.ExecuteBarrier(cfc::gpu_resourcebarrier_desc::Transition(gfx.GetBackbufferDSResource(), cfc::gpu_resourcestate::NonPixelShaderResource | cfc::gpu_resourcestate::PixelShaderResource, cfc::gpu_resourcestate::DepthWrite));
+	cmdList.ExecuteTransitionBarrier(gfx.GetBackbufferDSResource(), cfc::gpu_resourcestate::NonPixelShaderResource | cfc::gpu_resourcestate::PixelShaderResource, cfc::gpu_resourcestate::DepthWrite);
 
 	cmdList.GFXSetRenderTargets(nullptr, 0, gfx.GetBackbufferDSVOffset());
 
@@ -842,7 +583,7 @@ void scene::renderGPUOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, us
 		m_timerQueryCopyUAVToDepth[timerQueryWriteIndex].End();
 	}
 
-	cmdList.ExecuteBarrier(cfc::gpu_resourcebarrier_desc::Transition(m_visibilityBufferGFXResourceIndex[frameIndex], cfc::gpu_resourcestate::PixelShaderResource | cfc::gpu_resourcestate::NonPixelShaderResource, cfc::gpu_resourcestate::UnorderedAccess));
+	cmdList.ExecuteTransitionBarrier(m_visibilityBufferGFXResourceIndex[frameIndex], cfc::gpu_resourcestate::PixelShaderResource | cfc::gpu_resourcestate::NonPixelShaderResource, cfc::gpu_resourcestate::UnorderedAccess);
 
 	// DRAW AABBs
 	{
@@ -865,20 +606,20 @@ void scene::renderGPUOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, us
 		m_timerQueryDrawAABBs[timerQueryWriteIndex].End();
 	}
 
-	cmdList.ExecuteBarrier(cfc::gpu_resourcebarrier_desc::Transition(m_visibilityBufferGFXResourceIndex[frameIndex], cfc::gpu_resourcestate::UnorderedAccess, cfc::gpu_resourcestate::PixelShaderResource | cfc::gpu_resourcestate::NonPixelShaderResource));
+	cmdList.ExecuteTransitionBarrier(m_visibilityBufferGFXResourceIndex[frameIndex], cfc::gpu_resourcestate::UnorderedAccess, cfc::gpu_resourcestate::PixelShaderResource | cfc::gpu_resourcestate::NonPixelShaderResource);
 	
-	cmdList.ExecuteBarrier(cfc::gpu_resourcebarrier_desc::Transition(m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferGFXResourceIndex, cfc::gpu_resourcestate::IndirectArgument, cfc::gpu_resourcestate::CopyDestination));
+	cmdList.ExecuteTransitionBarrier(m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferGFXResourceIndex, cfc::gpu_resourcestate::IndirectArgument, cfc::gpu_resourcestate::CopyDestination);
 
 	// CLEAR APPEND BUFFER COUNTER
 	{
 		m_timerQueryClearAppendBufferPass[timerQueryWriteIndex].Begin(&cmdList, "Indirect Draw: Clear Append Buffer Pass");
 		cfc::gfx_dx12& dx12Gfx = static_cast<cfc::gfx_dx12&>(gfx);
-		cfc::gpu_dx12_cmdlist_direct_api& dx12CmdList = *reinterpret_cast<cfc::gpu_dx12_cmdlist_direct_api*>(dx12Gfx.DX12_GetDirectCommandListAPI(cmdList.GetIndex()));
-		dx12CmdList.CopyBufferRegion(m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferGFXResourceIndex, m_opaqueIndirectCmdListAppend[frameIndex].CounterOffsetInBytes, m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferCounterResetGfxResourceIndex, 0, sizeof(u32));
+		cfc::gpu_dx12_cmdlist_direct_api& dx12CmdList = *reinterpret_cast<cfc::gpu_dx12_cmdlist_direct_api*>(dx12Gfx.DX12_GetDirectCommandListAPI(cmdList.GetHandle()));
+		dx12CmdList.CopyBufferRegion(dx12Gfx.DX12_GetResourceIdx(m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferGFXResourceIndex), m_opaqueIndirectCmdListAppend[frameIndex].CounterOffsetInBytes, dx12Gfx.DX12_GetResourceIdx(m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferCounterResetGfxResourceIndex), 0, sizeof(u32));
 		m_timerQueryClearAppendBufferPass[timerQueryWriteIndex].End();
 	}
 
-	cmdList.ExecuteBarrier(cfc::gpu_resourcebarrier_desc::Transition(m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferGFXResourceIndex, cfc::gpu_resourcestate::CopyDestination, cfc::gpu_resourcestate::UnorderedAccess));
+	cmdList.ExecuteTransitionBarrier(m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferGFXResourceIndex, cfc::gpu_resourcestate::CopyDestination, cfc::gpu_resourcestate::UnorderedAccess);
 
 	// we move the clear of the depth stencil target to after visibility rendering
 	cmdList.GFXClearDepthStencilTarget(gfx.GetBackbufferDSVOffset());
@@ -921,7 +662,7 @@ void scene::renderGPUOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, us
 		m_timerQueryAquireVisibleObjects[timerQueryWriteIndex].End();
 	}
 
-	cmdList.ExecuteBarrier(cfc::gpu_resourcebarrier_desc::Transition(m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferGFXResourceIndex, cfc::gpu_resourcestate::UnorderedAccess, cfc::gpu_resourcestate::IndirectArgument));
+	cmdList.ExecuteTransitionBarrier(m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferGFXResourceIndex, cfc::gpu_resourcestate::UnorderedAccess, cfc::gpu_resourcestate::IndirectArgument);
 	
 	cmdList.GFXSetViewports(cfc::gpu_viewport(0, 0, (f32)gfx.GetBackbufferWidth(), (f32)gfx.GetBackbufferHeight()));
 	cmdList.GFXSetScissorRects(cfc::gpu_rectangle(0, 0, gfx.GetBackbufferWidth(), gfx.GetBackbufferHeight()));
@@ -936,12 +677,12 @@ void scene::renderGPUOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, us
 			cmdList.GFXSetPrimitiveTopology(cfc::gpu_primitive_type::TriangleList);
 			cmdList.GFXSetRootParameterCBV(1, viewStateGfxResourceIndex, CB_ALIGNMENT_IN_BYTES * frameIndex);
 			cmdList.GFXSetRootParameterSRV(0, m_modelMatricesGFXResourceIndex);
-			cmdList.GFXSetDescriptorTableCbvSrvUav(3, m_defaultMaterial.AlbedoGFXResourceDescTableIndex);
+			cmdList.GFXSetDescriptorTableCbvSrvUav(3, m_textureStreamer.GetDescriptorTable(gfx.GetGlobalFrameIndex()));
 
 			// DX12 specific, note that we use the DX12 gpu commands directly
 			cfc::gfx_dx12& dx12Gfx = static_cast<cfc::gfx_dx12&>(gfx);
-			cfc::gpu_dx12_cmdlist_direct_api& dx12CmdList = *reinterpret_cast<cfc::gpu_dx12_cmdlist_direct_api*>(dx12Gfx.DX12_GetDirectCommandListAPI(cmdList.GetIndex()));
-			dx12CmdList.ExecuteIndirect(m_opaqueIndirectCmdList, m_maxNumMeshesToRender, m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferGFXResourceIndex, 0, m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferGFXResourceIndex, m_opaqueIndirectCmdListAppend[frameIndex].CounterOffsetInBytes);
+			cfc::gpu_dx12_cmdlist_direct_api& dx12CmdList = *reinterpret_cast<cfc::gpu_dx12_cmdlist_direct_api*>(dx12Gfx.DX12_GetDirectCommandListAPI(cmdList.GetHandle()));
+			dx12CmdList.ExecuteIndirect(m_opaqueIndirectCmdList, m_maxNumMeshesToRender, dx12Gfx.DX12_GetResourceIdx(m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferGFXResourceIndex), 0, dx12Gfx.DX12_GetResourceIdx(m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferGFXResourceIndex), m_opaqueIndirectCmdListAppend[frameIndex].CounterOffsetInBytes);
 		}
 		m_timerQueryIndirectDraw[timerQueryWriteIndex].End();
 
@@ -953,11 +694,11 @@ void scene::renderGPUOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, us
 				cmdList.GFXSetPrimitiveTopology(cfc::gpu_primitive_type::TriangleList);
 				cmdList.GFXSetRootParameterCBV(1, viewStateGfxResourceIndex, CB_ALIGNMENT_IN_BYTES * frameIndex);
 				cmdList.GFXSetRootParameterSRV(0, m_modelMatricesGFXResourceIndex);
-				cmdList.GFXSetDescriptorTableCbvSrvUav(3, m_defaultMaterial.AlbedoGFXResourceDescTableIndex);
+				cmdList.GFXSetDescriptorTableCbvSrvUav(3, m_textureStreamer.GetDescriptorTable(gfx.GetGlobalFrameIndex()));
 
 				cfc::gfx_dx12& dx12Gfx = static_cast<cfc::gfx_dx12&>(gfx);
-				cfc::gpu_dx12_cmdlist_direct_api& dx12CmdList = *reinterpret_cast<cfc::gpu_dx12_cmdlist_direct_api*>(dx12Gfx.DX12_GetDirectCommandListAPI(cmdList.GetIndex()));
-				dx12CmdList.ExecuteIndirect(m_opaqueIndirectCmdList, m_maxNumMeshesToRender, m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferGFXResourceIndex, 0, m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferGFXResourceIndex, m_opaqueIndirectCmdListAppend[frameIndex].CounterOffsetInBytes);
+				cfc::gpu_dx12_cmdlist_direct_api& dx12CmdList = *reinterpret_cast<cfc::gpu_dx12_cmdlist_direct_api*>(dx12Gfx.DX12_GetDirectCommandListAPI(cmdList.GetHandle()));
+				dx12CmdList.ExecuteIndirect(m_opaqueIndirectCmdList, m_maxNumMeshesToRender, dx12Gfx.DX12_GetResourceIdx(m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferGFXResourceIndex), 0, dx12Gfx.DX12_GetResourceIdx(m_opaqueIndirectCmdListAppend[frameIndex].AppendBufferGFXResourceIndex), m_opaqueIndirectCmdListAppend[frameIndex].CounterOffsetInBytes);
 			}
 		}
 	}
@@ -1020,10 +761,3 @@ void scene::debugRenderTexture(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, us
 		}
 	}
 }
-
-void scene::setStatus(const stl_string& str)
-{
-	m_mtxStatus.lock();
-	m_status = str;
-	m_mtxStatus.unlock();
-}
@@ -4,10 +4,17 @@
 #include <cfc/stl/stl_vector.hpp>
 #include <cfc/stl/stl_string.hpp>
 #include <cfc/stl/stl_threading.hpp>
+#include <cfc/stl/stl_unique_ptr.hpp>
+#include <cfc/stl/jobsystem.h>
+#include <cfc/core/frame_allocator.h>
+#include <cfc/core/counters.h>
+#include <cfc/math/math.h>
 #include <cfc/gpu/gfx.h>
+#include <cfc/gpu/gfx_texture_streamer.h>
 
 #include "renderPasses.h"
 #include "occlusion.h"
+#include "sceneManifest.h"
 
 
 namespace cfc
@@ -18,22 +25,13 @@ namespace cfc
 	class gpu_dx12_cmdlist_indirect_api;
 }; 
 
-#define GRID_SIZE 4
-#define DRAW_SPONZA 1
-
-#if DRAW_SPONZA
-#define MODEL_SCALE 0.001f
-#else
-#define MODEL_SCALE 1.0f
-#endif
-
 struct view_state;
 
 struct occlusionDepthRT
 {
 	usize Width;
 	usize Height;
-	usize UAVRTResource;
+	cfc::gfx_resource_handle UAVRTResource;
 };
 
 struct material
@@ -41,32 +39,75 @@ struct material
 	u32 AlbedoGFXResourceDescTableIndex = 0;
 };
 
-struct mat4_simple
-{
-	float Mat[16];
-};
-
 struct append_buffer
 {
-	usize AppendBufferGFXResourceIndex = cfc::invalid_index;
-	usize AppendBufferCounterResetGfxResourceIndex = cfc::invalid_index;
+	cfc::gfx_resource_handle AppendBufferGFXResourceIndex;
+	cfc::gfx_resource_handle AppendBufferCounterResetGfxResourceIndex;
 	u32 CounterOffsetInBytes;
 };
 
 struct vertex_buffer
 {
-	usize GFXResourceIndex = cfc::invalid_index;
+	cfc::gfx_resource_handle GFXResourceIndex;
 	u32 SizeInBytes;
 	u32 StrideInBytes;
 };
 
 struct index_buffer
 {
-	usize GFXResourceIndex = cfc::invalid_index;
+	cfc::gfx_resource_handle GFXResourceIndex;
 	u32 SizeInBytes;
 	u32 NumIndices;
 };
 
+// numeric loading progress, can be queried from any thread
+struct scene_load_progress
+{
+	u32 NumMeshes = 0;
+	u32 NumMeshesProcessed = 0;		// geometry stage finished
+	u32 NumMeshesUploaded = 0;		// resident on the gpu and visible in the scene
+	u32 NumTextures = 0;
+	u32 NumTexturesProcessed = 0;	// decoded, mipmapped and compressed (or read from cache)
+	u32 NumTexturesUploaded = 0;	// registered with the texture streamer
+	f32 ElapsedSeconds = 0.0f;
+
+	f32 GetFraction() const { return (NumMeshes + NumTextures) > 0 ? (f32)(NumMeshesUploaded + NumTexturesUploaded) / (f32)(NumMeshes + NumTextures) : 0.0f; }
+};
+
+// view dependent values of a frame, read by the frame graph nodes
+struct scene_frame_state
+{
+	cfc::math::matrix4f ViewProjectionMatrix;
+	f32 CameraPosition[3];
+	f32 WorldUnitsPerPixelAtUnitDistance;	// world units covered by one pixel at a distance of one world unit
+	bool GatherDirectDraws;
+};
+
+// counters the scene reports into, the registry of the context (nullptr when the app has none)
+struct scene_counters
+{
+	cfc::profiling::counter_registry* Registry = nullptr;
+	usize ObjectsTested = cfc::invalid_index;		// frustum tests of the visibility stage
+	usize ObjectsInFrustum = cfc::invalid_index;
+	usize ObjectsDrawn = cfc::invalid_index;		// direct render path only, the indirect path decides on the gpu
+	usize TrianglesSubmitted = cfc::invalid_index;
+
+	void Register(cfc::profiling::counter_registry* registry);
+	void Add(usize counter, i64 value) const { if (Registry != nullptr) Registry->Add(counter, value); }
+};
+
+// output of the visibility stage for one frame, the owner keeps one per frame in flight
+struct scene_visibility
+{
+	scene_frame_state Frame;
+	stl_vector<u8> MeshInFrustum;	// per mesh, resident and inside the view frustum
+	stl_vector<u32> DirectDraws;	// meshes drawn by the direct render path, in mesh order
+	bool Valid = false;
+};
+
+// forward declare
+struct scene_loader;
+
 class scene
 {
 public:
@@ -86,15 +127,43 @@ public:
 		Count
 	};
 
+	enum class LoadStates
+	{
+		Idle,
+		Loading,		// stages are running, uploaded meshes are rendered without occlusion culling
+		Loaded,			// fully loaded and finalized, all render paths available
+		Cancelled,
+	};
+
 public:
-	void Load(cfc::context* const context, cfc::gfx& gfx, stl_string sceneFile);
+	scene();
+	~scene();
+
+	// starts the staged loader (parse, geometry, texture and gpu upload stages running concurrently), returns immediately
+	// NOTE: the manifest is copied, it can be discarded after this call
+	void LoadAsync(cfc::context* const context, cfc::gfx& gfx, const scene_manifest& manifest);
+	void CancelLoading();
+	// call once per frame from the render thread, applies arrived meshes and textures and finalizes the scene once all stages are done
+	void UpdateLoading(cfc::gfx& gfx);
 	void Unload(cfc::gfx& gfx);
 
+	LoadStates GetLoadState() const { return m_loadState; }
+	bool IsLoaded() const { return m_loadState == LoadStates::Loaded; }
+	bool IsRenderable() const { return m_renderable; }
+	scene_load_progress GetLoadProgress() const;
+
 	void Resize(cfc::gfx& gfx);
 
-	void Render(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, OcclusionTypes occlusionType, usize viewStateGfxResourceIndex, usize prevViewStateGfxResourceIndex, view_state& view);
+	// visibility stage, culls the scene and gathers texture mip requests for the view, does not touch gfx and can run on any thread
+	// NOTE: not concurrently with UpdateLoading, Unload or UpdateTextureStreaming, one visibility stage at a time
+	void UpdateVisibility(OcclusionTypes occlusionType, const view_state& view, scene_visibility& visibilityOUT);
+	// hands the mip requests of the last visibility stage to the texture streamer, render thread
+	void UpdateTextureStreaming(cfc::gfx& gfx);
 
-	void GatherFrameTimerQueries(cfc::gfx& gfx, OcclusionTypes occlusionType, stl_vector<cfc::gfx_gpu_timer_query>& timerQueriesOUT) const;
+	// record stage, draws the scene with the result of an earlier visibility stage
+	void Render(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, OcclusionTypes occlusionType, cfc::gfx_resource_handle viewStateGfxResourceIndex, cfc::gfx_resource_handle prevViewStateGfxResourceIndex, const scene_visibility& visibility);
+
+	void GatherFrameTimerQueries(cfc::gfx& gfx, OcclusionTypes occlusionType, stl_frame_vector<cfc::gfx_gpu_timer_query>& timerQueriesOUT) const;
 
 	DebugRenderMode GetDebugRenderMode() const { return m_debugRenderMode; }
 	void SetDebugRenderMode(DebugRenderMode dbgRenderMode) { m_debugRenderMode = dbgRenderMode; }
@@ -105,14 +174,29 @@ public:
 
 	void AllowWireFrame(bool allowed) { m_rasterizeWireFrameOfVisibleGeometryAdditive = allowed; }
 
-	stl_string GetStatus();
+	cfc::gfx_texture_streamer_stats GetTextureStreamingStats() const { return m_textureStreamer.GetStats(); }
+	void SetTextureStreamingBudget(usize budgetInBytes) { m_textureStreamer.SetBudget(budgetInBytes); }
 
 private:
-	void renderNoOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, usize viewStateGfxResourceIndex, view_state& view);
-	void renderGPUOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, usize viewStateGfxResourceIndex, usize prevViewStateGfxResourceIndex);
+	void renderNoOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, cfc::gfx_resource_handle viewStateGfxResourceIndex, const scene_visibility& visibility);
+	void renderGPUOcclusion(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, cfc::gfx_resource_handle viewStateGfxResourceIndex, cfc::gfx_resource_handle prevViewStateGfxResourceIndex);
+
+	// per frame cpu work, the graph is built once and executed on the job system every frame
+	void buildFrameGraph();
+	void cullMeshes();
+	void requestTextureMips();
+	void gatherDirectDraws();
+
+	// loading stages, see sceneLoader.cpp
+	void stageParse();
+	void stageGeometry();
+	void stageTexture();
+	void stageUpload();
+	void finalizeLoading(cfc::gfx& gfx);
+	void joinLoadingThreads();
+	void releaseLoader();
 
 	void debugRenderTexture(cfc::gfx& gfx, cfc::gfx_command_list& cmdList, usize descriptorTableSrvIndex, u32 debugIndex);
-	void setStatus(const stl_string& str);
 
 private:
 	cfc::gfx_descriptor_heap* m_opaqueRenderingDescHeap = nullptr;
@@ -145,22 +229,40 @@ private:
 	// timer query groups direct
 	stl_vector<cfc::gfx_gpu_timer_query> m_timerQueryDirectDraw;
 
-	// loading status
-	stl_mutex m_mtxStatus;
-	stl_string m_status;
+	// frame graph
+	cfc::core::threading::job_system* m_jobs = nullptr;
+	scene_counters m_counters;
+	cfc::core::threading::task_graph m_frameGraph;
+	scene_visibility* m_visibilityTarget = nullptr; // written by the frame graph nodes during UpdateVisibility
+	stl_mutex m_textureRequestLock; // the mip request ranges merge into the streamer under this lock
+	stl_vector<u32> m_directDrawBlockOffsets; // per block of the direct draw gather + 1
+
+	// staged loading
+	stl_unique_ptr<scene_loader> m_loader;
+	LoadStates m_loadState = LoadStates::Idle;
+	bool m_renderable = false;
+	stl_vector<u8> m_meshResident; // per mesh, written by the render thread as uploads arrive
 
 	// visual fidelity resources
+	// NOTE: every instance of a model shares the vertex and index buffers of the model's meshes, the source buffers own them
+	stl_vector<vertex_buffer> m_sourceVertexBuffers;
+	stl_vector<index_buffer> m_sourceIndexBuffers;
 	u32 m_maxNumMeshesToRender = 0;
 	stl_vector<vertex_buffer> m_vertexBuffers;
 	stl_vector<index_buffer> m_indexBuffers;
 	stl_vector<mat4_simple> m_modelMatrices;
-	usize m_modelMatricesGFXResourceIndex = cfc::invalid_index;
+	cfc::gfx_resource_handle m_modelMatricesGFXResourceIndex;
 	stl_vector<u32> m_materialIds;
 	stl_vector<material> m_materials;
-	stl_vector<usize> m_albedoTextureGFXResourceIndex;
+	stl_vector<cfc::gfx_resource_handle> m_albedoTextureGFXResourceIndex;
 	material m_defaultMaterial;
 
-	stl_vector<usize> m_opaqueIndirectCmdListRef;
+	// texture streaming
+	cfc::gfx_texture_streamer m_textureStreamer;
+	stl_vector<usize> m_materialStreamedTexture;
+	stl_vector<f32> m_uvDensities; // uv units per world unit, per mesh
+
+	stl_vector<cfc::gfx_resource_handle> m_opaqueIndirectCmdListRef;
 	stl_vector<append_buffer> m_opaqueIndirectCmdListAppend;
 	stl_vector<usize> m_opaqueIndirectCmdListAppendDescTableOffset;
 
@@ -170,14 +272,15 @@ private:
 	occlusionDepthRT m_occlusionDepthBufferQuarterRes;
 	stl_vector<aabb> m_aabbs;
 	stl_vector<aabb> m_final_aabbs;
+	stl_vector<f32> m_cullBounds[6]; // m_final_aabbs as an array per component (min xyz, max xyz) for the batch frustum cull
 	vertex_buffer m_aabbVertexBuffer;
 	index_buffer m_aabbIndexBuffer;
 	stl_vector<mat4_simple> m_aabbTransScaleMatrices; // can be optimized by only sending position and scale
-	usize m_aabbTransScaleMatricesGFXResourceIndex = cfc::invalid_index;
-	stl_vector<usize> m_visibilityBufferGFXResourceIndex;
+	cfc::gfx_resource_handle m_aabbTransScaleMatricesGFXResourceIndex;
+	stl_vector<cfc::gfx_resource_handle> m_visibilityBufferGFXResourceIndex;
 
 	// debug
-	usize m_debugRT = cfc::invalid_index;
+	cfc::gfx_render_target_handle m_debugRT;
 	DebugRenderMode m_debugRenderMode = DebugRenderMode::NoDebugRender;
 	bool m_enableNvidiaVertexShaderTrick = false;
 	bool m_enableReprojectedDownSample = true;
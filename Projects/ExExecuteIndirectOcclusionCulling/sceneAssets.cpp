@@ -0,0 +1,129 @@
+#include "sceneAssets.h"
+
+#include <dependencies/stb/stb_image.h>
+
+#include <cfc/core/io.h>
+#include <cfc/core/hashing.h>
+#include <cfc/core/logging.h>
+#include <cfc/core/frame_allocator.h>
+
+#include <cfc/gpu/texture_mipgen.h>
+#include <cfc/gpu/texture_compress.h>
+
+#include <float.h>
+#include <istream>
+
+#define REQUEST_RGBA_4_COMPONENTS 4
+
+
+class io_stream_buffer : public std::streambuf
+{
+public:
+	explicit io_stream_buffer(cfc::iobuffer& buffer) { setg((char*)buffer.data, (char*)buffer.data, (char*)buffer.data + buffer.size); }
+};
+
+class io_material_reader : public tinyobj::MaterialReader
+{
+public:
+	io_material_reader(cfc::io& fileIO, const stl_string& basePath) : m_io(fileIO), m_basePath(basePath) {}
+
+	virtual std::string operator()(const std::string& matId, std::vector<tinyobj::material_t>& materials, std::map<std::string, size_t>& matMap)
+	{
+		// NOTE: a missing material file is not an error, like in tinyobj::MaterialFileReader
+		cfc::iobuffer file = m_io.ReadFileToMemory((m_basePath + matId).c_str());
+		if (!file)
+			return std::string();
+
+		io_stream_buffer streamBuffer(file);
+		std::istream stream(&streamBuffer);
+		return tinyobj::LoadMtl(matMap, materials, stream);
+	}
+
+private:
+	cfc::io& m_io;
+	stl_string m_basePath;
+};
+
+stl_string scene_assets::LoadObj(cfc::io& fileIO, const stl_string& path, const stl_string& basePath, stl_vector<tinyobj::shape_t>& meshesOUT, stl_vector<tinyobj::material_t>& materialsOUT)
+{
+	cfc::iobuffer file = fileIO.ReadFileToMemory(path.c_str());
+	if (!file)
+		return "Cannot open file [" + path + "]";
+
+	io_stream_buffer streamBuffer(file);
+	std::istream stream(&streamBuffer);
+	io_material_reader materialReader(fileIO, basePath);
+	return tinyobj::LoadObj(meshesOUT, materialsOUT, stream, materialReader);
+}
+
+bool scene_assets::LoadAlbedoTexture(cfc::context* const context, const stl_string& albedoTexturePath, cfc::iobuffer& sourceFile, cfc::iobuffer& cacheFile, cfc::texture_compressed_mip_chain& textureChainOUT)
+{
+	if (!sourceFile)
+		return false;
+
+	// BC1 for opaque, BC3 for textures with alpha
+	const cfc::texture_compress_settings compressSettings;
+
+	// the compressed texture cache is keyed by the hash of the source file and the encoder settings
+	const u64 cacheKey = cfc::texture_compress::GetCacheKey(context->Hash->HashU64(sourceFile.data, sourceFile.size), compressSettings);
+	const stl_string cachePath = albedoTexturePath + TEXTURE_CACHE_EXTENSION;
+
+	if (cacheFile && cfc::texture_compress::ReadCacheFromMemory(cacheFile.data, cacheFile.size, cacheKey, textureChainOUT))
+		return true;
+
+	// load albedo texture
+	i32 width, height, numComponents = 0;
+	stbi_uc* image = stbi_load_from_memory(sourceFile.data, (int)sourceFile.size, &width, &height, &numComponents, REQUEST_RGBA_4_COMPONENTS);
+	if (image == nullptr)
+		return false;
+
+	// generate mips (filtered in linear space, only supply premul alpha when texture contains alpha)
+	cfc::texture_mipgen_desc mipDesc;
+	mipDesc.PremultiplyAlpha = numComponents == REQUEST_RGBA_4_COMPONENTS;
+
+	const u32 mipLevels = cfc::texture_mipgen::GetMipLevelQuantity(width, height);
+	stl_frame_vector<u8> nimage(cfc::texture_mipgen::GetMipChainSizeInBytes(width, height, 0, mipLevels));
+	cfc::texture_mipgen::GenerateRGBA8(image, width, height, mipLevels, &nimage[0], mipDesc);
+
+	free(image);
+
+	if (cfc::texture_compress::CanCompress(width, height))
+	{
+		// NOTE: no job system, the callers already run a worker per texture
+		cfc::texture_compress::CompressMipChainRGBA8(&nimage[0], width, height, mipLevels, compressSettings, textureChainOUT);
+
+		if (!cfc::texture_compress::WriteCache(*context->IO, cachePath.c_str(), cacheKey, textureChainOUT))
+			context->Log->Logf(cfc::logflags::ScpEngine | cfc::logflags::SevWarning, "Could not write texture cache (%s).", cachePath.c_str());
+	}
+	else
+	{
+		// block compression needs multiple of 4 dimensions, stream uncompressed
+		textureChainOUT.Format = cfc::gpu_format_type::Rgba8UnormSrgb;
+		textureChainOUT.Width = width;
+		textureChainOUT.Height = height;
+		textureChainOUT.MipCount = mipLevels;
+		textureChainOUT.Data.assign(nimage.begin(), nimage.end());
+	}
+	return true;
+}
+
+void scene_assets::ComputeBounds(const stl_vector<float>& positions, aabb& boundsOUT)
+{
+	// NOTE: for the maximum we cant use FLT_MIN since FLT_MIN returns the minimum positive value!
+	float min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+	const usize numVertices = positions.size() / 3;
+	for (usize v = 0; v < numVertices; ++v)
+	{
+		const usize index = v * 3;
+		for (u32 j = 0; j < 3; ++j)
+		{
+			min[j] = min[j] < positions[index + j] ? min[j] : positions[index + j];
+			max[j] = max[j] > positions[index + j] ? max[j] : positions[index + j];
+		}
+	}
+
+	memcpy(boundsOUT.Min, min, sizeof(float) * 3);
+	memcpy(boundsOUT.Max, max, sizeof(float) * 3);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cfc/base.h>
+#include <cfc/stl/stl_vector.hpp>
+#include <cfc/stl/stl_string.hpp>
+
+#include <dependencies/stb/stb_obj_loader.h>
+
+#include "occlusion.h"
+
+namespace cfc
+{
+	// forward declare
+	struct context;
+	class io;
+	class iobuffer;
+	struct texture_compressed_mip_chain;
+};
+
+// compressed albedo textures are cached next to their source file
+#define TEXTURE_CACHE_EXTENSION ".bctex"
+
+// Asset loading shared by the scene loader and the headless app, nothing in here needs a graphics device.
+class scene_assets
+{
+public:
+	// OBJ and MTL files are read through the context io (from the content archive when there is one) and parsed from memory,
+	// returns the error of the parser (empty on success)
+	static stl_string LoadObj(cfc::io& fileIO, const stl_string& path, const stl_string& basePath, stl_vector<tinyobj::shape_t>& meshesOUT, stl_vector<tinyobj::material_t>& materialsOUT);
+
+	// uses the compressed texture cache, on a miss the source is decoded, mipmapped, compressed and written back to the cache
+	// NOTE: the uncompressed mip chain is allocated from the frame allocator of the calling thread
+	static bool LoadAlbedoTexture(cfc::context* const context, const stl_string& albedoTexturePath, cfc::iobuffer& sourceFile, cfc::iobuffer& cacheFile, cfc::texture_compressed_mip_chain& textureChainOUT);
+
+	// model space bounds of xyz positions, an empty mesh gets inverted (FLT_MAX) bounds
+	static void ComputeBounds(const stl_vector<float>& positions, aabb& boundsOUT);
+};
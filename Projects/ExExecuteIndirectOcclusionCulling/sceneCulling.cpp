@@ -0,0 +1,62 @@
+#include "sceneCulling.h"
+
+#include <cfc/math/math_simd.h>
+
+#include <dependencies/collision/libcollision.h>
+
+
+void scene_culling::CullDraws(cfc::core::threading::job_system& jobs, const cfc::math::matrix4f& viewProjection, const stl_vector<float> (&bounds)[6],
+	const u8* resident, u32 numDraws, u8* insideOUT, const scene_cull_counters& counters)
+{
+	collision::PrimFrustum frustum;
+	frustum.SetMatrix(viewProjection);
+
+	// the frustum planes for the batch test, libcollision classifies points as dot(point, normal) - D
+	cfc::math::planef planes[6];
+	for (u32 i = 0; i < 6; ++i)
+	{
+		const collision::vec3f& normal = frustum.m_Planes[i].GetNormal();
+		planes[i].a = normal.x;
+		planes[i].b = normal.y;
+		planes[i].c = normal.z;
+		planes[i].d = -frustum.m_Planes[i].GetD();
+	}
+
+	jobs.ParallelFor(0, numDraws, [&frustum, &planes, &bounds, resident, insideOUT, &counters](u32 first, u32 last)
+	{
+		// the plane tests of the whole range at once, only boxes passing them get the exact test against the frustum corners
+		cfc::math::simd::aabb_arrays rangeBounds;
+		rangeBounds.MinX = const_cast<float*>(bounds[0].data()) + first;
+		rangeBounds.MinY = const_cast<float*>(bounds[1].data()) + first;
+		rangeBounds.MinZ = const_cast<float*>(bounds[2].data()) + first;
+		rangeBounds.MaxX = const_cast<float*>(bounds[3].data()) + first;
+		rangeBounds.MaxY = const_cast<float*>(bounds[4].data()) + first;
+		rangeBounds.MaxZ = const_cast<float*>(bounds[5].data()) + first;
+		cfc::math::simd::CullAABBs(planes, 6, rangeBounds, insideOUT + first, last - first);
+
+		u32 numInFrustum = 0;
+		for (u32 i = first; i < last; ++i)
+		{
+			if (!insideOUT[i])
+				continue;
+
+			// draws still in flight in the loader are skipped
+			if (resident != nullptr && !resident[i])
+			{
+				insideOUT[i] = 0;
+				continue;
+			}
+
+			const collision::PrimAABB box(collision::vec3f(bounds[0][i], bounds[1][i], bounds[2][i]), collision::vec3f(bounds[3][i], bounds[4][i], bounds[5][i]));
+			insideOUT[i] = frustum.Test(box);
+			numInFrustum += insideOUT[i];
+		}
+
+		// one update per range, the counters are shared by every worker
+		if (counters.Registry != nullptr)
+		{
+			counters.Registry->Add(counters.ObjectsTested, last - first);
+			counters.Registry->Add(counters.ObjectsInFrustum, numInFrustum);
+		}
+	}, SCENE_CULL_GRAIN_SIZE);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cfc/base.h>
+#include <cfc/stl/stl_vector.hpp>
+#include <cfc/stl/jobsystem.h>
+#include <cfc/core/counters.h>
+#include <cfc/math/math.h>
+
+// draws per ParallelFor chunk of the frustum culling
+#define SCENE_CULL_GRAIN_SIZE 1024
+
+// counters the cull reports into, once per range (nullptr registry when the app has none)
+struct scene_cull_counters
+{
+	cfc::profiling::counter_registry* Registry = nullptr;
+	usize ObjectsTested = cfc::invalid_index;
+	usize ObjectsInFrustum = cfc::invalid_index;
+};
+
+// Frustum culling shared by the scene and the headless app, nothing in here needs a graphics device.
+class scene_culling
+{
+public:
+	// tests the world bounds of numDraws draws (SoA, min xyz followed by max xyz) against the frustum of viewProjection,
+	// insideOUT gets 1 for the draws inside it
+	// NOTE: draws with a zero in resident are never inside, resident may be nullptr when all draws are resident
+	static void CullDraws(cfc::core::threading::job_system& jobs, const cfc::math::matrix4f& viewProjection, const stl_vector<float> (&bounds)[6],
+		const u8* resident, u32 numDraws, u8* insideOUT, const scene_cull_counters& counters);
+};
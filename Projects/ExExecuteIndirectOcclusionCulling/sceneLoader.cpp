@@ -0,0 +1,963 @@
+#include "scene.h"
+#include "sceneAssets.h"
+#include "worldGenerator.h"
+
+#include <dependencies/stb/stb_obj_loader.h>
+#include <dependencies/collision/libcollision.h>
+
+#include <cfc/core/io.h>
+#include <cfc/core/hashing.h>
+#include <cfc/core/logging.h>
+#include <cfc/core/timing.h>
+#include <cfc/core/frame_allocator.h>
+#include <cfc/core/profiling.h>
+#include <cfc/core/memory_tracker.h>
+
+#include <cfc/stl/stl_string.hpp>
+#include <cfc/stl/stl_threading.hpp>
+#include <cfc/stl/stl_bounded_queue.hpp>
+#include <cfc/stl/threading.h>
+
+#include <cfc/gpu/gfx.h>
+#include <cfc/gpu/gfx_d3d12.h>
+#include <cfc/gpu/gpu_d3d12.h>
+#include <cfc/gpu/texture_compress.h>
+
+// queue capacities, the result queues limit how much decoded data can be in flight between stages
+#define LOADER_JOB_QUEUE_CAPACITY 256
+#define LOADER_GEOMETRY_QUEUE_CAPACITY 16
+#define LOADER_TEXTURE_QUEUE_CAPACITY 4
+#define LOADER_UPLOADED_QUEUE_CAPACITY 1024
+
+// meshes uploaded per resource stream flush, textures registered with the streamer per frame
+#define LOADER_UPLOAD_BATCH_SIZE 8
+#define LOADER_TEXTURE_REGISTRATIONS_PER_FRAME 4
+
+#define LOADER_HEADER_INDEX 0xFFFFFFFF
+
+// slots of the albedo texture table, albedoTextures in drawOpaquePass.hlsl
+#define LOADER_ALBEDO_DESCRIPTOR_TABLE_SIZE 26
+
+
+static const u32 g_numVerticesCube = 8;
+static const u32 g_numIndicesCube = 36;
+static const u32 g_indexBufferDataCube[] = { 0, 1, 2, 2, 1, 3,		// front face
+											 4, 0, 6, 6, 0, 2,		// left face
+											 5, 4, 7, 7, 4, 6,		// back face
+											 1, 5, 3, 3, 5, 7,		// right face
+											 4, 5, 0, 0, 5, 1,		// top face
+											 2, 3, 6, 6, 3, 7 };		// bottom face
+
+
+struct vert_pos_uv
+{
+	float X, Y, Z;
+	float U, V;
+};
+
+struct vert_pos
+{
+	float X, Y, Z;
+};
+
+struct indirectDrawOpaqueArgs
+{
+	cfc::gpu_dx12_cmdlist_indirect_api::dx12_indirect_command_descriptors::ICIndexBufferViewArgs IBV;
+	cfc::gpu_dx12_cmdlist_indirect_api::dx12_indirect_command_descriptors::ICVertexBufferViewArgs VBV;
+	u32 ModelMatrixIndex;
+	u32 AlbedoTextureDescriptorTableIdx;
+	cfc::gpu_dx12_cmdlist_indirect_api::dx12_indirect_command_descriptors::ICDrawIndexedInstancedArgs Draw;
+	u32 _padding;
+};
+
+// geometry stage -> upload stage, MeshIndex LOADER_HEADER_INDEX carries the scene wide resources
+struct scene_load_geometry
+{
+	u32 MeshIndex = LOADER_HEADER_INDEX;
+	stl_vector<vert_pos_uv> Vertices;
+	stl_vector<u32> Indices;
+	aabb LocalAABB;
+	f32 UVDensity = 0.0f;
+};
+
+// upload stage -> render thread, the per draw state is written on the render thread since the visibility jobs read it
+// for every draw, resident or not
+struct scene_load_uploaded_mesh
+{
+	u32 MeshIndex = 0;
+	aabb LocalAABB;
+	f32 UVDensity = 0.0f;
+};
+
+// io workers -> texture stage, a failed read leaves its buffer empty
+struct scene_load_texture_files
+{
+	cfc::iobuffer Source;
+	cfc::iobuffer Cache;
+	stl_atomic_int NumPendingReads{ 2 };
+};
+
+// texture stage -> render thread, an empty chain marks a texture that could not be loaded
+struct scene_load_texture
+{
+	u32 MaterialIndex = 0;
+	cfc::texture_compressed_mip_chain Chain;
+};
+
+struct scene_loader
+{
+	scene_loader() : GeometryJobs(LOADER_JOB_QUEUE_CAPACITY), TextureJobs(LOADER_JOB_QUEUE_CAPACITY), Geometry(LOADER_GEOMETRY_QUEUE_CAPACITY),
+		Textures(LOADER_TEXTURE_QUEUE_CAPACITY), UploadedMeshes(LOADER_UPLOADED_QUEUE_CAPACITY) {}
+
+	void Close()
+	{
+		GeometryJobs.Close();
+		TextureJobs.Close();
+		Geometry.Close();
+		Textures.Close();
+		UploadedMeshes.Close();
+	}
+
+	cfc::context* Context = nullptr;
+	cfc::gfx* Gfx = nullptr;
+	scene_manifest Manifest;
+
+	// parse stage output, every mesh is only touched by the geometry worker that picked it up
+	// NOTE: meshes and materials of all models are appended, the model tables below map them back
+	stl_vector<tinyobj::shape_t> Meshes;
+	stl_vector<tinyobj::material_t> Materials;
+	stl_vector<stl_string> ModelBasePaths;
+	stl_vector<u32> MaterialModels;			// per material
+	stl_vector<u32> MeshModels;				// per mesh
+	stl_vector<u32> ModelMeshBegin;			// per model + 1, first mesh of a model
+
+	// draw layout, every instance draws all meshes of its model starting at its draw base
+	// NOTE: instances are bucketed per model so a mesh upload can reach all its instances without searching
+	stl_vector<u32> ModelInstanceBegin;		// per model + 1, first entry in ModelInstances
+	stl_vector<u32> ModelInstances;			// instance indices grouped by model
+	stl_vector<u32> InstanceDrawBase;		// per instance
+
+	// parse -> geometry / texture -> upload / render thread
+	stl_bounded_queue<u32> GeometryJobs;
+	stl_bounded_queue<u32> TextureJobs;
+	stl_bounded_queue<scene_load_geometry> Geometry;
+	stl_bounded_queue<scene_load_texture> Textures;
+	stl_bounded_queue<scene_load_uploaded_mesh> UploadedMeshes;
+
+	// the source and the cache file of every material are read as one batch, a material is queued for the texture stage
+	// once both of its files arrived
+	cfc::io_batch TextureReads;
+	stl_vector<scene_load_texture_files> TextureFiles;		// per material
+
+	stl_vector<stl_thread> Threads;
+	stl_atomic_int NumRunningThreads{ 0 };
+	stl_atomic_int NumRunningGeometryWorkers{ 0 };
+	std::atomic<bool> Cancelled{ false };
+	std::atomic<bool> Renderable{ false };
+
+	// progress
+	stl_atomic_int NumMeshes{ 0 };
+	stl_atomic_int NumMeshesProcessed{ 0 };
+	stl_atomic_int NumMeshesUploaded{ 0 };
+	stl_atomic_int NumTextures{ 0 };
+	stl_atomic_int NumTexturesProcessed{ 0 };
+	stl_atomic_int NumTexturesUploaded{ 0 };
+	double StartTimeSeconds = 0.0;
+	double EndTimeSeconds = 0.0;
+};
+
+
+void generateCubePositions(vert_pos inOut[8])
+{
+	// build unit cube (size xyz=1, center xyz=0)
+	for (u32 i = 0; i < 8; ++i)
+	{
+		// generate xyz offsets by bit field exploitation
+		const float xOffset = (float)((i & 1) >> 0); // 01010101...
+		const float yOffset = (float)((i & 2) >> 1); // 00110011...
+		const float zOffset = (float)((i & 4) >> 2); // 00001111...
+
+		inOut[i].X = -0.5f + xOffset;
+		inOut[i].Y = -0.5f + yOffset;
+		inOut[i].Z = -0.5f + zOffset;
+	}
+}
+
+// average scale of the upper 3x3, converts model space uv densities to world space
+static f32 getInstanceScale(const mat4_simple& transform)
+{
+	f32 scale = 0.0f;
+	for (u32 i = 0; i < 3; ++i)
+	{
+		const f32* column = &transform.Mat[i * 4];
+		scale += sqrtf(column[0] * column[0] + column[1] * column[1] + column[2] * column[2]);
+	}
+	return scale / 3.0f;
+}
+
+
+#pragma region Loading
+scene::scene()
+{
+	buildFrameGraph();
+}
+
+scene::~scene()
+{
+	CancelLoading();
+	joinLoadingThreads();
+}
+
+void scene::LoadAsync(cfc::context* const context, cfc::gfx& gfx, const scene_manifest& manifest)
+{
+	stl_assert(m_loader == nullptr);
+	stl_assert(context->Jobs != nullptr);
+
+	// per frame work (culling, texture streaming requests) runs on the job system
+	m_jobs = context->Jobs;
+	m_counters.Register(context->Counters);
+
+	m_loader.reset(new scene_loader());
+	scene_loader& loader = *m_loader;
+	loader.Context = context;
+	loader.Gfx = &gfx;
+	loader.Manifest = manifest;
+	loader.StartTimeSeconds = context->Timing->GetTimeSeconds();
+
+	m_opaqueRenderingDescHeap = gfx.GetDescriptorHeap(gfx.AddDescriptorHeap());
+	m_depthBufferDescHeap = gfx.GetDescriptorHeap(gfx.AddDescriptorHeap());
+
+	// texture streaming, textures start with their tail mips resident
+	// NOTE: the copies of the albedo texture table start at the front of the opaque heap
+	m_textureStreamer.Init(gfx, (usize)manifest.Settings.TextureStreamingBudgetInMB * 1024 * 1024, m_opaqueRenderingDescHeap, 0, LOADER_ALBEDO_DESCRIPTOR_TABLE_SIZE);
+
+	// timer query groups indirect
+	m_timerQueryIndirectDrawFrame.resize(gfx.GetTimerQueryFrameDelayQuantity());
+	m_timerQueryClearUav.resize(gfx.GetTimerQueryFrameDelayQuantity());
+	m_timerQueryReprojectDepth.resize(gfx.GetTimerQueryFrameDelayQuantity());
+	m_timerQueryDownSampleReprojectedDepth.resize(gfx.GetTimerQueryFrameDelayQuantity());
+	m_timerQueryCopyUAVToDepth.resize(gfx.GetTimerQueryFrameDelayQuantity());
+	m_timerQueryDrawAABBs.resize(gfx.GetTimerQueryFrameDelayQuantity());
+	m_timerQueryClearAppendBufferPass.resize(gfx.GetTimerQueryFrameDelayQuantity());
+	m_timerQueryAquireVisibleObjects.resize(gfx.GetTimerQueryFrameDelayQuantity());
+	m_timerQueryIndirectDraw.resize(gfx.GetTimerQueryFrameDelayQuantity());
+
+	// timer query groups direct
+	m_timerQueryDirectDraw.resize(gfx.GetTimerQueryFrameDelayQuantity());
+
+	m_loadState = LoadStates::Loading;
+	m_renderable = false;
+
+	// one parse and one upload thread, the remaining hardware threads are split over the geometry and texture workers
+	// NOTE: texture processing is by far the most expensive stage, so it gets the larger share
+	const u32 numHardwareThreads = cfc::core::threading::thread::GetHardwareThreadCount();
+	const u32 numGeometryWorkers = numHardwareThreads >= 8 ? numHardwareThreads / 4 : 1;
+	const u32 numTextureWorkers = numHardwareThreads >= 4 ? numHardwareThreads / 2 : 1;
+
+	loader.NumRunningThreads = 2 + numGeometryWorkers + numTextureWorkers;
+	loader.NumRunningGeometryWorkers = numGeometryWorkers;
+
+	loader.Threads.push_back(stl_thread([this]() { CFC_PROFILE_THREAD_NAME("Scene Parse"); cfc::memory_tag_scope tag(cfc::memory_tag::Loader); stageParse(); m_loader->NumRunningThreads--; }));
+	loader.Threads.push_back(stl_thread([this]() { CFC_PROFILE_THREAD_NAME("Scene Upload"); cfc::memory_tag_scope tag(cfc::memory_tag::Loader); stageUpload(); m_loader->NumRunningThreads--; }));
+	for (u32 i = 0; i < numGeometryWorkers; ++i)
+		loader.Threads.push_back(stl_thread([this]() { CFC_PROFILE_THREAD_NAME("Scene Geometry"); cfc::memory_tag_scope tag(cfc::memory_tag::Geometry); stageGeometry(); m_loader->NumRunningThreads--; }));
+	for (u32 i = 0; i < numTextureWorkers; ++i)
+		loader.Threads.push_back(stl_thread([this]() { CFC_PROFILE_THREAD_NAME("Scene Texture"); cfc::memory_tag_scope tag(cfc::memory_tag::Textures); stageTexture(); m_loader->NumRunningThreads--; }));
+}
+
+void scene::CancelLoading()
+{
+	if (m_loader == nullptr)
+		return;
+
+	// stages check the flag between work items, closing the queues wakes up blocked stages
+	m_loader->Cancelled = true;
+	m_loader->Close();
+}
+
+void scene::joinLoadingThreads()
+{
+	if (m_loader == nullptr)
+		return;
+
+	for (usize i = 0; i < m_loader->Threads.size(); ++i)
+		m_loader->Threads[i].join();
+	m_loader->Threads.resize(0);
+}
+
+void scene::releaseLoader()
+{
+	CancelLoading();
+	joinLoadingThreads();
+	m_loader.reset();
+}
+
+void scene::UpdateLoading(cfc::gfx& gfx)
+{
+	if (m_loader == nullptr || m_loadState != LoadStates::Loading)
+		return;
+
+	scene_loader& loader = *m_loader;
+
+	if (loader.Renderable)
+		m_renderable = true;
+
+	// make arrived meshes visible, all instances of the model share the buffers of the mesh, only the transform differs
+	// NOTE: the bounds are written before the residency flag, the visibility jobs never run during UpdateLoading
+	scene_load_uploaded_mesh uploaded;
+	while (loader.UploadedMeshes.TryPop(uploaded))
+	{
+		const u32 meshIndex = uploaded.MeshIndex;
+		const u32 modelIndex = loader.MeshModels[meshIndex];
+		const u32 localMeshIndex = meshIndex - loader.ModelMeshBegin[modelIndex];
+		for (u32 i = loader.ModelInstanceBegin[modelIndex]; i < loader.ModelInstanceBegin[modelIndex + 1]; ++i)
+		{
+			const u32 drawIndex = loader.InstanceDrawBase[loader.ModelInstances[i]] + localMeshIndex;
+
+			m_vertexBuffers[drawIndex] = m_sourceVertexBuffers[meshIndex];
+			m_indexBuffers[drawIndex] = m_sourceIndexBuffers[meshIndex];
+
+			const f32 instanceScale = getInstanceScale(m_modelMatrices[drawIndex]);
+			m_uvDensities[drawIndex] = instanceScale > 0.0f ? uploaded.UVDensity / instanceScale : 0.0f;
+
+			m_aabbs[drawIndex] = uploaded.LocalAABB;
+			m_final_aabbs[drawIndex] = uploaded.LocalAABB;
+			collision::PrimAABB& finalAABB = (collision::PrimAABB&)m_final_aabbs[drawIndex];
+			finalAABB.Transform(finalAABB, (collision::mat44f&)m_modelMatrices[drawIndex]);
+			for (u32 j = 0; j < 3; ++j)
+			{
+				m_cullBounds[j][drawIndex] = m_final_aabbs[drawIndex].Min[j];
+				m_cullBounds[3 + j][drawIndex] = m_final_aabbs[drawIndex].Max[j];
+			}
+
+			m_meshResident[drawIndex] = 1;
+		}
+		loader.NumMeshesUploaded++;
+	}
+
+	// register processed textures, limited per frame since every registration uploads the tail mips
+	scene_load_texture texture;
+	for (u32 i = 0; i < LOADER_TEXTURE_REGISTRATIONS_PER_FRAME && loader.Textures.TryPop(texture); ++i)
+	{
+		// the streamer owns the texture resource, the descriptor table slot stays fixed (slot 0 holds the default texture)
+		// NOTE: materials past the end of the table keep the default texture
+		const u32 texDescTableIndex = texture.MaterialIndex + 1;
+		if (texture.Chain.MipCount > 0 && texDescTableIndex < LOADER_ALBEDO_DESCRIPTOR_TABLE_SIZE)
+		{
+			m_materialStreamedTexture[texture.MaterialIndex] = m_textureStreamer.AddTexture(texture.Chain.Format, texture.Chain.Width, texture.Chain.Height, texture.Chain.MipCount, std::move(texture.Chain.Data), texDescTableIndex);
+			m_materials[texture.MaterialIndex].AlbedoGFXResourceDescTableIndex = texDescTableIndex;
+		}
+		loader.NumTexturesUploaded++;
+	}
+
+	// all stages have to be done and their output applied before finalizing
+	if (loader.NumRunningThreads > 0 || loader.UploadedMeshes.Size() > 0 || loader.Textures.Size() > 0)
+		return;
+
+	joinLoadingThreads();
+
+	if (loader.Cancelled)
+	{
+		m_loadState = LoadStates::Cancelled;
+		loader.EndTimeSeconds = loader.Context->Timing->GetTimeSeconds();
+		loader.Context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevInfo, "Loading (%s) cancelled.", loader.Manifest.Name.c_str());
+		return;
+	}
+
+	finalizeLoading(gfx);
+
+	m_loadState = LoadStates::Loaded;
+	loader.EndTimeSeconds = loader.Context->Timing->GetTimeSeconds();
+	loader.Context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevInfo, "Loaded (%s) in %.2fs.", loader.Manifest.Name.c_str(), loader.EndTimeSeconds - loader.StartTimeSeconds);
+
+	// source data is no longer needed
+	stl_vector<tinyobj::shape_t>().swap(loader.Meshes);
+	stl_vector<tinyobj::material_t>().swap(loader.Materials);
+	loader.Manifest.Clear();
+}
+
+scene_load_progress scene::GetLoadProgress() const
+{
+	scene_load_progress progress;
+	if (m_loader == nullptr)
+		return progress;
+
+	const scene_loader& loader = *m_loader;
+	progress.NumMeshes = (u32)loader.NumMeshes;
+	progress.NumMeshesProcessed = (u32)loader.NumMeshesProcessed;
+	progress.NumMeshesUploaded = (u32)loader.NumMeshesUploaded;
+	progress.NumTextures = (u32)loader.NumTextures;
+	progress.NumTexturesProcessed = (u32)loader.NumTexturesProcessed;
+	progress.NumTexturesUploaded = (u32)loader.NumTexturesUploaded;
+
+	const double endTimeSeconds = loader.EndTimeSeconds > 0.0 ? loader.EndTimeSeconds : loader.Context->Timing->GetTimeSeconds();
+	progress.ElapsedSeconds = (f32)(endTimeSeconds - loader.StartTimeSeconds);
+	return progress;
+}
+#pragma endregion
+
+#pragma region Stages
+void scene::stageParse()
+{
+	CFC_PROFILE_FUNCTION();
+	scene_loader& loader = *m_loader;
+	const scene_manifest& manifest = loader.Manifest;
+	const u32 numModels = manifest.GetModelQuantity();
+	const u32 numInstances = manifest.GetInstanceQuantity();
+
+	// load meshes and materials of every model for visual fidelity
+	loader.ModelBasePaths.resize(numModels);
+	loader.ModelMeshBegin.resize(numModels + 1);
+	for (u32 m = 0; m < numModels && !loader.Cancelled; ++m)
+	{
+		const stl_string& modelFile = manifest.Models[m].File;
+
+		// get base path of obj file for material loading
+		// NOTE: + 1 append to lastIndexOfFolderDivide makes sure to include '/' character as folder divide
+		usize lastIndexOfFolderDivide = modelFile.find_last_of('/');
+		if (lastIndexOfFolderDivide != std::string::npos)
+			loader.ModelBasePaths[m] = modelFile.substr(0, lastIndexOfFolderDivide + 1);
+
+		loader.ModelMeshBegin[m] = (u32)loader.Meshes.size();
+
+		stl_vector<tinyobj::shape_t> meshes;
+		stl_vector<tinyobj::material_t> materials;
+		stl_string error;
+		if (world_generator::IsProceduralModel(modelFile.c_str()))
+		{
+			// generated meshes have no materials and draw with the default material
+			meshes.resize(1);
+			meshes[0].name = modelFile;
+			if (!world_generator::CreateProceduralMesh(modelFile.c_str(), meshes[0].mesh.positions, meshes[0].mesh.texcoords, meshes[0].mesh.indices))
+				error = "unknown procedural shape";
+		}
+		else
+		{
+			error = scene_assets::LoadObj(*loader.Context->IO, modelFile, loader.ModelBasePaths[m], meshes, materials);
+		}
+
+		if (error != "" || meshes.empty())
+		{
+			// NOTE: instances of a model that failed to load draw nothing
+			loader.Context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevError, "Could not load OBJ (%s): %s", modelFile.c_str(), error.c_str());
+			continue;
+		}
+
+		// material ids are local to the OBJ, offset them into the appended material list
+		const i32 materialOffset = (i32)loader.Materials.size();
+		for (usize i = 0; i < meshes.size(); ++i)
+		{
+			stl_vector<int>& materialIds = meshes[i].mesh.material_ids;
+			for (usize j = 0; j < materialIds.size(); ++j)
+				materialIds[j] = materialIds[j] >= 0 ? materialIds[j] + materialOffset : -1;
+		}
+
+		loader.Meshes.insert(loader.Meshes.end(), std::make_move_iterator(meshes.begin()), std::make_move_iterator(meshes.end()));
+		loader.Materials.insert(loader.Materials.end(), std::make_move_iterator(materials.begin()), std::make_move_iterator(materials.end()));
+		loader.MeshModels.resize(loader.Meshes.size(), m);
+		loader.MaterialModels.resize(loader.Materials.size(), m);
+	}
+	loader.ModelMeshBegin[numModels] = (u32)loader.Meshes.size();
+
+	if (loader.Cancelled || loader.Meshes.empty())
+	{
+		loader.Context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevError, "Scene (%s) has no meshes to draw.", manifest.Name.c_str());
+		loader.Cancelled = true;
+		loader.Close();
+		return;
+	}
+
+	const u32 numLoadedMeshes = (u32)loader.Meshes.size();
+	const u32 numMaterials = (u32)loader.Materials.size();
+
+	// bucket the instances per model (counting sort) and give every instance its range of draws
+	loader.ModelInstanceBegin.assign(numModels + 1, 0);
+	for (u32 i = 0; i < numInstances; ++i)
+		loader.ModelInstanceBegin[manifest.InstanceModels[i] + 1]++;
+	for (u32 m = 0; m < numModels; ++m)
+		loader.ModelInstanceBegin[m + 1] += loader.ModelInstanceBegin[m];
+
+	stl_vector<u32> modelInstanceCursor(loader.ModelInstanceBegin.begin(), loader.ModelInstanceBegin.end() - 1);
+	loader.ModelInstances.resize(numInstances);
+	loader.InstanceDrawBase.resize(numInstances);
+
+	u64 numDraws = 0;
+	for (u32 i = 0; i < numInstances; ++i)
+	{
+		const u32 modelIndex = manifest.InstanceModels[i];
+		loader.ModelInstances[modelInstanceCursor[modelIndex]++] = i;
+		loader.InstanceDrawBase[i] = (u32)numDraws;
+		numDraws += loader.ModelMeshBegin[modelIndex + 1] - loader.ModelMeshBegin[modelIndex];
+	}
+
+	if (numDraws == 0 || numDraws >= 0xFFFFFFFF)
+	{
+		loader.Context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevError, "Scene (%s) has an unsupported amount of draws (%llu).", manifest.Name.c_str(), numDraws);
+		loader.Cancelled = true;
+		loader.Close();
+		return;
+	}
+
+	// NOTE: everything below is sized once here, later stages only write to their own entries
+	m_maxNumMeshesToRender = (u32)numDraws;
+	m_sourceVertexBuffers.resize(numLoadedMeshes);
+	m_sourceIndexBuffers.resize(numLoadedMeshes);
+	m_vertexBuffers.resize(m_maxNumMeshesToRender);
+	m_indexBuffers.resize(m_maxNumMeshesToRender);
+	m_materialIds.resize(m_maxNumMeshesToRender);
+	m_modelMatrices.resize(m_maxNumMeshesToRender);
+	m_aabbs.resize(m_maxNumMeshesToRender);
+	m_final_aabbs.resize(m_maxNumMeshesToRender);
+	for (u32 i = 0; i < 6; ++i)
+		m_cullBounds[i].assign(m_maxNumMeshesToRender, 0.0f);
+	m_uvDensities.resize(m_maxNumMeshesToRender);
+	m_meshResident.assign(m_maxNumMeshesToRender, 0);
+
+	for (u32 i = 0; i < numInstances; ++i)
+	{
+		const u32 modelIndex = manifest.InstanceModels[i];
+		const u32 meshBegin = loader.ModelMeshBegin[modelIndex];
+		const u32 meshEnd = loader.ModelMeshBegin[modelIndex + 1];
+		for (u32 j = meshBegin; j < meshEnd; ++j)
+		{
+			const u32 drawIndex = loader.InstanceDrawBase[i] + (j - meshBegin);
+
+			// we only support the first ID at the moment, meshes without material use the default material (last entry)
+			const stl_vector<int>& materialIds = loader.Meshes[j].mesh.material_ids;
+			m_materialIds[drawIndex] = !materialIds.empty() && materialIds[0] >= 0 ? (u32)materialIds[0] : numMaterials;
+
+			m_modelMatrices[drawIndex] = manifest.InstanceTransforms[i];
+		}
+	}
+
+	// materials use the default texture (descriptor slot 0) until their own texture arrives
+	m_defaultMaterial.AlbedoGFXResourceDescTableIndex = 0;
+	m_materials.resize(numMaterials + 1);
+	m_materialStreamedTexture.assign(numMaterials + 1, cfc::invalid_index);
+	m_albedoTextureGFXResourceIndex.assign(numMaterials + 1, cfc::gfx_resource_handle());
+
+	loader.NumMeshes = numLoadedMeshes;
+	loader.NumTextures = numMaterials;
+
+	// the upload stage needs the scene wide resources before any mesh
+	loader.Geometry.Push(scene_load_geometry());
+
+	// read the texture files of all materials up front, the io workers queue the texture jobs in order of arrival
+	// NOTE: an io worker blocks while the texture job queue is full, this limits the files held in memory
+	stl_vector<stl_string> texturePaths(numMaterials * 2);
+	stl_vector<cfc::io_read_request> textureReads(numMaterials * 2);
+	for (u32 i = 0; i < numMaterials; ++i)
+	{
+		texturePaths[i * 2 + 0] = loader.ModelBasePaths[loader.MaterialModels[i]] + loader.Materials[i].diffuse_texname;
+		texturePaths[i * 2 + 1] = texturePaths[i * 2 + 0] + TEXTURE_CACHE_EXTENSION;
+		textureReads[i * 2 + 0].Path = texturePaths[i * 2 + 0].c_str();
+		textureReads[i * 2 + 1].Path = texturePaths[i * 2 + 1].c_str();
+	}
+
+	stl_vector<scene_load_texture_files>(numMaterials).swap(loader.TextureFiles);
+	loader.Context->IO->ReadAsync(textureReads.data(), textureReads.size(), loader.TextureReads, [&loader](cfc::io_read_result& result)
+	{
+		const u32 materialIndex = (u32)(result.RequestIndex / 2);
+		scene_load_texture_files& files = loader.TextureFiles[materialIndex];
+		if (result.Succeeded)
+			((result.RequestIndex & 1) == 0 ? files.Source : files.Cache) = result.Buffer;
+
+		if (--files.NumPendingReads == 0)
+			loader.TextureJobs.Push(materialIndex);
+	});
+
+	for (u32 i = 0; i < numLoadedMeshes && !loader.Cancelled; ++i)
+		loader.GeometryJobs.Push(i);
+	loader.GeometryJobs.Close();
+
+	// NOTE: the batch completes on cancel too, pushes to the closed queue return right away
+	loader.TextureReads.Wait();
+	loader.TextureJobs.Close();
+}
+
+void scene::stageGeometry()
+{
+	scene_loader& loader = *m_loader;
+
+	u32 meshIndex;
+	while (!loader.Cancelled && loader.GeometryJobs.Pop(meshIndex))
+	{
+		CFC_PROFILE_SCOPE("Scene Geometry Mesh");
+		tinyobj::mesh_t& mesh = loader.Meshes[meshIndex].mesh;
+
+		scene_load_geometry geometry;
+		geometry.MeshIndex = meshIndex;
+
+		const usize numVertices = mesh.positions.size() / 3;
+
+		// interleave vertex data (positions, uvs)
+		geometry.Vertices.resize(numVertices);
+		for (usize v = 0; v < numVertices; ++v)
+		{
+			geometry.Vertices[v].X = mesh.positions[v * 3 + 0];
+			geometry.Vertices[v].Y = mesh.positions[v * 3 + 1];
+			geometry.Vertices[v].Z = mesh.positions[v * 3 + 2];
+
+			// NOTE: V gets flipped to conform to DX UV space (bottom left 0,0)
+			geometry.Vertices[v].U = mesh.texcoords[v * 2 + 0];
+			geometry.Vertices[v].V = 1.0f - mesh.texcoords[v * 2 + 1];
+		}
+
+		// flip winding order
+		const usize numFaces = mesh.indices.size() / 3;
+		geometry.Indices = mesh.indices;
+		for (usize j = 0; j < numFaces; ++j)
+		{
+			const usize index = j * 3;
+			std::swap(geometry.Indices[index], geometry.Indices[index + 2]);
+		}
+
+		// generate aabbs
+		scene_assets::ComputeBounds(mesh.positions, geometry.LocalAABB);
+
+		// uv density (uv units per model space unit) used to derive the required texture mip from the on screen size
+		// NOTE: converted to world space per instance during upload
+		float worldArea = 0.0f;
+		float uvArea = 0.0f;
+		for (usize j = 0; j + 2 < mesh.indices.size(); j += 3)
+		{
+			const float* p0 = &mesh.positions[mesh.indices[j + 0] * 3];
+			const float* p1 = &mesh.positions[mesh.indices[j + 1] * 3];
+			const float* p2 = &mesh.positions[mesh.indices[j + 2] * 3];
+			const cfc::math::vector3f e0(p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]);
+			const cfc::math::vector3f e1(p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]);
+			worldArea += e0.Cross(e1).Length() * 0.5f;
+
+			const float* t0 = &mesh.texcoords[mesh.indices[j + 0] * 2];
+			const float* t1 = &mesh.texcoords[mesh.indices[j + 1] * 2];
+			const float* t2 = &mesh.texcoords[mesh.indices[j + 2] * 2];
+			uvArea += fabsf((t1[0] - t0[0]) * (t2[1] - t0[1]) - (t2[0] - t0[0]) * (t1[1] - t0[1])) * 0.5f;
+		}
+
+		// NOTE: degenerate meshes get a density of 0, which always requests the finest mip
+		geometry.UVDensity = worldArea > 0.0f ? sqrtf(uvArea / worldArea) : 0.0f;
+
+		// source data of this mesh is no longer needed
+		stl_vector<float>().swap(mesh.positions);
+		stl_vector<float>().swap(mesh.normals);
+		stl_vector<float>().swap(mesh.texcoords);
+		stl_vector<unsigned int>().swap(mesh.indices);
+
+		loader.NumMeshesProcessed++;
+
+		// blocks while the upload stage is behind
+		if (!loader.Geometry.Push(std::move(geometry)))
+			break;
+	}
+
+	// last worker out signals the upload stage that no more geometry follows
+	if (--loader.NumRunningGeometryWorkers == 0)
+		loader.Geometry.Close();
+}
+
+void scene::stageTexture()
+{
+	scene_loader& loader = *m_loader;
+
+	u32 materialIndex;
+	while (!loader.Cancelled && loader.TextureJobs.Pop(materialIndex))
+	{
+		CFC_PROFILE_SCOPE("Scene Texture Material");
+
+		// the uncompressed mip chain lives in the frame allocator of this thread, after the first textures it stops growing
+		cfc::frame_allocator_scope transientScope;
+
+		scene_load_texture texture;
+		texture.MaterialIndex = materialIndex;
+
+		const stl_string albedoTexturePath = loader.ModelBasePaths[loader.MaterialModels[materialIndex]] + loader.Materials[materialIndex].diffuse_texname;
+		scene_load_texture_files& files = loader.TextureFiles[materialIndex];
+		if (!scene_assets::LoadAlbedoTexture(loader.Context, albedoTexturePath, files.Source, files.Cache, texture.Chain))
+			texture.Chain = cfc::texture_compressed_mip_chain();
+
+		// the files are no longer needed once the chain exists
+		files.Source = cfc::iobuffer();
+		files.Cache = cfc::iobuffer();
+
+		loader.NumTexturesProcessed++;
+
+		// blocks while the render thread is behind registering textures
+		if (!loader.Textures.Push(std::move(texture)))
+			break;
+	}
+}
+
+void scene::stageUpload()
+{
+	CFC_PROFILE_FUNCTION();
+	scene_loader& loader = *m_loader;
+	cfc::context* const context = loader.Context;
+	cfc::gfx& gfx = *loader.Gfx;
+
+	char resourceNameBuffer[128];
+
+	// DX12 INTEROP
+	cfc::gfx_dx12& dx12Gfx = static_cast<cfc::gfx_dx12&>(gfx);
+	cfc::gpu_dx12_context& dx12Context = *reinterpret_cast<cfc::gpu_dx12_context*>(dx12Gfx.DX12_GetContext());
+
+	// load render passes, shaders compile while the OBJ is being parsed
+	// NOTE: not cancellable, Unload relies on the passes being loaded
+	const scene_pass_settings& settings = loader.Manifest.Settings;
+	m_downSampleReprojectedDepthBufferCmp.Load(context, gfx, settings.DownSampleReprojectedDepthThreads[0], settings.DownSampleReprojectedDepthThreads[1]);
+	m_reprojectDepthBufferCmp.Load(context, gfx, settings.ReprojectDepthThreads[0], settings.ReprojectDepthThreads[1]);
+	m_copyReprojectDepthBuffer.Load(context, gfx);
+	m_renderVisibilityGfx.Load(context, gfx);
+	m_collectVisibleDrawCallsCmp.Load(context, gfx, settings.CollectVisibleDrawCallsThreads);
+	m_collectVisibleDrawCallsCmpLowOverhead.Load(context, gfx);
+	m_renderOpaqueGfx.Load(context, gfx);
+	m_debugFullScreenTexQuad.Load(context, gfx);
+	m_debugOpaqueWireFrameGfx.Load(context, gfx);
+
+	cfc::gfx_resource_stream* gfxResourceStream = gfx.GetResourceStream(gfx.AddResourceStream());
+
+	stl_vector<scene_load_uploaded_mesh> batch;
+	auto publishBatch = [&]()
+	{
+		if (batch.empty())
+			return;
+
+		CFC_PROFILE_SCOPE("Scene Upload Flush");
+
+		// the flush submits to the same queue as the frames, frames recorded after this are ordered behind the copies
+		gfxResourceStream->Flush();
+		for (usize i = 0; i < batch.size(); ++i)
+			loader.UploadedMeshes.Push(batch[i]);
+		batch.resize(0);
+	};
+
+	scene_load_geometry geometry;
+	for (;;)
+	{
+		// publish what is uploaded so far before blocking on the geometry stage
+		if (!loader.Geometry.TryPop(geometry))
+		{
+			publishBatch();
+			if (!loader.Geometry.Pop(geometry))
+				break;
+		}
+
+		if (loader.Cancelled)
+			break;
+
+		if (geometry.MeshIndex == LOADER_HEADER_INDEX)
+		{
+			m_modelMatricesGFXResourceIndex = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::SRVBuffer, &m_modelMatrices[0], sizeof(mat4_simple) * m_maxNumMeshesToRender);
+			dx12Context.ResourceSetName(dx12Gfx.DX12_GetResourceIdx(m_modelMatricesGFXResourceIndex), "m_modelMatricesGFXResourceIndex");
+
+			// generate default texture
+			const u32 whiteTextureDataRGBA[4]{ 0xFF00FFFF, 0xFF00FFFF, 0xFF00FFFF, 0xFF00FFFF };
+			const u32 texDescTableIndexDefault = m_defaultMaterial.AlbedoGFXResourceDescTableIndex;
+			m_albedoTextureGFXResourceIndex[texDescTableIndexDefault] = gfxResourceStream->AddTexture(cfc::gfx_texture_creation_desc(&whiteTextureDataRGBA, cfc::gpu_format_type::Rgba8UnormSrgb, 2, 2));
+			for (u32 i = 0; i < m_textureStreamer.GetDescriptorTableCopyQuantity(); ++i)
+				m_opaqueRenderingDescHeap->SetSRVTexture(m_textureStreamer.GetDescriptorTableCopy(i) + texDescTableIndexDefault, m_albedoTextureGFXResourceIndex[texDescTableIndexDefault]);
+
+			dx12Context.ResourceSetName(dx12Gfx.DX12_GetResourceIdx(m_albedoTextureGFXResourceIndex[texDescTableIndexDefault]), "default texture");
+
+			gfxResourceStream->Flush();
+
+			loader.Renderable = true;
+			continue;
+		}
+
+		const u32 meshIndex = geometry.MeshIndex;
+
+		vertex_buffer vertexBuffer;
+		vertexBuffer.SizeInBytes = (u32)(geometry.Vertices.size() * sizeof(vert_pos_uv));
+		vertexBuffer.StrideInBytes = sizeof(vert_pos_uv);
+		vertexBuffer.GFXResourceIndex = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::VertexBuffer, &geometry.Vertices[0], vertexBuffer.SizeInBytes);
+
+		sprintf(resourceNameBuffer, "m_vertexBuffers[%d]", meshIndex);
+		dx12Context.ResourceSetName(dx12Gfx.DX12_GetResourceIdx(vertexBuffer.GFXResourceIndex), resourceNameBuffer);
+
+		index_buffer indexBuffer;
+		indexBuffer.NumIndices = (u32)geometry.Indices.size();
+		indexBuffer.SizeInBytes = indexBuffer.NumIndices * sizeof(u32);
+		indexBuffer.GFXResourceIndex = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::IndexBuffer, &geometry.Indices[0], indexBuffer.SizeInBytes);
+
+		sprintf(resourceNameBuffer, "m_indexBuffers[%d]", meshIndex);
+		dx12Context.ResourceSetName(dx12Gfx.DX12_GetResourceIdx(indexBuffer.GFXResourceIndex), resourceNameBuffer);
+
+		// the per draw state of the instances is written by the render thread once the mesh is published
+		m_sourceVertexBuffers[meshIndex] = vertexBuffer;
+		m_sourceIndexBuffers[meshIndex] = indexBuffer;
+
+		scene_load_uploaded_mesh uploaded;
+		uploaded.MeshIndex = meshIndex;
+		uploaded.LocalAABB = geometry.LocalAABB;
+		uploaded.UVDensity = geometry.UVDensity;
+		batch.push_back(uploaded);
+		if (batch.size() >= LOADER_UPLOAD_BATCH_SIZE)
+			publishBatch();
+	}
+	publishBatch();
+
+	gfxResourceStream->WaitForFinish();
+
+	gfx.RemoveResourceStream(gfxResourceStream->GetHandle());
+}
+
+void scene::finalizeLoading(cfc::gfx& gfx)
+{
+	cfc::gfx_resource_stream* gfxResourceStream = gfx.GetResourceStream(gfx.AddResourceStream());
+
+	char resourceNameBuffer[128];
+
+	// DX12 INTEROP
+	cfc::gfx_dx12& dx12Gfx = static_cast<cfc::gfx_dx12&>(gfx);
+	cfc::gpu_dx12_context& dx12Context = *reinterpret_cast<cfc::gpu_dx12_context*>(dx12Gfx.DX12_GetContext());
+
+	// generate visibility mesh (aabb)
+	vert_pos visibilityAABBMeshVerts[g_numVerticesCube];
+	generateCubePositions(visibilityAABBMeshVerts);
+
+	m_aabbVertexBuffer.SizeInBytes = sizeof(vert_pos) * g_numVerticesCube;
+	m_aabbVertexBuffer.StrideInBytes = sizeof(vert_pos);
+	m_aabbVertexBuffer.GFXResourceIndex = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::VertexBuffer, visibilityAABBMeshVerts, m_aabbVertexBuffer.SizeInBytes);
+
+	dx12Context.ResourceSetName(dx12Gfx.DX12_GetResourceIdx(m_aabbVertexBuffer.GFXResourceIndex), "m_aabbVertexBuffer");
+
+	m_aabbIndexBuffer.NumIndices = g_numIndicesCube;
+	m_aabbIndexBuffer.SizeInBytes = g_numIndicesCube * sizeof(u32);
+	m_aabbIndexBuffer.GFXResourceIndex = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::IndexBuffer, g_indexBufferDataCube, m_aabbIndexBuffer.SizeInBytes);
+
+	dx12Context.ResourceSetName(dx12Gfx.DX12_GetResourceIdx(m_aabbIndexBuffer.GFXResourceIndex), "m_aabbIndexBuffer");
+
+	// generate aabb transform matrices
+	m_aabbTransScaleMatrices.resize(m_aabbs.size());
+	for (u32 i = 0; i < m_aabbs.size(); ++i)
+	{
+		for (u32 j = 0; j < 3; ++j)
+		{
+			// calculate scale
+			float scale = m_aabbs[i].Max[j] - m_aabbs[i].Min[j];
+			m_aabbTransScaleMatrices[i].Mat[j * 5] = scale;
+
+			// calculate center position
+			m_aabbTransScaleMatrices[i].Mat[12 + j] = m_aabbs[i].Min[j] + scale * 0.5f;
+		}
+		m_aabbTransScaleMatrices[i].Mat[15] = 1.0f;
+	}
+	m_aabbTransScaleMatricesGFXResourceIndex = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::SRVBuffer, &m_aabbTransScaleMatrices[0], sizeof(mat4_simple) * m_aabbTransScaleMatrices.size());
+
+	dx12Context.ResourceSetName(dx12Gfx.DX12_GetResourceIdx(m_aabbTransScaleMatricesGFXResourceIndex), "m_aabbTransScaleMatrices");
+
+	// create visibility UAV
+	stl_vector<u32> visibilityBuffer(m_aabbs.size());
+	m_visibilityBufferGFXResourceIndex.resize(gfx.GetBackbufferFrameQuantity());
+	for (u32 i = 0; i < gfx.GetBackbufferFrameQuantity(); ++i)
+	{
+		m_visibilityBufferGFXResourceIndex[i] = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::UAVBuffer, &visibilityBuffer[0], sizeof(u32) * visibilityBuffer.size());
+
+		sprintf(resourceNameBuffer, "m_visibilityBufferGFXResourceIndex[%d]", i);
+		dx12Context.ResourceSetName(dx12Gfx.DX12_GetResourceIdx(m_visibilityBufferGFXResourceIndex[i]), resourceNameBuffer);
+	}
+
+	gfxResourceStream->Flush();
+
+	// DX12 INTEROP
+	usize rootSignatureIdx = dx12Gfx.DX12_GetRootSignatureIdxFromProgram(m_renderOpaqueGfx.GetShaderProgram());
+
+	m_opaqueIndirectCmdList = new cfc::gpu_dx12_cmdlist_indirect_api(dx12Context);
+	m_opaqueIndirectCmdList->ICIASetIndexBuffer();
+	m_opaqueIndirectCmdList->ICIASetVertexBuffers(0, 1);
+	m_opaqueIndirectCmdList->ICSetRoot32BitConstants(2, 2, 0);
+	m_opaqueIndirectCmdList->ICDrawIndexedInstanced();
+
+	// note since we are using RootConstants in the indirect command list, we need to set a root signature.
+	bool indirectTemplateCompiled = m_opaqueIndirectCmdList->CompileIC(rootSignatureIdx);
+
+	// create indirect draw commands for opaque pass
+	m_opaqueIndirectCmdListRef.resize(gfx.GetBackbufferFrameQuantity());
+	m_opaqueIndirectCmdListAppend.resize(gfx.GetBackbufferFrameQuantity());
+
+	stl_vector<indirectDrawOpaqueArgs> indirectDrawOpaque;
+	indirectDrawOpaque.resize(m_maxNumMeshesToRender);
+	for (u32 i = 0; i < m_maxNumMeshesToRender; ++i)
+	{
+		indirectDrawOpaque[i].IBV.BufferLocation = dx12Context.ResourceGetGPUAddress(dx12Gfx.DX12_GetResourceIdx(m_indexBuffers[i].GFXResourceIndex));
+		indirectDrawOpaque[i].IBV.SizeInBytes = m_indexBuffers[i].SizeInBytes;
+		indirectDrawOpaque[i].IBV.Format = (u32)cfc::gpu_format_type::R32Uint;
+
+		indirectDrawOpaque[i].VBV.BufferLocation = dx12Context.ResourceGetGPUAddress(dx12Gfx.DX12_GetResourceIdx(m_vertexBuffers[i].GFXResourceIndex));
+		indirectDrawOpaque[i].VBV.SizeInBytes = m_vertexBuffers[i].SizeInBytes;
+		indirectDrawOpaque[i].VBV.StrideInBytes = m_vertexBuffers[i].StrideInBytes;
+
+		indirectDrawOpaque[i].ModelMatrixIndex = i;
+		indirectDrawOpaque[i].AlbedoTextureDescriptorTableIdx = m_materials[m_materialIds[i]].AlbedoGFXResourceDescTableIndex;
+
+		indirectDrawOpaque[i].Draw.IndexCountPerInstance = m_indexBuffers[i].NumIndices;
+		indirectDrawOpaque[i].Draw.InstanceCount = 1;
+		indirectDrawOpaque[i].Draw.BaseVertexLocation = 0;
+		indirectDrawOpaque[i].Draw.StartIndexLocation = 0;
+		indirectDrawOpaque[i].Draw.StartInstanceLocation = 0;
+	}
+
+	m_opaqueIndirectCmdListAppendDescTableOffset.resize(gfx.GetBackbufferFrameQuantity());
+	for (u32 i = 0; i < gfx.GetBackbufferFrameQuantity(); ++i)
+	{
+		m_opaqueIndirectCmdListRef[i] = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::SRVBuffer, &indirectDrawOpaque[0], sizeof(indirectDrawOpaqueArgs) * indirectDrawOpaque.size());
+
+		// note that we add a u32 for the append buffer count
+		m_opaqueIndirectCmdListAppend[i].CounterOffsetInBytes = (u32)(sizeof(indirectDrawOpaqueArgs) * indirectDrawOpaque.size());
+		m_opaqueIndirectCmdListAppend[i].CounterOffsetInBytes = ((m_opaqueIndirectCmdListAppend[i].CounterOffsetInBytes + 4095) / 4096) * 4096;
+		m_opaqueIndirectCmdListAppend[i].AppendBufferGFXResourceIndex = gfxResourceStream->AddDynamicResource(cfc::gfx_resource_type::UAVBuffer, m_opaqueIndirectCmdListAppend[i].CounterOffsetInBytes + sizeof(u32), false);
+		gfxResourceStream->UpdateDynamicResource(m_opaqueIndirectCmdListAppend[i].AppendBufferGFXResourceIndex, sizeof(indirectDrawOpaqueArgs) * indirectDrawOpaque.size(), &indirectDrawOpaque[0]);
+
+		m_opaqueIndirectCmdListAppendDescTableOffset[i] = m_textureStreamer.GetDescriptorTableEnd() + i;
+
+		m_opaqueRenderingDescHeap->SetUAVBuffer(m_opaqueIndirectCmdListAppendDescTableOffset[i], m_opaqueIndirectCmdListAppend[i].AppendBufferGFXResourceIndex, sizeof(indirectDrawOpaqueArgs), 0, m_maxNumMeshesToRender, m_opaqueIndirectCmdListAppend[i].CounterOffsetInBytes, m_opaqueIndirectCmdListAppend[i].AppendBufferGFXResourceIndex);
+
+		sprintf(resourceNameBuffer, "m_opaqueIndirectCmdListRef[%d]", i);
+		dx12Context.ResourceSetName(dx12Gfx.DX12_GetResourceIdx(m_opaqueIndirectCmdListRef[i]), resourceNameBuffer);
+
+		sprintf(resourceNameBuffer, "m_opaqueIndirectCmdListAppend[%d]", i);
+		dx12Context.ResourceSetName(dx12Gfx.DX12_GetResourceIdx(m_opaqueIndirectCmdListAppend[i].AppendBufferGFXResourceIndex), resourceNameBuffer);
+	}
+
+	u32 zero[] = { 0,0,0,0 };
+	m_opaqueIndirectCmdListAppend[0].AppendBufferCounterResetGfxResourceIndex = gfxResourceStream->AddStaticResource(cfc::gfx_resource_type::CopySource, &zero, sizeof(zero));
+	m_opaqueIndirectCmdListAppend[1].AppendBufferCounterResetGfxResourceIndex = m_opaqueIndirectCmdListAppend[0].AppendBufferCounterResetGfxResourceIndex;
+
+	dx12Context.ResourceSetName(dx12Gfx.DX12_GetResourceIdx(m_opaqueIndirectCmdListAppend[0].AppendBufferCounterResetGfxResourceIndex), "m_opaqueIndirectCmdListAppendCounterResetBuffer");
+
+	m_debugRT = gfx.AddRenderTarget2D(gfx.GetBackbufferWidth(), gfx.GetBackbufferHeight(), cfc::gpu_format_type::Rgba8UnormSrgb);
+	dx12Context.ResourceSetName(dx12Gfx.DX12_GetResourceIdx(gfx.GetRenderTargetResource(m_debugRT)), "m_debugRT");
+
+	gfxResourceStream->Flush();
+
+	u32* tmpDepthBufferFill = new u32[gfx.GetBackbufferWidth() * gfx.GetBackbufferHeight()];
+
+	memset(tmpDepthBufferFill, 0xFF, sizeof(u32) * gfx.GetBackbufferWidth() * gfx.GetBackbufferHeight());
+	m_occlusionDepthBufferHalfRes.Width = gfx.GetBackbufferWidth() / HALF_SCREEN_DIV;
+	m_occlusionDepthBufferHalfRes.Height = gfx.GetBackbufferHeight() / HALF_SCREEN_DIV;
+	m_occlusionDepthBufferHalfRes.UAVRTResource = gfxResourceStream->AddTexture(cfc::gfx_texture_creation_desc(tmpDepthBufferFill, cfc::gpu_format_type::R32Typeless, (i32)m_occlusionDepthBufferHalfRes.Width, (i32)m_occlusionDepthBufferHalfRes.Height, 1, 1, true));
+	dx12Context.ResourceSetName(dx12Gfx.DX12_GetResourceIdx(m_occlusionDepthBufferHalfRes.UAVRTResource), "m_occlusionDepthBufferHalfRes");
+
+	gfxResourceStream->Flush();
+
+	m_occlusionDepthBufferQuarterRes.Width = gfx.GetBackbufferWidth() / QUART_SCREEN_DIV;
+	m_occlusionDepthBufferQuarterRes.Height = gfx.GetBackbufferHeight() / QUART_SCREEN_DIV;
+	m_occlusionDepthBufferQuarterRes.UAVRTResource = gfxResourceStream->AddTexture(cfc::gfx_texture_creation_desc(tmpDepthBufferFill, cfc::gpu_format_type::R32Typeless, (i32)m_occlusionDepthBufferQuarterRes.Width, (i32)m_occlusionDepthBufferQuarterRes.Height, 1, 1, true));
+	dx12Context.ResourceSetName(dx12Gfx.DX12_GetResourceIdx(m_occlusionDepthBufferQuarterRes.UAVRTResource), "m_occlusionDepthBufferQuarterRes");
+
+	delete[] tmpDepthBufferFill;
+
+	m_depthBufferDescHeap->SetSRVTexture(0, gfx.GetBackbufferDSResource(), cfc::gpu_format_type::R24UnormX8Typeless);
+	m_depthBufferDescHeap->SetUAVTexture(1, m_occlusionDepthBufferHalfRes.UAVRTResource, cfc::gpu_format_type::R32Uint);
+	m_depthBufferDescHeap->SetSRVTexture(2, m_occlusionDepthBufferHalfRes.UAVRTResource, cfc::gpu_format_type::R32Float);
+	m_depthBufferDescHeap->SetUAVTexture(3, m_occlusionDepthBufferQuarterRes.UAVRTResource, cfc::gpu_format_type::R32Float);
+	m_depthBufferDescHeap->SetSRVTexture(4, m_occlusionDepthBufferQuarterRes.UAVRTResource, cfc::gpu_format_type::R32Float);
+	m_depthBufferDescHeap->SetSRVTexture(5, gfx.GetRenderTargetResource(m_debugRT), cfc::gpu_format_type::Rgba8UnormSrgb);
+
+	gfxResourceStream->Flush();
+
+	gfxResourceStream->WaitForFinish();
+
+	gfx.RemoveResourceStream(gfxResourceStream->GetHandle());
+}
+#pragma endregion
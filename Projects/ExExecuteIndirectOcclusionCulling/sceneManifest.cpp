@@ -0,0 +1,392 @@
+#include "sceneManifest.h"
+#include "worldGenerator.h"
+
+#include <dependencies/gason/gason.h>
+
+#include <cfc/core/context.h>
+#include <cfc/core/io.h>
+#include <cfc/core/logging.h>
+#include <cfc/math/math.h>
+
+#include <string.h>
+
+#define MANIFEST_DEG_TO_RAD (3.14159265358979f / 180.0f)
+
+// instances along one axis of a grid, the total of all instances is limited to below 0xFFFFFFFF as well
+#define MANIFEST_MAX_GRID_COUNT (1 << 20)
+
+
+#pragma region Helpers
+static gason::JsonValue findMember(gason::JsonValue object, const char* key)
+{
+	if (object.getTag() != gason::JSON_OBJECT)
+		return gason::JsonValue();
+
+	for (auto member : object)
+	{
+		if (strcmp(member->key, key) == 0)
+			return member->value;
+	}
+	return gason::JsonValue();
+}
+
+static f32 readNumber(gason::JsonValue value, f32 defaultValue)
+{
+	return value.getTag() == gason::JSON_NUMBER ? (f32)value.toNumber() : defaultValue;
+}
+
+// integer fields are read as double, f32 is exact up to 2^24 only. Returns false when the value is there but is not an
+// integer in [0, maxValue], out keeps defaultValue when the value is missing.
+static bool readUInt(gason::JsonValue value, u32 defaultValue, u32 maxValue, u32& out)
+{
+	out = defaultValue;
+	if (value.getTag() != gason::JSON_NUMBER)
+		return value.getTag() == gason::JSON_NULL;
+
+	const double number = value.toNumber();
+	if (!(number >= 0.0 && number <= (double)maxValue) || number != (double)(u64)number)
+		return false;
+	out = (u32)number;
+	return true;
+}
+
+static bool readBool(gason::JsonValue value, bool defaultValue)
+{
+	if (value.getTag() == gason::JSON_TRUE)
+		return true;
+	if (value.getTag() == gason::JSON_FALSE)
+		return false;
+	return defaultValue;
+}
+
+// reads [x, y, z], a single number is used for all components
+static void readVector(gason::JsonValue value, f32 defaultValue, f32 out[3])
+{
+	out[0] = out[1] = out[2] = readNumber(value, defaultValue);
+	if (value.getTag() != gason::JSON_ARRAY)
+		return;
+
+	u32 i = 0;
+	for (auto element : value)
+	{
+		if (i >= 3)
+			break;
+		out[i++] = readNumber(element->value, defaultValue);
+	}
+}
+
+// models are referenced by name or by index
+static u32 resolveModel(gason::JsonValue value, const stl_vector<scene_manifest_model>& models)
+{
+	if (value.getTag() == gason::JSON_NUMBER)
+	{
+		const double index = value.toNumber();
+		return index >= 0.0 && index < (double)models.size() ? (u32)index : (u32)cfc::invalid_index;
+	}
+
+	if (value.getTag() == gason::JSON_STRING)
+	{
+		const char* name = value.toString();
+		for (usize i = 0; i < models.size(); ++i)
+		{
+			if (models[i].Name == name)
+				return (u32)i;
+		}
+	}
+	return (u32)cfc::invalid_index;
+}
+
+static void buildTransform(const f32 position[3], const f32 rotationInDegrees[3], const f32 scale[3], mat4_simple& out)
+{
+	cfc::math::matrix4f transform;
+	transform.Translate3(position[0], position[1], position[2]);
+	if (rotationInDegrees[0] != 0.0f || rotationInDegrees[1] != 0.0f || rotationInDegrees[2] != 0.0f)
+		transform.RotateEuler(rotationInDegrees[0] * MANIFEST_DEG_TO_RAD, rotationInDegrees[1] * MANIFEST_DEG_TO_RAD, rotationInDegrees[2] * MANIFEST_DEG_TO_RAD);
+	transform.Scale3(scale[0], scale[1], scale[2]);
+	memcpy(out.Mat, &transform.MM[0][0], sizeof(mat4_simple));
+}
+
+// count is a number for all axes or [x, y, z], returns false when a count is not an integer in [0, MANIFEST_MAX_GRID_COUNT]
+static bool readGridCount(gason::JsonValue grid, u32 countOUT[3])
+{
+	const gason::JsonValue count = findMember(grid, "count");
+	if (count.getTag() != gason::JSON_ARRAY)
+	{
+		if (!readUInt(count, 1, MANIFEST_MAX_GRID_COUNT, countOUT[0]))
+			return false;
+		countOUT[1] = countOUT[2] = countOUT[0];
+		return true;
+	}
+
+	countOUT[0] = countOUT[1] = countOUT[2] = 1;
+	u32 i = 0;
+	for (auto element : count)
+	{
+		if (i >= 3)
+			break;
+		if (!readUInt(element->value, 1, MANIFEST_MAX_GRID_COUNT, countOUT[i++]))
+			return false;
+	}
+	return true;
+}
+#pragma endregion
+
+#pragma region scene_manifest
+bool scene_manifest::LoadFromFile(cfc::context* const context, const char* file)
+{
+	cfc::iobuffer buffer = context->IO->ReadFileToMemory(file);
+	if (!buffer)
+	{
+		context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevError, "Could not read scene manifest (%s).", file);
+		return false;
+	}
+
+	// gason parses in place and expects a zero terminated string
+	stl_vector<char> json(buffer.size + 1);
+	memcpy(&json[0], buffer.data, buffer.size);
+	json[buffer.size] = '\0';
+
+	return LoadFromMemory(context, &json[0], file);
+}
+
+bool scene_manifest::LoadFromMemory(cfc::context* const context, char* json, const char* name)
+{
+	Clear();
+	Name = name;
+
+	// NOTE: the DOM lives in gason's zone allocator, a handful of allocations for the whole document
+	gason::JsonAllocator allocator;
+	gason::JsonValue root;
+	char* endPtr = nullptr;
+	const int status = gason::jsonParse(json, &endPtr, &root, allocator);
+	if (status != gason::JSON_OK || root.getTag() != gason::JSON_OBJECT)
+	{
+		context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevError, "Could not parse scene manifest (%s): %s at offset %d.", name, gason::jsonStrError(status), (i32)(endPtr - json));
+		return false;
+	}
+
+	// models
+	const gason::JsonValue models = findMember(root, "models");
+	if (models.getTag() == gason::JSON_ARRAY)
+	{
+		for (auto model : models)
+		{
+			const gason::JsonValue file = findMember(model->value, "file");
+			if (file.getTag() != gason::JSON_STRING)
+			{
+				context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevWarning, "Scene manifest (%s): model without file skipped.", name);
+				continue;
+			}
+
+			const gason::JsonValue modelName = findMember(model->value, "name");
+			scene_manifest_model entry;
+			entry.File = file.toString();
+			entry.Name = modelName.getTag() == gason::JSON_STRING ? modelName.toString() : entry.File;
+			Models.push_back(entry);
+		}
+	}
+
+	// procedural world, read up front as its instances count towards the limit below
+	const gason::JsonValue generator = findMember(root, "generator");
+	world_generator_desc desc;
+	if (generator.getTag() == gason::JSON_OBJECT)
+	{
+		const bool validIntegers =
+			readUInt(findMember(generator, "seed"), desc.Seed, 0xFFFFFFFF, desc.Seed) &&
+			readUInt(findMember(generator, "instances"), desc.NumInstances, 0xFFFFFFFE, desc.NumInstances) &&
+			readUInt(findMember(generator, "instancesPerBlock"), desc.InstancesPerBlock, 0xFFFFFFFF, desc.InstancesPerBlock) &&
+			readUInt(findMember(generator, "depthComplexity"), desc.DepthComplexity, 0xFFFFFFFF, desc.DepthComplexity);
+		if (!validIntegers)
+		{
+			context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevError, "Scene manifest (%s): generator fields seed, instances, instancesPerBlock and depthComplexity have to be unsigned integers.", name);
+			Clear();
+			return false;
+		}
+		desc.OccluderRatio = readNumber(findMember(generator, "occluderRatio"), desc.OccluderRatio);
+		desc.BlockSize = readNumber(findMember(generator, "blockSize"), desc.BlockSize);
+		desc.StreetWidth = readNumber(findMember(generator, "streetWidth"), desc.StreetWidth);
+		desc.MinBuildingHeight = readNumber(findMember(generator, "minBuildingHeight"), desc.MinBuildingHeight);
+		desc.MaxBuildingHeight = readNumber(findMember(generator, "maxBuildingHeight"), desc.MaxBuildingHeight);
+		desc.MinPropSize = readNumber(findMember(generator, "minPropSize"), desc.MinPropSize);
+		desc.MaxPropSize = readNumber(findMember(generator, "maxPropSize"), desc.MaxPropSize);
+		desc.NoiseFrequency = readNumber(findMember(generator, "noiseFrequency"), desc.NoiseFrequency);
+	}
+
+	// count instances first so the instance arrays are allocated once
+	// NOTE: every term is below 2^61 and the total is checked after each, the sum can not wrap
+	const gason::JsonValue instances = findMember(root, "instances");
+	const gason::JsonValue grids = findMember(root, "grids");
+	u64 numInstances = generator.getTag() == gason::JSON_OBJECT ? desc.NumInstances : 0;
+	if (instances.getTag() == gason::JSON_ARRAY)
+	{
+		for (auto instance : instances)
+			numInstances += resolveModel(findMember(instance->value, "model"), Models) != (u32)cfc::invalid_index ? 1 : 0;
+	}
+	if (grids.getTag() == gason::JSON_ARRAY)
+	{
+		for (auto grid : grids)
+		{
+			u32 count[3];
+			if (!readGridCount(grid->value, count))
+			{
+				context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevError, "Scene manifest (%s): grid counts have to be integers from 0 to %d.", name, MANIFEST_MAX_GRID_COUNT);
+				Clear();
+				return false;
+			}
+			if (resolveModel(findMember(grid->value, "model"), Models) != (u32)cfc::invalid_index)
+				numInstances += (u64)count[0] * (u64)count[1] * (u64)count[2];
+			if (numInstances >= 0xFFFFFFFF)
+				break;
+		}
+	}
+
+	if (numInstances >= 0xFFFFFFFF)
+	{
+		context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevError, "Scene manifest (%s) describes too many instances.", name);
+		Clear();
+		return false;
+	}
+
+	const usize numListedInstances = (usize)(numInstances - (generator.getTag() == gason::JSON_OBJECT ? desc.NumInstances : 0));
+	InstanceModels.resize(numListedInstances);
+	InstanceTransforms.resize(numListedInstances);
+	usize instanceIndex = 0;
+
+	// explicit instances
+	if (instances.getTag() == gason::JSON_ARRAY)
+	{
+		for (auto instance : instances)
+		{
+			const u32 modelIndex = resolveModel(findMember(instance->value, "model"), Models);
+			if (modelIndex == (u32)cfc::invalid_index)
+			{
+				context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevWarning, "Scene manifest (%s): instance with unknown model skipped.", name);
+				continue;
+			}
+
+			f32 position[3], rotation[3], scale[3];
+			readVector(findMember(instance->value, "position"), 0.0f, position);
+			readVector(findMember(instance->value, "rotation"), 0.0f, rotation);
+			readVector(findMember(instance->value, "scale"), 1.0f, scale);
+
+			InstanceModels[instanceIndex] = modelIndex;
+			buildTransform(position, rotation, scale, InstanceTransforms[instanceIndex]);
+			instanceIndex++;
+		}
+	}
+
+	// grid generators
+	if (grids.getTag() == gason::JSON_ARRAY)
+	{
+		for (auto grid : grids)
+		{
+			const u32 modelIndex = resolveModel(findMember(grid->value, "model"), Models);
+			if (modelIndex == (u32)cfc::invalid_index)
+			{
+				context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevWarning, "Scene manifest (%s): grid with unknown model skipped.", name);
+				continue;
+			}
+
+			// NOTE: counts were validated while counting the instances
+			u32 count[3];
+			readGridCount(grid->value, count);
+
+			f32 origin[3], spacing[3], rotation[3], scale[3];
+			readVector(findMember(grid->value, "origin"), 0.0f, origin);
+			readVector(findMember(grid->value, "spacing"), 1.0f, spacing);
+			readVector(findMember(grid->value, "rotation"), 0.0f, rotation);
+			readVector(findMember(grid->value, "scale"), 1.0f, scale);
+
+			// rotation and scale are shared by all grid instances, only the translation (Mat[12..14]) differs
+			const f32 zero[3] = { 0.0f, 0.0f, 0.0f };
+			mat4_simple transform;
+			buildTransform(zero, rotation, scale, transform);
+
+			for (u32 z = 0; z < count[2]; ++z)
+			{
+				for (u32 y = 0; y < count[1]; ++y)
+				{
+					for (u32 x = 0; x < count[0]; ++x)
+					{
+						transform.Mat[12] = origin[0] + spacing[0] * (f32)x;
+						transform.Mat[13] = origin[1] + spacing[1] * (f32)y;
+						transform.Mat[14] = origin[2] + spacing[2] * (f32)z;
+
+						InstanceModels[instanceIndex] = modelIndex;
+						InstanceTransforms[instanceIndex] = transform;
+						instanceIndex++;
+					}
+				}
+			}
+		}
+	}
+	stl_assert(instanceIndex == InstanceModels.size());
+
+	// procedural world, appended after the explicit instances and grids
+	if (generator.getTag() == gason::JSON_OBJECT)
+	{
+		const world_generator_stats stats = world_generator::Generate(desc, *this);
+		context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevInfo, "Scene manifest (%s): generated %d blocks, %d occluders, %d occludees (%.0f world units wide).", name, stats.NumBlocks, stats.NumOccluders, stats.NumOccludees, stats.WorldSize);
+	}
+
+	// settings
+	const gason::JsonValue settings = findMember(root, "settings");
+	Settings.OcclusionCulling = readBool(findMember(settings, "occlusionCulling"), Settings.OcclusionCulling);
+	Settings.DownsampleAfterReproject = readBool(findMember(settings, "downsampleAfterReproject"), Settings.DownsampleAfterReproject);
+	Settings.ComputeAsVertexShader = readBool(findMember(settings, "computeAsVertexShader"), Settings.ComputeAsVertexShader);
+	Settings.WireFrame = readBool(findMember(settings, "wireFrame"), Settings.WireFrame);
+	if (!readUInt(findMember(settings, "textureStreamingBudgetMB"), Settings.TextureStreamingBudgetInMB, 0xFFFFFFFF, Settings.TextureStreamingBudgetInMB))
+		context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevWarning, "Scene manifest (%s): textureStreamingBudgetMB is not an unsigned integer, the default is used.", name);
+
+	const gason::JsonValue passes = findMember(settings, "passes");
+	f32 threads[3];
+	readVector(findMember(findMember(passes, "reprojectDepth"), "threads"), 0.0f, threads);
+	Settings.ReprojectDepthThreads[0] = threads[0] >= 1.0f ? (u32)threads[0] : Settings.ReprojectDepthThreads[0];
+	Settings.ReprojectDepthThreads[1] = threads[1] >= 1.0f ? (u32)threads[1] : Settings.ReprojectDepthThreads[1];
+	readVector(findMember(findMember(passes, "downSampleReprojectedDepth"), "threads"), 0.0f, threads);
+	Settings.DownSampleReprojectedDepthThreads[0] = threads[0] >= 1.0f ? (u32)threads[0] : Settings.DownSampleReprojectedDepthThreads[0];
+	Settings.DownSampleReprojectedDepthThreads[1] = threads[1] >= 1.0f ? (u32)threads[1] : Settings.DownSampleReprojectedDepthThreads[1];
+	readVector(findMember(findMember(passes, "collectVisibleDrawCalls"), "threads"), 0.0f, threads);
+	Settings.CollectVisibleDrawCallsThreads = threads[0] >= 1.0f ? (u32)threads[0] : Settings.CollectVisibleDrawCallsThreads;
+
+	if (InstanceModels.empty())
+		context->Log->Logf(cfc::logflags::ScpApplication | cfc::logflags::SevWarning, "Scene manifest (%s) has no instances.", name);
+
+	return true;
+}
+
+void scene_manifest::CreateGrid(const char* modelFile, u32 countX, u32 countZ, f32 spacingX, f32 spacingZ, f32 scale)
+{
+	Clear();
+	Name = modelFile;
+
+	scene_manifest_model model;
+	model.Name = modelFile;
+	model.File = modelFile;
+	Models.push_back(model);
+
+	InstanceModels.resize(countX * countZ, 0);
+	InstanceTransforms.resize(countX * countZ);
+
+	// centered around the origin
+	const f32 rotation[3] = { 0.0f, 0.0f, 0.0f };
+	const f32 scaleXYZ[3] = { scale, scale, scale };
+	for (u32 z = 0; z < countZ; ++z)
+	{
+		for (u32 x = 0; x < countX; ++x)
+		{
+			const f32 position[3] = { (-(f32)countX * 0.5f + (f32)x) * spacingX, 0.0f, (-(f32)countZ * 0.5f + (f32)z) * spacingZ };
+			buildTransform(position, rotation, scaleXYZ, InstanceTransforms[z * countX + x]);
+		}
+	}
+}
+
+void scene_manifest::Clear()
+{
+	Name.clear();
+	Models.resize(0);
+	InstanceModels.resize(0);
+	InstanceTransforms.resize(0);
+	Settings = scene_pass_settings();
+}
+#pragma endregion
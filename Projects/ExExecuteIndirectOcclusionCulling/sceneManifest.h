@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cfc/base.h>
+#include <cfc/stl/stl_vector.hpp>
+#include <cfc/stl/stl_string.hpp>
+
+namespace cfc
+{
+	// forward declare
+	struct context;
+};
+
+struct mat4_simple
+{
+	float Mat[16];
+};
+
+// render pass settings, the defaults match the demo as it was hardcoded before manifests existed
+struct scene_pass_settings
+{
+	bool OcclusionCulling = true;
+	bool DownsampleAfterReproject = true;
+	bool ComputeAsVertexShader = false;
+	bool WireFrame = false;
+	u32 TextureStreamingBudgetInMB = 256;
+
+	// compute thread group sizes
+	u32 ReprojectDepthThreads[2] = { 32, 32 };
+	u32 DownSampleReprojectedDepthThreads[2] = { 32, 32 };
+	u32 CollectVisibleDrawCallsThreads = 1024;
+};
+
+struct scene_manifest_model
+{
+	stl_string Name;
+	stl_string File;	// OBJ file, relative to the content folder
+};
+
+// Data driven world description, loaded from JSON:
+//
+// {
+//   "models":    [ { "name": "sponza", "file": "crytek_sponza/sponza.obj" } ],
+//   "instances": [ { "model": "sponza", "position": [0, 0, 0], "rotation": [0, 90, 0], "scale": 0.001 } ],
+//   "grids":     [ { "model": "sponza", "count": [4, 1, 4], "origin": [-8, 0, -5], "spacing": [4, 0, 2.5], "scale": 0.001 } ],
+//   "generator": { "seed": 1, "instances": 100000, "instancesPerBlock": 64, "depthComplexity": 4, "occluderRatio": 0.25 },
+//   "settings":  { "occlusionCulling": true, "downsampleAfterReproject": true, "computeAsVertexShader": false, "wireFrame": false,
+//                  "textureStreamingBudgetMB": 256,
+//                  "passes": { "reprojectDepth": { "threads": [32, 32] }, "downSampleReprojectedDepth": { "threads": [32, 32] },
+//                              "collectVisibleDrawCalls": { "threads": 1024 } } }
+// }
+//
+// Models are referenced by name or by index, rotations are euler angles in degrees and a scale is a number or an [x, y, z] array.
+// Grids expand to count.x * count.y * count.z instances (x fastest), counts are integers up to 2^20 per axis. Instances are
+// counted before they are generated, so the instance arrays are allocated once no matter how many instances the manifest
+// describes. Manifests with invalid counts or more than 0xFFFFFFFE instances in total are rejected.
+// The optional generator appends a procedural city (see world_generator_desc for all fields), its models are added automatically.
+class scene_manifest
+{
+public:
+	bool LoadFromFile(cfc::context* const context, const char* file);
+
+	// parses in place, the json buffer is modified and has to be zero terminated
+	bool LoadFromMemory(cfc::context* const context, char* json, const char* name);
+
+	// single model on a grid, used when no manifest is available
+	void CreateGrid(const char* modelFile, u32 countX, u32 countZ, f32 spacingX, f32 spacingZ, f32 scale);
+
+	void Clear();
+
+	u32 GetModelQuantity() const { return (u32)Models.size(); }
+	u32 GetInstanceQuantity() const { return (u32)InstanceModels.size(); }
+
+public:
+	stl_string Name;
+	stl_vector<scene_manifest_model> Models;
+
+	// instances, structure of arrays
+	stl_vector<u32> InstanceModels;
+	stl_vector<mat4_simple> InstanceTransforms;
+
+	scene_pass_settings Settings;
+};
@@ -0,0 +1,241 @@
+#include "worldGenerator.h"
+#include "sceneManifest.h"
+
+#include <dependencies/stb/par_shapes.h>
+#include <dependencies/stb/stb_perlin.h>
+
+#include <math.h>
+#include <string.h>
+
+#define WORLD_GENERATOR_PI 3.14159265358979f
+
+// building footprints leave room for props between the rows
+#define BUILDING_FOOTPRINT_WIDTH 0.9f
+#define BUILDING_FOOTPRINT_DEPTH 0.6f
+
+
+static const char* g_buildingModel = PROCEDURAL_MODEL_PREFIX "building";
+static const char* g_propModels[] = {
+	PROCEDURAL_MODEL_PREFIX "rock",
+	PROCEDURAL_MODEL_PREFIX "sphere",
+	PROCEDURAL_MODEL_PREFIX "cylinder",
+	PROCEDURAL_MODEL_PREFIX "torus",
+	PROCEDURAL_MODEL_PREFIX "dodecahedron",
+};
+static const u32 g_numPropModels = sizeof(g_propModels) / sizeof(g_propModels[0]);
+
+
+#pragma region Helpers
+// splitmix64, small and identical on every platform (rand() is not)
+struct world_random
+{
+	explicit world_random(u64 seed) : State(seed) {}
+
+	u64 Next()
+	{
+		u64 z = (State += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	// [0, 1)
+	f32 NextFloat() { return (f32)(Next() >> 40) * (1.0f / 16777216.0f); }
+	f32 NextRange(f32 min, f32 max) { return min + (max - min) * NextFloat(); }
+	u32 NextIndex(u32 count) { return (u32)(Next() % count); }
+
+	u64 State;
+};
+
+static u32 findOrAddModel(scene_manifest& manifest, const char* file)
+{
+	for (usize i = 0; i < manifest.Models.size(); ++i)
+	{
+		if (manifest.Models[i].File == file)
+			return (u32)i;
+	}
+
+	scene_manifest_model model;
+	model.Name = file;
+	model.File = file;
+	manifest.Models.push_back(model);
+	return (u32)manifest.Models.size() - 1;
+}
+
+// column major, yaw around y followed by a non uniform scale
+static void buildTransform(f32 x, f32 y, f32 z, f32 yaw, f32 scaleX, f32 scaleY, f32 scaleZ, mat4_simple& out)
+{
+	const f32 c = cosf(yaw);
+	const f32 s = sinf(yaw);
+
+	f32* m = out.Mat;
+	m[0] = c * scaleX;	m[1] = 0.0f;	m[2] = -s * scaleX;	m[3] = 0.0f;
+	m[4] = 0.0f;		m[5] = scaleY;	m[6] = 0.0f;		m[7] = 0.0f;
+	m[8] = s * scaleZ;	m[9] = 0.0f;	m[10] = c * scaleZ;	m[11] = 0.0f;
+	m[12] = x;			m[13] = y;		m[14] = z;			m[15] = 1.0f;
+}
+
+static par_shapes_mesh* createShape(const char* shape)
+{
+	if (strcmp(shape, "building") == 0)
+		return par_shapes_create_cube();
+	if (strcmp(shape, "rock") == 0)
+		return par_shapes_create_rock(1, 2);
+	if (strcmp(shape, "sphere") == 0)
+		return par_shapes_create_subdivided_sphere(2);
+	if (strcmp(shape, "dodecahedron") == 0)
+		return par_shapes_create_dodecahedron();
+	if (strcmp(shape, "torus") == 0)
+		return par_shapes_create_torus(24, 12, 0.3f);
+
+	if (strcmp(shape, "cylinder") == 0)
+	{
+		// stands on z = 0, rotate it upright
+		par_shapes_mesh* mesh = par_shapes_create_cylinder(16, 1);
+		const float axis[3] = { 1.0f, 0.0f, 0.0f };
+		par_shapes_rotate(mesh, -WORLD_GENERATOR_PI * 0.5f, axis);
+		return mesh;
+	}
+	return nullptr;
+}
+#pragma endregion
+
+#pragma region world_generator
+bool world_generator::IsProceduralModel(const char* modelFile)
+{
+	return strncmp(modelFile, PROCEDURAL_MODEL_PREFIX, sizeof(PROCEDURAL_MODEL_PREFIX) - 1) == 0;
+}
+
+bool world_generator::CreateProceduralMesh(const char* modelFile, stl_vector<float>& positionsOUT, stl_vector<float>& texcoordsOUT, stl_vector<u32>& indicesOUT)
+{
+	if (!IsProceduralModel(modelFile))
+		return false;
+
+	par_shapes_mesh* mesh = createShape(modelFile + sizeof(PROCEDURAL_MODEL_PREFIX) - 1);
+	if (mesh == nullptr)
+		return false;
+
+	// center on x and z, stand on y = 0 and fit the largest extent in a unit
+	float aabb[6];
+	par_shapes_compute_aabb(mesh, aabb);
+	par_shapes_translate(mesh, -(aabb[0] + aabb[3]) * 0.5f, -aabb[1], -(aabb[2] + aabb[5]) * 0.5f);
+
+	float maxExtent = aabb[3] - aabb[0];
+	maxExtent = maxExtent > aabb[4] - aabb[1] ? maxExtent : aabb[4] - aabb[1];
+	maxExtent = maxExtent > aabb[5] - aabb[2] ? maxExtent : aabb[5] - aabb[2];
+	if (maxExtent > 0.0f)
+		par_shapes_scale(mesh, 1.0f / maxExtent, 1.0f / maxExtent, 1.0f / maxExtent);
+
+	positionsOUT.assign(mesh->points, mesh->points + mesh->npoints * 3);
+	indicesOUT.assign(mesh->triangles, mesh->triangles + mesh->ntriangles * 3);
+
+	// most shapes come without texture coordinates, fall back to a box projection
+	if (mesh->tcoords != nullptr)
+	{
+		texcoordsOUT.assign(mesh->tcoords, mesh->tcoords + mesh->npoints * 2);
+	}
+	else
+	{
+		texcoordsOUT.resize(mesh->npoints * 2);
+		for (i32 i = 0; i < mesh->npoints; ++i)
+		{
+			const float* p = &mesh->points[i * 3];
+			texcoordsOUT[i * 2 + 0] = p[0] + p[2];
+			texcoordsOUT[i * 2 + 1] = p[1];
+		}
+	}
+
+	par_shapes_free_mesh(mesh);
+	return true;
+}
+
+world_generator_stats world_generator::Generate(const world_generator_desc& desc, scene_manifest& manifestOUT)
+{
+	world_generator_stats stats;
+	if (desc.NumInstances == 0)
+		return stats;
+
+	const u32 instancesPerBlock = desc.InstancesPerBlock > 0 ? desc.InstancesPerBlock : 1;
+	const f32 occluderRatio = desc.OccluderRatio < 0.0f ? 0.0f : (desc.OccluderRatio > 1.0f ? 1.0f : desc.OccluderRatio);
+
+	stats.NumBlocks = (desc.NumInstances + instancesPerBlock - 1) / instancesPerBlock;
+	const u32 blocksPerSide = (u32)ceilf(sqrtf((f32)stats.NumBlocks));
+	const f32 cellSize = desc.BlockSize + desc.StreetWidth;
+	stats.WorldSize = blocksPerSide * cellSize;
+
+	const u32 buildingModel = findOrAddModel(manifestOUT, g_buildingModel);
+	u32 propModels[g_numPropModels];
+	for (u32 i = 0; i < g_numPropModels; ++i)
+		propModels[i] = findOrAddModel(manifestOUT, g_propModels[i]);
+
+	// NOTE: appended in one go, the instance arrays are allocated once
+	const usize firstInstance = manifestOUT.InstanceModels.size();
+	manifestOUT.InstanceModels.resize(firstInstance + desc.NumInstances);
+	manifestOUT.InstanceTransforms.resize(firstInstance + desc.NumInstances);
+	u32* instanceModels = &manifestOUT.InstanceModels[firstInstance];
+	mat4_simple* instanceTransforms = &manifestOUT.InstanceTransforms[firstInstance];
+
+	// the seed selects a slice through the noise volume
+	const f32 noiseSlice = (f32)(desc.Seed % 4093) * 0.731f + 0.5f;
+
+	u32 instanceIndex = 0;
+	for (u32 b = 0; b < stats.NumBlocks; ++b)
+	{
+		const u32 blockX = b % blocksPerSide;
+		const u32 blockZ = b / blocksPerSide;
+		const f32 blockMinX = -stats.WorldSize * 0.5f + blockX * cellSize + desc.StreetWidth * 0.5f;
+		const f32 blockMinZ = -stats.WorldSize * 0.5f + blockZ * cellSize + desc.StreetWidth * 0.5f;
+
+		// every block has its own random stream, blocks do not depend on each other
+		world_random random(((u64)desc.Seed << 32) ^ ((u64)blockZ << 16) ^ blockX);
+
+		// downtown factor in [0, 1]
+		const f32 noise = stb_perlin_noise3(blockX * desc.NoiseFrequency, noiseSlice, blockZ * desc.NoiseFrequency, 0, 0, 0);
+		f32 downtown = noise * 0.5f + 0.5f;
+		downtown = downtown < 0.0f ? 0.0f : (downtown > 1.0f ? 1.0f : downtown);
+
+		const u32 remaining = desc.NumInstances - instanceIndex;
+		const u32 numBlockInstances = remaining < instancesPerBlock ? remaining : instancesPerBlock;
+		const u32 numOccluders = (u32)(numBlockInstances * occluderRatio + 0.5f);
+		const u32 numRows = numOccluders == 0 ? 1 : (desc.DepthComplexity == 0 ? 1 : (desc.DepthComplexity < numOccluders ? desc.DepthComplexity : numOccluders));
+		const u32 buildingsPerRow = (numOccluders + numRows - 1) / numRows;
+		const f32 rowDepth = desc.BlockSize / numRows;
+
+		// occluders, rows of buildings along x
+		for (u32 i = 0; i < numOccluders; ++i)
+		{
+			const u32 row = i / buildingsPerRow;
+			const u32 column = i % buildingsPerRow;
+			const f32 buildingWidth = desc.BlockSize / buildingsPerRow;
+
+			const f32 height = desc.MinBuildingHeight + (desc.MaxBuildingHeight - desc.MinBuildingHeight) * downtown * downtown * random.NextRange(0.5f, 1.0f);
+			const f32 x = blockMinX + (column + 0.5f) * buildingWidth;
+			const f32 z = blockMinZ + row * rowDepth + rowDepth * BUILDING_FOOTPRINT_DEPTH * 0.5f;
+
+			instanceModels[instanceIndex] = buildingModel;
+			buildTransform(x, 0.0f, z, 0.0f, buildingWidth * BUILDING_FOOTPRINT_WIDTH, height, rowDepth * BUILDING_FOOTPRINT_DEPTH, instanceTransforms[instanceIndex]);
+			instanceIndex++;
+		}
+
+		// occludees, props in the gaps behind the rows
+		for (u32 i = numOccluders; i < numBlockInstances; ++i)
+		{
+			const u32 row = random.NextIndex(numRows);
+			const f32 size = random.NextRange(desc.MinPropSize, desc.MaxPropSize);
+			const f32 x = random.NextRange(blockMinX, blockMinX + desc.BlockSize);
+			const f32 z = blockMinZ + row * rowDepth + rowDepth * random.NextRange(BUILDING_FOOTPRINT_DEPTH, 1.0f);
+			const f32 yaw = random.NextRange(0.0f, 2.0f * WORLD_GENERATOR_PI);
+
+			instanceModels[instanceIndex] = propModels[random.NextIndex(g_numPropModels)];
+			buildTransform(x, 0.0f, z, yaw, size, size, size, instanceTransforms[instanceIndex]);
+			instanceIndex++;
+		}
+
+		stats.NumOccluders += numOccluders;
+		stats.NumOccludees += numBlockInstances - numOccluders;
+	}
+	stl_assert(instanceIndex == desc.NumInstances);
+
+	return stats;
+}
+#pragma endregion
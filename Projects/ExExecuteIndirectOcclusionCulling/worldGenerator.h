@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cfc/base.h>
+#include <cfc/stl/stl_vector.hpp>
+
+class scene_manifest;
+
+// models created by CreateProceduralMesh, referenced from manifests as "file": "procedural:<shape>"
+#define PROCEDURAL_MODEL_PREFIX "procedural:"
+
+// City like layout used to measure culling and load time scaling beyond the demo asset.
+// The world is a grid of blocks separated by streets, every block holds DepthComplexity rows of buildings (occluders)
+// with small props (occludees) scattered in between. Building heights follow perlin noise (downtown areas),
+// everything else is drawn from a random stream seeded per block, so the result only depends on the desc.
+struct world_generator_desc
+{
+	u32 Seed = 1;
+	u32 NumInstances = 10000;
+	u32 InstancesPerBlock = 64;		// density, the amount of blocks follows from NumInstances
+	u32 DepthComplexity = 4;		// building rows per block, every row hides the rows behind it
+	f32 OccluderRatio = 0.25f;		// buildings per instance, the remainder are props
+
+	f32 BlockSize = 40.0f;
+	f32 StreetWidth = 10.0f;
+	f32 MinBuildingHeight = 4.0f;
+	f32 MaxBuildingHeight = 60.0f;
+	f32 MinPropSize = 0.5f;
+	f32 MaxPropSize = 2.5f;
+	f32 NoiseFrequency = 0.08f;		// per block
+};
+
+struct world_generator_stats
+{
+	u32 NumBlocks = 0;
+	u32 NumOccluders = 0;
+	u32 NumOccludees = 0;
+	f32 WorldSize = 0.0f;			// side length in world units
+};
+
+class world_generator
+{
+public:
+	// headless, only fills the manifest (models and instances are appended, existing content is kept)
+	static world_generator_stats Generate(const world_generator_desc& desc, scene_manifest& manifestOUT);
+
+	// builds a unit sized mesh standing on y = 0 for a "procedural:<shape>" model file, returns false for unknown shapes
+	// NOTE: counter clockwise winding, like OBJ files
+	static bool CreateProceduralMesh(const char* modelFile, stl_vector<float>& positionsOUT, stl_vector<float>& texcoordsOUT, stl_vector<u32>& indicesOUT);
+
+	static bool IsProceduralModel(const char* modelFile);
+};
@@ -0,0 +1,62 @@
+
+#include <functional>
+
+#include <cfc/platform/platform_linux.hpp>
+#include <cfc/stl/threading.h>
+#include <cfc/stl/jobsystem.h>
+#include <cfc/core/counters.h>
+#include <cfc/core/io_archive.h>
+#include <thread>
+#include "cfc/math/math.h"
+
+extern void app_main(cfc::context* context);
+
+void init(int argc, char** argv)
+{
+	cfc::context context;
+
+	// * Initialize core components without context dependencies.
+	cfc::platform::linux::timing timing;
+	cfc::hashing hashing;
+	cfc::logging log;
+	cfc::random random;
+	cfc::platform::linux::io io;
+	context.Timing = &timing;
+	context.Hash = &hashing;
+	context.Log = &log;
+	context.Random = &random;
+	context.IO = &io;
+
+	// * Content packed with CFC.Tool.Archive is read from the archive, files that are not in it from disk.
+	cfc::io_archive archiveIO(io);
+	if (archiveIO.Open("content" CFC_ARCHIVE_EXTENSION))
+		context.IO = &archiveIO;
+
+	// * The main thread becomes job worker 0, it executes jobs while it waits on a counter.
+	cfc::core::threading::job_system jobs;
+	jobs.Init();
+	context.Jobs = &jobs;
+
+	// * Per-frame counters, the app and the scene report into it and the app ends the frame.
+	cfc::profiling::counter_registry counters;
+	context.Counters = &counters;
+
+	// * Headless window, the input of a run comes from the script given on the command line (--window-script <path>).
+	cfc::platform::linux::window window(context);
+	for (int i = 1; i + 1 < argc; ++i)
+	{
+		if (strcmp(argv[i], "--window-script") == 0 && !window.LoadScript(argv[i + 1]))
+			log.Logf(cfc::logflags::ScpEngine | cfc::logflags::SevError, "Could not read window script (%s).", argv[i + 1]);
+	}
+	context.Window = &window;
+
+	app_main(&context);
+}
+
+int main(int argc, char** argv)
+{
+	init(argc, argv);
+
+	if (cfc::object::GetNumberOfObjectsAlive() > 0)
+		CFC_BREAKPOINT; // memory leaks detected.
+}
@@ -1,2 +1,2 @@
 #define LIBCOLLISION_IMPLEMENTATION
-#include "libCollision.h"
\ No newline at end of file
+#include "libcollision.h"
\ No newline at end of file
@@ -1,4 +1,6 @@
 #pragma once
+#include <stddef.h>
+
 namespace stb
 {
 	typedef unsigned long long u64;
@@ -5,6 +5,12 @@
 // Add safety checks for array lookups and buffer overflows in various places in the engine.
 #define CFC_CONF_SAFETY
 
+// Validate the generation of gfx handles on every lookup, a handle to a removed object breaks into the debugger.
+// Release builds skip the check and a lookup is a plain array access.
+#ifdef _DEBUG
+#define CFC_CONF_GFX_HANDLE_VALIDATION
+#endif
+
 // Enable/disable logging
 #define CFC_CONF_LOGGING
 
@@ -17,6 +23,6 @@
 // Enable memory leak detection (VLD: Visual Leak Detector, only for visual studio)
 //#define CFC_CONF_ENABLE_VLD
 
-// Debug memory tracking - shows which objects through the memory allocator are still alive, and where they have been allocated (through signature).
-// Warning: Slows things down. Every allocation accesses a std::map with allocation information. Use only for debug builds!
-//#define CFC_CONF_ALLOCATOR_TRACKER
\ No newline at end of file
+// Memory tracking - replaces global operator new / delete, every allocation is attributed to the memory tag of the allocating thread (see memory_tracker).
+// Costs a 16 byte header and two adds to counters of the calling thread per allocation, cheap enough for release builds.
+#define CFC_CONF_ALLOCATOR_TRACKER
\ No newline at end of file
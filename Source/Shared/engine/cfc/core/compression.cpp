@@ -0,0 +1,175 @@
+#include "compression.h"
+
+#include <string.h>
+
+// positions in the match table, 4096 entries keep the table in the l1 cache
+#define CFC_LZ_HASH_BITS 12
+#define CFC_LZ_MIN_MATCH 4
+#define CFC_LZ_MAX_OFFSET 0xFFFF
+
+CFC_NAMESPACE1(cfc)
+
+static inline u32 readU32(const u8* ptr)
+{
+	u32 v;
+	memcpy(&v, ptr, sizeof(v));
+	return v;
+}
+
+static inline u32 hashLZ(u32 sequence)
+{
+	return (sequence * 2654435761U) >> (32 - CFC_LZ_HASH_BITS);
+}
+
+// lengths of 15 and up continue in bytes of 255 until a byte below 255
+static inline u8* writeLength(u8* op, usize length)
+{
+	for (length -= 15; length >= 255; length -= 255)
+		*op++ = 255;
+	*op++ = (u8)length;
+	return op;
+}
+
+static inline u8* writeSequence(u8* op, const u8* literals, usize numLiterals, usize offset, usize matchLength)
+{
+	const usize matchCode = matchLength - CFC_LZ_MIN_MATCH;
+	u8* token = op++;
+	*token = (u8)((numLiterals < 15 ? numLiterals : 15) << 4);
+	if (numLiterals >= 15)
+		op = writeLength(op, numLiterals);
+	if (numLiterals > 0)
+		memcpy(op, literals, numLiterals);
+	op += numLiterals;
+
+	// the last sequence has literals only
+	if (matchLength == 0)
+		return op;
+
+	*op++ = (u8)(offset & 0xFF);
+	*op++ = (u8)(offset >> 8);
+	*token |= (u8)(matchCode < 15 ? matchCode : 15);
+	if (matchCode >= 15)
+		op = writeLength(op, matchCode);
+	return op;
+}
+
+static inline bool readLength(const u8*& ip, const u8* ipEnd, usize& lengthInOut)
+{
+	u8 b;
+	do
+	{
+		if (ip >= ipEnd)
+			return false;
+		b = *ip++;
+		lengthInOut += b;
+	} while (b == 255);
+	return true;
+}
+
+usize compression::CompressLZ(const u8* src, usize srcSize, u8* dst, usize dstCapacity)
+{
+	if (dstCapacity < GetCompressBound(srcSize))
+		return 0;
+	stl_assert(srcSize < 0xFFFFFFFFU); // positions are stored as 32 bit
+
+	u32 table[1 << CFC_LZ_HASH_BITS];
+	memset(table, 0xFF, sizeof(table));
+
+	u8* op = dst;
+	usize anchor = 0;
+	usize ip = 0;
+
+	// greedy, the first match of at least CFC_LZ_MIN_MATCH bytes is taken
+	const usize matchLimit = srcSize >= CFC_LZ_MIN_MATCH ? srcSize - CFC_LZ_MIN_MATCH : 0;
+	while (ip < matchLimit)
+	{
+		const u32 sequence = readU32(src + ip);
+		const u32 h = hashLZ(sequence);
+		const u32 ref = table[h];
+		table[h] = (u32)ip;
+
+		if (ref == 0xFFFFFFFFU || ip - ref > CFC_LZ_MAX_OFFSET || readU32(src + ref) != sequence)
+		{
+			ip++;
+			continue;
+		}
+
+		usize matchLength = CFC_LZ_MIN_MATCH;
+		while (ip + matchLength < srcSize && src[ref + matchLength] == src[ip + matchLength])
+			matchLength++;
+
+		op = writeSequence(op, src + anchor, ip - anchor, ip - ref, matchLength);
+		ip += matchLength;
+		anchor = ip;
+	}
+
+	op = writeSequence(op, src + anchor, srcSize - anchor, 0, 0);
+	return (usize)(op - dst);
+}
+
+bool compression::DecompressLZ(const u8* src, usize srcSize, u8* dst, usize dstSize)
+{
+	const u8* ip = src;
+	const u8* const ipEnd = src + srcSize;
+	u8* op = dst;
+	u8* const opEnd = dst + dstSize;
+
+	while (ip < ipEnd)
+	{
+		const u8 token = *ip++;
+
+		usize numLiterals = token >> 4;
+		if (numLiterals == 15 && !readLength(ip, ipEnd, numLiterals))
+			return false;
+		if (numLiterals > (usize)(ipEnd - ip) || numLiterals > (usize)(opEnd - op))
+			return false;
+
+		// short runs are copied as a fixed 16 bytes when both buffers have the room, a constant size copy is a single move
+		if (numLiterals <= 16 && ipEnd - ip >= 16 && opEnd - op >= 16)
+			memcpy(op, ip, 16);
+		else
+			memcpy(op, ip, numLiterals);
+		ip += numLiterals;
+		op += numLiterals;
+
+		// literals only, the end of the block
+		if (ip == ipEnd)
+			break;
+
+		if (ipEnd - ip < 2)
+			return false;
+		const usize offset = (usize)ip[0] | ((usize)ip[1] << 8);
+		ip += 2;
+
+		usize matchLength = token & 15;
+		if (matchLength == 15 && !readLength(ip, ipEnd, matchLength))
+			return false;
+		matchLength += CFC_LZ_MIN_MATCH;
+
+		if (offset == 0 || offset > (usize)(op - dst) || matchLength > (usize)(opEnd - op))
+			return false;
+
+		// NOTE: matches can overlap their own output (offset < length), copied front to back. From an offset of 8 up a
+		// chunk of 8 bytes never reads what it writes, the last chunk may write past the match (not past the buffer).
+		const u8* match = op - offset;
+		if (offset >= 8 && (usize)(opEnd - op) >= matchLength + 8)
+		{
+			u8* const matchEnd = op + matchLength;
+			do
+			{
+				memcpy(op, match, 8);
+				op += 8;
+				match += 8;
+			} while (op < matchEnd);
+			op = matchEnd;
+		}
+		else
+		{
+			for (usize i = 0; i < matchLength; ++i)
+				*op++ = *match++;
+		}
+	}
+	return op == opEnd;
+}
+
+CFC_END_NAMESPACE1(cfc)
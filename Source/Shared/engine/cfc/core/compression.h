@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cfc/base.h>
+
+CFC_NAMESPACE1(cfc)
+
+// Byte oriented LZ77 block codec (LZ4 block layout: a token with literal and match length nibbles, the literals, a 16 bit
+// offset). Decoding is a copy loop without entropy stage, it runs at memory speed and is meant for data that is read far
+// more often than it is written, like the entries of an io_archive.
+class CFC_API compression
+{
+public:
+	// worst case size of compressed data, incompressible input grows by a byte per 255
+	static usize GetCompressBound(usize size) { return size + size / 255 + 16; }
+
+	// returns the compressed size, 0 when the destination is smaller than GetCompressBound(srcSize)
+	static usize CompressLZ(const u8* src, usize srcSize, u8* dst, usize dstCapacity);
+
+	// decodes exactly dstSize bytes, fails on malformed or truncated input instead of reading or writing out of bounds
+	static bool DecompressLZ(const u8* src, usize srcSize, u8* dst, usize dstSize);
+};
+
+CFC_END_NAMESPACE1(cfc)
@@ -11,10 +11,15 @@ class random;
 class timing;
 class window;
 
+namespace core { namespace threading { class job_system; }; };
+namespace profiling { class counter_registry; };
+
 struct context
 {
 	hashing* 	Hash		= nullptr;
 	io* 		IO			= nullptr;
+	core::threading::job_system* Jobs = nullptr;
+	profiling::counter_registry* Counters = nullptr;
 	logging* 	Log			= nullptr;
 	random* 	Random		= nullptr;
 	timing* 	Timing		= nullptr;
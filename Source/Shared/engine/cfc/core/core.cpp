@@ -35,7 +35,9 @@ cfc::object::object()
 cfc::object::~object()
 {
 	if (gObjectCounter.fetch_add(-1) == 1)
-		0; // printf("Engine cleanup successful. All objects have been accounted for.\n"); // all objects have been deleted..
+	{
+		// printf("Engine cleanup successful. All objects have been accounted for.\n"); // all objects have been deleted..
+	}
 }
 
 int cfc::object::GetNumberOfObjectsAlive()
@@ -46,13 +48,24 @@ int cfc::object::GetNumberOfObjectsAlive()
 #pragma endregion
 #pragma region IO
 
+static void releaseIOBuffer(iobuffer& buffer)
+{
+	if (buffer.data)
+	{
+		if (buffer.release)
+			buffer.release(buffer.data, buffer.size);
+		else
+			free(buffer.data);
+	}
+	buffer.data = nullptr;
+	buffer.size = cfc::invalid_index;
+	buffer.release = nullptr;
+}
+
 cfc::iobuffer::~iobuffer()
 { 
 	// destroy
-	if (data)
-		free(data);
-	data = nullptr;
-	size = cfc::invalid_index;
+	releaseIOBuffer(*this);
 }
 
 iobuffer::iobuffer(const iobuffer& o)
@@ -61,25 +74,29 @@ iobuffer::iobuffer(const iobuffer& o)
 	iobuffer& v = (iobuffer&)o;
 	data = v.data;
 	size = v.size;
+	release = v.release;
 	v.data = nullptr;
 	v.size = cfc::invalid_index;
+	v.release = nullptr;
 }
 
 
 iobuffer& iobuffer::operator=(const iobuffer& o)
 {
+	if (this == &o)
+		return *this;
+
 	// destroy
-	if (data)
-		free(data);
-	data = nullptr;
-	size = cfc::invalid_index;
+	releaseIOBuffer(*this);
 
 	// steal
 	iobuffer& v = (iobuffer&)o;
 	data = v.data;
 	size = v.size;
+	release = v.release;
 	v.data = nullptr;
 	v.size = cfc::invalid_index;
+	v.release = nullptr;
 
 	return *this;
 }
@@ -101,46 +118,6 @@ int cfc::random::randInt(int base, int range)
 }
 
 
-#pragma endregion
-#pragma region Logging
-void cfc::logging::Log(const char* msg, unsigned int flags/*=Flags::ScpEngine | Flags::SevInfo*/)
-{
-	printf("%s", msg);
-}
-
-void cfc::logging::Logf(unsigned int flags, const char* format, ...)
-{
-	char dest[1024 * 16];
-	va_list argptr;
-	va_start(argptr, format);
-#ifdef WIN32
-	vsprintf_s(dest, (1024*16)-1, format, argptr);
-#else
-	vsprintf(dest, format, argptr);
-#endif
-	va_end(argptr);
-
-	Log(dest, flags);
-}
-
-const char* cfc::logflags::ToString(Enumeration flag) const
-{
-	switch (flag)
-	{
-		case logflags::ScpApplication:			return "Application";
-		case logflags::ScpEngine:				return "Engine";
-		case logflags::SevAssert:				return "Assert";
-		case logflags::SevCrash:				return "Crash";
-		case logflags::SevCritical:				return "Critical";
-		case logflags::SevDebug:				return "Debug";
-		case logflags::SevInfo:					return "Info";
-		case logflags::SevError:				return "Major";
-		case logflags::SevWarning:				return "Minor";
-		case logflags::SevProfiling:			return "Profiling";
-		default:								return "Unknown";
-	}
-}
-
 #pragma endregion
 #pragma region Timing
 
@@ -163,27 +140,19 @@ u64 cfc::timing::GetTimeNanoSeconds()
 cfc::profiling::scopedtime::scopedtime(cfc::context& ctx, const char* scope) : m_ctx(ctx), m_scope(scope)
 {
 	m_time = m_ctx.Timing->GetTimeSeconds();
+	profiler::BeginZone(scope);
 }
 
 cfc::profiling::scopedtime::~scopedtime()
 {
+	profiler::EndZone();
+
 	double timeEnd = m_ctx.Timing->GetTimeSeconds();
 	double timeElapsed = timeEnd - m_time;
 
 	m_ctx.Log->Logf(cfc::logflags::ScpEngine | cfc::logflags::SevInfo, "Timescope \"%s\" elapsed: %f ms\n", m_scope, timeElapsed*1000.0);
 }
 
-#pragma endregion
-#pragma region Hashing
-
-u64 cfc::hashing::HashU64(const void* data, u32_64 length, u64 startHash) 
-{ 
-	return 0ULL; 
-}
-u32 cfc::hashing::HashU32(const void* data, u32_64 length, u32 startHash) 
-{ 
-	return 0U; 
-}
 #pragma endregion
 
 // UNORDERED - ORDER THESE!
@@ -0,0 +1,359 @@
+#include "counters.h"
+#include "io.h"
+
+#include <cfc/stl/stl_vector.hpp>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+CFC_NAMESPACE2(cfc, profiling)
+
+struct _counter
+{
+	char Name[64];
+	counter_type::Enumeration Type;
+
+	std::atomic<i64> Accumulator;		// Count, value of the current frame
+	std::atomic<u64> ValueBits;			// Value, bits of the last f64 that was set
+
+	u64 FirstFrame;						// frames before this have no sample (registered later or reset)
+	f64 History[CFC_COUNTER_HISTORY];
+};
+
+class _imp_counter_registry
+{
+public:
+	_imp_counter_registry() : NumCounters(0), NumFrames(0) {}
+
+	usize FindLocked(const char* name) const
+	{
+		const usize numCounters = NumCounters.load(std::memory_order_acquire);
+		for (usize i = 0; i < numCounters; ++i)
+		{
+			if (strncmp(Counters[i].Name, name, sizeof(Counters[i].Name) - 1) == 0)
+				return i;
+		}
+		return cfc::invalid_index;
+	}
+
+	// first frame of the history window of a counter
+	u64 GetFirstFrame(const _counter& counter) const
+	{
+		const u64 windowBegin = NumFrames > CFC_COUNTER_HISTORY ? NumFrames - CFC_COUNTER_HISTORY : 0;
+		return counter.FirstFrame > windowBegin ? counter.FirstFrame : windowBegin;
+	}
+
+	// NOTE: the storage never moves, Add and Set index it without taking the lock
+	_counter Counters[CFC_COUNTER_MAX_QUANTITY];
+	std::atomic<usize> NumCounters;
+	mutable std::mutex Lock;
+
+	u64 NumFrames;
+};
+
+static f64 bitsToValue(u64 bits)
+{
+	f64 value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static u64 valueToBits(f64 value)
+{
+	u64 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+// nearest rank percentile of sorted samples
+static f64 percentile(const stl_vector<f64>& sorted, f64 fraction)
+{
+	usize rank = (usize)(fraction * (f64)sorted.size() + 0.999999);
+	rank = rank > 0 ? rank - 1 : 0;
+	return sorted[rank < sorted.size() ? rank : sorted.size() - 1];
+}
+
+counter_registry::counter_registry()
+{
+	m_impl = new _imp_counter_registry();
+}
+
+counter_registry::~counter_registry()
+{
+	delete m_impl;
+}
+
+usize counter_registry::Register(const char* name, counter_type::Enumeration type)
+{
+	std::lock_guard<std::mutex> lock(m_impl->Lock);
+
+	const usize existing = m_impl->FindLocked(name);
+	if (existing != cfc::invalid_index)
+		return existing;
+
+	const usize index = m_impl->NumCounters.load(std::memory_order_relaxed);
+	if (index >= CFC_COUNTER_MAX_QUANTITY)
+		return cfc::invalid_index;
+
+	_counter& counter = m_impl->Counters[index];
+	snprintf(counter.Name, sizeof(counter.Name), "%s", name);
+	counter.Type = type;
+	counter.Accumulator.store(0, std::memory_order_relaxed);
+	counter.ValueBits.store(valueToBits(0.0), std::memory_order_relaxed);
+	counter.FirstFrame = m_impl->NumFrames;
+
+	m_impl->NumCounters.store(index + 1, std::memory_order_release);
+	return index;
+}
+
+usize counter_registry::Find(const char* name) const
+{
+	std::lock_guard<std::mutex> lock(m_impl->Lock);
+	return m_impl->FindLocked(name);
+}
+
+void counter_registry::Add(usize counter, i64 value)
+{
+	if (counter >= m_impl->NumCounters.load(std::memory_order_acquire))
+		return;
+	m_impl->Counters[counter].Accumulator.fetch_add(value, std::memory_order_relaxed);
+}
+
+void counter_registry::Set(usize counter, f64 value)
+{
+	if (counter >= m_impl->NumCounters.load(std::memory_order_acquire))
+		return;
+	m_impl->Counters[counter].ValueBits.store(valueToBits(value), std::memory_order_relaxed);
+}
+
+void counter_registry::EndFrame()
+{
+	std::lock_guard<std::mutex> lock(m_impl->Lock);
+
+	const usize slot = (usize)(m_impl->NumFrames % CFC_COUNTER_HISTORY);
+	const usize numCounters = m_impl->NumCounters.load(std::memory_order_relaxed);
+	for (usize i = 0; i < numCounters; ++i)
+	{
+		_counter& counter = m_impl->Counters[i];
+		if (counter.Type == counter_type::Count)
+			counter.History[slot] = (f64)counter.Accumulator.exchange(0, std::memory_order_relaxed);
+		else
+			counter.History[slot] = bitsToValue(counter.ValueBits.load(std::memory_order_relaxed));
+	}
+	m_impl->NumFrames++;
+}
+
+void counter_registry::Reset()
+{
+	std::lock_guard<std::mutex> lock(m_impl->Lock);
+
+	const usize numCounters = m_impl->NumCounters.load(std::memory_order_relaxed);
+	for (usize i = 0; i < numCounters; ++i)
+		m_impl->Counters[i].FirstFrame = m_impl->NumFrames;
+}
+
+usize counter_registry::GetCounterQuantity() const
+{
+	return m_impl->NumCounters.load(std::memory_order_acquire);
+}
+
+const char* counter_registry::GetName(usize counter) const
+{
+	if (counter >= GetCounterQuantity())
+		return "";
+	return m_impl->Counters[counter].Name;
+}
+
+counter_type::Enumeration counter_registry::GetType(usize counter) const
+{
+	if (counter >= GetCounterQuantity())
+		return counter_type::Count;
+	return m_impl->Counters[counter].Type;
+}
+
+u64 counter_registry::GetFrameQuantity() const
+{
+	return m_impl->NumFrames;
+}
+
+counter_stats counter_registry::GetStats(usize counter) const
+{
+	counter_stats stats;
+	if (counter >= GetCounterQuantity())
+		return stats;
+
+	stl_vector<f64> sorted;
+	sorted.reserve(CFC_COUNTER_HISTORY);
+	{
+		std::lock_guard<std::mutex> lock(m_impl->Lock);
+		const _counter& c = m_impl->Counters[counter];
+		for (u64 f = m_impl->GetFirstFrame(c); f < m_impl->NumFrames; ++f)
+			sorted.push_back(c.History[f % CFC_COUNTER_HISTORY]);
+	}
+	if (sorted.empty())
+		return stats;
+
+	stats.Last = sorted.back();
+	stats.NumSamples = (u32)sorted.size();
+
+	f64 sum = 0.0;
+	for (usize i = 0; i < sorted.size(); ++i)
+		sum += sorted[i];
+	stats.Average = sum / (f64)sorted.size();
+
+	std::sort(sorted.begin(), sorted.end());
+	stats.Min = sorted.front();
+	stats.Max = sorted.back();
+	stats.P50 = percentile(sorted, 0.50);
+	stats.P95 = percentile(sorted, 0.95);
+	stats.P99 = percentile(sorted, 0.99);
+	return stats;
+}
+
+usize counter_registry::GetHistory(usize counter, f32* samplesOUT, usize maxSamples) const
+{
+	if (counter >= GetCounterQuantity())
+		return 0;
+
+	std::lock_guard<std::mutex> lock(m_impl->Lock);
+	const _counter& c = m_impl->Counters[counter];
+
+	// the most recent samples when the buffer is smaller than the history
+	u64 first = m_impl->GetFirstFrame(c);
+	if (m_impl->NumFrames - first > maxSamples)
+		first = m_impl->NumFrames - maxSamples;
+
+	usize numSamples = 0;
+	for (u64 f = first; f < m_impl->NumFrames; ++f)
+		samplesOUT[numSamples++] = (f32)c.History[f % CFC_COUNTER_HISTORY];
+	return numSamples;
+}
+
+#pragma region Export
+
+static void appendCsvField(stl_string& out, const char* str)
+{
+	out += '"';
+	for (; *str != 0; ++str)
+	{
+		if (*str == '"')
+			out += '"';
+		out += *str;
+	}
+	out += '"';
+}
+
+static void appendJsonString(stl_string& out, const char* str)
+{
+	out += '"';
+	for (; *str != 0; ++str)
+	{
+		const char c = *str;
+		if (c == '"' || c == '\\')
+			out += '\\';
+		out += (unsigned char)c < 0x20 ? ' ' : c;
+	}
+	out += '"';
+}
+
+static void appendNumber(stl_string& out, f64 value)
+{
+	// NOTE: json has no representation for nan and infinity
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%.9g", isfinite(value) ? value : 0.0);
+	out += buffer;
+}
+
+stl_string counter_registry::ExportCSV() const
+{
+	std::lock_guard<std::mutex> lock(m_impl->Lock);
+	const usize numCounters = m_impl->NumCounters.load(std::memory_order_acquire);
+
+	stl_string csv;
+	csv += "frame";
+	for (usize i = 0; i < numCounters; ++i)
+	{
+		csv += ',';
+		appendCsvField(csv, m_impl->Counters[i].Name);
+	}
+	csv += '\n';
+
+	// counters without a sample in a frame have an empty field
+	const u64 first = m_impl->NumFrames > CFC_COUNTER_HISTORY ? m_impl->NumFrames - CFC_COUNTER_HISTORY : 0;
+	for (u64 f = first; f < m_impl->NumFrames; ++f)
+	{
+		char buffer[32];
+		snprintf(buffer, sizeof(buffer), "%llu", (unsigned long long)f);
+		csv += buffer;
+		for (usize i = 0; i < numCounters; ++i)
+		{
+			const _counter& c = m_impl->Counters[i];
+			csv += ',';
+			if (f >= m_impl->GetFirstFrame(c))
+				appendNumber(csv, c.History[f % CFC_COUNTER_HISTORY]);
+		}
+		csv += '\n';
+	}
+	return csv;
+}
+
+stl_string counter_registry::ExportJSON() const
+{
+	const usize numCounters = GetCounterQuantity();
+
+	stl_string json;
+	json += "{\"frames\":";
+	appendNumber(json, (f64)GetFrameQuantity());
+	json += ",\"counters\":[";
+	for (usize i = 0; i < numCounters; ++i)
+	{
+		const counter_stats stats = GetStats(i);
+
+		json += i == 0 ? "\n{\"name\":" : ",\n{\"name\":";
+		appendJsonString(json, GetName(i));
+		json += GetType(i) == counter_type::Count ? ",\"type\":\"count\"" : ",\"type\":\"value\"";
+		json += ",\"samples\":"; appendNumber(json, (f64)stats.NumSamples);
+		json += ",\"last\":"; appendNumber(json, stats.Last);
+		json += ",\"min\":"; appendNumber(json, stats.Min);
+		json += ",\"max\":"; appendNumber(json, stats.Max);
+		json += ",\"avg\":"; appendNumber(json, stats.Average);
+		json += ",\"p50\":"; appendNumber(json, stats.P50);
+		json += ",\"p95\":"; appendNumber(json, stats.P95);
+		json += ",\"p99\":"; appendNumber(json, stats.P99);
+
+		json += ",\"history\":[";
+		{
+			std::lock_guard<std::mutex> lock(m_impl->Lock);
+			const _counter& c = m_impl->Counters[i];
+			for (u64 f = m_impl->GetFirstFrame(c); f < m_impl->NumFrames; ++f)
+			{
+				if (f != m_impl->GetFirstFrame(c))
+					json += ',';
+				appendNumber(json, c.History[f % CFC_COUNTER_HISTORY]);
+			}
+		}
+		json += "]}";
+	}
+	json += "\n]}\n";
+	return json;
+}
+
+bool counter_registry::SaveCSV(cfc::context& ctx, const char* path) const
+{
+	const stl_string csv = ExportCSV();
+	return ctx.IO->WriteMemoryToFile(path, csv.data(), csv.size());
+}
+
+bool counter_registry::SaveJSON(cfc::context& ctx, const char* path) const
+{
+	const stl_string json = ExportJSON();
+	return ctx.IO->WriteMemoryToFile(path, json.data(), json.size());
+}
+
+#pragma endregion
+
+CFC_END_NAMESPACE2(cfc, profiling)
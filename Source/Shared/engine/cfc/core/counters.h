@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cfc/base.h>
+#include <cfc/core/context.h>
+#include <cfc/stl/stl_string.hpp>
+
+CFC_NAMESPACE2(cfc, profiling)
+
+// frames of history every counter keeps, the statistics are over this window
+#define CFC_COUNTER_HISTORY 512
+
+// counters a registry can hold, indices stay valid for the lifetime of the registry
+#define CFC_COUNTER_MAX_QUANTITY 128
+
+class _imp_counter_registry;
+
+struct counter_type
+{
+	enum Enumeration
+	{
+		Count,			// summed over the frame with Add (objects, draws, triangles)
+		Value,			// last value set in the frame with Set (timings in milliseconds)
+	};
+};
+
+struct counter_stats
+{
+	f64 Last = 0.0;
+	f64 Min = 0.0;
+	f64 Max = 0.0;
+	f64 Average = 0.0;
+	f64 P50 = 0.0;
+	f64 P95 = 0.0;
+	f64 P99 = 0.0;
+	u32 NumSamples = 0;
+};
+
+// Named per-frame counters with a ring of history. Add and Set can be called from any thread, EndFrame moves the value of
+// the frame into the history of every counter. EndFrame, the statistics and the exports are called from one thread.
+class CFC_API counter_registry : public cfc::object
+{
+public:
+	counter_registry();
+	~counter_registry();
+
+	// returns the counter with this name, it is added when it does not exist yet (the name is copied, up to 63 characters)
+	usize Register(const char* name, counter_type::Enumeration type = counter_type::Count);
+	// cfc::invalid_index when there is no counter with this name
+	usize Find(const char* name) const;
+
+	// NOTE: an invalid index is ignored, code reporting into an optional registry does not have to check
+	void Add(usize counter, i64 value = 1);
+	void Set(usize counter, f64 value);
+
+	// pushes the value of the frame into the history of every counter and starts the next frame
+	void EndFrame();
+	// clears the history of every counter, the counters stay registered
+	void Reset();
+
+	// NOTE: an invalid index gets an empty name, a Count type and empty statistics
+	usize GetCounterQuantity() const;
+	const char* GetName(usize counter) const;
+	counter_type::Enumeration GetType(usize counter) const;
+	u64 GetFrameQuantity() const;
+
+	counter_stats GetStats(usize counter) const;
+	// oldest sample first, returns the number of samples written
+	usize GetHistory(usize counter, f32* samplesOUT, usize maxSamples) const;
+
+	// CSV has a row per frame of the history and a column per counter, the JSON has the statistics and the history
+	stl_string ExportCSV() const;
+	stl_string ExportJSON() const;
+	bool SaveCSV(cfc::context& ctx, const char* path) const;
+	bool SaveJSON(cfc::context& ctx, const char* path) const;
+
+protected:
+	counter_registry(const counter_registry& o) {}
+	void operator = (const counter_registry& o) {}
+
+private:
+	_imp_counter_registry* m_impl;
+};
+
+CFC_END_NAMESPACE2(cfc, profiling)
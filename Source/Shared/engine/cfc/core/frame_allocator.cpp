@@ -0,0 +1,175 @@
+#include "frame_allocator.h"
+
+#include <mutex>
+
+CFC_NAMESPACE1(cfc)
+
+#pragma region Linear Allocator
+linear_allocator::linear_allocator(usize initialCapacity)
+{
+	m_currentBlock = 0;
+	m_offset = 0;
+	addBlock(initialCapacity > 0 ? initialCapacity : CFC_LINEAR_ALLOCATOR_DEFAULT_CAPACITY);
+}
+
+linear_allocator::~linear_allocator()
+{
+	for (usize i = 0; i < m_blocks.size(); ++i)
+		delete[] m_blocks[i].Data;
+}
+
+void linear_allocator::addBlock(usize capacity)
+{
+	block newBlock;
+	newBlock.Data = new u8[capacity];
+	newBlock.Capacity = capacity;
+	m_blocks.push_back(newBlock);
+
+	m_stats.CapacityBytes += capacity;
+	m_stats.NumHeapAllocations++;
+}
+
+void* linear_allocator::Allocate(usize size, usize alignment)
+{
+	stl_assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+	for (;;)
+	{
+		block& current = m_blocks[m_currentBlock];
+		const usize address = (usize)(current.Data + m_offset);
+		const usize padding = ((address + alignment - 1) & ~(alignment - 1)) - address;
+
+		if (m_offset + padding + size <= current.Capacity)
+		{
+			void* ptr = current.Data + m_offset + padding;
+			m_offset += padding + size;
+
+			m_stats.UsedBytes += padding + size;
+			m_stats.HighWaterBytes = m_stats.UsedBytes > m_stats.HighWaterBytes ? m_stats.UsedBytes : m_stats.HighWaterBytes;
+			return ptr;
+		}
+
+		// the rest of this block is wasted until the next reset, count it so the high water mark covers it
+		m_stats.UsedBytes += current.Capacity - m_offset;
+
+		// blocks after the current one are spares left by FreeToMarker, otherwise grow
+		if (m_currentBlock + 1 == m_blocks.size())
+		{
+			const usize doubled = current.Capacity * 2;
+			addBlock(doubled > size + alignment ? doubled : size + alignment);
+		}
+		m_currentBlock++;
+		m_offset = 0;
+	}
+}
+
+void linear_allocator::Free(void* ptr, usize size)
+{
+	block& current = m_blocks[m_currentBlock];
+	if ((u8*)ptr + size == current.Data + m_offset && (u8*)ptr >= current.Data)
+	{
+		m_offset -= size;
+		m_stats.UsedBytes -= size;
+	}
+}
+
+linear_allocator_marker linear_allocator::GetMarker() const
+{
+	linear_allocator_marker marker;
+	marker.Block = m_currentBlock;
+	marker.Offset = m_offset;
+	marker.UsedBytes = m_stats.UsedBytes;
+	return marker;
+}
+
+void linear_allocator::FreeToMarker(const linear_allocator_marker& marker)
+{
+	stl_assert(marker.Block < m_currentBlock || (marker.Block == m_currentBlock && marker.Offset <= m_offset));
+
+	m_currentBlock = marker.Block;
+	m_offset = marker.Offset;
+	m_stats.UsedBytes = marker.UsedBytes;
+}
+
+void linear_allocator::Reset()
+{
+	// fold a chain into a single block, the next frame with the same workload fits without growing
+	if (m_blocks.size() > 1)
+	{
+		const usize capacity = m_stats.CapacityBytes > m_stats.HighWaterBytes ? m_stats.CapacityBytes : m_stats.HighWaterBytes;
+		for (usize i = 0; i < m_blocks.size(); ++i)
+			delete[] m_blocks[i].Data;
+		m_blocks.resize(0);
+
+		m_stats.CapacityBytes = 0;
+		addBlock(capacity);
+	}
+
+	m_currentBlock = 0;
+	m_offset = 0;
+	m_stats.UsedBytes = 0;
+}
+#pragma endregion
+
+#pragma region Frame Allocator
+static std::mutex g_frameAllocatorsLock;
+static stl_vector<linear_allocator*> g_frameAllocators;
+
+// NOTE: C++11 thread_local instead of CFC_THREAD_LOCAL_STORAGE, the allocator has to be released when the thread exits
+struct frame_allocator_owner
+{
+	~frame_allocator_owner()
+	{
+		if (Allocator == nullptr)
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(g_frameAllocatorsLock);
+			for (usize i = 0; i < g_frameAllocators.size(); ++i)
+			{
+				if (g_frameAllocators[i] == Allocator)
+				{
+					g_frameAllocators[i] = g_frameAllocators.back();
+					g_frameAllocators.pop_back();
+					break;
+				}
+			}
+		}
+		delete Allocator;
+	}
+
+	linear_allocator* Allocator = nullptr;
+};
+
+static thread_local frame_allocator_owner g_threadFrameAllocator;
+
+linear_allocator& frame_allocator::GetThreadAllocator()
+{
+	if (g_threadFrameAllocator.Allocator == nullptr)
+	{
+		g_threadFrameAllocator.Allocator = new linear_allocator();
+
+		std::lock_guard<std::mutex> lock(g_frameAllocatorsLock);
+		g_frameAllocators.push_back(g_threadFrameAllocator.Allocator);
+	}
+	return *g_threadFrameAllocator.Allocator;
+}
+
+linear_allocator_stats frame_allocator::GetGlobalStats()
+{
+	linear_allocator_stats globalStats;
+
+	std::lock_guard<std::mutex> lock(g_frameAllocatorsLock);
+	for (usize i = 0; i < g_frameAllocators.size(); ++i)
+	{
+		const linear_allocator_stats stats = g_frameAllocators[i]->GetStats();
+		globalStats.UsedBytes += stats.UsedBytes;
+		globalStats.HighWaterBytes += stats.HighWaterBytes;
+		globalStats.CapacityBytes += stats.CapacityBytes;
+		globalStats.NumHeapAllocations += stats.NumHeapAllocations;
+	}
+	return globalStats;
+}
+#pragma endregion
+
+CFC_END_NAMESPACE1(cfc)
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cfc/base.h>
+#include <cfc/stl/stl_vector.hpp>
+
+#include <string>
+
+#define CFC_LINEAR_ALLOCATOR_DEFAULT_CAPACITY (1024 * 1024)
+
+CFC_NAMESPACE1(cfc)
+
+struct linear_allocator_stats
+{
+	usize UsedBytes = 0;
+	usize HighWaterBytes = 0;		// most bytes in use at once since creation
+	usize CapacityBytes = 0;
+	u32 NumHeapAllocations = 0;		// blocks requested from the heap since creation, stops growing once the capacity covers the high water mark
+};
+
+struct linear_allocator_marker
+{
+	u32 Block;
+	usize Offset;
+	usize UsedBytes;
+};
+
+// Bump allocator for transient data, allocations are released all at once by Reset or FreeToMarker.
+// Runs out of a block: a bigger block is chained, Reset folds the chain into a single block that covers the high water mark,
+// after which a steady workload no longer touches the heap.
+// NOTE: not thread safe, every thread uses its own (see frame_allocator)
+class CFC_API linear_allocator
+{
+public:
+	explicit linear_allocator(usize initialCapacity = CFC_LINEAR_ALLOCATOR_DEFAULT_CAPACITY);
+	~linear_allocator();
+
+	void* Allocate(usize size, usize alignment = 16);
+	// only the most recent allocation is returned to the allocator, anything else waits for a reset
+	void Free(void* ptr, usize size);
+
+	linear_allocator_marker GetMarker() const;
+	void FreeToMarker(const linear_allocator_marker& marker);
+	void Reset();
+
+	linear_allocator_stats GetStats() const { return m_stats; }
+
+protected:
+	linear_allocator(const linear_allocator& o) {}
+	void operator = (const linear_allocator& o) {}
+
+private:
+	struct block
+	{
+		u8* Data;
+		usize Capacity;
+	};
+
+	void addBlock(usize capacity);
+
+	stl_vector<block> m_blocks;
+	u32 m_currentBlock;
+	usize m_offset;
+	linear_allocator_stats m_stats;
+};
+
+// per thread linear allocators, the main thread resets its allocator at the frame boundary,
+// jobs and loader stages release their transient data with a frame_allocator_scope
+class CFC_API frame_allocator
+{
+public:
+	// allocator of the calling thread, created on first use and released when the thread exits
+	static linear_allocator& GetThreadAllocator();
+
+	// summed over the allocators of all threads
+	// NOTE: read without synchronization, numbers of other threads can be slightly outdated
+	static linear_allocator_stats GetGlobalStats();
+};
+
+// releases everything the calling thread allocated from its frame allocator during the lifetime of the scope
+class CFC_API frame_allocator_scope
+{
+public:
+	frame_allocator_scope() : m_allocator(frame_allocator::GetThreadAllocator()), m_marker(m_allocator.GetMarker()) {}
+	~frame_allocator_scope() { m_allocator.FreeToMarker(m_marker); }
+
+protected:
+	frame_allocator_scope(const frame_allocator_scope& o) : m_allocator(o.m_allocator) {}
+	void operator = (const frame_allocator_scope& o) {}
+
+private:
+	linear_allocator& m_allocator;
+	linear_allocator_marker m_marker;
+};
+
+// STL allocator adapter, containers allocate from the linear allocator of the thread that created them
+// NOTE: the container must not outlive the reset of that allocator
+template <class T>
+class frame_stl_allocator
+{
+public:
+	typedef T value_type;
+
+	frame_stl_allocator() : Allocator(&frame_allocator::GetThreadAllocator()) {}
+	explicit frame_stl_allocator(linear_allocator& allocator) : Allocator(&allocator) {}
+	template <class U> frame_stl_allocator(const frame_stl_allocator<U>& o) : Allocator(o.Allocator) {}
+
+	template <class U> struct rebind { typedef frame_stl_allocator<U> other; };
+
+	T* allocate(usize n) { return (T*)Allocator->Allocate(n * sizeof(T), alignof(T) > 16 ? alignof(T) : 16); }
+	void deallocate(T* ptr, usize n) { Allocator->Free(ptr, n * sizeof(T)); }
+
+	template <class U> bool operator == (const frame_stl_allocator<U>& o) const { return Allocator == o.Allocator; }
+	template <class U> bool operator != (const frame_stl_allocator<U>& o) const { return Allocator != o.Allocator; }
+
+	linear_allocator* Allocator;
+};
+
+CFC_END_NAMESPACE1(cfc)
+
+template <typename T> using stl_frame_vector = std::vector<T, cfc::frame_stl_allocator<T>>;
+using stl_frame_string = std::basic_string<char, std::char_traits<char>, cfc::frame_stl_allocator<char>>;
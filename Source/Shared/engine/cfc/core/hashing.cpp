@@ -0,0 +1,332 @@
+#include "hashing.h"
+
+#include <string.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define CFC_HASH_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define CFC_HASH_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#define HASH_STRIPE_SIZE 64
+#define HASH_STRIPES_PER_BLOCK 16
+
+// ** Source Code
+using namespace cfc;
+#pragma region Helpers
+static const u32 g_prime32_1 = 0x9E3779B1U;
+static const u32 g_prime32_2 = 0x85EBCA77U;
+static const u32 g_prime32_3 = 0xC2B2AE3DU;
+static const u64 g_prime64_1 = 0x9E3779B185EBCA87ULL;
+static const u64 g_prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+static const u64 g_prime64_3 = 0x165667B19E3779F9ULL;
+static const u64 g_prime64_4 = 0x85EBCA77C2B2AE63ULL;
+static const u64 g_prime64_5 = 0x27D4EB2F165667C5ULL;
+
+// splitmix64 sequence (seed 0), stripe s uses key[s..s+7], scrambling uses key[16..23]
+static const u64 g_secret[24] = {
+	0xE220A8397B1DCDAFULL, 0x6E789E6AA1B965F4ULL, 0x06C45D188009454FULL, 0xF88BB8A8724C81ECULL,
+	0x1B39896A51A8749BULL, 0x53CB9F0C747EA2EAULL, 0x2C829ABE1F4532E1ULL, 0xC584133AC916AB3CULL,
+	0x3EE5789041C98AC3ULL, 0xF3B8488C368CB0A6ULL, 0x657EECDD3CB13D09ULL, 0xC2D326E0055BDEF6ULL,
+	0x8621A03FE0BBDB7BULL, 0x8E1F7555983AA92FULL, 0xB54E0F1600CC4D19ULL, 0x84BB3F97971D80ABULL,
+	0x7D29825C75521255ULL, 0xC3CF17102B7F7F86ULL, 0x3466E9A083914F64ULL, 0xD81A8D2B5A4485ACULL,
+	0xDB01602B100B9ED7ULL, 0xA9038A921825F10DULL, 0xEDF5F1D90DCA2F6AULL, 0x54496AD67BD2634CULL,
+};
+
+static inline u64 read64(const u8* p)
+{
+	u64 v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+// 64x64 -> 128 bit multiply, folded back to 64 bits
+static inline u64 mul128Fold64(u64 a, u64 b)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	u64 hi;
+	const u64 lo = _umul128(a, b, &hi);
+	return lo ^ hi;
+#elif defined(__SIZEOF_INT128__)
+	const unsigned __int128 product = (unsigned __int128)a * b;
+	return (u64)product ^ (u64)(product >> 64);
+#else
+	const u64 loLo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+	const u64 hiLo = (a >> 32) * (b & 0xFFFFFFFF);
+	const u64 loHi = (a & 0xFFFFFFFF) * (b >> 32);
+	const u64 hiHi = (a >> 32) * (b >> 32);
+	const u64 cross = (loLo >> 32) + (hiLo & 0xFFFFFFFF) + loHi;
+	const u64 hi = (hiLo >> 32) + (cross >> 32) + hiHi;
+	const u64 lo = (cross << 32) | (loLo & 0xFFFFFFFF);
+	return lo ^ hi;
+#endif
+}
+
+static inline u64 avalanche(u64 h)
+{
+	h ^= h >> 37;
+	h *= 0x165667919E3779F9ULL;
+	h ^= h >> 32;
+	return h;
+}
+
+static inline u64 deriveKey(u64 seed, u32 index)
+{
+	return (index & 1) ? g_secret[index] - seed : g_secret[index] + seed;
+}
+
+static void initAccumulators(u64 acc[8])
+{
+	acc[0] = g_prime32_3;
+	acc[1] = g_prime64_1;
+	acc[2] = g_prime64_2;
+	acc[3] = g_prime64_3;
+	acc[4] = g_prime64_4;
+	acc[5] = g_prime32_2;
+	acc[6] = g_prime64_5;
+	acc[7] = g_prime32_1;
+}
+
+// accumulates numStripes consecutive stripes, firstStripe is the global stripe index of the first one
+// every lane adds the product of the low and high half of (data ^ key) and the data of its neighbour lane,
+// the accumulators are scrambled after every block of HASH_STRIPES_PER_BLOCK stripes
+#if CFC_HASH_AVX2
+static void accumulateStripes(u64 acc[8], const u8* data, u64 numStripes, u64 firstStripe, const u64 key[24])
+{
+	__m256i acc0 = _mm256_loadu_si256((const __m256i*)&acc[0]);
+	__m256i acc1 = _mm256_loadu_si256((const __m256i*)&acc[4]);
+	const __m256i prime = _mm256_set1_epi32((int)g_prime32_1);
+	const __m256i scrambleKey0 = _mm256_loadu_si256((const __m256i*)&key[16]);
+	const __m256i scrambleKey1 = _mm256_loadu_si256((const __m256i*)&key[20]);
+
+	for (u64 s = 0; s < numStripes; ++s, data += HASH_STRIPE_SIZE)
+	{
+		const u32 stripeInBlock = (u32)((firstStripe + s) & (HASH_STRIPES_PER_BLOCK - 1));
+		const u64* stripeKey = &key[stripeInBlock];
+
+		const __m256i data0 = _mm256_loadu_si256((const __m256i*)(data + 0));
+		const __m256i data1 = _mm256_loadu_si256((const __m256i*)(data + 32));
+		const __m256i dataKey0 = _mm256_xor_si256(data0, _mm256_loadu_si256((const __m256i*)&stripeKey[0]));
+		const __m256i dataKey1 = _mm256_xor_si256(data1, _mm256_loadu_si256((const __m256i*)&stripeKey[4]));
+		acc0 = _mm256_add_epi64(acc0, _mm256_mul_epu32(dataKey0, _mm256_shuffle_epi32(dataKey0, _MM_SHUFFLE(0, 3, 0, 1))));
+		acc1 = _mm256_add_epi64(acc1, _mm256_mul_epu32(dataKey1, _mm256_shuffle_epi32(dataKey1, _MM_SHUFFLE(0, 3, 0, 1))));
+		acc0 = _mm256_add_epi64(acc0, _mm256_shuffle_epi32(data0, _MM_SHUFFLE(1, 0, 3, 2)));
+		acc1 = _mm256_add_epi64(acc1, _mm256_shuffle_epi32(data1, _MM_SHUFFLE(1, 0, 3, 2)));
+
+		if (stripeInBlock == HASH_STRIPES_PER_BLOCK - 1)
+		{
+			acc0 = _mm256_xor_si256(_mm256_xor_si256(acc0, _mm256_srli_epi64(acc0, 47)), scrambleKey0);
+			acc1 = _mm256_xor_si256(_mm256_xor_si256(acc1, _mm256_srli_epi64(acc1, 47)), scrambleKey1);
+			acc0 = _mm256_add_epi64(_mm256_mul_epu32(acc0, prime), _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(acc0, 32), prime), 32));
+			acc1 = _mm256_add_epi64(_mm256_mul_epu32(acc1, prime), _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(acc1, 32), prime), 32));
+		}
+	}
+
+	_mm256_storeu_si256((__m256i*)&acc[0], acc0);
+	_mm256_storeu_si256((__m256i*)&acc[4], acc1);
+}
+#elif CFC_HASH_SSE2
+static void accumulateStripes(u64 acc[8], const u8* data, u64 numStripes, u64 firstStripe, const u64 key[24])
+{
+	__m128i accs[4];
+	for (u32 i = 0; i < 4; ++i)
+		accs[i] = _mm_loadu_si128((const __m128i*)&acc[i * 2]);
+	const __m128i prime = _mm_set1_epi32((int)g_prime32_1);
+
+	for (u64 s = 0; s < numStripes; ++s, data += HASH_STRIPE_SIZE)
+	{
+		const u32 stripeInBlock = (u32)((firstStripe + s) & (HASH_STRIPES_PER_BLOCK - 1));
+		const u64* stripeKey = &key[stripeInBlock];
+
+		for (u32 i = 0; i < 4; ++i)
+		{
+			const __m128i data0 = _mm_loadu_si128((const __m128i*)(data + i * 16));
+			const __m128i dataKey = _mm_xor_si128(data0, _mm_loadu_si128((const __m128i*)&stripeKey[i * 2]));
+			accs[i] = _mm_add_epi64(accs[i], _mm_mul_epu32(dataKey, _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1))));
+			accs[i] = _mm_add_epi64(accs[i], _mm_shuffle_epi32(data0, _MM_SHUFFLE(1, 0, 3, 2)));
+		}
+
+		if (stripeInBlock == HASH_STRIPES_PER_BLOCK - 1)
+		{
+			for (u32 i = 0; i < 4; ++i)
+			{
+				__m128i a = _mm_xor_si128(_mm_xor_si128(accs[i], _mm_srli_epi64(accs[i], 47)), _mm_loadu_si128((const __m128i*)&key[16 + i * 2]));
+				accs[i] = _mm_add_epi64(_mm_mul_epu32(a, prime), _mm_slli_epi64(_mm_mul_epu32(_mm_srli_epi64(a, 32), prime), 32));
+			}
+		}
+	}
+
+	for (u32 i = 0; i < 4; ++i)
+		_mm_storeu_si128((__m128i*)&acc[i * 2], accs[i]);
+}
+#else
+static void accumulateStripes(u64 acc[8], const u8* data, u64 numStripes, u64 firstStripe, const u64 key[24])
+{
+	for (u64 s = 0; s < numStripes; ++s, data += HASH_STRIPE_SIZE)
+	{
+		const u32 stripeInBlock = (u32)((firstStripe + s) & (HASH_STRIPES_PER_BLOCK - 1));
+		const u64* stripeKey = &key[stripeInBlock];
+
+		for (u32 i = 0; i < 8; ++i)
+		{
+			const u64 value = read64(data + i * 8);
+			const u64 dataKey = value ^ stripeKey[i];
+			acc[i ^ 1] += value;
+			acc[i] += (dataKey & 0xFFFFFFFF) * (dataKey >> 32);
+		}
+
+		if (stripeInBlock == HASH_STRIPES_PER_BLOCK - 1)
+		{
+			for (u32 i = 0; i < 8; ++i)
+			{
+				u64 a = acc[i];
+				a ^= a >> 47;
+				a ^= key[16 + i];
+				acc[i] = a * g_prime32_1;
+			}
+		}
+	}
+}
+#endif
+
+// the last stripe holds 1 to 64 bytes and is zero padded
+static u64 finalizeLong(const u64 accIn[8], const u8* lastData, u32 lastSize, u64 numStripes, u64 totalLength, const u64 key[24])
+{
+	u64 acc[8];
+	memcpy(acc, accIn, sizeof(acc));
+
+	u8 lastStripe[HASH_STRIPE_SIZE] = {};
+	memcpy(lastStripe, lastData, lastSize);
+	accumulateStripes(acc, lastStripe, 1, numStripes, key);
+
+	u64 result = totalLength * g_prime64_1;
+	for (u32 i = 0; i < 4; ++i)
+		result += mul128Fold64(acc[i * 2] ^ key[8 + i * 2], acc[i * 2 + 1] ^ key[9 + i * 2]);
+	return avalanche(result);
+}
+
+// up to 64 bytes, 16 bytes per multiply, a partial last pair is zero padded
+static u64 hashShort(const u8* data, u32 length, u64 seed)
+{
+	u64 result = seed + length * g_prime64_1;
+
+	const u32 numFullPairs = length / 16;
+	for (u32 i = 0; i < numFullPairs; ++i)
+		result += mul128Fold64(read64(data + i * 16) ^ deriveKey(seed, i * 2), read64(data + i * 16 + 8) ^ deriveKey(seed, i * 2 + 1));
+
+	const u32 remainder = length & 15;
+	if (remainder > 0)
+	{
+		u8 padded[16] = {};
+		memcpy(padded, data + numFullPairs * 16, remainder);
+		result += mul128Fold64(read64(padded) ^ deriveKey(seed, numFullPairs * 2), read64(padded + 8) ^ deriveKey(seed, numFullPairs * 2 + 1));
+	}
+	return avalanche(result ^ g_secret[23]);
+}
+#pragma endregion
+
+#pragma region Hashing
+u64 cfc::Hash64(const void* data, usize length, u64 seed)
+{
+	const u8* bytes = (const u8*)data;
+	if (length <= HASH_STRIPE_SIZE)
+		return hashShort(bytes, (u32)length, seed);
+
+	u64 key[24];
+	for (u32 i = 0; i < 24; ++i)
+		key[i] = deriveKey(seed, i);
+
+	u64 acc[8];
+	initAccumulators(acc);
+
+	// NOTE: the last (partial or full) stripe is always handled by finalizeLong, equal to hash_stream
+	const u64 numStripes = (length - 1) / HASH_STRIPE_SIZE;
+	accumulateStripes(acc, bytes, numStripes, 0, key);
+
+	const usize processed = (usize)numStripes * HASH_STRIPE_SIZE;
+	return finalizeLong(acc, bytes + processed, (u32)(length - processed), numStripes, length, key);
+}
+
+u32 cfc::Hash32(const void* data, usize length, u32 seed)
+{
+	const u64 hash = Hash64(data, length, seed);
+	return (u32)(hash ^ (hash >> 32));
+}
+
+u64 cfc::HashName(const char* str)
+{
+	u64 hash = 0xCBF29CE484222325ULL;
+	for (; *str; ++str)
+		hash = (hash ^ (u64)(u8)*str) * 0x100000001B3ULL;
+	return hash;
+}
+
+void cfc::hash_stream::Reset(u64 seed)
+{
+	for (u32 i = 0; i < 24; ++i)
+		m_key[i] = deriveKey(seed, i);
+	initAccumulators(m_acc);
+	m_bufferSize = 0;
+	m_numStripes = 0;
+	m_totalLength = 0;
+	m_seed = seed;
+}
+
+void cfc::hash_stream::Update(const void* data, usize length)
+{
+	const u8* bytes = (const u8*)data;
+	m_totalLength += length;
+
+	// a full buffer is only accumulated once more data follows, the last stripe belongs to Finalize
+	if (m_bufferSize + length <= HASH_STRIPE_SIZE)
+	{
+		memcpy(m_buffer + m_bufferSize, bytes, length);
+		m_bufferSize += (u32)length;
+		return;
+	}
+
+	if (m_bufferSize > 0)
+	{
+		const u32 fill = HASH_STRIPE_SIZE - m_bufferSize;
+		memcpy(m_buffer + m_bufferSize, bytes, fill);
+		bytes += fill;
+		length -= fill;
+		accumulateStripes(m_acc, m_buffer, 1, m_numStripes, m_key);
+		m_numStripes++;
+	}
+
+	// stripes straight from the input, 1 to 64 bytes stay behind
+	const u64 numStripes = (length - 1) / HASH_STRIPE_SIZE;
+	accumulateStripes(m_acc, bytes, numStripes, m_numStripes, m_key);
+	m_numStripes += numStripes;
+	bytes += numStripes * HASH_STRIPE_SIZE;
+	length -= (usize)numStripes * HASH_STRIPE_SIZE;
+
+	memcpy(m_buffer, bytes, length);
+	m_bufferSize = (u32)length;
+}
+
+u64 cfc::hash_stream::Finalize() const
+{
+	if (m_totalLength <= HASH_STRIPE_SIZE)
+		return hashShort(m_buffer, m_bufferSize, m_seed);
+
+	return finalizeLong(m_acc, m_buffer, m_bufferSize, m_numStripes, m_totalLength, m_key);
+}
+
+u64 cfc::hashing::HashU64(const void* data, u32_64 length, u64 startHash)
+{
+	return Hash64(data, (usize)length, startHash);
+}
+
+u32 cfc::hashing::HashU32(const void* data, u32_64 length, u32 startHash)
+{
+	return Hash32(data, (usize)length, startHash);
+}
+#pragma endregion
@@ -2,8 +2,46 @@
 
 #include <cfc/base.h>
 
+#include <type_traits>
+
+// compile time name hash, usable as case label or template argument
+#define CFC_HASH_NAME(str) (std::integral_constant<u64, cfc::HashNameConst(str)>::value)
+
 CFC_NAMESPACE1(cfc)
 
+// Content hash (non cryptographic), 64 byte stripes are accumulated in 8 independent 64 bit lanes
+// which maps directly on SSE2 / AVX2 registers, inputs up to 64 bytes take a short path.
+// The result only depends on the data and the seed, not on how the data is split over hash_stream::Update calls.
+CFC_API u64 Hash64(const void* data, usize length, u64 seed = 0);
+CFC_API u32 Hash32(const void* data, usize length, u32 seed = 0);
+
+// Name hash (FNV-1a), the runtime and compile time versions give the same result
+CFC_API u64 HashName(const char* str);
+constexpr u64 HashNameConst(const char* str, u64 hash = 0xCBF29CE484222325ULL)
+{
+	return *str ? HashNameConst(str + 1, (hash ^ (u64)(u8)*str) * 0x100000001B3ULL) : hash;
+}
+
+// incremental version of Hash64
+class CFC_API hash_stream
+{
+public:
+	explicit hash_stream(u64 seed = 0) { Reset(seed); }
+
+	void Reset(u64 seed = 0);
+	void Update(const void* data, usize length);
+	u64 Finalize() const;
+
+private:
+	u64 m_acc[8];
+	u64 m_key[24];
+	u8 m_buffer[64];
+	u32 m_bufferSize;
+	u64 m_numStripes;
+	u64 m_totalLength;
+	u64 m_seed;
+};
+
 class CFC_API hashing : public object
 {
 public:
@@ -11,4 +49,4 @@ public:
 	virtual u32 HashU32(const void* data, u32_64 length, u32 startHash = 0xFFFFffffU);
 };
 
-CFC_END_NAMESPACE1(cfc)
\ No newline at end of file
+CFC_END_NAMESPACE1(cfc)
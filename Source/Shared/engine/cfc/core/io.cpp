@@ -0,0 +1,230 @@
+#include "io.h"
+#include "profiling.h"
+
+#include <cfc/stl/stl_string.hpp>
+#include <cfc/stl/stl_vector.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <deque>
+#include <thread>
+
+CFC_NAMESPACE1(cfc)
+
+#pragma region Queue
+
+// a submitted batch, shared by its requests and deleted by the worker finishing the last one
+struct _io_submission
+{
+	stl_vector<io_read_request> Requests;
+	stl_vector<stl_string> Paths;
+	io_read_callback Callback;
+	io_batch* Batch;
+	std::atomic<usize> NumRemaining;
+};
+
+struct _io_job
+{
+	_io_submission* Submission;
+	usize RequestIndex;
+};
+
+class _imp_io_queue
+{
+public:
+	_imp_io_queue(io& fileIO) : m_io(fileIO), m_stop(false)
+	{
+		for (u32 i = 0; i < CFC_IO_WORKER_QUANTITY; ++i)
+		{
+			m_workers.push_back(std::thread([this, i]()
+			{
+				char threadName[32];
+				snprintf(threadName, sizeof(threadName), "IO Worker %u", i);
+				cfc::profiling::profiler::SetThreadName(threadName);
+				work();
+			}));
+		}
+	}
+
+	~_imp_io_queue()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			m_stop = true;
+		}
+		m_wake.notify_all();
+		for (usize i = 0; i < m_workers.size(); ++i)
+			m_workers[i].join();
+	}
+
+	void Submit(_io_submission* submission)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			for (usize i = 0; i < submission->Requests.size(); ++i)
+				m_jobs.push_back(_io_job{ submission, i });
+		}
+		m_wake.notify_all();
+	}
+
+	// NOTE: the batch is not touched after the lock is released, the waiter can destroy it once it got the lock
+	static void Complete(io_batch& batch, bool succeeded)
+	{
+		if (!succeeded)
+			batch.m_numFailed.fetch_add(1, std::memory_order_relaxed);
+
+		std::lock_guard<std::mutex> lock(batch.m_lock);
+		if (batch.m_numPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			batch.m_completed.notify_all();
+	}
+
+private:
+	void work()
+	{
+		for (;;)
+		{
+			_io_job job;
+			{
+				std::unique_lock<std::mutex> lock(m_lock);
+				m_wake.wait(lock, [this]() { return m_stop || !m_jobs.empty(); });
+				if (m_jobs.empty())
+					return;
+				job = m_jobs.front();
+				m_jobs.pop_front();
+			}
+			execute(job);
+		}
+	}
+
+	void execute(const _io_job& job)
+	{
+		CFC_PROFILE_SCOPE("IO Read");
+		_io_submission& submission = *job.Submission;
+		const io_read_request& request = submission.Requests[job.RequestIndex];
+		const char* path = submission.Paths[job.RequestIndex].c_str();
+
+		io_read_result result;
+		result.RequestIndex = job.RequestIndex;
+		result.UserData = request.UserData;
+
+		if (request.Destination == nullptr && request.Offset == 0 && request.Size == cfc::invalid_index)
+		{
+			result.Buffer = m_io.ReadFileToMemory(path);
+			if (result.Buffer)
+			{
+				result.Succeeded = true;
+				result.Data = result.Buffer.data;
+				result.Size = result.Buffer.size;
+			}
+		}
+		else
+		{
+			usize size = request.Size;
+			if (size == cfc::invalid_index)
+			{
+				const u64 fileSize = m_io.GetFileSize(path);
+				size = fileSize > request.Offset ? (usize)(fileSize - request.Offset) : 0;
+			}
+
+			u8* destination = (u8*)request.Destination;
+			if (destination == nullptr)
+			{
+				result.Buffer.data = (u8*)malloc(size > 0 ? size : 1);
+				result.Buffer.size = size;
+				destination = result.Buffer.data;
+			}
+
+			// NOTE: a destination that is too small fails the request instead of writing past it
+			if (request.Destination == nullptr || size <= request.DestinationSize)
+			{
+				usize numRead = 0;
+				result.Succeeded = m_io.ReadFileRange(path, request.Offset, destination, size, numRead) && numRead == size;
+				result.Data = destination;
+				result.Size = numRead;
+			}
+		}
+
+		submission.Callback(result);
+
+		// the submission is released before the batch completes, the caller can reuse the batch right after Wait
+		io_batch& batch = *submission.Batch;
+		const bool succeeded = result.Succeeded;
+		if (submission.NumRemaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			delete &submission;
+		Complete(batch, succeeded);
+	}
+
+	io& m_io;
+	std::mutex m_lock;
+	std::condition_variable m_wake;
+	std::deque<_io_job> m_jobs;
+	stl_vector<std::thread> m_workers;
+	bool m_stop;
+};
+
+#pragma endregion
+#pragma region IO
+
+void io_batch::Wait()
+{
+	// NOTE: always takes the lock, the last worker still holds it right after the counter reached zero
+	std::unique_lock<std::mutex> lock(m_lock);
+	m_completed.wait(lock, [this]() { return IsComplete(); });
+}
+
+io::~io()
+{
+	delete m_queue;
+}
+
+bool io::ReadFileRange(const char* path, u64 offset, void* destination, usize size, usize& numReadOUT)
+{
+	numReadOUT = 0;
+	FILE* f = fopen(path, "rb");
+	if (!f)
+		return false;
+
+#ifdef _MSC_VER
+	const bool seeked = _fseeki64(f, (i64)offset, SEEK_SET) == 0;
+#else
+	const bool seeked = fseeko(f, (off_t)offset, SEEK_SET) == 0;
+#endif
+	if (seeked)
+		numReadOUT = fread(destination, 1, size, f);
+	const bool failed = !seeked || ferror(f) != 0;
+	fclose(f);
+	return !failed;
+}
+
+void io::ReadAsync(const io_read_request* requests, usize numRequests, io_batch& batch, io_read_callback callback)
+{
+	stl_assert(batch.IsComplete());
+	if (numRequests == 0)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_queueLock);
+		if (m_queue == nullptr)
+			m_queue = new _imp_io_queue(*this);
+	}
+
+	_io_submission* submission = new _io_submission();
+	submission->Requests.assign(requests, requests + numRequests);
+	submission->Paths.resize(numRequests);
+	for (usize i = 0; i < numRequests; ++i)
+	{
+		submission->Paths[i] = requests[i].Path != nullptr ? requests[i].Path : "";
+		submission->Requests[i].Path = nullptr;
+	}
+	submission->Callback = std::move(callback);
+	submission->Batch = &batch;
+	submission->NumRemaining.store(numRequests, std::memory_order_relaxed);
+
+	batch.m_numFailed.store(0, std::memory_order_relaxed);
+	batch.m_numPending.store(numRequests, std::memory_order_release);
+	m_queue->Submit(submission);
+}
+
+#pragma endregion
+
+CFC_END_NAMESPACE1(cfc)
@@ -1,6 +1,14 @@
 #pragma once
 
 #include <cfc/base.h>
+#include <cfc/stl/stl_function.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+// threads serving asynchronous reads, enough requests in flight to keep a ssd busy
+#define CFC_IO_WORKER_QUANTITY 8
 
 CFC_NAMESPACE1(cfc)
 
@@ -14,18 +22,94 @@ public:
 	u8* data=nullptr;
 	usize size=cfc::invalid_index;
 
+	// releases data when set (memory mapped files are unmapped), data is freed with free() otherwise
+	typedef void(*release_function)(u8* data, usize size);
+	release_function release=nullptr;
+
 	operator bool() { return size != cfc::invalid_index; }
 protected:
-	
+
+};
+
+// a read of a batch, see io::ReadAsync
+struct io_read_request
+{
+	const char* Path = nullptr;				// copied on submit
+	u64 Offset = 0;
+	usize Size = cfc::invalid_index;		// invalid_index reads up to the end of the file
+	void* Destination = nullptr;			// caller provided memory, the result owns a new buffer when there is none
+	usize DestinationSize = 0;
+	void* UserData = nullptr;
 };
 
+struct io_read_result
+{
+	usize RequestIndex = 0;					// index in the submitted batch
+	void* UserData = nullptr;
+	bool Succeeded = false;
+	u8* Data = nullptr;						// the destination of the request or the data of Buffer
+	usize Size = 0;							// bytes read
+	iobuffer Buffer;						// owns the data of requests without destination, move it out to keep it
+};
+
+// called on an io worker once per request, the batch completes after the callback of its last request returned
+typedef stl_function<void(io_read_result& result)> io_read_callback;
+
+// completion of a submitted batch, destroy it after Wait returned (not after IsComplete, a worker can still be signaling)
+class CFC_API io_batch
+{
+public:
+	io_batch() : m_numPending(0), m_numFailed(0) {}
+
+	bool IsComplete() const { return m_numPending.load(std::memory_order_acquire) == 0; }
+	void Wait();
+	usize GetFailedQuantity() const { return m_numFailed.load(std::memory_order_relaxed); }
+
+protected:
+	io_batch(const io_batch& o) {}
+	void operator = (const io_batch& o) {}
+
+private:
+	friend class io;
+	friend class _imp_io_queue;
+
+	std::atomic<usize> m_numPending;
+	std::atomic<usize> m_numFailed;
+	std::mutex m_lock;
+	std::condition_variable m_completed;
+};
+
+class _imp_io_queue;
+
 class CFC_API io : public object
 {
 public:
+	io() {}
+	virtual ~io();
+
 	virtual u32_64 GetFileSize(const char* path) { return 0; }
 	virtual bool Exists(const char* path) { return false; }
 	virtual iobuffer ReadFileToMemory(const char* path) { return iobuffer(); }
+	virtual bool WriteMemoryToFile(const char* path, const void* data, usize size) { return false; }
 	virtual bool ShowOpenFileDialog(const char* filter, char* destination, i32 destinationBufferSize) { return false; }
+
+	// reads up to size bytes at offset, called concurrently by the io workers (platforms read without a shared file position)
+	virtual bool ReadFileRange(const char* path, u64 offset, void* destination, usize size, usize& numReadOUT);
+
+	// Queues the reads of a batch and returns, the reads complete out of order on the io workers. Whole file reads without a
+	// destination go through ReadFileToMemory (memory mapped where the platform supports it), the other reads through
+	// ReadFileRange into the destination or a buffer of the result.
+	// NOTE: a batch can only be submitted once at a time, submit a batch again after it completed
+	// NOTE: batches have to be completed before the io is destroyed
+	void ReadAsync(const io_read_request* requests, usize numRequests, io_batch& batch, io_read_callback callback = io_read_callback());
+
+protected:
+	io(const io& o) {}
+	void operator = (const io& o) {}
+
+private:
+	std::mutex m_queueLock;
+	_imp_io_queue* m_queue = nullptr;		// workers start with the first batch
 };
 
-CFC_END_NAMESPACE1(cfc)
\ No newline at end of file
+CFC_END_NAMESPACE1(cfc)
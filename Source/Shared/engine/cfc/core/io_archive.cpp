@@ -0,0 +1,350 @@
+#include "io_archive.h"
+#include "compression.h"
+
+#include <cfc/stl/stl_algorithm.hpp>
+
+#include <stdlib.h>
+#include <string.h>
+
+CFC_NAMESPACE1(cfc)
+
+static inline char lowerPathChar(char c)
+{
+	return c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c;
+}
+
+// orders entries like the builder does, by hash and then by lower case path
+static int comparePath(u64 hashA, const char* pathA, usize lengthA, u64 hashB, const char* pathB, usize lengthB)
+{
+	if (hashA != hashB)
+		return hashA < hashB ? -1 : 1;
+
+	const usize length = lengthA < lengthB ? lengthA : lengthB;
+	for (usize i = 0; i < length; ++i)
+	{
+		const char a = lowerPathChar(pathA[i]);
+		const char b = lowerPathChar(pathB[i]);
+		if (a != b)
+			return (u8)a < (u8)b ? -1 : 1;
+	}
+	return lengthA == lengthB ? 0 : (lengthA < lengthB ? -1 : 1);
+}
+
+io_archive::~io_archive()
+{
+	Close();
+}
+
+bool io_archive::Open(const char* path)
+{
+	Close();
+
+	iobuffer archive = m_fallback.ReadFileToMemory(path);
+	if (!archive || archive.size < sizeof(io_archive_header))
+		return false;
+
+	// NOTE: everything is validated once here, lookups and reads trust the table afterwards
+	const io_archive_header* header = (const io_archive_header*)archive.data;
+	if (header->Magic != CFC_ARCHIVE_MAGIC || header->Version != CFC_ARCHIVE_VERSION || header->DataSize != archive.size)
+		return false;
+	if (header->EntriesOffset > archive.size || (archive.size - header->EntriesOffset) / sizeof(io_archive_entry) < header->NumEntries)
+		return false;
+	if (header->NamesOffset > archive.size || header->NamesSize > archive.size - header->NamesOffset)
+		return false;
+
+	const io_archive_entry* entries = (const io_archive_entry*)(archive.data + header->EntriesOffset);
+	const char* names = (const char*)(archive.data + header->NamesOffset);
+	for (u32 i = 0; i < header->NumEntries; ++i)
+	{
+		const io_archive_entry& entry = entries[i];
+		if (entry.Offset > archive.size || entry.StoredSize > archive.size - entry.Offset)
+			return false;
+		if ((u64)entry.PathOffset + entry.PathLength > header->NamesSize)
+			return false;
+		if ((entry.Flags & io_archive_entry_flags::Compressed) == 0 && entry.StoredSize != entry.Size)
+			return false;
+		if (i > 0 && comparePath(entries[i - 1].PathHash, names + entries[i - 1].PathOffset, entries[i - 1].PathLength, entry.PathHash, names + entry.PathOffset, entry.PathLength) >= 0)
+			return false;
+	}
+
+	m_archive = archive;
+	m_header = (const io_archive_header*)m_archive.data;
+	m_entries = entries;
+	m_names = names;
+	return true;
+}
+
+void io_archive::Close()
+{
+	m_archive = iobuffer();
+	m_header = nullptr;
+	m_entries = nullptr;
+	m_names = nullptr;
+}
+
+const io_archive_entry* io_archive::FindEntry(const char* path) const
+{
+	if (m_header == nullptr)
+		return nullptr;
+
+	char normalized[CFC_ARCHIVE_MAX_PATH];
+	const usize length = NormalizePath(path, normalized, sizeof(normalized));
+	if (length == cfc::invalid_index)
+		return nullptr;
+	const u64 hash = HashPath(normalized, length);
+
+	usize first = 0;
+	usize last = m_header->NumEntries;
+	while (first < last)
+	{
+		const usize middle = first + (last - first) / 2;
+		const io_archive_entry& entry = m_entries[middle];
+		const int order = comparePath(entry.PathHash, m_names + entry.PathOffset, entry.PathLength, hash, normalized, length);
+		if (order == 0)
+			return &entry;
+		if (order < 0)
+			first = middle + 1;
+		else
+			last = middle;
+	}
+	return nullptr;
+}
+
+bool io_archive::readEntry(const io_archive_entry& entry, u8* destination) const
+{
+	const u8* stored = m_archive.data + entry.Offset;
+	if ((entry.Flags & io_archive_entry_flags::Compressed) != 0)
+		return compression::DecompressLZ(stored, (usize)entry.StoredSize, destination, (usize)entry.Size);
+
+	memcpy(destination, stored, (usize)entry.Size);
+	return true;
+}
+
+u32_64 io_archive::GetFileSize(const char* path)
+{
+	if (const io_archive_entry* entry = FindEntry(path))
+		return (u32_64)entry->Size;
+	return m_fallback.GetFileSize(path);
+}
+
+bool io_archive::Exists(const char* path)
+{
+	return FindEntry(path) != nullptr || m_fallback.Exists(path);
+}
+
+iobuffer io_archive::ReadFileToMemory(const char* path)
+{
+	const io_archive_entry* entry = FindEntry(path);
+	if (entry == nullptr)
+		return m_fallback.ReadFileToMemory(path);
+
+	// NOTE: always a copy, callers own the buffer and some parse in place (json)
+	iobuffer outBuffer;
+	outBuffer.data = (u8*)malloc(entry->Size > 0 ? (usize)entry->Size : 1);
+	outBuffer.size = (usize)entry->Size;
+	if (!readEntry(*entry, outBuffer.data))
+		outBuffer = iobuffer();
+	return outBuffer;
+}
+
+bool io_archive::ReadFileRange(const char* path, u64 offset, void* destination, usize size, usize& numReadOUT)
+{
+	const io_archive_entry* entry = FindEntry(path);
+	if (entry == nullptr)
+		return m_fallback.ReadFileRange(path, offset, destination, size, numReadOUT);
+
+	numReadOUT = 0;
+	if (offset >= entry->Size)
+		return true;
+	const usize numAvailable = (usize)(entry->Size - offset);
+	const usize numRead = size < numAvailable ? size : numAvailable;
+
+	if ((entry->Flags & io_archive_entry_flags::Compressed) == 0)
+	{
+		memcpy(destination, m_archive.data + entry->Offset + offset, numRead);
+		numReadOUT = numRead;
+		return true;
+	}
+
+	// compressed entries have no random access, the whole entry is decoded
+	iobuffer decoded = ReadFileToMemory(path);
+	if (!decoded)
+		return false;
+	memcpy(destination, decoded.data + offset, numRead);
+	numReadOUT = numRead;
+	return true;
+}
+
+bool io_archive::WriteMemoryToFile(const char* path, const void* data, usize size)
+{
+	// NOTE: the file is written loose, an entry with the same path in the archive still shadows it
+	return m_fallback.WriteMemoryToFile(path, data, size);
+}
+
+bool io_archive::ShowOpenFileDialog(const char* filter, char* destination, i32 destinationBufferSize)
+{
+	return m_fallback.ShowOpenFileDialog(filter, destination, destinationBufferSize);
+}
+
+usize io_archive::NormalizePath(const char* path, char* destination, usize destinationSize)
+{
+	// archives only hold relative paths ("/a", "\\server\a" and "c:\a" are not in it)
+	if (path[0] == '/' || path[0] == '\\' || (path[0] != 0 && path[1] == ':'))
+		return cfc::invalid_index;
+
+	usize length = 0;
+	while (*path != 0)
+	{
+		const char* segment = path;
+		while (*path != 0 && *path != '/' && *path != '\\')
+			path++;
+		const usize segmentLength = (usize)(path - segment);
+		if (*path != 0)
+			path++;
+
+		if (segmentLength == 0 || (segmentLength == 1 && segment[0] == '.'))
+			continue;
+
+		if (segmentLength == 2 && segment[0] == '.' && segment[1] == '.')
+		{
+			if (length == 0)
+				return cfc::invalid_index;
+			while (length > 0 && destination[length - 1] != '/')
+				length--;
+			if (length > 0)
+				length--;
+			continue;
+		}
+
+		const usize separator = length > 0 ? 1 : 0;
+		if (length + separator + segmentLength + 1 > destinationSize)
+			return cfc::invalid_index;
+		if (separator)
+			destination[length++] = '/';
+		memcpy(destination + length, segment, segmentLength);
+		length += segmentLength;
+	}
+
+	if (destinationSize == 0)
+		return cfc::invalid_index;
+	destination[length] = 0;
+	return length;
+}
+
+u64 io_archive::HashPath(const char* normalizedPath, usize length)
+{
+	u64 hash = 0xCBF29CE484222325ULL;
+	for (usize i = 0; i < length; ++i)
+		hash = (hash ^ (u64)(u8)lowerPathChar(normalizedPath[i])) * 0x100000001B3ULL;
+	return hash;
+}
+
+#pragma region Builder
+
+bool io_archive_builder::AddFile(const char* path, const void* data, usize size)
+{
+	char normalized[CFC_ARCHIVE_MAX_PATH];
+	const usize length = io_archive::NormalizePath(path, normalized, sizeof(normalized));
+	if (length == cfc::invalid_index || length == 0)
+		return false;
+
+	m_files.push_back(file());
+	file& f = m_files.back();
+	f.Path.assign(normalized, length);
+	f.PathHash = io_archive::HashPath(normalized, length);
+	f.Size = size;
+	f.Flags = 0;
+
+	if (m_compress && size > 0)
+	{
+		f.Data.resize(compression::GetCompressBound(size));
+		const usize compressedSize = compression::CompressLZ((const u8*)data, size, &f.Data[0], f.Data.size());
+		if (compressedSize > 0 && compressedSize <= size - size / 8)
+		{
+			f.Data.resize(compressedSize);
+			f.Flags |= io_archive_entry_flags::Compressed;
+		}
+	}
+	if ((f.Flags & io_archive_entry_flags::Compressed) == 0)
+		f.Data.assign((const u8*)data, (const u8*)data + size);
+
+	// the builder holds the whole archive, release the slack of the compression bound
+	f.Data.shrink_to_fit();
+
+	m_size += f.Size;
+	m_storedSize += f.Data.size();
+	return true;
+}
+
+bool io_archive_builder::Write(io& fileIO, const char* path) const
+{
+	const u64 alignment = m_alignment > 0 ? m_alignment : 1;
+	auto alignUp = [alignment](u64 v) { return (v + alignment - 1) / alignment * alignment; };
+
+	stl_vector<u32> order(m_files.size());
+	for (u32 i = 0; i < (u32)order.size(); ++i)
+		order[i] = i;
+	std::sort(order.begin(), order.end(), [this](u32 a, u32 b)
+	{
+		const file& fa = m_files[a];
+		const file& fb = m_files[b];
+		return comparePath(fa.PathHash, fa.Path.c_str(), fa.Path.size(), fb.PathHash, fb.Path.c_str(), fb.Path.size()) < 0;
+	});
+
+	io_archive_header header;
+	memset(&header, 0, sizeof(header));
+	header.Magic = CFC_ARCHIVE_MAGIC;
+	header.Version = CFC_ARCHIVE_VERSION;
+	header.NumEntries = (u32)m_files.size();
+	header.Alignment = (u32)alignment;
+	header.EntriesOffset = sizeof(io_archive_header);
+	header.NamesOffset = header.EntriesOffset + sizeof(io_archive_entry) * m_files.size();
+
+	stl_vector<io_archive_entry> entries(m_files.size());
+	for (usize i = 0; i < order.size(); ++i)
+	{
+		const file& f = m_files[order[i]];
+		if (i > 0)
+		{
+			const file& previous = m_files[order[i - 1]];
+			if (comparePath(previous.PathHash, previous.Path.c_str(), previous.Path.size(), f.PathHash, f.Path.c_str(), f.Path.size()) == 0)
+				return false;
+		}
+
+		io_archive_entry& entry = entries[i];
+		memset(&entry, 0, sizeof(entry));
+		entry.PathHash = f.PathHash;
+		entry.Size = f.Size;
+		entry.StoredSize = f.Data.size();
+		entry.PathOffset = (u32)header.NamesSize;
+		entry.PathLength = (u32)f.Path.size();
+		entry.Flags = f.Flags;
+		header.NamesSize += f.Path.size();
+	}
+
+	// the data follows the names, every entry starts aligned
+	u64 offset = alignUp(header.NamesOffset + header.NamesSize);
+	for (usize i = 0; i < entries.size(); ++i)
+	{
+		entries[i].Offset = offset;
+		offset = alignUp(offset + entries[i].StoredSize);
+	}
+	header.DataSize = offset;
+
+	stl_vector<u8> archive((usize)header.DataSize, 0);
+	memcpy(&archive[0], &header, sizeof(header));
+	if (!entries.empty())
+		memcpy(&archive[(usize)header.EntriesOffset], &entries[0], sizeof(io_archive_entry) * entries.size());
+	for (usize i = 0; i < order.size(); ++i)
+	{
+		const file& f = m_files[order[i]];
+		memcpy(&archive[(usize)(header.NamesOffset + entries[i].PathOffset)], f.Path.c_str(), f.Path.size());
+		if (!f.Data.empty())
+			memcpy(&archive[(usize)entries[i].Offset], &f.Data[0], f.Data.size());
+	}
+	return fileIO.WriteMemoryToFile(path, &archive[0], archive.size());
+}
+
+#pragma endregion
+
+CFC_END_NAMESPACE1(cfc)
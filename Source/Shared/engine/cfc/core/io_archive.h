@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cfc/base.h>
+#include <cfc/core/io.h>
+
+#include <cfc/stl/stl_string.hpp>
+#include <cfc/stl/stl_vector.hpp>
+
+#define CFC_ARCHIVE_MAGIC 0x4B415043		// 'CPAK'
+#define CFC_ARCHIVE_VERSION 1
+#define CFC_ARCHIVE_EXTENSION ".cfcpack"
+
+// entry data starts at a multiple of this, stored entries can be used in place with aligned loads
+#define CFC_ARCHIVE_DEFAULT_ALIGNMENT 64
+#define CFC_ARCHIVE_MAX_PATH 512
+
+CFC_NAMESPACE1(cfc)
+
+// Layout: header, entry table (sorted by PathHash, then path), path names (not terminated), entry data.
+// NOTE: all offsets are from the start of the archive, the layout is little endian and read in place
+struct io_archive_header
+{
+	u32 Magic;
+	u32 Version;
+	u32 NumEntries;
+	u32 Alignment;
+	u64 EntriesOffset;
+	u64 NamesOffset;
+	u64 NamesSize;
+	u64 DataSize;							// size of the whole archive
+};
+
+struct io_archive_entry_flags
+{
+	enum Enumeration : u32
+	{
+		Compressed = 1,						// cfc::compression::CompressLZ
+	};
+};
+
+struct io_archive_entry
+{
+	u64 PathHash;							// io_archive::HashPath of the normalized path
+	u64 Offset;
+	u64 Size;								// size of the file
+	u64 StoredSize;							// size in the archive, equal to Size when stored uncompressed
+	u32 PathOffset;							// from NamesOffset
+	u32 PathLength;
+	u32 Flags;
+	u32 Reserved;
+};
+
+// Resolves paths inside a packed archive, paths that are not in it (and all writes) go to the fallback io. The archive is
+// read with the fallback's ReadFileToMemory once (memory mapped by the platforms), lookups are a binary search in the
+// mapped table of contents and reads copy or decompress from the mapping. A startup that reads its content from an
+// archive does a single open instead of an open, a seek and a read per file.
+// Paths are matched relative to the directory the archive was built from, case insensitive and with '\' and '/' both
+// as separator ("./Textures\\a.jpg" resolves "textures/a.jpg").
+// NOTE: read only after Open, concurrent reads (io workers) do not lock
+class CFC_API io_archive : public io
+{
+public:
+	explicit io_archive(io& fallback) : m_fallback(fallback) {}
+	~io_archive();
+
+	bool Open(const char* path);
+	void Close();
+	bool IsOpen() const										{ return m_header != nullptr; }
+
+	u32 GetEntryQuantity() const							{ return m_header != nullptr ? m_header->NumEntries : 0; }
+	const io_archive_entry* GetEntries() const				{ return m_entries; }
+	const char* GetEntryPath(const io_archive_entry& entry) const { return m_names + entry.PathOffset; }
+	const io_archive_entry* FindEntry(const char* path) const;
+
+	virtual u32_64 GetFileSize(const char* path);
+	virtual bool Exists(const char* path);
+	virtual iobuffer ReadFileToMemory(const char* path);
+	virtual bool ReadFileRange(const char* path, u64 offset, void* destination, usize size, usize& numReadOUT);
+	virtual bool WriteMemoryToFile(const char* path, const void* data, usize size);
+	virtual bool ShowOpenFileDialog(const char* filter, char* destination, i32 destinationBufferSize);
+
+	// removes "." and empty segments, folds ".." and converts '\' to '/', returns the length or invalid_index when the
+	// path does not fit, is absolute or leaves the root
+	static usize NormalizePath(const char* path, char* destination, usize destinationSize);
+	// FNV-1a of the lower case path
+	static u64 HashPath(const char* normalizedPath, usize length);
+
+protected:
+	io_archive(const io_archive& o) : m_fallback(o.m_fallback) {}
+	void operator = (const io_archive& o) {}
+
+	bool readEntry(const io_archive_entry& entry, u8* destination) const;
+
+	io& m_fallback;
+	iobuffer m_archive;
+	const io_archive_header* m_header = nullptr;
+	const io_archive_entry* m_entries = nullptr;
+	const char* m_names = nullptr;
+};
+
+// Collects files in memory and writes them as an archive (see the CFC.Tool.Archive project for the command line tool).
+// Files are compressed when that saves at least an eighth, most images stay stored.
+class CFC_API io_archive_builder
+{
+public:
+	explicit io_archive_builder(u32 alignment = CFC_ARCHIVE_DEFAULT_ALIGNMENT, bool compress = true) : m_alignment(alignment), m_compress(compress) {}
+
+	// copies the data, fails on paths NormalizePath rejects
+	bool AddFile(const char* path, const void* data, usize size);
+
+	usize GetFileQuantity() const							{ return m_files.size(); }
+	u64 GetSize() const										{ return m_size; }
+	u64 GetStoredSize() const								{ return m_storedSize; }
+
+	// fails when two files resolve to the same path
+	bool Write(io& fileIO, const char* path) const;
+
+protected:
+	io_archive_builder(const io_archive_builder& o) {}
+	void operator = (const io_archive_builder& o) {}
+
+	struct file
+	{
+		stl_string Path;
+		u64 PathHash;
+		u64 Size;
+		u32 Flags;
+		stl_vector<u8> Data;
+	};
+
+	stl_vector<file> m_files;
+	u32 m_alignment;
+	bool m_compress;
+	u64 m_size = 0;
+	u64 m_storedSize = 0;
+};
+
+CFC_END_NAMESPACE1(cfc)
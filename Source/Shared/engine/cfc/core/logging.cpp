@@ -0,0 +1,695 @@
+#include "logging.h"
+
+#include <cfc/stl/stl_vector.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// an idle logging thread checks the rings this often, producers wake it earlier when a ring fills up
+#define CFC_LOG_IDLE_WAIT_MS 10
+
+// severities that are never dropped, the producer waits for room instead
+#define CFC_LOG_BLOCKING_FLAGS (cfc::logflags::SevCritical | cfc::logflags::SevAssert | cfc::logflags::SevCrash)
+
+// severities that flush the log before returning, the process is likely about to stop
+#define CFC_LOG_FLUSHING_FLAGS (cfc::logflags::SevAssert | cfc::logflags::SevCrash)
+
+CFC_NAMESPACE1(cfc)
+
+#pragma region Ring
+
+struct _log_record
+{
+	u32 Size;						// including this header, records are 8 byte aligned
+	u32 Flags;
+	const char* Format;				// nullptr: padding up to the end of the ring
+	u64 Time;
+};
+
+// single producer (the thread that owns it) single consumer (the logging thread) ring of records
+// NOTE: a record never wraps, the producer pads the end of the ring when the record does not fit in one piece
+struct _log_ring
+{
+	_log_ring() : Head(0), Tail(0), Dropped(0), RefCount(2), Orphaned(false), PendingSize(0) {}
+
+	u8* Reserve(usize size)
+	{
+		const u64 head = Head.load(std::memory_order_relaxed);
+		const u64 tail = Tail.load(std::memory_order_acquire);
+		const usize offset = (usize)(head & (CFC_LOG_RING_SIZE - 1));
+		const usize contiguous = CFC_LOG_RING_SIZE - offset;
+		const usize padding = contiguous < size ? contiguous : 0;
+
+		if (CFC_LOG_RING_SIZE - (head - tail) < padding + size)
+			return nullptr;
+
+		// NOTE: an end of the ring shorter than a record header is padding without a header, the consumer skips it the same way
+		u64 writeHead = head;
+		if (padding >= sizeof(_log_record))
+		{
+			_log_record* pad = reinterpret_cast<_log_record*>(Data + offset);
+			pad->Size = (u32)padding;
+			pad->Format = nullptr;
+		}
+		writeHead += padding;
+
+		PendingHead = writeHead;
+		PendingSize = size;
+		return Data + (usize)(writeHead & (CFC_LOG_RING_SIZE - 1));
+	}
+
+	// returns true when the ring just crossed half of its capacity
+	bool Commit()
+	{
+		const u64 tail = Tail.load(std::memory_order_relaxed);
+		const u64 previousHead = Head.load(std::memory_order_relaxed);
+		const u64 head = PendingHead + PendingSize;
+		Head.store(head, std::memory_order_release);
+		return previousHead - tail < CFC_LOG_RING_SIZE / 2 && head - tail >= CFC_LOG_RING_SIZE / 2;
+	}
+
+	// consumer only, skips padding and returns the next record or nullptr
+	const _log_record* Peek()
+	{
+		u64 tail = Tail.load(std::memory_order_relaxed);
+		const u64 head = Head.load(std::memory_order_acquire);
+		while (tail != head)
+		{
+			const usize offset = (usize)(tail & (CFC_LOG_RING_SIZE - 1));
+			const usize contiguous = CFC_LOG_RING_SIZE - offset;
+			if (contiguous < sizeof(_log_record))
+			{
+				tail += contiguous;
+				Tail.store(tail, std::memory_order_release);
+				continue;
+			}
+
+			const _log_record* record = reinterpret_cast<const _log_record*>(Data + offset);
+			if (record->Format != nullptr)
+				return record;
+
+			tail += record->Size;
+			Tail.store(tail, std::memory_order_release);
+		}
+		return nullptr;
+	}
+	void Pop(const _log_record* record) { Tail.store(Tail.load(std::memory_order_relaxed) + record->Size, std::memory_order_release); }
+
+	// NOTE: the producer and the consumer indices are on separate cache lines
+	alignas(64) std::atomic<u64> Head;
+	alignas(64) std::atomic<u64> Tail;
+	alignas(64) std::atomic<u32> Dropped;
+	std::atomic<int> RefCount;					// owning thread and logger
+	std::atomic<bool> Orphaned;					// the owning thread exited
+
+	// producer only
+	u64 PendingHead;
+	usize PendingSize;
+
+	alignas(64) u8 Data[CFC_LOG_RING_SIZE];
+};
+
+// NOTE: new does not honour alignas(64) before C++17, the ring is placed in storage aligned by hand with the pointer to
+// free in front of it
+static _log_ring* createRing()
+{
+	void* storage = malloc(sizeof(_log_ring) + 64);
+	u8* aligned = (u8*)(((uintptr_t)storage + 64) & ~(uintptr_t)63);
+	((void**)aligned)[-1] = storage;
+	return new (aligned) _log_ring();
+}
+
+static void releaseRing(_log_ring* ring)
+{
+	if (ring->RefCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		return;
+
+	void* storage = ((void**)ring)[-1];
+	ring->~_log_ring();
+	free(storage);
+}
+
+static std::atomic<u64> g_loggerIdCounter(0);
+
+// ring of the calling thread, bound to a single logger at a time
+struct _log_thread_ring
+{
+	~_log_thread_ring()
+	{
+		if (Ring == nullptr)
+			return;
+		Ring->Orphaned.store(true, std::memory_order_release);
+		releaseRing(Ring);
+	}
+
+	_log_ring* Ring = nullptr;
+	u64 LoggerId = 0;
+};
+
+static thread_local _log_thread_ring g_threadRing;
+
+#pragma endregion
+#pragma region Formatting
+
+static usize appendText(char* dst, usize pos, usize capacity, const char* src, usize length)
+{
+	if (pos + length > capacity)
+		length = capacity - pos;
+	memcpy(dst + pos, src, length);
+	return pos + length;
+}
+
+// formats a single argument with the conversion of the format, the length modifier follows from the stored type
+static usize appendArg(char* dst, usize pos, usize capacity, const char* spec, usize specLength, char conversion, const _log_arg& arg, const char* str)
+{
+	// spec holds the flags, width and precision, without the length modifier and the conversion
+	char fmt[64];
+	if (specLength > sizeof(fmt) - 4)
+		specLength = sizeof(fmt) - 4;
+	memcpy(fmt, spec, specLength);
+
+	double d;
+	memcpy(&d, &arg.Value, sizeof(d));
+
+	int written = 0;
+	switch (conversion)
+	{
+	case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c':
+	{
+		memcpy(fmt + specLength, "ll", 2);
+		fmt[specLength + 2] = conversion;
+		fmt[specLength + 3] = 0;
+		const u64 value = arg.ArgType == _log_arg::Double ? (u64)(i64)d : arg.Value;
+		if (conversion == 'c')
+		{
+			fmt[specLength] = 'c';
+			fmt[specLength + 1] = 0;
+			written = snprintf(dst + pos, capacity - pos + 1, fmt, (int)value);
+		}
+		else if (conversion == 'd' || conversion == 'i')
+			written = snprintf(dst + pos, capacity - pos + 1, fmt, (long long)value);
+		else
+			written = snprintf(dst + pos, capacity - pos + 1, fmt, (unsigned long long)value);
+		break;
+	}
+	case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+	{
+		fmt[specLength] = conversion;
+		fmt[specLength + 1] = 0;
+		const double value = arg.ArgType == _log_arg::Double ? d : arg.ArgType == _log_arg::Int ? (double)(i64)arg.Value : (double)arg.Value;
+		written = snprintf(dst + pos, capacity - pos + 1, fmt, value);
+		break;
+	}
+	case 's':
+	{
+		fmt[specLength] = 's';
+		fmt[specLength + 1] = 0;
+		const char* value = arg.ArgType == _log_arg::String && arg.Value != 0 ? str : "(null)";
+		written = snprintf(dst + pos, capacity - pos + 1, fmt, value);
+		break;
+	}
+	case 'p':
+		fmt[specLength] = 'p';
+		fmt[specLength + 1] = 0;
+		written = snprintf(dst + pos, capacity - pos + 1, fmt, (void*)(usize)arg.Value);
+		break;
+	default:
+		break;
+	}
+
+	if (written < 0)
+		return pos;
+	return pos + (usize)written > capacity ? capacity : pos + (usize)written;
+}
+
+// printf compatible formatting of a record, returns the length of the zero terminated message
+static usize formatRecord(const _log_record* record, char* dst, usize capacity)
+{
+	const u8* args = reinterpret_cast<const u8*>(record + 1);
+	const u8* argsEnd = reinterpret_cast<const u8*>(record) + record->Size;
+
+	// reserve the terminator
+	capacity -= 1;
+
+	usize pos = 0;
+	const char* format = record->Format;
+	while (*format != 0 && pos < capacity)
+	{
+		const char* percent = strchr(format, '%');
+		if (percent == nullptr)
+		{
+			pos = appendText(dst, pos, capacity, format, strlen(format));
+			break;
+		}
+
+		pos = appendText(dst, pos, capacity, format, (usize)(percent - format));
+		format = percent + 1;
+		if (*format == '%')
+		{
+			pos = appendText(dst, pos, capacity, "%", 1);
+			format++;
+			continue;
+		}
+
+		// flags, width and precision, a '*' takes its value from the arguments
+		char spec[64];
+		usize specLength = 0;
+		spec[specLength++] = '%';
+		while (*format != 0 && strchr("-+ #0123456789.*", *format) != nullptr && specLength < sizeof(spec) - 24)
+		{
+			if (*format == '*')
+			{
+				int value = 0;
+				if (args + sizeof(_log_arg) <= argsEnd)
+				{
+					_log_arg arg;
+					memcpy(&arg, args, sizeof(arg));
+					args += sizeof(arg) + (arg.ArgType == _log_arg::String ? _log_arg::AlignedStringSize(arg.Length) : 0);
+					value = (int)(i64)arg.Value;
+				}
+				specLength += snprintf(spec + specLength, sizeof(spec) - specLength, "%d", value);
+			}
+			else
+				spec[specLength++] = *format;
+			format++;
+		}
+
+		// length modifiers are ignored, the stored type decides
+		while (*format != 0 && strchr("hljztLIq", *format) != nullptr)
+		{
+			if (format[0] == 'I' && ((format[1] == '6' && format[2] == '4') || (format[1] == '3' && format[2] == '2')))
+				format += 2;
+			format++;
+		}
+
+		const char conversion = *format;
+		if (conversion == 0)
+			break;
+		format++;
+
+		if (conversion == 'n' || args + sizeof(_log_arg) > argsEnd)
+			continue;
+
+		_log_arg arg;
+		memcpy(&arg, args, sizeof(arg));
+		args += sizeof(arg);
+		const char* str = reinterpret_cast<const char*>(args);
+		if (arg.ArgType == _log_arg::String)
+			args += _log_arg::AlignedStringSize(arg.Length);
+
+		pos = appendArg(dst, pos, capacity, spec, specLength, conversion, arg, str);
+	}
+
+	dst[pos] = 0;
+	return pos;
+}
+
+#pragma endregion
+#pragma region Sinks
+
+void log_sink_stdout::Write(u32 flags, u64 timeNanoSeconds, const char* message, usize length)
+{
+	fwrite(message, 1, length, stdout);
+	if (length == 0 || message[length - 1] != '\n')
+		fputc('\n', stdout);
+}
+
+void log_sink_stdout::Flush()
+{
+	fflush(stdout);
+}
+
+log_sink_file::~log_sink_file()
+{
+	Close();
+}
+
+bool log_sink_file::Open(const char* path, bool append)
+{
+	Close();
+#ifdef _MSC_VER
+	FILE* file = nullptr;
+	if (fopen_s(&file, path, append ? "ab" : "wb") != 0)
+		file = nullptr;
+#else
+	FILE* file = fopen(path, append ? "ab" : "wb");
+#endif
+	m_file = file;
+	return file != nullptr;
+}
+
+void log_sink_file::Close()
+{
+	if (m_file != nullptr)
+		fclose((FILE*)m_file);
+	m_file = nullptr;
+}
+
+void log_sink_file::Write(u32 flags, u64 timeNanoSeconds, const char* message, usize length)
+{
+	if (m_file == nullptr)
+		return;
+
+	// the lowest severity bit that is set names the record
+	const char* severity = "Unknown";
+	for (u32 bit = logflags::SevProfiling; bit <= logflags::SevCrash; bit <<= 1)
+	{
+		if ((flags & bit) != 0)
+		{
+			severity = logflags().ToString((logflags::Enumeration)bit);
+			break;
+		}
+	}
+
+	FILE* file = (FILE*)m_file;
+	fprintf(file, "[%10.4f] [%s] ", (double)timeNanoSeconds / 1000000000.0, severity);
+	fwrite(message, 1, length, file);
+	if (length == 0 || message[length - 1] != '\n')
+		fputc('\n', file);
+}
+
+void log_sink_file::Flush()
+{
+	if (m_file != nullptr)
+		fflush((FILE*)m_file);
+}
+
+const char* logflags::ToString(Enumeration flag) const
+{
+	switch (flag)
+	{
+		case logflags::ScpApplication:			return "Application";
+		case logflags::ScpEngine:				return "Engine";
+		case logflags::SevAssert:				return "Assert";
+		case logflags::SevCrash:				return "Crash";
+		case logflags::SevCritical:				return "Critical";
+		case logflags::SevDebug:				return "Debug";
+		case logflags::SevInfo:					return "Info";
+		case logflags::SevError:				return "Major";
+		case logflags::SevWarning:				return "Minor";
+		case logflags::SevProfiling:			return "Profiling";
+		default:								return "Unknown";
+	}
+}
+
+#pragma endregion
+#pragma region Logging
+
+class _imp_logging
+{
+public:
+	u64 m_id;
+	std::chrono::steady_clock::time_point m_startTime;
+
+	// rings of every thread that logged, only the logging thread removes from it
+	std::mutex m_ringLock;
+	stl_vector<_log_ring*> m_rings;
+
+	std::mutex m_sinkLock;
+	stl_vector<log_sink*> m_sinks;
+	log_sink_stdout m_consoleSink;
+	bool m_consoleOutput;
+
+	std::mutex m_wakeLock;
+	std::condition_variable m_wakeCondition;
+	std::atomic<bool> m_wakeRequested;
+	std::atomic<bool> m_quit;
+
+	std::condition_variable m_flushCondition;
+	std::atomic<u64> m_flushRequested;
+	u64 m_flushCompleted;
+
+	std::atomic<u64> m_dropped;
+
+	std::thread m_thread;
+	char m_message[CFC_LOG_MESSAGE_MAX_SIZE];
+
+	_log_ring* GetThreadRing();
+	void Wake();
+	void ThreadMain();
+	bool Drain();
+	void WriteMessage(u32 flags, u64 time, const char* message, usize length);
+};
+
+_log_ring* _imp_logging::GetThreadRing()
+{
+	_log_thread_ring& threadRing = g_threadRing;
+	if (threadRing.LoggerId == m_id)
+		return threadRing.Ring;
+
+	// NOTE: a thread that alternates between loggers gets a new ring every switch
+	if (threadRing.Ring != nullptr)
+	{
+		threadRing.Ring->Orphaned.store(true, std::memory_order_release);
+		releaseRing(threadRing.Ring);
+	}
+
+	threadRing.Ring = createRing();
+	threadRing.LoggerId = m_id;
+
+	std::lock_guard<std::mutex> lock(m_ringLock);
+	m_rings.push_back(threadRing.Ring);
+	return threadRing.Ring;
+}
+
+void _imp_logging::Wake()
+{
+	m_wakeRequested.store(true, std::memory_order_release);
+	{
+		std::lock_guard<std::mutex> lock(m_wakeLock);
+	}
+	m_wakeCondition.notify_one();
+}
+
+void _imp_logging::WriteMessage(u32 flags, u64 time, const char* message, usize length)
+{
+	if (m_consoleOutput)
+		m_consoleSink.Write(flags, time, message, length);
+	for (usize i = 0; i < m_sinks.size(); ++i)
+		m_sinks[i]->Write(flags, time, message, length);
+}
+
+// writes every pending record in order of time, returns false when there was nothing to write
+bool _imp_logging::Drain()
+{
+	stl_vector<_log_ring*> rings;
+	{
+		std::lock_guard<std::mutex> lock(m_ringLock);
+		rings = m_rings;
+	}
+
+	std::lock_guard<std::mutex> sinkLock(m_sinkLock);
+	bool written = false;
+
+	for (usize i = 0; i < rings.size(); ++i)
+	{
+		const u32 dropped = rings[i]->Dropped.exchange(0, std::memory_order_relaxed);
+		if (dropped == 0)
+			continue;
+
+		m_dropped.fetch_add(dropped, std::memory_order_relaxed);
+		const int length = snprintf(m_message, sizeof(m_message), "Logging: %u records dropped, the ring of a thread was full.", dropped);
+		WriteMessage(logflags::ScpEngine | logflags::SevWarning, 0, m_message, (usize)length);
+		written = true;
+	}
+
+	// merge the rings, the oldest head record goes first
+	for (;;)
+	{
+		_log_ring* oldestRing = nullptr;
+		const _log_record* oldest = nullptr;
+		for (usize i = 0; i < rings.size(); ++i)
+		{
+			const _log_record* record = rings[i]->Peek();
+			if (record != nullptr && (oldest == nullptr || record->Time < oldest->Time))
+			{
+				oldest = record;
+				oldestRing = rings[i];
+			}
+		}
+		if (oldest == nullptr)
+			break;
+
+		const usize length = formatRecord(oldest, m_message, sizeof(m_message));
+		WriteMessage(oldest->Flags, oldest->Time, m_message, length);
+		oldestRing->Pop(oldest);
+		written = true;
+	}
+
+	// rings of threads that exited are released once they are empty
+	std::lock_guard<std::mutex> lock(m_ringLock);
+	for (usize i = 0; i < m_rings.size();)
+	{
+		_log_ring* ring = m_rings[i];
+		if (ring->Orphaned.load(std::memory_order_acquire) && ring->Peek() == nullptr)
+		{
+			m_rings[i] = m_rings.back();
+			m_rings.pop_back();
+			releaseRing(ring);
+		}
+		else
+			++i;
+	}
+
+	return written;
+}
+
+void _imp_logging::ThreadMain()
+{
+	for (;;)
+	{
+		const u64 flushRequested = m_flushRequested.load(std::memory_order_acquire);
+		const bool quit = m_quit.load(std::memory_order_acquire);
+
+		const bool written = Drain();
+
+		if (flushRequested != m_flushCompleted || quit)
+		{
+			{
+				std::lock_guard<std::mutex> sinkLock(m_sinkLock);
+				if (m_consoleOutput)
+					m_consoleSink.Flush();
+				for (usize i = 0; i < m_sinks.size(); ++i)
+					m_sinks[i]->Flush();
+			}
+
+			std::lock_guard<std::mutex> lock(m_wakeLock);
+			m_flushCompleted = flushRequested;
+			m_flushCondition.notify_all();
+		}
+
+		if (quit)
+			break;
+		if (written)
+			continue;
+
+		std::unique_lock<std::mutex> lock(m_wakeLock);
+		m_wakeCondition.wait_for(lock, std::chrono::milliseconds(CFC_LOG_IDLE_WAIT_MS), [this]() { return m_wakeRequested.load(std::memory_order_acquire); });
+		m_wakeRequested.store(false, std::memory_order_relaxed);
+	}
+}
+
+logging::logging()
+{
+	m_filter = ~0u;
+	m_impl = new _imp_logging();
+	m_impl->m_id = g_loggerIdCounter.fetch_add(1) + 1;
+	m_impl->m_startTime = std::chrono::steady_clock::now();
+	m_impl->m_consoleOutput = true;
+	m_impl->m_wakeRequested.store(false);
+	m_impl->m_quit.store(false);
+	m_impl->m_flushRequested.store(0);
+	m_impl->m_flushCompleted = 0;
+	m_impl->m_dropped.store(0);
+	m_impl->m_thread = std::thread([this]() { m_impl->ThreadMain(); });
+}
+
+logging::~logging()
+{
+	m_impl->m_quit.store(true, std::memory_order_release);
+	m_impl->Wake();
+	m_impl->m_thread.join();
+
+	// records logged after the last drain by threads that are still running are lost
+	for (usize i = 0; i < m_impl->m_rings.size(); ++i)
+		releaseRing(m_impl->m_rings[i]);
+	delete m_impl;
+}
+
+u8* logging::_BeginRecord(u32 flags, const char* format, usize argsSize)
+{
+	_log_ring* ring = m_impl->GetThreadRing();
+	const usize size = (sizeof(_log_record) + argsSize + 7) & ~(usize)7;
+	if (size > CFC_LOG_RING_SIZE / 2)
+	{
+		ring->Dropped.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	u8* dst = ring->Reserve(size);
+	while (dst == nullptr)
+	{
+		if ((flags & CFC_LOG_BLOCKING_FLAGS) == 0)
+		{
+			ring->Dropped.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		m_impl->Wake();
+		std::this_thread::yield();
+		dst = ring->Reserve(size);
+	}
+
+	_log_record* record = reinterpret_cast<_log_record*>(dst);
+	record->Size = (u32)size;
+	record->Flags = flags;
+	record->Format = format;
+	record->Time = (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_impl->m_startTime).count();
+	return dst + sizeof(_log_record);
+}
+
+void logging::_EndRecord()
+{
+	_log_ring* ring = g_threadRing.Ring;
+	const u32 flags = reinterpret_cast<const _log_record*>(ring->Data + (usize)(ring->PendingHead & (CFC_LOG_RING_SIZE - 1)))->Flags;
+
+	if (ring->Commit())
+		m_impl->Wake();
+
+	if ((flags & CFC_LOG_FLUSHING_FLAGS) != 0)
+		Flush();
+}
+
+void logging::Log(const char* msg, u32 flags/*=logflags::ScpEngine | logflags::SevInfo*/)
+{
+	Logf(flags, "%s", msg);
+}
+
+void logging::AddSink(log_sink* sink)
+{
+	std::lock_guard<std::mutex> lock(m_impl->m_sinkLock);
+	m_impl->m_sinks.push_back(sink);
+}
+
+void logging::RemoveSink(log_sink* sink)
+{
+	std::lock_guard<std::mutex> lock(m_impl->m_sinkLock);
+	for (usize i = 0; i < m_impl->m_sinks.size(); ++i)
+	{
+		if (m_impl->m_sinks[i] == sink)
+		{
+			m_impl->m_sinks.erase(m_impl->m_sinks.begin() + i);
+			break;
+		}
+	}
+}
+
+void logging::SetConsoleOutput(bool enabled)
+{
+	std::lock_guard<std::mutex> lock(m_impl->m_sinkLock);
+	m_impl->m_consoleOutput = enabled;
+}
+
+void logging::Flush()
+{
+	const u64 ticket = m_impl->m_flushRequested.fetch_add(1, std::memory_order_acq_rel) + 1;
+	m_impl->Wake();
+
+	std::unique_lock<std::mutex> lock(m_impl->m_wakeLock);
+	m_impl->m_flushCondition.wait(lock, [this, ticket]() { return m_impl->m_flushCompleted >= ticket; });
+}
+
+u64 logging::GetDroppedQuantity() const
+{
+	return m_impl->m_dropped.load(std::memory_order_relaxed);
+}
+
+#pragma endregion
+
+CFC_END_NAMESPACE1(cfc)
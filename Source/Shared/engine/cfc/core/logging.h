@@ -2,11 +2,22 @@
 
 #include <cfc/base.h>
 
+#include <string.h>
+#include <type_traits>
+
 CFC_NAMESPACE1(cfc)
 
 #define CFC_LOG_ASSERT(log, x) if((x) == false) { log->Logf(cfc::logflags::SevAssert, "Assertion failed: %s", #x); CFC_BREAKPOINT; }
 #define CFC_LOG_ASSERT_EXPLAIN(log, x, y) if((x) == false) { log->Logf(cfc::logflags::SevAssert, "Assertion failed: %s", y); CFC_BREAKPOINT; }
 
+// bytes of records a thread can have in flight, a full ring drops records below SevCritical
+#define CFC_LOG_RING_SIZE (64 * 1024)
+
+// longest formatted message, longer messages are truncated
+#define CFC_LOG_MESSAGE_MAX_SIZE (16 * 1024)
+
+class _imp_logging;
+
 struct logflags
 {
 	enum Enumeration
@@ -26,16 +37,158 @@ struct logflags
 	const char* ToString(Enumeration flag) const;
 };
 
+// destination of formatted messages, called from the logging thread only
+class CFC_API log_sink
+{
+public:
+	virtual ~log_sink() {}
+
+	// timeNanoSeconds is relative to the creation of the logger, message is zero terminated
+	virtual void Write(u32 flags, u64 timeNanoSeconds, const char* message, usize length) = 0;
+	virtual void Flush() {}
+};
+
+class CFC_API log_sink_stdout : public log_sink
+{
+public:
+	virtual void Write(u32 flags, u64 timeNanoSeconds, const char* message, usize length) override;
+	virtual void Flush() override;
+};
+
+class CFC_API log_sink_file : public log_sink
+{
+public:
+	log_sink_file() : m_file(nullptr) {}
+	~log_sink_file();
+
+	bool Open(const char* path, bool append = false);
+	void Close();
+
+	virtual void Write(u32 flags, u64 timeNanoSeconds, const char* message, usize length) override;
+	virtual void Flush() override;
+
+protected:
+	log_sink_file(const log_sink_file& o) {}
+	void operator = (const log_sink_file& o) {}
+
+private:
+	void* m_file;
+};
+
+// Asynchronous logger, Logf stores the format pointer and the arguments in a lock-free ring of the calling thread and a
+// background thread formats the records (in order of time) and writes them to the sinks. Records filtered out by the
+// mask cost a compare.
+// NOTE: the format has to outlive the logger (a string literal), string arguments are copied
 class CFC_API logging : public cfc::object
 {
 public:
+	logging();
+	~logging();
+
 	u32 GetFilterMask() const { return m_filter; }
 	void SetFilterMask(u32 allowedMask) { m_filter = allowedMask; }
+	bool IsEnabled(u32 flags) const { return (flags & ~m_filter) == 0; }
 
 	virtual void Log(const char* msg, u32 flags=logflags::ScpEngine | logflags::SevInfo);
-	void Logf(u32 flags, const char* format, ...);
+	template <class... Args> void Logf(u32 flags, const char* format, Args... args);
+
+	// the caller keeps ownership of the sink, the console sink is enabled by default
+	void AddSink(log_sink* sink);
+	void RemoveSink(log_sink* sink);
+	void SetConsoleOutput(bool enabled);
+
+	// blocks until every record logged before the call has been written and the sinks are flushed
+	void Flush();
+
+	// records that did not fit in the ring of their thread
+	u64 GetDroppedQuantity() const;
+
+	// internal, used by Logf
+	u8* _BeginRecord(u32 flags, const char* format, usize argsSize);
+	void _EndRecord();
+
+protected:
+	logging(const logging& o) {}
+	void operator = (const logging& o) {}
+
 private:
 	u32 m_filter;
+	_imp_logging* m_impl;
 };
 
-CFC_END_NAMESPACE1(cfc)
\ No newline at end of file
+#pragma region Record Arguments
+// arguments are packed as a type and an 8 byte value, strings are copied behind it (zero terminated, padded to 8 bytes)
+struct _log_arg
+{
+	enum Type
+	{
+		Int,
+		UInt,
+		Double,
+		Pointer,
+		String,
+	};
+
+	u32 ArgType;
+	u32 Length;
+	u64 Value;
+
+	static usize AlignedStringSize(usize length) { return (length + 1 + 7) & ~(usize)7; }
+
+	static usize Size() { return 0; }
+	template <class T, class... Args> static usize Size(T v, Args... args) { return argSize(v) + Size(args...); }
+
+	static void Write(u8* dst) {}
+	template <class T, class... Args> static void Write(u8* dst, T v, Args... args) { Write(writeArg(dst, v), args...); }
+
+private:
+	static usize stringLength(const char* v) { return v != nullptr ? strlen(v) : 0; }
+
+	static usize argSize(const char* v) { return sizeof(_log_arg) + AlignedStringSize(stringLength(v)); }
+	static usize argSize(char* v) { return argSize((const char*)v); }
+	template <class T> static usize argSize(T v) { return sizeof(_log_arg); }
+
+	static u8* writeValue(u8* dst, u32 type, u64 value)
+	{
+		_log_arg arg = { type, 0, value };
+		memcpy(dst, &arg, sizeof(arg));
+		return dst + sizeof(arg);
+	}
+
+	static u8* writeArg(u8* dst, const char* v)
+	{
+		const usize length = stringLength(v);
+		_log_arg arg = { String, (u32)length, v != nullptr ? 1ULL : 0ULL };
+		memcpy(dst, &arg, sizeof(arg));
+		dst += sizeof(arg);
+		if (length > 0)
+			memcpy(dst, v, length);
+		dst[length] = 0;
+		return dst + AlignedStringSize(length);
+	}
+	static u8* writeArg(u8* dst, char* v) { return writeArg(dst, (const char*)v); }
+	static u8* writeArg(u8* dst, double v) { u64 bits; memcpy(&bits, &v, sizeof(bits)); return writeValue(dst, Double, bits); }
+	static u8* writeArg(u8* dst, float v) { return writeArg(dst, (double)v); }
+	template <class T> static u8* writeArg(u8* dst, T* v) { return writeValue(dst, Pointer, (u64)(usize)v); }
+	template <class T> static typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, u8*>::type writeArg(u8* dst, T v)
+	{
+		return writeValue(dst, std::is_signed<T>::value ? Int : UInt, (u64)(i64)v);
+	}
+};
+#pragma endregion
+
+template <class... Args>
+void logging::Logf(u32 flags, const char* format, Args... args)
+{
+	if (!IsEnabled(flags))
+		return;
+
+	u8* dst = _BeginRecord(flags, format, _log_arg::Size(args...));
+	if (dst == nullptr)
+		return;
+
+	_log_arg::Write(dst, args...);
+	_EndRecord();
+}
+
+CFC_END_NAMESPACE1(cfc)
@@ -0,0 +1,277 @@
+#include "memory_tracker.h"
+
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+
+CFC_NAMESPACE1(cfc)
+
+#pragma region State
+
+// counters of a thread, written by the thread that owns the block only (a free is counted by the freeing thread)
+// NOTE: the block of an exited thread is handed to the next new thread, the sums stay valid
+struct _memory_thread
+{
+	std::atomic<i64> Bytes[memory_tag::Count];
+	std::atomic<u64> NumAllocations[memory_tag::Count];
+	std::atomic<u64> NumFrees[memory_tag::Count];
+	std::atomic<bool> InUse;
+	_memory_thread* Next;
+
+	bool Shared;						// only the block of exiting threads is written by more than one thread
+
+	void Add(u32 tag, i64 bytes, bool allocation)
+	{
+		std::atomic<u64>& num = allocation ? NumAllocations[tag] : NumFrees[tag];
+		if (Shared)
+		{
+			Bytes[tag].fetch_add(bytes, std::memory_order_relaxed);
+			num.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		// the owner is the only writer, a load and a store instead of a locked add
+		Bytes[tag].store(Bytes[tag].load(std::memory_order_relaxed) + bytes, std::memory_order_relaxed);
+		num.store(num.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+};
+
+// NOTE: blocks are never freed, the list only grows up to the highest number of threads alive at once
+static std::atomic<_memory_thread*> g_memoryThreads(nullptr);
+static std::atomic<i64> g_memoryPeak[memory_tag::Count];
+
+// zero initialized and pushed to the list on first use, see acquireMemoryThread
+static _memory_thread g_memoryExitingThread;
+
+static CFC_THREAD_LOCAL_STORAGE _memory_thread* g_tlsMemoryThread = nullptr;
+static CFC_THREAD_LOCAL_STORAGE u32 g_tlsMemoryTag = memory_tag::General;
+
+struct _memory_thread_owner
+{
+	~_memory_thread_owner()
+	{
+		if (Thread == nullptr)
+			return;
+
+		// what the thread still allocates or frees after this goes to the shared block, the own block is free for reuse
+		g_tlsMemoryThread = &g_memoryExitingThread;
+		Thread->InUse.store(false, std::memory_order_release);
+	}
+
+	_memory_thread* Thread = nullptr;
+};
+
+static thread_local _memory_thread_owner g_memoryThreadOwner;
+
+static void pushMemoryThread(_memory_thread* thread)
+{
+	thread->Next = g_memoryThreads.load(std::memory_order_relaxed);
+	while (!g_memoryThreads.compare_exchange_weak(thread->Next, thread, std::memory_order_release, std::memory_order_relaxed)) {}
+}
+
+static _memory_thread* acquireMemoryThread()
+{
+	// the shared block is in use forever, the first thread adds it to the list
+	static const bool s_exitingThreadPushed = []() { g_memoryExitingThread.Shared = true; g_memoryExitingThread.InUse = true; pushMemoryThread(&g_memoryExitingThread); return true; }();
+	(void)s_exitingThreadPushed;
+
+	for (_memory_thread* thread = g_memoryThreads.load(std::memory_order_acquire); thread != nullptr; thread = thread->Next)
+	{
+		bool expected = false;
+		if (!thread->InUse.load(std::memory_order_relaxed) && thread->InUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+			return thread;
+	}
+
+	// malloc, operator new would come back here
+	_memory_thread* thread = new (calloc(1, sizeof(_memory_thread))) _memory_thread();
+	for (u32 i = 0; i < memory_tag::Count; ++i)
+	{
+		thread->Bytes[i].store(0, std::memory_order_relaxed);
+		thread->NumAllocations[i].store(0, std::memory_order_relaxed);
+		thread->NumFrees[i].store(0, std::memory_order_relaxed);
+	}
+	thread->InUse.store(true, std::memory_order_relaxed);
+	thread->Shared = false;
+
+	pushMemoryThread(thread);
+	return thread;
+}
+
+static _memory_thread* getMemoryThread()
+{
+	_memory_thread* thread = g_tlsMemoryThread;
+	if (thread != nullptr)
+		return thread;
+
+	thread = acquireMemoryThread();
+	g_tlsMemoryThread = thread;
+	g_memoryThreadOwner.Thread = thread;
+	return thread;
+}
+
+#pragma endregion
+#pragma region Memory Tracker
+
+const char* memory_tag::ToString(Enumeration tag)
+{
+	switch (tag)
+	{
+		case General:	return "General";
+		case Geometry:	return "Geometry";
+		case Textures:	return "Textures";
+		case Loader:	return "Loader";
+		case UI:		return "UI";
+		default:		return "Unknown";
+	}
+}
+
+memory_tag::Enumeration memory_tracker::GetThreadTag()
+{
+	return (memory_tag::Enumeration)g_tlsMemoryTag;
+}
+
+void memory_tracker::SetThreadTag(memory_tag::Enumeration tag)
+{
+	g_tlsMemoryTag = tag;
+}
+
+void memory_tracker::Sample()
+{
+	for (u32 i = 0; i < memory_tag::Count; ++i)
+		GetStats((memory_tag::Enumeration)i);
+}
+
+memory_tag_stats memory_tracker::GetStats(memory_tag::Enumeration tag)
+{
+	memory_tag_stats stats;
+	for (_memory_thread* thread = g_memoryThreads.load(std::memory_order_acquire); thread != nullptr; thread = thread->Next)
+	{
+		stats.CurrentBytes += thread->Bytes[tag].load(std::memory_order_relaxed);
+		stats.NumAllocations += thread->NumAllocations[tag].load(std::memory_order_relaxed);
+		stats.NumFrees += thread->NumFrees[tag].load(std::memory_order_relaxed);
+	}
+
+	i64 peak = g_memoryPeak[tag].load(std::memory_order_relaxed);
+	while (stats.CurrentBytes > peak && !g_memoryPeak[tag].compare_exchange_weak(peak, stats.CurrentBytes, std::memory_order_relaxed)) {}
+	stats.PeakBytes = stats.CurrentBytes > peak ? stats.CurrentBytes : peak;
+	return stats;
+}
+
+#pragma endregion
+
+CFC_END_NAMESPACE1(cfc)
+
+#pragma region Operators
+#ifdef CFC_CONF_ALLOCATOR_TRACKER
+
+// in front of every allocation, 16 bytes keep the alignment of malloc
+struct _memory_header
+{
+	u64 Size;
+	u32 Tag;
+	u32 Offset;						// from the block malloc returned to the allocation, more than the header when over-aligned
+};
+
+static void* trackedAllocate(usize size)
+{
+	_memory_header* header = (_memory_header*)malloc(sizeof(_memory_header) + size);
+	if (header == nullptr)
+		return nullptr;
+
+	const u32 tag = cfc::g_tlsMemoryTag;
+	header->Size = size;
+	header->Tag = tag;
+	header->Offset = sizeof(_memory_header);
+
+	cfc::getMemoryThread()->Add(tag, (i64)size, true);
+	return header + 1;
+}
+
+static void trackedFree(void* ptr)
+{
+	if (ptr == nullptr)
+		return;
+
+	_memory_header* header = (_memory_header*)ptr - 1;
+	cfc::getMemoryThread()->Add(header->Tag, -(i64)header->Size, false);
+	free((u8*)ptr - header->Offset);
+}
+
+void* operator new(size_t size)
+{
+	void* ptr = trackedAllocate(size);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new[](size_t size)
+{
+	void* ptr = trackedAllocate(size);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return trackedAllocate(size); }
+
+void operator delete(void* ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+
+// over-aligned types (alignas above 16), C++17
+#ifdef __cpp_aligned_new
+// the header stays directly in front of the allocation, the block is padded so the first aligned address after it fits
+static void* trackedAllocateAligned(usize size, usize alignment)
+{
+	if (alignment <= sizeof(_memory_header))
+		return trackedAllocate(size);
+
+	u8* block = (u8*)malloc(size + sizeof(_memory_header) + alignment - 1);
+	if (block == nullptr)
+		return nullptr;
+
+	u8* ptr = (u8*)(((uintptr_t)block + sizeof(_memory_header) + alignment - 1) & ~(uintptr_t)(alignment - 1));
+	_memory_header* header = (_memory_header*)ptr - 1;
+	const u32 tag = cfc::g_tlsMemoryTag;
+	header->Size = size;
+	header->Tag = tag;
+	header->Offset = (u32)(ptr - block);
+
+	cfc::getMemoryThread()->Add(tag, (i64)size, true);
+	return ptr;
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	void* ptr = trackedAllocateAligned(size, (usize)alignment);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	void* ptr = trackedAllocateAligned(size, (usize)alignment);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return trackedAllocateAligned(size, (usize)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return trackedAllocateAligned(size, (usize)alignment); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+#endif
+
+#endif
+#pragma endregion
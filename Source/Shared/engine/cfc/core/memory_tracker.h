@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cfc/base.h>
+
+CFC_NAMESPACE1(cfc)
+
+struct memory_tag
+{
+	enum Enumeration
+	{
+		General,
+		Geometry,
+		Textures,
+		Loader,
+		UI,
+		Count
+	};
+	static const char* ToString(Enumeration tag);
+};
+
+struct memory_tag_stats
+{
+	i64 CurrentBytes = 0;
+	i64 PeakBytes = 0;			// highest sampled total, see memory_tracker::Sample
+	u64 NumAllocations = 0;
+	u64 NumFrees = 0;
+};
+
+// Attributes heap allocations (global operator new / delete) to the memory tag of the allocating thread. The tag is stored
+// in front of the allocation, a free is counted against the tag it was allocated with on whichever thread frees it.
+// Counters are per thread and summed on demand, an allocation only adds to counters of the calling thread.
+// NOTE: only with CFC_CONF_ALLOCATOR_TRACKER, without it the operators are not replaced and the statistics stay zero
+class CFC_API memory_tracker
+{
+public:
+	static memory_tag::Enumeration GetThreadTag();
+	static void SetThreadTag(memory_tag::Enumeration tag);
+
+	// sums the counters of all threads and updates the peak, the app samples once per frame
+	static void Sample();
+	// samples and returns the totals of one tag
+	static memory_tag_stats GetStats(memory_tag::Enumeration tag);
+};
+
+// allocations of the calling thread during the lifetime of the scope are attributed to the tag
+class CFC_API memory_tag_scope
+{
+public:
+	explicit memory_tag_scope(memory_tag::Enumeration tag) : m_previous(memory_tracker::GetThreadTag()) { memory_tracker::SetThreadTag(tag); }
+	~memory_tag_scope() { memory_tracker::SetThreadTag(m_previous); }
+
+protected:
+	memory_tag_scope(const memory_tag_scope& o) {}
+	void operator = (const memory_tag_scope& o) {}
+
+private:
+	memory_tag::Enumeration m_previous;
+};
+
+CFC_END_NAMESPACE1(cfc)
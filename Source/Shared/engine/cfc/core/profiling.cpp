@@ -0,0 +1,353 @@
+#include "profiling.h"
+#include "io.h"
+
+#include <cfc/stl/stl_vector.hpp>
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#	include <intrin.h>
+#	define CFC_PROFILE_TSC
+#elif defined(__i386__) || defined(__x86_64__)
+#	include <x86intrin.h>
+#	define CFC_PROFILE_TSC
+#endif
+
+// end events have the upper bit of the ticks set
+#define CFC_PROFILE_END_BIT (1ULL << 63)
+
+CFC_NAMESPACE2(cfc, profiling)
+
+#pragma region State
+
+struct _profile_event
+{
+	u64 Ticks;
+	const char* Name;
+};
+
+// ring of a single thread, written by the owning thread only
+// NOTE: the exporter reads while the owner writes, events that were overwritten during the copy are discarded
+struct _profile_thread
+{
+	std::atomic<u64> Head;
+	u64 StartHead;						// events before this belong to a previous (exited) thread
+	u32 Id;
+	char Name[64];
+	std::atomic<bool> Exited;
+
+	_profile_event Events[CFC_PROFILE_THREAD_EVENTS];
+};
+
+struct _profile_gpu_zone
+{
+	u64 Begin;
+	u64 End;
+	char Name[64];
+};
+
+struct _profile_state
+{
+	_profile_state() : Enabled(true), NextThreadId(1), NumGpuZones(0)
+	{
+		StartTicks = readTicks();
+		StartTime = std::chrono::steady_clock::now();
+		GpuZones.resize(CFC_PROFILE_GPU_ZONES);
+	}
+
+	static u64 readTicks()
+	{
+#ifdef CFC_PROFILE_TSC
+		return __rdtsc();
+#else
+		return (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	std::atomic<bool> Enabled;
+
+	u64 StartTicks;
+	std::chrono::steady_clock::time_point StartTime;
+
+	std::mutex Lock;
+	stl_vector<_profile_thread*> Threads;
+	u32 NextThreadId;
+
+	std::mutex GpuLock;
+	stl_vector<_profile_gpu_zone> GpuZones;
+	u64 NumGpuZones;
+};
+
+// NOTE: never destroyed, threads can still record while statics are destroyed
+static _profile_state& getState()
+{
+	static _profile_state* state = new _profile_state();
+	return *state;
+}
+
+struct _profile_thread_owner
+{
+	~_profile_thread_owner()
+	{
+		if (Thread != nullptr)
+			Thread->Exited.store(true, std::memory_order_release);
+	}
+
+	_profile_thread* Thread = nullptr;
+};
+
+static thread_local _profile_thread_owner g_profileThread;
+
+static _profile_thread* getThread()
+{
+	_profile_thread* thread = g_profileThread.Thread;
+	if (thread != nullptr)
+		return thread;
+
+	_profile_state& state = getState();
+	std::lock_guard<std::mutex> lock(state.Lock);
+
+	// the buffer of the oldest exited thread is reused once too many threads exited
+	u32 numExited = 0;
+	for (usize i = 0; i < state.Threads.size(); ++i)
+	{
+		if (state.Threads[i]->Exited.load(std::memory_order_acquire))
+		{
+			if (++numExited > CFC_PROFILE_MAX_EXITED_THREADS)
+			{
+				thread = state.Threads[i];
+				break;
+			}
+		}
+	}
+
+	if (thread == nullptr)
+	{
+		thread = new _profile_thread();
+		thread->Head.store(0, std::memory_order_relaxed);
+		state.Threads.push_back(thread);
+	}
+
+	thread->StartHead = thread->Head.load(std::memory_order_relaxed);
+	thread->Id = state.NextThreadId++;
+	snprintf(thread->Name, sizeof(thread->Name), "Thread %u", thread->Id);
+	thread->Exited.store(false, std::memory_order_release);
+
+	g_profileThread.Thread = thread;
+	return thread;
+}
+
+static void record(u64 ticks, const char* name)
+{
+	_profile_thread* thread = getThread();
+	const u64 head = thread->Head.load(std::memory_order_relaxed);
+	_profile_event& ev = thread->Events[head & (CFC_PROFILE_THREAD_EVENTS - 1)];
+	ev.Ticks = ticks;
+	ev.Name = name;
+	thread->Head.store(head + 1, std::memory_order_release);
+}
+
+// ticks per nanosecond, measured against the steady clock since the start of the profiler (the longer the baseline, the
+// more precise the frequency)
+static double calibrate()
+{
+#ifdef CFC_PROFILE_TSC
+	_profile_state& state = getState();
+	const u64 ticks = _profile_state::readTicks() - state.StartTicks;
+	const i64 elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - state.StartTime).count();
+	return elapsedNs > 0 && ticks > 0 ? (double)ticks / (double)elapsedNs : 1.0;
+#else
+	return 1.0;
+#endif
+}
+
+#pragma endregion
+#pragma region Profiler
+
+void profiler::BeginZone(const char* name)
+{
+	if (!getState().Enabled.load(std::memory_order_relaxed))
+		return;
+	record(GetTicks(), name);
+}
+
+void profiler::EndZone()
+{
+	if (!getState().Enabled.load(std::memory_order_relaxed))
+		return;
+	record(GetTicks() | CFC_PROFILE_END_BIT, nullptr);
+}
+
+void profiler::SetThreadName(const char* name)
+{
+	_profile_thread* thread = getThread();
+
+	std::lock_guard<std::mutex> lock(getState().Lock);
+	snprintf(thread->Name, sizeof(thread->Name), "%s", name);
+}
+
+u64 profiler::GetTicks()
+{
+	return _profile_state::readTicks() - getState().StartTicks;
+}
+
+u64 profiler::TicksToNanoSeconds(u64 ticks)
+{
+	return (u64)((double)ticks / calibrate());
+}
+
+void profiler::AddGpuZone(const char* name, u64 beginNanoSeconds, u64 endNanoSeconds)
+{
+	_profile_state& state = getState();
+	if (!state.Enabled.load(std::memory_order_relaxed))
+		return;
+
+	std::lock_guard<std::mutex> lock(state.GpuLock);
+	_profile_gpu_zone& zone = state.GpuZones[state.NumGpuZones++ % CFC_PROFILE_GPU_ZONES];
+	zone.Begin = beginNanoSeconds;
+	zone.End = endNanoSeconds;
+	snprintf(zone.Name, sizeof(zone.Name), "%s", name);
+}
+
+void profiler::SetEnabled(bool enabled)
+{
+	getState().Enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool profiler::IsEnabled()
+{
+	return getState().Enabled.load(std::memory_order_relaxed);
+}
+
+#pragma endregion
+#pragma region Chrome Trace
+
+static void appendJsonString(stl_string& json, const char* str)
+{
+	json += '"';
+	for (; *str != 0; ++str)
+	{
+		const char c = *str;
+		if (c == '"' || c == '\\')
+		{
+			json += '\\';
+			json += c;
+		}
+		else if ((unsigned char)c < 0x20)
+			json += ' ';
+		else
+			json += c;
+	}
+	json += '"';
+}
+
+static void appendZone(stl_string& json, const char* name, const char* category, u32 tid, u64 beginNs, u64 endNs, bool& first)
+{
+	char buffer[128];
+	json += first ? "\n" : ",\n";
+	first = false;
+
+	json += "{\"name\":";
+	appendJsonString(json, name != nullptr ? name : "?");
+	snprintf(buffer, sizeof(buffer), ",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", category, tid, beginNs / 1000.0, (endNs - beginNs) / 1000.0);
+	json += buffer;
+}
+
+static void appendThreadName(stl_string& json, u32 tid, const char* name, bool& first)
+{
+	char buffer[64];
+	json += first ? "\n" : ",\n";
+	first = false;
+
+	snprintf(buffer, sizeof(buffer), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":", tid);
+	json += buffer;
+	appendJsonString(json, name);
+	json += "}}";
+}
+
+stl_string profiler::ExportChromeTrace()
+{
+	_profile_state& state = getState();
+
+	// all events of the trace use the same frequency
+	const double ticksPerNs = calibrate();
+
+	stl_string json;
+	json.reserve(1024 * 1024);
+	json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+
+	// gpu zones are on their own track
+	appendThreadName(json, 0, "GPU", first);
+	{
+		std::lock_guard<std::mutex> lock(state.GpuLock);
+		const u64 numZones = state.NumGpuZones < CFC_PROFILE_GPU_ZONES ? state.NumGpuZones : CFC_PROFILE_GPU_ZONES;
+		for (u64 i = state.NumGpuZones - numZones; i < state.NumGpuZones; ++i)
+		{
+			const _profile_gpu_zone& zone = state.GpuZones[i % CFC_PROFILE_GPU_ZONES];
+			appendZone(json, zone.Name, "gpu", 0, zone.Begin, zone.End > zone.Begin ? zone.End : zone.Begin, first);
+		}
+	}
+
+	stl_vector<_profile_thread*> threads;
+	{
+		std::lock_guard<std::mutex> lock(state.Lock);
+		threads = state.Threads;
+		for (usize i = 0; i < threads.size(); ++i)
+			appendThreadName(json, threads[i]->Id, threads[i]->Name, first);
+	}
+
+	stl_vector<_profile_event> events;
+	stl_vector<_profile_event> stack;
+	events.resize(CFC_PROFILE_THREAD_EVENTS);
+
+	for (usize t = 0; t < threads.size(); ++t)
+	{
+		_profile_thread& thread = *threads[t];
+
+		// copy, then drop what the owner overwrote in the meantime
+		const u64 head = thread.Head.load(std::memory_order_acquire);
+		u64 begin = head > CFC_PROFILE_THREAD_EVENTS ? head - CFC_PROFILE_THREAD_EVENTS : 0;
+		begin = begin > thread.StartHead ? begin : thread.StartHead;
+		for (u64 i = begin; i < head; ++i)
+			events[(usize)(i - begin)] = thread.Events[i & (CFC_PROFILE_THREAD_EVENTS - 1)];
+
+		const u64 headAfterCopy = thread.Head.load(std::memory_order_acquire);
+		const u64 firstValid = headAfterCopy >= CFC_PROFILE_THREAD_EVENTS ? headAfterCopy - CFC_PROFILE_THREAD_EVENTS + 1 : 0;
+
+		// begin events are matched with end events, zones that are still open or lost their begin are skipped
+		stack.clear();
+		for (u64 i = begin > firstValid ? begin : firstValid; i < head; ++i)
+		{
+			const _profile_event& ev = events[(usize)(i - begin)];
+			if ((ev.Ticks & CFC_PROFILE_END_BIT) == 0)
+			{
+				stack.push_back(ev);
+				continue;
+			}
+			if (stack.empty())
+				continue;
+
+			const _profile_event& beginEv = stack.back();
+			appendZone(json, beginEv.Name, "cpu", thread.Id, (u64)(beginEv.Ticks / ticksPerNs), (u64)((ev.Ticks & ~CFC_PROFILE_END_BIT) / ticksPerNs), first);
+			stack.pop_back();
+		}
+	}
+
+	json += "\n]}\n";
+	return json;
+}
+
+bool profiler::SaveChromeTrace(cfc::context& ctx, const char* path)
+{
+	const stl_string json = ExportChromeTrace();
+	return ctx.IO->WriteMemoryToFile(path, json.data(), json.size());
+}
+
+#pragma endregion
+
+CFC_END_NAMESPACE2(cfc, profiling)
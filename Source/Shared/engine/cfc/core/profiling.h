@@ -1,9 +1,74 @@
 #pragma once
 
 #include <cfc/base.h>
+#include <cfc/core/context.h>
+#include <cfc/stl/stl_string.hpp>
 
 CFC_NAMESPACE2(cfc, profiling)
 
+// begin and end events a thread keeps, older events are overwritten (flight recorder)
+#define CFC_PROFILE_THREAD_EVENTS (16 * 1024)
+
+// gpu zones kept for the trace, older zones are overwritten
+#define CFC_PROFILE_GPU_ZONES 4096
+
+// buffers of threads that exited are kept for the trace until there are more than this many
+#define CFC_PROFILE_MAX_EXITED_THREADS 16
+
+#define CFC_PROFILE_CONCAT_IMPL(a, b) a##b
+#define CFC_PROFILE_CONCAT(a, b) CFC_PROFILE_CONCAT_IMPL(a, b)
+
+// NOTE: zone names are stored as pointers, they have to be string literals (or outlive the trace)
+#ifdef CFC_CONF_PROFILING_ENABLED
+#define CFC_PROFILE_SCOPE(name) cfc::profiling::zone CFC_PROFILE_CONCAT(cfcProfileZone, __LINE__)(name)
+#define CFC_PROFILE_FUNCTION() CFC_PROFILE_SCOPE(__FUNCTION__)
+#define CFC_PROFILE_THREAD_NAME(name) cfc::profiling::profiler::SetThreadName(name)
+#else
+#define CFC_PROFILE_SCOPE(name)
+#define CFC_PROFILE_FUNCTION()
+#define CFC_PROFILE_THREAD_NAME(name)
+#endif
+
+// Instrumentation of cpu zones in a ring of begin / end events per thread, stamped with the time stamp counter. The counter
+// is calibrated against the steady clock when a trace is exported, gpu timer queries are converted to the same timeline
+// by the gfx layer and added as gpu zones.
+class CFC_API profiler
+{
+public:
+	static void BeginZone(const char* name);
+	static void EndZone();
+
+	// the name is copied, names longer than 63 characters are truncated
+	static void SetThreadName(const char* name);
+
+	// time stamp counter of the calling cpu (nanoseconds on platforms without one)
+	static u64 GetTicks();
+	// nanoseconds since the profiler started, the timeline of the trace
+	static u64 TicksToNanoSeconds(u64 ticks);
+	static u64 GetTimeNanoSeconds() { return TicksToNanoSeconds(GetTicks()); }
+
+	// zone on the gpu timeline, begin and end in nanoseconds of the profiler timeline (the name is copied)
+	static void AddGpuZone(const char* name, u64 beginNanoSeconds, u64 endNanoSeconds);
+
+	static void SetEnabled(bool enabled);
+	static bool IsEnabled();
+
+	// chrome://tracing (or Perfetto) json of the events that are still in the rings
+	static stl_string ExportChromeTrace();
+	static bool SaveChromeTrace(cfc::context& ctx, const char* path);
+};
+
+class zone
+{
+public:
+	zone(const char* name) { profiler::BeginZone(name); }
+	~zone() { profiler::EndZone(); }
+protected:
+	zone(const zone& o) {}
+	void operator = (const zone& o) {}
+};
+
+// logs the elapsed time of the scope and records it as a zone
 class CFC_API scopedtime
 {
 public:
@@ -15,4 +80,4 @@ protected:
 	double m_time;
 };
 
-CFC_END_NAMESPACE2(cfc, profiling)
\ No newline at end of file
+CFC_END_NAMESPACE2(cfc, profiling)
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdlib.h>
+
 CFC_NAMESPACE1(cfc)
 
 class CFC_API random : public object
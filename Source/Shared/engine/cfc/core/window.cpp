@@ -102,7 +102,7 @@ void cfc::window::_doKeyChar(int index, int keyCharCode)
 
 void cfc::window::_doCursorDown(int index, float x, float y, int buttonIndex)
 {
-	if (index < sizeof(m_cursorX) / sizeof(m_cursorX[0]))
+	if ((usize)index < sizeof(m_cursorX) / sizeof(m_cursorX[0]))
 	{
 		m_cursorX[index] = x;
 		m_cursorY[index] = y;
@@ -122,7 +122,7 @@ void cfc::window::_doCursorDown(int index, float x, float y, int buttonIndex)
 
 void cfc::window::_doCursorUp(int index, float x, float y, int buttonIndex)
 {
-	if (index < sizeof(m_cursorX) / sizeof(m_cursorX[0]))
+	if ((usize)index < sizeof(m_cursorX) / sizeof(m_cursorX[0]))
 	{
 		m_cursorX[index] = x;
 		m_cursorY[index] = y;
@@ -154,7 +154,7 @@ void cfc::window::_doCursorScroll(int index, float scroll)
 
 void cfc::window::_doCursorMove(int index, float x, float y)
 {
-	if (index < sizeof(m_cursorX) / sizeof(m_cursorX[0]))
+	if ((usize)index < sizeof(m_cursorX) / sizeof(m_cursorX[0]))
 	{
 		m_cursorX[index] = x;
 		m_cursorY[index] = y;
@@ -2,7 +2,7 @@
 
 #include <cfc/base.h>
 #include <cfc/stl/stl_node.hpp>
-#include <cfc/stl/stl_lambda1.hpp>
+#include <cfc/stl/stl_function.hpp>
 #include <cfc/stl/stl_array.hpp>
 
 CFC_NAMESPACE1(cfc)
@@ -47,7 +47,7 @@ public:
 		cursorButton button=cursorButton::Unknown;
 	};
 
-	typedef stl_node<stl_lambda1<const eventData&> > event;
+	typedef stl_node<stl_function<void(const eventData&)> > event;
 
 	bool IsRequestingStop() const							{ return m_requestStop;  }
 	bool IsKeyboardPresent() const							{ return m_keyboardPresent; }
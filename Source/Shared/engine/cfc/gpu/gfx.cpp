@@ -2,6 +2,8 @@
 
 #include <cfc/core/io.h>
 
+#include <string.h>
+
 namespace cfc {
 
 	void gfx_gpu_timer_query::Begin(gfx_command_list* const cmdList, const char* const description)
@@ -12,21 +14,23 @@ namespace cfc {
 		usize descriptionLength = strlen(description);
 		stl_assert(descriptionLength < GFX_MAX_TIMER_QUERY_DESCRIPTION_STRING_SIZE);
 		memcpy(m_description, description, descriptionLength);
+		m_description[descriptionLength] = 0;
 	}
 
 	void gfx_gpu_timer_query::Begin(gfx_command_list* const cmdList)
 	{
 		m_cmdList = cmdList;
 		m_startIndex = cmdList->InsertTimerQuery();
+		m_description[0] = 0;
 	}
 
 	void gfx_gpu_timer_query::End()
 	{
-		m_endIndex = m_cmdList->InsertTimerQuery();
+		m_endIndex = m_cmdList->InsertTimerQueryEnd(m_startIndex, m_description[0] != 0 ? m_description : "GPU");
 	}
 
 
-	usize gfx::AddShaderFromFile(context& ctx, const char* filename, const char* funcName /*= "main"*/, const char* shaderType /*= "vs_5_0"*/, const char* defineData /*=null*/)
+	gfx_shader_handle gfx::AddShaderFromFile(context& ctx, const char* filename, const char* funcName /*= "main"*/, const char* shaderType /*= "vs_5_0"*/, const char* defineData /*=null*/)
 	{
 		iobuffer ioData = ctx.IO->ReadFileToMemory(filename);
 		stl_assert(ioData); // read shader
@@ -43,19 +47,20 @@ namespace cfc {
 		Barriers.resize(0);
 	}
 
-	void gfx_barrier_list::BarrierResource(usize resourceIdx, u32 stateBefore, u32 stateAfter)
+	// NOTE: barrier lists store gpu descriptors, the handle generations are not validated here
+	void gfx_barrier_list::BarrierResource(gfx_resource_handle resource, u32 stateBefore, u32 stateAfter)
 	{
-		Barriers.push_back(gpu_resourcebarrier_desc::Transition(resourceIdx, stateBefore, stateAfter));
+		Barriers.push_back(gpu_resourcebarrier_desc::Transition(resource.GetIndex(), stateBefore, stateAfter));
 	}
 
-	void gfx_barrier_list::BarrierUAV(usize resourceIdx)
+	void gfx_barrier_list::BarrierUAV(gfx_resource_handle resource)
 	{
-		Barriers.push_back(gpu_resourcebarrier_desc::UAV(resourceIdx));
+		Barriers.push_back(gpu_resourcebarrier_desc::UAV(resource.GetIndex()));
 	}
 
-	void gfx_barrier_list::BarrierAliasing(usize resourceBeforeIdx, usize resourceAfterIdx)
+	void gfx_barrier_list::BarrierAliasing(gfx_resource_handle resourceBefore, gfx_resource_handle resourceAfter)
 	{
-		Barriers.push_back(gpu_resourcebarrier_desc::Aliasing(resourceBeforeIdx, resourceAfterIdx));
+		Barriers.push_back(gpu_resourcebarrier_desc::Aliasing(resourceBefore.GetIndex(), resourceAfter.GetIndex()));
 	}
 
 };
\ No newline at end of file
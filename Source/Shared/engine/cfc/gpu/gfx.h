@@ -3,6 +3,7 @@
 #include <cfc/base.h>
 #include <cfc/core/context.h>
 #include <cfc/gpu/gpu.h>
+#include <cfc/gpu/gfx_handle.h>
 
 #define GFX_MAX_TIMER_QUERY_DESCRIPTION_STRING_SIZE 256
 
@@ -39,6 +40,23 @@ namespace cfc {
 		ResolveDest
 	};
 
+	// categories of the gpu memory ledger, see gfx::GetMemoryStats
+	enum class gfx_memory_category
+	{
+		StaticResources,
+		DynamicResources,
+		Textures,
+		RenderTargets,
+		COUNT
+	};
+
+	struct gfx_memory_stats
+	{
+		u64 CurrentBytes = 0;
+		u64 PeakBytes = 0;
+		u64 NumResources = 0;
+	};
+
 	// Multithreading guarantee: Only use this from one thread concurrently. For multi-threaded operation, keeps track of a query 
 	class gfx_command_list;
 	class CFC_API gfx_gpu_timer_query
@@ -63,15 +81,15 @@ namespace cfc {
 	class CFC_API gfx_descriptor_heap
 	{
 	public:
-		virtual usize GetIndex() = 0;
+		virtual gfx_descriptor_heap_handle GetHandle() = 0;
 
 		virtual void SetSampler(usize idx, const cfc::gpu_sampler_desc& samplerDescriptor) = 0;
 
-		virtual void SetSRVTexture(usize idx, usize resSrvTexture, gpu_format_type fmt = gpu_format_type::Unknown, u32 mostDetailedMip = 0, u32 mipLevels = ~0, f32 resourceMinLodClamp = 0.0f, u32 planeSlice = 0, u32 firstArraySlice = 0, u32 arraySize = ~0) = 0;
-		virtual void SetSRVBuffer(usize idx, usize resSrvBuffer, u32 stride = 0, usize offset = 0) = 0;
-		virtual void SetCBV(usize idx, usize resCbv, usize offset = 0) = 0;
-		virtual void SetUAVBuffer(usize idx, usize resUav, u32 strideInBytes = 0, usize offsetInElements = 0, u32 numElements = 0, u32 counterOffsetInBytes = 0Ui64, usize counterResourceIdx = cfc::invalid_index) = 0;
-		virtual void SetUAVTexture(usize idx, usize resUav, gpu_format_type fmt = gpu_format_type::Unknown, u32 mipSlice = 0, u32 planeSlice = 0, u32 firstArraySlice = 0, u32 arraySize = ~0) = 0;
+		virtual void SetSRVTexture(usize idx, gfx_resource_handle resSrvTexture, gpu_format_type fmt = gpu_format_type::Unknown, u32 mostDetailedMip = 0, u32 mipLevels = ~0, f32 resourceMinLodClamp = 0.0f, u32 planeSlice = 0, u32 firstArraySlice = 0, u32 arraySize = ~0) = 0;
+		virtual void SetSRVBuffer(usize idx, gfx_resource_handle resSrvBuffer, u32 stride = 0, usize offset = 0) = 0;
+		virtual void SetCBV(usize idx, gfx_resource_handle resCbv, usize offset = 0) = 0;
+		virtual void SetUAVBuffer(usize idx, gfx_resource_handle resUav, u32 strideInBytes = 0, usize offsetInElements = 0, u32 numElements = 0, u32 counterOffsetInBytes = 0, gfx_resource_handle counterResource = gfx_resource_handle()) = 0;
+		virtual void SetUAVTexture(usize idx, gfx_resource_handle resUav, gpu_format_type fmt = gpu_format_type::Unknown, u32 mipSlice = 0, u32 planeSlice = 0, u32 firstArraySlice = 0, u32 arraySize = ~0) = 0;
 
 		virtual u64 GetUAVCPUDescriptorHandle(usize idx) = 0;
 		virtual u64 GetUAVGPUDescriptorHandle(usize idx) = 0;
@@ -87,9 +105,9 @@ namespace cfc {
 		gfx_barrier_list(usize reserve = 4);
 
 		void Reset();
-		void BarrierResource(usize resourceIdx, u32 stateBefore, u32 stateAfter);
-		void BarrierUAV(usize resourceIdx);
-		void BarrierAliasing(usize resourceBeforeIdx, usize resourceAfterIdx);
+		void BarrierResource(gfx_resource_handle resource, u32 stateBefore, u32 stateAfter);
+		void BarrierUAV(gfx_resource_handle resource);
+		void BarrierAliasing(gfx_resource_handle resourceBefore, gfx_resource_handle resourceAfter);
 
 	public:
 		stl_vector<cfc::gpu_resourcebarrier_desc> Barriers;
@@ -124,7 +142,7 @@ namespace cfc {
 			Bundle,
 		};
 
-		virtual usize GetIndex() const = 0;
+		virtual gfx_command_list_handle GetHandle() const = 0;
 		virtual type GetType() const = 0;
 
 		virtual void Reset() = 0;
@@ -135,39 +153,42 @@ namespace cfc {
 		inline  void ExecuteBarrier(gfx_barrier_list& barrierList) { ExecuteBarrier(&barrierList.Barriers[0], barrierList.Barriers.size()); }
 		inline  void ExecuteBarrier(cfc::gpu_resourcebarrier_desc& barrier) { ExecuteBarrier(&barrier, 1); }
 		virtual void ExecuteBarrier(cfc::gpu_resourcebarrier_desc* barriers, usize count) = 0;
+		virtual void ExecuteTransitionBarrier(gfx_resource_handle resource, u32 stateBefore, u32 stateAfter) = 0;
 		virtual u32 InsertTimerQuery() = 0;
-		virtual void ResolveQueryData(usize queryHeapIdx, cfc::gpu_query_type Type, u32 StartIndex, u32 NumQueries, usize destinationResourceIdx, u64 AlignedDestinationBufferOffset) = 0;
+		// closes the query started at startIndex, the zone shows up on the gpu track of the profiler once it is read back
+		virtual u32 InsertTimerQueryEnd(u32 startIndex, const char* description) = 0;
+		virtual void ResolveQueryData(usize queryHeapIdx, cfc::gpu_query_type Type, u32 StartIndex, u32 NumQueries, gfx_resource_handle destinationResource, u64 AlignedDestinationBufferOffset) = 0;
 
 		// GRAPHICS (GFX)
 		// TODO: come up with better name for GFXSetProgram (only changes root signature) where SetProgramState does the actual program switch, maybe GFXSetProgramBindings?
-		virtual void GFXSetProgram(usize programIdx) = 0;
-		virtual void GFXSetProgramState(usize programIdx, usize programStateIdx) = 0;
+		virtual void GFXSetProgram(gfx_program_handle program) = 0;
+		virtual void GFXSetProgramState(gfx_program_handle program, usize programStateIdx) = 0;
 		virtual void GFXSetViewports(const cfc::gpu_viewport* viewports, usize numViewports) = 0;
 		virtual void GFXSetScissorRects(const cfc::gpu_rectangle* scissorRects, usize numScissorRects) = 0;
 		virtual void GFXSetRenderTargets(const usize* rtvOffsets, usize numRtvs, usize dsvOffset) = 0;
 		virtual void GFXSetPrimitiveTopology(cfc::gpu_primitive_type primType) = 0;
-		virtual void GFXSetVertexBuffer(i32 startSlot, usize idx, usize offset, u32 stride, u32 size) = 0;
-		virtual void GFXSetIndexBuffer(usize idx, usize offset, usize sizeInBytes, cfc::gpu_format_type fmt) = 0;
+		virtual void GFXSetVertexBuffer(i32 startSlot, gfx_resource_handle resource, usize offset, u32 stride, u32 size) = 0;
+		virtual void GFXSetIndexBuffer(gfx_resource_handle resource, usize offset, usize sizeInBytes, cfc::gpu_format_type fmt) = 0;
 		virtual void GFXSetDescriptorTableCbvSrvUav(i32 slot, usize blockIndex) = 0;
 		virtual void GFXSetDescriptorTableSamplers(i32 slot, usize blockIndex) = 0;
-		virtual void GFXSetRootParameterCBV(i32 slot, usize cbv, u64 offset = 0) = 0;
-		virtual void GFXSetRootParameterUAV(i32 slot, usize uav, u64 offset = 0) = 0;
-		virtual void GFXSetRootParameterSRV(i32 slot, usize srv, u64 offset = 0) = 0;
+		virtual void GFXSetRootParameterCBV(i32 slot, gfx_resource_handle cbv, u64 offset = 0) = 0;
+		virtual void GFXSetRootParameterUAV(i32 slot, gfx_resource_handle uav, u64 offset = 0) = 0;
+		virtual void GFXSetRootParameterSRV(i32 slot, gfx_resource_handle srv, u64 offset = 0) = 0;
 		virtual void GFXSetRootParameterConstants(i32 slot, const void* data, u32 sizeInDwords, u32 offsetInDwords = 0) = 0;
 		virtual void GFXDrawInstanced(u32 VertexCountPerInstance, u32 InstanceCount, u32 StartVertexLocation, u32 StartInstanceLocation) = 0;
 		virtual void GFXDrawIndexedInstanced(u32 IndexCountPerInstance, u32 InstanceCount, u32 StartIndexLocation, i32 BaseVertexLocation, u32 StartInstanceLocation) = 0;
-		virtual void GFXExecuteBundle(usize cmdBundleIdx) = 0;
+		virtual void GFXExecuteBundle(gfx_command_list_handle cmdBundle) = 0;
 		virtual void GFXClearRenderTarget(usize rtvOffset, const float* clearColor = nullptr) = 0;
 		virtual void GFXClearDepthStencilTarget(usize dsvOffset, float clearDepth = 1.0f, u8 clearStencil = 0) = 0;
 
 		// COMPUTE (CMP)
-		virtual void CMPSetProgram(usize programIdx) = 0;
-		virtual void CMPSetProgramState(usize programIdx, usize programStateIdx) = 0;
+		virtual void CMPSetProgram(gfx_program_handle program) = 0;
+		virtual void CMPSetProgramState(gfx_program_handle program, usize programStateIdx) = 0;
 		virtual void CMPSetDescriptorTableCbvSrvUav(i32 slot, usize blockIndex) = 0;
 		virtual void CMPSetDescriptorTableSamplers(i32 slot, usize blockIndex) = 0;
-		virtual void CMPSetRootParameterCBV(i32 slot, usize cbv, u64 offset = 0) = 0;
-		virtual void CMPSetRootParameterUAV(i32 slot, usize uav, u64 offset = 0) = 0;
-		virtual void CMPSetRootParameterSRV(i32 slot, usize srv, u64 offset = 0) = 0;
+		virtual void CMPSetRootParameterCBV(i32 slot, gfx_resource_handle cbv, u64 offset = 0) = 0;
+		virtual void CMPSetRootParameterUAV(i32 slot, gfx_resource_handle uav, u64 offset = 0) = 0;
+		virtual void CMPSetRootParameterSRV(i32 slot, gfx_resource_handle srv, u64 offset = 0) = 0;
 		virtual void CMPSetRootParameterConstants(i32 slot, const void* data, u32 sizeInDwords, u32 offsetInDwords = 0) = 0;
 		virtual void CMPDispatch(u32 ThreadGroupCountX, u32 ThreadGroupCountY, u32 ThreadGroupCountZ) = 0;
 
@@ -181,7 +202,7 @@ namespace cfc {
 	{
 	public:
 		gfx_texture_creation_desc(const void* initialData, cfc::gpu_format_type fmt, int width, int height, int mipmaps=1, int arraySize=1, bool allowUAV=false)
-			: Type(cfc::gfx_texture_type::Texture2D), Format(fmt), Width(width), Height(height), Mipmaps(mipmaps), ArraySize(arraySize), InitialData(initialData), AllowUAV(allowUAV) {}
+			: Type(cfc::gfx_texture_type::Texture2D), Format(fmt), Width(width), Height(height), Mipmaps(mipmaps), ArraySize(arraySize), AllowUAV(allowUAV), InitialData(initialData) {}
 
 		cfc::gfx_texture_type Type;
 		cfc::gpu_format_type Format;
@@ -197,22 +218,35 @@ namespace cfc {
 		bool AllowDSV = false;
 
 		const void* InitialData = nullptr;
+
+		// mips from InitialDataMipmaps on are copied on the gpu from CopySource (starting at its mip CopySourceMip) instead of
+		// uploaded, the copied mips need the format and the dimensions of the source mips
+		// NOTE: only for textures without array slices, InitialData holds the uploaded mips only
+		int InitialDataMipmaps = -1;	// -1: InitialData holds all mips
+		gfx_resource_handle CopySource;
+		int CopySourceMip = 0;
 	};
 
 	// Multithreading guarantee: Only use this from one thread concurrently. For multi-threaded operation, create multiple instances of resource streams.
 	class CFC_API gfx_resource_stream
 	{
 	public:
-		virtual usize GetIndex() = 0;
+		virtual gfx_resource_stream_handle GetHandle() = 0;
 
-		virtual usize AddTexture(const gfx_texture_creation_desc& descriptor) = 0;
-		virtual void UpdateTexture(usize resourceIdx, const void* dataBuffer, usize dataBufferRowPitch, int w, int h=1, int d=1, int dest_x = 0, int dest_y = 0, int dest_z = 0, int dest_mip = 0, int dest_arraySlice = 0) = 0;
+		virtual gfx_resource_handle AddTexture(const gfx_texture_creation_desc& descriptor) = 0;
+		virtual void UpdateTexture(gfx_resource_handle resource, const void* dataBuffer, usize dataBufferRowPitch, int w, int h=1, int d=1, int dest_x = 0, int dest_y = 0, int dest_z = 0, int dest_mip = 0, int dest_arraySlice = 0) = 0;
 
-		virtual usize AddStaticResource(gfx_resource_type type, const void* bufferData, usize bytes) = 0;
-		virtual usize AddDynamicResource(gfx_resource_type type, usize bytes, bool cpuResident = false, bool readBack = false) = 0;
-		virtual void UpdateDynamicResource(usize resourceIdx, u64 bytes, const void* dataBuffer, u64 dstOffset = 0) = 0;
+		// copies mips [firstMip, firstMip + numMips) of a texture into cpu readable memory, ReadTextureReadback can read it once the
+		// work of this stream finished on the gpu, remove the returned resource after reading it
+		virtual gfx_resource_handle AddTextureReadback(gfx_resource_handle texture, u32 firstMip, u32 numMips) = 0;
+		// the mips tightly packed, same layout as gfx_texture_creation_desc::InitialData
+		virtual void ReadTextureReadback(gfx_resource_handle readback, void* dataOUT) = 0;
 
-		virtual usize AllocateTemporary(gfx_resource_type type, usize bytes, u64& outResourceOffset, u64 alignment = 256) = 0;
+		virtual gfx_resource_handle AddStaticResource(gfx_resource_type type, const void* bufferData, usize bytes) = 0;
+		virtual gfx_resource_handle AddDynamicResource(gfx_resource_type type, usize bytes, bool cpuResident = false, bool readBack = false) = 0;
+		virtual void UpdateDynamicResource(gfx_resource_handle resource, u64 bytes, const void* dataBuffer, u64 dstOffset = 0) = 0;
+
+		virtual gfx_resource_handle AllocateTemporary(gfx_resource_type type, usize bytes, u64& outResourceOffset, u64 alignment = 256) = 0;
 
 		virtual void Flush() = 0;
 		virtual void WaitForFinish() = 0;
@@ -238,38 +272,39 @@ namespace cfc {
 		virtual void Init(cfc::context& ctx, usize deviceID = 0, u32 numFrames = 2, cfc::gpu_swapimage_type imgType = cfc::gpu_swapimage_type::Rgba8Unorm, cfc::gpu_format_type depthType = cfc::gpu_format_type::D32Float, cfc::gpu_swapflip_type flipType = cfc::gpu_swapflip_type::Discard) {}
 		virtual gpu_features GetDeviceFeatures() const = 0;
 
-		virtual usize AddShaderFromFile(cfc::context& ctx, const char* filename, const char* funcName = "main", const char* shaderType = "vs_5_0", const char* defineData = nullptr);
-		virtual usize AddShaderFromMemory(const void* fileData, usize fileDataSize, const char* funcName = "main", const char* shaderType = "vs_5_0", const char* shaderFilename = "unknown.shd", const char* defineData = nullptr) = 0;
-		virtual usize AddGraphicsProgram(usize vertexShader = cfc::invalid_index, usize pixelShader = cfc::invalid_index, usize geometryShader = cfc::invalid_index, usize hullShader = cfc::invalid_index, usize domainShader = cfc::invalid_index) = 0;
-		virtual usize AddGraphicsProgramPipelineState(usize graphicsProgramIdx, const gfx_gfxprogram_desc& descriptor) = 0;
-		virtual usize AddComputeProgram(usize computeShader = cfc::invalid_index) = 0;
-		virtual usize AddComputeProgramPipelineState(usize computeProgramIdx, const gfx_cmpprogram_desc& descriptor) = 0;
-		virtual usize AddDescriptorHeap(i32 maxCbvSrvUav = 256, i32 maxSamplers = 128) = 0;
-		virtual usize AddResourceStream() = 0;
-		virtual usize AddCommandList() = 0;
-		virtual usize AddCommandBundle(usize cmdAllocatorBundleId) = 0;
-		virtual usize AddBundleAllocator() = 0;
-		virtual usize AddRenderTarget2D(i32 width, i32 height, cfc::gpu_format_type format, cfc::gpu_defaultclear_desc defaultClear = cfc::gpu_defaultclear_desc()) = 0;
-
-		virtual gfx_descriptor_heap* GetDescriptorHeap(usize descriptorHeapIdx) = 0;
-		virtual gfx_resource_stream* GetResourceStream(usize resourceStreamIdx) = 0;
-		virtual gfx_command_list* GetCommandList(usize commandListIdx) = 0;
-		virtual gfx_command_list* GetCommandBundle(usize bundleCmdListIdx) = 0;
-		virtual usize GetBundleAllocator(usize bundleAllocatorIdx) = 0;
-
-		virtual void RemoveShader(usize shaderID) = 0;
-		virtual void RemoveResource(usize bufferID) = 0;
-		virtual void RemoveResourceStream(usize resourceStream) = 0;
-		virtual void RemoveDescriptorHeap(usize descriptorHeapIdx) = 0;
-		virtual void RemoveCommandList(usize commandListIdx) = 0;
-		virtual void RemoveCommandBundle(usize bundleCmdListIdx) = 0;
-		virtual void RemoveBundleAllocator(usize bundleAllocatorIdx) = 0;
-		virtual void RemoveGraphicsProgram(usize gfxProgramID) = 0;
-		virtual void RemoveComputeProgram(usize cmpProgramID) = 0;
-		virtual void RemoveRenderTarget(usize rtID) = 0;
+		virtual gfx_shader_handle AddShaderFromFile(cfc::context& ctx, const char* filename, const char* funcName = "main", const char* shaderType = "vs_5_0", const char* defineData = nullptr);
+		virtual gfx_shader_handle AddShaderFromMemory(const void* fileData, usize fileDataSize, const char* funcName = "main", const char* shaderType = "vs_5_0", const char* shaderFilename = "unknown.shd", const char* defineData = nullptr) = 0;
+		virtual gfx_program_handle AddGraphicsProgram(gfx_shader_handle vertexShader = gfx_shader_handle(), gfx_shader_handle pixelShader = gfx_shader_handle(), gfx_shader_handle geometryShader = gfx_shader_handle(), gfx_shader_handle hullShader = gfx_shader_handle(), gfx_shader_handle domainShader = gfx_shader_handle()) = 0;
+		virtual usize AddGraphicsProgramPipelineState(gfx_program_handle graphicsProgram, const gfx_gfxprogram_desc& descriptor) = 0;
+		virtual gfx_program_handle AddComputeProgram(gfx_shader_handle computeShader = gfx_shader_handle()) = 0;
+		virtual usize AddComputeProgramPipelineState(gfx_program_handle computeProgram, const gfx_cmpprogram_desc& descriptor) = 0;
+		virtual gfx_descriptor_heap_handle AddDescriptorHeap(i32 maxCbvSrvUav = 256, i32 maxSamplers = 128) = 0;
+		virtual gfx_resource_stream_handle AddResourceStream() = 0;
+		virtual gfx_command_list_handle AddCommandList() = 0;
+		virtual gfx_command_list_handle AddCommandBundle(gfx_bundle_allocator_handle cmdAllocatorBundle) = 0;
+		virtual gfx_bundle_allocator_handle AddBundleAllocator() = 0;
+		virtual gfx_render_target_handle AddRenderTarget2D(i32 width, i32 height, cfc::gpu_format_type format, cfc::gpu_defaultclear_desc defaultClear = cfc::gpu_defaultclear_desc()) = 0;
+
+		virtual gfx_descriptor_heap* GetDescriptorHeap(gfx_descriptor_heap_handle descriptorHeap) = 0;
+		virtual gfx_resource_stream* GetResourceStream(gfx_resource_stream_handle resourceStream) = 0;
+		virtual gfx_command_list* GetCommandList(gfx_command_list_handle commandList) = 0;
+		virtual gfx_command_list* GetCommandBundle(gfx_command_list_handle bundleCmdList) = 0;
+		virtual usize GetBundleAllocator(gfx_bundle_allocator_handle bundleAllocator) = 0;
+
+		// removing an invalid handle is a no-op
+		virtual void RemoveShader(gfx_shader_handle shader) = 0;
+		virtual void RemoveResource(gfx_resource_handle resource) = 0;
+		virtual void RemoveResourceStream(gfx_resource_stream_handle resourceStream) = 0;
+		virtual void RemoveDescriptorHeap(gfx_descriptor_heap_handle descriptorHeap) = 0;
+		virtual void RemoveCommandList(gfx_command_list_handle commandList) = 0;
+		virtual void RemoveCommandBundle(gfx_command_list_handle bundleCmdList) = 0;
+		virtual void RemoveBundleAllocator(gfx_bundle_allocator_handle bundleAllocator) = 0;
+		virtual void RemoveGraphicsProgram(gfx_program_handle gfxProgram) = 0;
+		virtual void RemoveComputeProgram(gfx_program_handle cmpProgram) = 0;
+		virtual void RemoveRenderTarget(gfx_render_target_handle renderTarget) = 0;
 
 		virtual void WaitForGpu() = 0;
-		virtual void ExecuteCommandLists(const usize* commandListIndices, usize numCommandLists) = 0;
+		virtual void ExecuteCommandLists(const gfx_command_list_handle* commandLists, usize numCommandLists) = 0;
 		virtual bool Present(u32 swapInterval = 1, u32 flags = 0) = 0;
 
 		virtual void ResolveTimerQueries() = 0;
@@ -277,21 +312,21 @@ namespace cfc {
 		virtual f64  GetTimerQueryResultInMS(const u32 index) = 0;
 		virtual f64  GetTimerQueryResultInMS(const gfx_gpu_timer_query& timerQuery) = 0;
 
-		virtual u32 GetGraphicsProgramBindLocation(usize gfxProgramIdx, const char* name) = 0;
-		virtual u32 GetComputeProgramBindLocation(usize cmpProgramIdx, const char* name) = 0;
+		virtual u32 GetGraphicsProgramBindLocation(gfx_program_handle gfxProgram, const char* name) = 0;
+		virtual u32 GetComputeProgramBindLocation(gfx_program_handle cmpProgram, const char* name) = 0;
 
-		virtual usize GetRenderTargetResource(usize rtID) = 0;
-		virtual usize GetRenderTargetRTVOffset(usize rtID) = 0;
-		virtual usize GetRenderTargetDSVOffset(usize rtID) = 0;
-		virtual i32 GetRenderTargetWidth(usize rtID) = 0;
-		virtual i32 GetRenderTargetHeight(usize rtID) = 0;
-		virtual cfc::gpu_format_type GetRenderTargetFormat(usize rtID) = 0;
+		virtual gfx_resource_handle GetRenderTargetResource(gfx_render_target_handle renderTarget) = 0;
+		virtual usize GetRenderTargetRTVOffset(gfx_render_target_handle renderTarget) = 0;
+		virtual usize GetRenderTargetDSVOffset(gfx_render_target_handle renderTarget) = 0;
+		virtual i32 GetRenderTargetWidth(gfx_render_target_handle renderTarget) = 0;
+		virtual i32 GetRenderTargetHeight(gfx_render_target_handle renderTarget) = 0;
+		virtual cfc::gpu_format_type GetRenderTargetFormat(gfx_render_target_handle renderTarget) = 0;
 
 		virtual i32 GetBackbufferWidth() = 0;
 		virtual i32 GetBackbufferHeight() = 0;
-		virtual usize GetBackbufferRTResource() = 0;
-		virtual usize GetBackbufferRTResource(usize index) = 0;
-		virtual usize GetBackbufferDSResource() = 0;
+		virtual gfx_resource_handle GetBackbufferRTResource() = 0;
+		virtual gfx_resource_handle GetBackbufferRTResource(usize index) = 0;
+		virtual gfx_resource_handle GetBackbufferDSResource() = 0;
 		virtual usize GetBackbufferRTVOffset() = 0;
 		virtual usize GetBackbufferDSVOffset() = 0;
 		virtual gpu_format_type GetBackbufferRTVFormat() = 0;
@@ -306,8 +341,11 @@ namespace cfc {
 		virtual usize GetTimerQueryWriteFrameIndex() = 0;
 		virtual usize GetTimerQueryFrameDelayQuantity() = 0;
 
+		// resources created through the gfx layer, in bytes the device allocated for them (released when the removal is queued)
+		virtual gfx_memory_stats GetMemoryStats(gfx_memory_category category) = 0;
+
 		// helpers
-		void ExecuteCommandLists(usize commandListIdx) { ExecuteCommandLists(&commandListIdx, 1); }
+		void ExecuteCommandLists(gfx_command_list_handle commandList) { ExecuteCommandLists(&commandList, 1); }
 	};
 
 }; // end namespace cfc
\ No newline at end of file
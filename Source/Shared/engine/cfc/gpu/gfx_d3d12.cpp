@@ -15,6 +15,7 @@
 #define MICROPROFILE_GPU_TIMERS_D3D12
 #include "dependencies/Microprofile/microprofile.h"
 #include <cfc/core/logging.h>
+#include <cfc/core/profiling.h>
 
 #define MAX_FRAMES 16
 
@@ -42,6 +43,14 @@ struct query_timer_frame
 	u32 StartIndex;
 };
 
+// stored at the end index of a timer query, read back with the frame of the end index
+struct query_timer_zone
+{
+	u32 StartIndex;
+	bool IsValid;
+	char Name[64];
+};
+
 struct _imp_dx12_gfx
 {
 	gfx_dx12* parent;
@@ -94,29 +103,106 @@ struct _imp_dx12_gfx
 	u64 gpuTimerQueryLastResolvedFrame = 0;
 	std::atomic<u32> gpuTimerQueryIndex;
 	usize gpuTimerQueryHeap = cfc::invalid_index;
-	usize gpuTimerQueryReadbackBuffer = cfc::invalid_index;
+	gfx_resource_handle gpuTimerQueryReadbackBuffer;
 	usize gpuTimerQueryFnc = cfc::invalid_index;
 	usize gpuTimerQueryFnev = cfc::invalid_index;
 	u64 gpuTimerQueryTimeStampFrequency = 0;
 	stl_vector<u64> gpuTimerQueryResults;
-	stl_array<usize, TIMER_QUERIES_FRAMES_DELAY> gpuTimerQueryResolveCommandLists;
+	stl_vector<query_timer_zone> gpuTimerQueryZones;
+	stl_array<gfx_command_list_handle, TIMER_QUERIES_FRAMES_DELAY> gpuTimerQueryResolveCommandLists;
 	stl_array<query_timer_frame, TIMER_QUERIES_FRAMES_DELAY> gpuTimerQueryFrameInfo;
 
+	// Memory ledger, resource index to category and allocation size
+	stl_mutex mtxMemoryLedger;
+	stl_map<usize, stl_pair<gfx_memory_category, u64> > memoryLedgerResources;
+	stl_array<gfx_memory_stats, (usize)gfx_memory_category::COUNT> memoryLedger;
+
 	// Deletion Queue
 	stl_mutex mtxDeletionQueue;
 	stl_map<u64, stl_vector<stl_pair<gpu_object_type, usize> > > deletionQueue;
 
 	// Resources
-	stl_resource_collection<stl_unique_ptr<gfx_dx12_program>, stl_mutex> resGfxPrograms;
-	stl_resource_collection<stl_unique_ptr<gfx_dx12_desc_heap>, stl_mutex> resDescriptorHeaps;
-	stl_resource_collection<stl_unique_ptr<gfx_dx12_resource_stream>, stl_mutex> resResourceStreams;
-	stl_resource_collection<stl_unique_ptr<gfx_dx12_command_list>, stl_mutex> resCommandLists;
-	stl_resource_collection<stl_unique_ptr<gfx_dx12_command_list>, stl_mutex> resCommandBundles;
-	stl_resource_collection<stl_unique_ptr<dx12_gfx_render_target>, stl_mutex> resRenderTargets;
-
-	stl_resource_collection<usize, stl_mutex> resBundleCommandAllocator;
+	stl_resource_collection<stl_unique_ptr<gfx_dx12_program>> resGfxPrograms;
+	stl_resource_collection<stl_unique_ptr<gfx_dx12_desc_heap>> resDescriptorHeaps;
+	stl_resource_collection<stl_unique_ptr<gfx_dx12_resource_stream>> resResourceStreams;
+	stl_resource_collection<stl_unique_ptr<gfx_dx12_command_list>> resCommandLists;
+	stl_resource_collection<stl_unique_ptr<gfx_dx12_command_list>> resCommandBundles;
+	stl_resource_collection<stl_unique_ptr<dx12_gfx_render_target>> resRenderTargets;
+
+	stl_resource_collection<usize> resBundleCommandAllocator;
 };
 
+#pragma region Memory Ledger
+static void trackResourceMemory(_imp_dx12_gfx* impl, usize resourceIdx, gfx_memory_category category)
+{
+	if (resourceIdx == cfc::invalid_index)
+		return;
+
+	const u64 bytes = impl->gpuCtx.ResourceGetAllocationSize(resourceIdx);
+
+	std::lock_guard<stl_mutex> lock(impl->mtxMemoryLedger);
+	impl->memoryLedgerResources[resourceIdx] = stl_pair<gfx_memory_category, u64>(category, bytes);
+
+	gfx_memory_stats& stats = impl->memoryLedger[(usize)category];
+	stats.CurrentBytes += bytes;
+	stats.PeakBytes = stats.CurrentBytes > stats.PeakBytes ? stats.CurrentBytes : stats.PeakBytes;
+	stats.NumResources++;
+}
+
+// NOTE: resources the ledger does not know (upload and temporary resources of streams) are ignored
+static void untrackResourceMemory(_imp_dx12_gfx* impl, usize resourceIdx)
+{
+	std::lock_guard<stl_mutex> lock(impl->mtxMemoryLedger);
+	auto it = impl->memoryLedgerResources.find(resourceIdx);
+	if (it == impl->memoryLedgerResources.end())
+		return;
+
+	gfx_memory_stats& stats = impl->memoryLedger[(usize)it->second.first];
+	stats.CurrentBytes -= it->second.second;
+	stats.NumResources--;
+	impl->memoryLedgerResources.erase(it);
+}
+#pragma endregion
+
+#pragma region Handles
+// gfx objects live in the collections of _imp_dx12_gfx, resources and shaders in the collections of the gpu layer.
+// A handle stores the generation of its slot at creation, resolving a handle of a removed object asserts when validation is enabled.
+template <class Tag, class T>
+static gfx_handle<Tag> makeHandle(const stl_resource_collection<T>& collection, usize index)
+{
+	return gfx_handle<Tag>::Make(index, index != cfc::invalid_index ? collection.get_generation(index) : 0);
+}
+
+template <class Tag, class T>
+static usize resolveHandle(const stl_resource_collection<T>& collection, gfx_handle<Tag> handle)
+{
+#ifdef CFC_CONF_GFX_HANDLE_VALIDATION
+	stl_assert(!handle.IsValid() || collection.is_current(handle.GetIndex(), handle.GetGeneration()));
+#endif
+	return handle.GetIndex();
+}
+
+template <class Tag>
+static gfx_handle<Tag> makeGpuHandle(const gpu_dx12_context& gpuCtx, gpu_object_type type, usize index)
+{
+	return gfx_handle<Tag>::Make(index, index != cfc::invalid_index ? gpuCtx.GetGeneration(type, index) : 0);
+}
+
+template <class Tag>
+static usize resolveGpuHandle(const gpu_dx12_context& gpuCtx, gpu_object_type type, gfx_handle<Tag> handle)
+{
+#ifdef CFC_CONF_GFX_HANDLE_VALIDATION
+	stl_assert(!handle.IsValid() || gpuCtx.IsCurrent(type, handle.GetIndex(), handle.GetGeneration()));
+#endif
+	return handle.GetIndex();
+}
+
+static gfx_resource_handle makeResourceHandle(const gpu_dx12_context& gpuCtx, usize resourceIdx) { return makeGpuHandle<gfx_resource_tag>(gpuCtx, gpu_object_type::Resource, resourceIdx); }
+static usize resolveResource(const gpu_dx12_context& gpuCtx, gfx_resource_handle resource) { return resolveGpuHandle(gpuCtx, gpu_object_type::Resource, resource); }
+static gfx_shader_handle makeShaderHandle(const gpu_dx12_context& gpuCtx, usize shaderIdx) { return makeGpuHandle<gfx_shader_tag>(gpuCtx, gpu_object_type::ShaderBlob, shaderIdx); }
+static usize resolveShader(const gpu_dx12_context& gpuCtx, gfx_shader_handle shader) { return resolveGpuHandle(gpuCtx, gpu_object_type::ShaderBlob, shader); }
+#pragma endregion
+
 // ** State API
 class gfx_dx12_resource_stream;
 
@@ -133,7 +219,7 @@ public:
 	}
 
 	_imp_dx12_gfx* m_impl;
-	usize m_index;
+	gfx_program_handle m_handle;
 	cfc::gpu_rootsignature_desc rootSignatureDescriptor;
 	stl_array<usize, 6> shaderIndices;
 	usize rootSignatureIndex;
@@ -155,9 +241,9 @@ public:
 		numHeaps = 0;
 	}
 
-	virtual usize GetIndex() override
+	virtual gfx_descriptor_heap_handle GetHandle() override
 	{
-		return m_index;
+		return m_handle;
 	}
 
 	virtual void SetSampler(usize idx, const cfc::gpu_sampler_desc& samplerDesc) override
@@ -165,31 +251,34 @@ public:
 		m_impl->gpuCtx.CreateDescriptorSampler(GetCPUOffsetSamplers(idx), samplerDesc);
 	}
 
-	virtual void SetSRVTexture(usize idx, usize resSrvTexture, gpu_format_type fmt = gpu_format_type::Unknown, u32 mostDetailedMip = 0, u32 mipLevels = ~0, f32 resourceMinLodClamp = 0.0f, u32 planeSlice = 0, u32 firstArraySlice = 0, u32 arraySize = ~0) override
+	virtual void SetSRVTexture(usize idx, gfx_resource_handle resSrvTexture, gpu_format_type fmt = gpu_format_type::Unknown, u32 mostDetailedMip = 0, u32 mipLevels = ~0, f32 resourceMinLodClamp = 0.0f, u32 planeSlice = 0, u32 firstArraySlice = 0, u32 arraySize = ~0) override
 	{
-		m_impl->gpuCtx.CreateDescriptorSRVTexture(resSrvTexture, GetCPUOffsetCBVSRVUAV(idx), fmt, mostDetailedMip, mipLevels, resourceMinLodClamp, planeSlice, firstArraySlice, arraySize);
+		m_impl->gpuCtx.CreateDescriptorSRVTexture(resolveResource(m_impl->gpuCtx, resSrvTexture), GetCPUOffsetCBVSRVUAV(idx), fmt, mostDetailedMip, mipLevels, resourceMinLodClamp, planeSlice, firstArraySlice, arraySize);
 	}
 
-	virtual void SetSRVBuffer(usize idx, usize resSrvBuffer, u32 stride = 0, usize offset = 0) override
+	virtual void SetSRVBuffer(usize idx, gfx_resource_handle resSrvBuffer, u32 stride = 0, usize offset = 0) override
 	{
-		m_impl->gpuCtx.CreateDescriptorSRVBuffer(resSrvBuffer, GetCPUOffsetCBVSRVUAV(idx), stride, offset);
+		m_impl->gpuCtx.CreateDescriptorSRVBuffer(resolveResource(m_impl->gpuCtx, resSrvBuffer), GetCPUOffsetCBVSRVUAV(idx), stride, offset);
 	}
 
-	virtual void SetCBV(usize idx, usize resCbv, usize offset = 0) override
+	virtual void SetCBV(usize idx, gfx_resource_handle resCbv, usize offset = 0) override
 	{
-		m_impl->gpuCtx.CreateDescriptorCBVBuffer(resCbv, GetCPUOffsetCBVSRVUAV(idx), offset);
+		m_impl->gpuCtx.CreateDescriptorCBVBuffer(resolveResource(m_impl->gpuCtx, resCbv), GetCPUOffsetCBVSRVUAV(idx), offset);
 	}
 
-	virtual void SetUAVBuffer(usize idx, usize resUav, u32 strideInBytes /*= 0*/, usize offsetInElements /*= 0*/, u32 numElements /*= 0*/, u32 counterOffsetInBytes /*= 0Ui64*/, usize counterResourceIdx/*=cfc::invalid_index*/) override
+	virtual void SetUAVBuffer(usize idx, gfx_resource_handle resUav, u32 strideInBytes /*= 0*/, usize offsetInElements /*= 0*/, u32 numElements /*= 0*/, u32 counterOffsetInBytes /*= 0Ui64*/, gfx_resource_handle counterResource/*=gfx_resource_handle()*/) override
 	{
-		m_impl->gpuCtx.CreateDescriptorUAVBuffer(resUav, GetCPUOffsetCBVSRVUAV(idx), strideInBytes, offsetInElements, numElements, counterOffsetInBytes, counterResourceIdx);
-		m_impl->gpuCtx.CreateDescriptorUAVBuffer(resUav, GetUAVCPUDescriptorHandle(idx), strideInBytes, offsetInElements, numElements, counterOffsetInBytes, counterResourceIdx);
+		const usize resUavIdx = resolveResource(m_impl->gpuCtx, resUav);
+		const usize counterResourceIdx = resolveResource(m_impl->gpuCtx, counterResource);
+		m_impl->gpuCtx.CreateDescriptorUAVBuffer(resUavIdx, GetCPUOffsetCBVSRVUAV(idx), strideInBytes, offsetInElements, numElements, counterOffsetInBytes, counterResourceIdx);
+		m_impl->gpuCtx.CreateDescriptorUAVBuffer(resUavIdx, GetUAVCPUDescriptorHandle(idx), strideInBytes, offsetInElements, numElements, counterOffsetInBytes, counterResourceIdx);
 	}
 
-	virtual void SetUAVTexture(usize idx, usize resUav, gpu_format_type fmt = gpu_format_type::Unknown, u32 mipSlice = 0, u32 planeSlice = 0, u32 firstArraySlice = 0, u32 arraySize = ~0) override
+	virtual void SetUAVTexture(usize idx, gfx_resource_handle resUav, gpu_format_type fmt = gpu_format_type::Unknown, u32 mipSlice = 0, u32 planeSlice = 0, u32 firstArraySlice = 0, u32 arraySize = ~0) override
 	{
-		m_impl->gpuCtx.CreateDescriptorUAVTexture(resUav, GetCPUOffsetCBVSRVUAV(idx), fmt, mipSlice, planeSlice, firstArraySlice, arraySize);
-		m_impl->gpuCtx.CreateDescriptorUAVTexture(resUav, GetUAVCPUDescriptorHandle(idx), fmt, mipSlice, planeSlice, firstArraySlice, arraySize);
+		const usize resUavIdx = resolveResource(m_impl->gpuCtx, resUav);
+		m_impl->gpuCtx.CreateDescriptorUAVTexture(resUavIdx, GetCPUOffsetCBVSRVUAV(idx), fmt, mipSlice, planeSlice, firstArraySlice, arraySize);
+		m_impl->gpuCtx.CreateDescriptorUAVTexture(resUavIdx, GetUAVCPUDescriptorHandle(idx), fmt, mipSlice, planeSlice, firstArraySlice, arraySize);
 	}
 
 
@@ -245,7 +334,7 @@ public:
 
 	gfx_dx12_resource_stream* m_resStream;
 	_imp_dx12_gfx* m_impl;
-	usize m_index;
+	gfx_descriptor_heap_handle m_handle;
 
 
 };
@@ -324,21 +413,64 @@ public:
 		return *(supplemental_res_data*)m_impl->gpuCtx.ResourceGetCustom(resourceIdx);
 	}
 
-	virtual usize GetIndex() override
+	virtual gfx_resource_stream_handle GetHandle() override
+	{
+		return m_handle;
+	}
+
+	virtual gfx_resource_handle AddStaticResource(gfx_resource_type bufType, const void* bufData, usize bytes) override
+	{
+		usize gpuResource = _AddDynamicResource(bufType, bytes, false, false);
+		_UpdateDynamicResource(gpuResource, bytes, bufData, 0);
+		trackResourceMemory(m_impl, gpuResource, gfx_memory_category::StaticResources);
+		return makeResourceHandle(m_impl->gpuCtx, gpuResource);
+	}
+
+	virtual gfx_resource_handle AddDynamicResource(gfx_resource_type type, usize bytes, bool cpuResident, bool readBack) override
+	{
+		usize gpuResource = _AddDynamicResource(type, bytes, cpuResident, readBack);
+		trackResourceMemory(m_impl, gpuResource, gfx_memory_category::DynamicResources);
+		return makeResourceHandle(m_impl->gpuCtx, gpuResource);
+	}
+
+	virtual gfx_resource_handle AddTexture(const gfx_texture_creation_desc& desc) override
+	{
+		usize gpuResource = _AddTexture(desc);
+		trackResourceMemory(m_impl, gpuResource, gfx_memory_category::Textures);
+		return makeResourceHandle(m_impl->gpuCtx, gpuResource);
+	}
+
+	virtual void UpdateDynamicResource(gfx_resource_handle resource, u64 bytes, const void* dataBuffer, u64 dstOffset = 0) override
+	{
+		_UpdateDynamicResource(resolveResource(m_impl->gpuCtx, resource), bytes, dataBuffer, dstOffset);
+	}
+
+	virtual void UpdateTexture(gfx_resource_handle resource, const void* dataBuffer, usize dataBufferRowPitch, int w, int h, int d, int dest_x, int dest_y, int dest_z, int dest_mip, int dest_arraySlice) override
+	{
+		_UpdateTexture(resolveResource(m_impl->gpuCtx, resource), dataBuffer, dataBufferRowPitch, w, h, d, dest_x, dest_y, dest_z, dest_mip, dest_arraySlice);
+	}
+
+	virtual gfx_resource_handle AddTextureReadback(gfx_resource_handle texture, u32 firstMip, u32 numMips) override
+	{
+		usize gpuResource = _AddTextureReadback(resolveResource(m_impl->gpuCtx, texture), firstMip, numMips);
+		trackResourceMemory(m_impl, gpuResource, gfx_memory_category::DynamicResources);
+		return makeResourceHandle(m_impl->gpuCtx, gpuResource);
+	}
+
+	virtual void ReadTextureReadback(gfx_resource_handle readback, void* dataOUT) override
 	{
-		return m_index;
+		_ReadTextureReadback(resolveResource(m_impl->gpuCtx, readback), dataOUT);
 	}
 
-	virtual usize AddStaticResource(gfx_resource_type bufType, const void* bufData, usize bytes) override
+	virtual gfx_resource_handle AllocateTemporary(gfx_resource_type type, usize bytes, u64& outResourceOffset, u64 alignment) override
 	{
-		usize gpuResource = AddDynamicResource(bufType, bytes, false, false);
-		UpdateDynamicResource(gpuResource, bytes, bufData, 0);
-		return gpuResource;
+		return makeResourceHandle(m_impl->gpuCtx, _AllocateTemporary(type, bytes, outResourceOffset, alignment));
 	}
 
-	virtual usize AddDynamicResource(gfx_resource_type type, usize bytes, bool cpuResident, bool readBack) override
+	// NOTE: the stream works with gpu resource indices internally, handles are made and resolved at the interface above
+	usize _AddDynamicResource(gfx_resource_type type, usize bytes, bool cpuResident, bool readBack)
 	{
-		MICROPROFILE_SCOPEI("DX12", "AddDynamicResource", 0);
+		CFC_PROFILE_SCOPE("DX12 AddDynamicResource");
 
 		// constant buffers need to be 256 byte aligned
 		if(type == gfx_resource_type::ConstantBuffer)
@@ -371,9 +503,9 @@ public:
 	}
 	
 
-	virtual usize AddTexture(const gfx_texture_creation_desc& desc) override
+	usize _AddTexture(const gfx_texture_creation_desc& desc)
 	{
-		MICROPROFILE_SCOPEI("DX12", "AddTexture", 0);
+		CFC_PROFILE_SCOPE("DX12 AddTexture");
 		gpu_resource_desc resDesc;
 		gpu_resource_desc::resourceflags::flag flags = gpu_resource_desc::resourceflags::None;
 		flags |= desc.AllowUAV ? gpu_resource_desc::resourceflags::AllowUnorderedAccess : 0;
@@ -389,12 +521,18 @@ public:
 		case gfx_texture_type::Texture3D:				resDesc = gpu_resource_desc::Tex3D(desc.Format, desc.Width, desc.Height, desc.Depth, desc.Mipmaps, flags); break;
 		}
 
-		usize res = m_impl->gpuCtx.CreateCommittedResource(gpu_heap_type::Default, resDesc, desc.InitialData == nullptr ? ResourceTypeToState(gfx_resource_type::SRVBuffer) : cfc::gpu_resourcestate::CopyDestination);
+		// mips that are not uploaded can be copied from another texture
+		const int numUploadMips = desc.InitialDataMipmaps < 0 ? desc.Mipmaps : desc.InitialDataMipmaps;
+		const bool copyMips = desc.CopySource.IsValid() && numUploadMips < desc.Mipmaps;
+		stl_assert((desc.InitialDataMipmaps < 0 && !copyMips) || desc.ArraySize == 1);
 
-		if (desc.InitialData)
+		const bool initialized = (desc.InitialData != nullptr && numUploadMips > 0) || copyMips;
+		usize res = m_impl->gpuCtx.CreateCommittedResource(gpu_heap_type::Default, resDesc, initialized ? cfc::gpu_resourcestate::CopyDestination : ResourceTypeToState(gfx_resource_type::SRVBuffer));
+
+		if (desc.InitialData && numUploadMips > 0)
 		{
 			// calculate number of footprints
-			usize numFootprints = desc.Mipmaps * desc.ArraySize;
+			usize numFootprints = numUploadMips * desc.ArraySize;
 
 			// calculate size requirements
 			stl_vector< gpu_copyablefootprint_desc> footprints;
@@ -424,7 +562,8 @@ public:
 				char* ptr = bptr + footprints[srIndex].Offset;
 				for (u32 z = 0; z < footprints[srIndex].Depth; z++)
 				{
-					for (u32 y = 0; y < footprints[srIndex].Height; y++)
+					// NOTE: NumRows equals Height for uncompressed formats, for block compressed formats it is the number of block rows
+					for (u32 y = 0; y < footprints[srIndex].NumRows; y++)
 					{
 						memcpy(ptr, sptr, (usize)footprints[srIndex].RowSizeInBytes);
 						sptr += footprints[srIndex].RowSizeInBytes;
@@ -438,14 +577,82 @@ public:
 			gpu_dx12_cmdlist_direct_api& api = gpuResourceCmds;
 			for (usize i = 0; i < footprints.size(); i++)
 				gpuResourceCmds.CopyTextureRegion(gpu_texturecopy_desc::AsSubresourceIndex(res, (u32)i), gpu_texturecopy_desc::AsPlacedFootprint(resUpload, footprints[i]));
-			gpuResourceCmds.ResourceBarrier(1, &gpu_resourcebarrier_desc::Transition(res, gpu_resourcestate::CopyDestination, ResourceTypeToState(gfx_resource_type::SRVBuffer)));
 			cmdResourcesFreeListBack.push_back(stl_pair<gpu_object_type, usize>(gpu_object_type::Resource, resUpload));
 		}
 
+		if (copyMips)
+		{
+			// NOTE: the source stays a shader resource for the frames around this copy, it is only a copy source within the stream
+			const usize resSource = resolveResource(m_impl->gpuCtx, desc.CopySource);
+			gpuResourceCmds.ResourceBarrier(1, &gpu_resourcebarrier_desc::Transition(resSource, ResourceTypeToState(gfx_resource_type::SRVBuffer), gpu_resourcestate::CopySource));
+			for (int i = numUploadMips; i < desc.Mipmaps; i++)
+				gpuResourceCmds.CopyTextureRegion(gpu_texturecopy_desc::AsSubresourceIndex(res, (u32)i), gpu_texturecopy_desc::AsSubresourceIndex(resSource, (u32)(desc.CopySourceMip + i - numUploadMips)));
+			gpuResourceCmds.ResourceBarrier(1, &gpu_resourcebarrier_desc::Transition(resSource, gpu_resourcestate::CopySource, ResourceTypeToState(gfx_resource_type::SRVBuffer)));
+		}
+
+		if (initialized)
+			gpuResourceCmds.ResourceBarrier(1, &gpu_resourcebarrier_desc::Transition(res, gpu_resourcestate::CopyDestination, ResourceTypeToState(gfx_resource_type::SRVBuffer)));
+
+		return res;
+	}
+
+	usize _AddTextureReadback(usize textureIdx, u32 firstMip, u32 numMips)
+	{
+		CFC_PROFILE_SCOPE("DX12 AddTextureReadback");
+		const gpu_resource_desc resDesc = m_impl->gpuCtx.ResourceGetDesc(textureIdx);
+		stl_assert(resDesc.DepthOrArraySize == 1 && numMips > 0 && firstMip + numMips <= resDesc.MipLevels);
+
+		// same placement as the upload of the initial data
+		stl_vector<gpu_copyablefootprint_desc> footprints;
+		for (u32 i = 0; i < numMips; i++)
+		{
+			u64 offset = i > 0 ? footprints[i - 1].Offset + footprints[i - 1].TotalBytes : 0;
+			offset = stl_math_iroundup(offset, 512); // dx12 padding requirement
+			footprints.push_back(m_impl->gpuCtx.GetCopyableFootprints(resDesc, firstMip + i, offset));
+		}
+
+		usize res = m_impl->gpuCtx.CreateCommittedResource(gpu_heap_type::Readback, gpu_resource_desc::Buffer(footprints.back().Offset + footprints.back().TotalBytes), gpu_resourcestate::CopyDestination);
+		if (res == cfc::invalid_index)
+			return cfc::invalid_index;
+
+		gpuResourceCmds.ResourceBarrier(1, &gpu_resourcebarrier_desc::Transition(textureIdx, ResourceTypeToState(gfx_resource_type::SRVBuffer), gpu_resourcestate::CopySource));
+		for (u32 i = 0; i < numMips; i++)
+			gpuResourceCmds.CopyTextureRegion(gpu_texturecopy_desc::AsPlacedFootprint(res, footprints[i]), gpu_texturecopy_desc::AsSubresourceIndex(textureIdx, firstMip + i));
+		gpuResourceCmds.ResourceBarrier(1, &gpu_resourcebarrier_desc::Transition(textureIdx, gpu_resourcestate::CopySource, ResourceTypeToState(gfx_resource_type::SRVBuffer)));
+
+		readbackFootprints.push_back(stl_pair<usize, stl_vector<gpu_copyablefootprint_desc>>(res, std::move(footprints)));
 		return res;
 	}
 
-	virtual void UpdateDynamicResource(usize resourceIdx, u64 bytes, const void* dataBuffer, u64 dstOffset = 0)
+	void _ReadTextureReadback(usize resourceIdx, void* dataOUT)
+	{
+		// the footprints are only needed once, the caller removes the resource after reading it
+		usize entry = 0;
+		while (entry < readbackFootprints.size() && readbackFootprints[entry].first != resourceIdx)
+			entry++;
+		stl_assert(entry < readbackFootprints.size());
+
+		const stl_vector<gpu_copyablefootprint_desc>& footprints = readbackFootprints[entry].second;
+		const usize numBytes = (usize)(footprints.back().Offset + footprints.back().TotalBytes);
+		const char* bptr = (const char*)m_impl->gpuCtx.ResourceMap(resourceIdx, true, 0, 0, numBytes);
+		char* dptr = (char*)dataOUT;
+		for (usize srIndex = 0; srIndex < footprints.size(); srIndex++)
+		{
+			const char* ptr = bptr + footprints[srIndex].Offset;
+			for (u32 y = 0; y < footprints[srIndex].NumRows; y++)
+			{
+				memcpy(dptr, ptr, (usize)footprints[srIndex].RowSizeInBytes);
+				dptr += footprints[srIndex].RowSizeInBytes;
+				ptr += footprints[srIndex].RowPitch;
+			}
+		}
+		m_impl->gpuCtx.ResourceUnmap(resourceIdx, false);
+
+		readbackFootprints[entry] = std::move(readbackFootprints.back());
+		readbackFootprints.pop_back();
+	}
+
+	void _UpdateDynamicResource(usize resourceIdx, u64 bytes, const void* dataBuffer, u64 dstOffset = 0)
 	{
 		auto heapType = m_impl->gpuCtx.ResourceGetHeapType(resourceIdx);
 		if (heapType == gpu_heap_type::Upload)
@@ -461,8 +668,8 @@ public:
 			auto resType = ResourceTypeToState(GetSupplementalResData(resourceIdx).type);
 
 			// very inefficient - creates/destroys constant buffer every time
-			usize cpuResource = AddDynamicResource(gfx_resource_type::ConstantBuffer, bytes, true);
-			UpdateDynamicResource(cpuResource, bytes, dataBuffer, 0);
+			usize cpuResource = _AddDynamicResource(gfx_resource_type::ConstantBuffer, bytes, true, false);
+			_UpdateDynamicResource(cpuResource, bytes, dataBuffer, 0);
 			gpuResourceCmds.ResourceBarrier(1, &cfc::gpu_resourcebarrier_desc::Transition(resourceIdx, resType, gpu_resourcestate::CopyDestination));
 			gpuResourceCmds.CopyBufferRegion(resourceIdx, dstOffset, cpuResource, 0, bytes);
 			gpuResourceCmds.ResourceBarrier(1, &cfc::gpu_resourcebarrier_desc::Transition(resourceIdx, gpu_resourcestate::CopyDestination, resType));
@@ -470,8 +677,8 @@ public:
 #elif defined(METHOD_SPINHEAP_COPY_IMMEDIATE) || defined(METHOD_SPINHEAP_COPY_BUFFERED)
 			// update spinheap
 			u64 spinOffset = ~0ULL;
-			usize resourceTemporary = AllocateTemporary(gfx_resource_type::Unknown, bytes, spinOffset, 256);
-			UpdateDynamicResource(resourceTemporary, bytes, dataBuffer, spinOffset);
+			usize resourceTemporary = _AllocateTemporary(gfx_resource_type::Unknown, bytes, spinOffset, 256);
+			_UpdateDynamicResource(resourceTemporary, bytes, dataBuffer, spinOffset);
 			
 			// get resource type 
 			auto resType = ResourceTypeToState(GetSupplementalResData(resourceIdx).type);
@@ -497,7 +704,7 @@ public:
 		}
 	}
 
-	virtual void UpdateTexture(usize resourceIdx, const void* dataBuffer, usize dataBufferRowPitch, int w, int h, int d, int dest_x, int dest_y, int dest_z, int dest_mip, int dest_arraySlice)
+	void _UpdateTexture(usize resourceIdx, const void* dataBuffer, usize dataBufferRowPitch, int w, int h, int d, int dest_x, int dest_y, int dest_z, int dest_mip, int dest_arraySlice)
 	{
 		usize res = resourceIdx;
 		gpu_resource_desc rdesc = m_impl->gpuCtx.ResourceGetDesc(resourceIdx);
@@ -511,7 +718,7 @@ public:
 
 		// create upload buffer
 		//usize resUpload = m_impl->gpuCtx.CreateCommittedResource(gpu_heap_type::Upload, gpu_resource_desc::Buffer(footprint.Offset + footprint.TotalBytes), gpu_resourcestate::GenericRead);
-		usize resUpload = AllocateTemporary(cfc::gfx_resource_type::Unknown, footprint.TotalBytes, footprint.Offset, 512);
+		usize resUpload = _AllocateTemporary(cfc::gfx_resource_type::Unknown, footprint.TotalBytes, footprint.Offset, 512);
 		if (resUpload == cfc::invalid_index)
 			return;
 
@@ -521,7 +728,7 @@ public:
 		char* ptr = bptr + footprint.Offset;
 		for (u32 z = 0; z < footprint.Depth; z++)
 		{
-			for (u32 y = 0; y < footprint.Height; y++)
+			for (u32 y = 0; y < footprint.NumRows; y++)
 			{
 				if (sptr != nullptr)
 				{
@@ -546,13 +753,13 @@ public:
 	}
 
 
-	usize AllocateTemporary(gfx_resource_type type, usize bytes, u64& outResourceOffset, u64 alignment)
+	usize _AllocateTemporary(gfx_resource_type type, usize bytes, u64& outResourceOffset, u64 alignment)
 	{
 		// create spinheap if it doesn't exist yet
 		if (resCPUSpinheap == cfc::invalid_index)
 		{
 			resCPUSpinheap_size = g_spinbufferSize;	
-			resCPUSpinheap = AddDynamicResource(gfx_resource_type::Unknown, resCPUSpinheap_size, true, false);
+			resCPUSpinheap = _AddDynamicResource(gfx_resource_type::Unknown, resCPUSpinheap_size, true, false);
 		}
 
 		// check size
@@ -578,7 +785,7 @@ public:
 
 	virtual void Flush() override
 	{
-		MICROPROFILE_SCOPEI("DX12", "FlushResources", 0);
+		CFC_PROFILE_SCOPE("DX12 FlushResources");
 
 		// execute buffered operations
 		{
@@ -617,7 +824,7 @@ public:
 
 		// flush new command queue
 		{
-			MICROPROFILE_SCOPEI("DX12", "FlushResourcesLocked", 0);
+			CFC_PROFILE_SCOPE("DX12 FlushResourcesLocked");
 
 			// close resource command buffer
 			stl_assert(gpuResourceCmds.Close());
@@ -643,7 +850,7 @@ public:
 		// if previous buffer/allocator is still in use, we cannot swap yet and have to wait..
 		if (m_impl->gpuCtx.FenceGetCompletedValue(fncResource) != resourceFrameIndex)
 		{
-			MICROPROFILE_SCOPEI("DX12", "FlushResourcesWait", 0);
+			CFC_PROFILE_SCOPE("DX12 FlushResourcesWait");
 			m_impl->gpuCtx.FenceSetEventOnCompletion(fncResource, fnevResource, resourceFrameIndex);
 			m_impl->gpuCtx.FenceEventWaitFor(fnevResource);
 		}
@@ -652,7 +859,7 @@ public:
 
 
 	_imp_dx12_gfx* m_impl;
-	usize m_index;
+	gfx_resource_stream_handle m_handle;
 
 	usize cmdResourceListIdx;
 	usize cmdResourceAllocatorFront, cmdResourceAllocatorBack;
@@ -663,6 +870,9 @@ public:
 	usize fnevResource;
 	u64 resourceFrameIndex = 0;
 
+	// readbacks waiting to be read, with the placement of their mips
+	stl_vector<stl_pair<usize, stl_vector<gpu_copyablefootprint_desc>>> readbackFootprints;
+
 	// Spinheap
 	usize resCPUSpinheap = cfc::invalid_index;
 	u64 resCPUSpinheap_offset = 0;
@@ -708,9 +918,9 @@ public:
 		return m_type;
 	}
 
-	virtual usize GetIndex() const override
+	virtual gfx_command_list_handle GetHandle() const override
 	{
-		return m_index;
+		return m_handle;
 	}
 
 	usize GetCommandListIndex() const { return cmdListIdx; }
@@ -734,16 +944,16 @@ public:
 		activeHeap = rHeap;
 	}
 
-	virtual void GFXSetProgram(usize gfxProgramIdx) override
+	virtual void GFXSetProgram(gfx_program_handle gfxProgram) override
 	{
-		gfx_dx12_program* program = m_impl->resGfxPrograms[gfxProgramIdx].get();
+		gfx_dx12_program* program = m_impl->resGfxPrograms[resolveHandle(m_impl->resGfxPrograms, gfxProgram)].get();
 
 		cmdListBundleApi.SetGraphicsRootSignature(program->rootSignatureIndex);
 	}
 
-	virtual void GFXSetProgramState(usize gfxProgramIdx, usize programStateIdx) override
+	virtual void GFXSetProgramState(gfx_program_handle gfxProgram, usize programStateIdx) override
 	{
-		gfx_dx12_program* program = m_impl->resGfxPrograms[gfxProgramIdx].get();
+		gfx_dx12_program* program = m_impl->resGfxPrograms[resolveHandle(m_impl->resGfxPrograms, gfxProgram)].get();
 		cmdListBundleApi.SetPipelineState(program->graphicsPipelineStateIndices[programStateIdx]);
 	}
 
@@ -757,19 +967,19 @@ public:
 		cmdListBundleApi.SetGraphicsRootDescriptorTable(slot, activeHeap->GetGPUOffsetSamplers(blockIndex));
 	}
 
-	virtual void GFXSetRootParameterCBV(i32 slot, usize cbv, u64 offset) override
+	virtual void GFXSetRootParameterCBV(i32 slot, gfx_resource_handle cbv, u64 offset) override
 	{
-		cmdListBundleApi.SetGraphicsRootConstantBufferView(slot, m_impl->gpuCtx.ResourceGetGPUAddress(cbv) + offset);
+		cmdListBundleApi.SetGraphicsRootConstantBufferView(slot, m_impl->gpuCtx.ResourceGetGPUAddress(resolveResource(m_impl->gpuCtx, cbv)) + offset);
 	}
 
-	virtual void GFXSetRootParameterUAV(i32 slot, usize uav, u64 offset) override
+	virtual void GFXSetRootParameterUAV(i32 slot, gfx_resource_handle uav, u64 offset) override
 	{
-		cmdListBundleApi.SetGraphicsRootUnorderedAccessView(slot, m_impl->gpuCtx.ResourceGetGPUAddress(uav) + offset);
+		cmdListBundleApi.SetGraphicsRootUnorderedAccessView(slot, m_impl->gpuCtx.ResourceGetGPUAddress(resolveResource(m_impl->gpuCtx, uav)) + offset);
 	}
 
-	virtual void GFXSetRootParameterSRV(i32 slot, usize srv, u64 offset) override
+	virtual void GFXSetRootParameterSRV(i32 slot, gfx_resource_handle srv, u64 offset) override
 	{
-		cmdListBundleApi.SetGraphicsRootShaderResourceView(slot, m_impl->gpuCtx.ResourceGetGPUAddress(srv) + offset);
+		cmdListBundleApi.SetGraphicsRootShaderResourceView(slot, m_impl->gpuCtx.ResourceGetGPUAddress(resolveResource(m_impl->gpuCtx, srv)) + offset);
 	}
 
 	virtual void GFXSetRootParameterConstants(i32 slot, const void* data, u32 sizeInDwords, u32 offsetInDwords = 0) override
@@ -782,18 +992,18 @@ public:
 		cmdListBundleApi.IASetPrimitiveTopology(primType);
 	}
 
-	virtual void GFXSetVertexBuffer(i32 startSlot, usize idx, usize offset, u32 stride, u32 size) override
+	virtual void GFXSetVertexBuffer(i32 startSlot, gfx_resource_handle resource, usize offset, u32 stride, u32 size) override
 	{
 		cfc::gpu_vertexbuffer_view vbv;
-		vbv.GpuBufferLocation = m_impl->gpuCtx.ResourceGetGPUAddress(idx) + offset;
+		vbv.GpuBufferLocation = m_impl->gpuCtx.ResourceGetGPUAddress(resolveResource(m_impl->gpuCtx, resource)) + offset;
 		vbv.SizeInBytes = size;
 		vbv.StrideInBytes = stride;
 		cmdListBundleApi.IASetVertexBuffers(startSlot, 1, &vbv);
 	}
 
-	virtual void GFXSetIndexBuffer(usize idx, usize offset, usize sizeInBytes, cfc::gpu_format_type fmt) override
+	virtual void GFXSetIndexBuffer(gfx_resource_handle resource, usize offset, usize sizeInBytes, cfc::gpu_format_type fmt) override
 	{
-		cmdListBundleApi.IASetIndexBuffer(m_impl->gpuCtx.ResourceGetGPUAddress(idx) + offset, (u32)sizeInBytes, fmt);
+		cmdListBundleApi.IASetIndexBuffer(m_impl->gpuCtx.ResourceGetGPUAddress(resolveResource(m_impl->gpuCtx, resource)) + offset, (u32)sizeInBytes, fmt);
 	}
 
 	virtual void GFXDrawInstanced(u32 VertexCountPerInstance, u32 InstanceCount, u32 StartVertexLocation, u32 StartInstanceLocation) override
@@ -806,22 +1016,22 @@ public:
 		cmdListBundleApi.DrawIndexedInstanced(IndexCountPerInstance, InstanceCount, StartIndexLocation, BaseVertexLocation, StartInstanceLocation);
 	}
 	
-	virtual void GFXExecuteBundle(usize cmdBundleIdx) override
+	virtual void GFXExecuteBundle(gfx_command_list_handle cmdBundle) override
 	{
-		cmdListDirectApi.ExecuteBundle(m_impl->resCommandBundles[cmdBundleIdx]->GetCommandListIndex());
+		cmdListDirectApi.ExecuteBundle(m_impl->resCommandBundles[resolveHandle(m_impl->resCommandBundles, cmdBundle)]->GetCommandListIndex());
 	}
 	
 
-	virtual void CMPSetProgram(usize gfxProgramIdx) override
+	virtual void CMPSetProgram(gfx_program_handle cmpProgram) override
 	{
-		gfx_dx12_program* program = m_impl->resGfxPrograms[gfxProgramIdx].get();
+		gfx_dx12_program* program = m_impl->resGfxPrograms[resolveHandle(m_impl->resGfxPrograms, cmpProgram)].get();
 
 		cmdListBundleApi.SetComputeRootSignature(program->rootSignatureIndex);
 	}
 
-	virtual void CMPSetProgramState(usize gfxProgramIdx, usize programStateIdx) override
+	virtual void CMPSetProgramState(gfx_program_handle cmpProgram, usize programStateIdx) override
 	{
-		gfx_dx12_program* program = m_impl->resGfxPrograms[gfxProgramIdx].get();
+		gfx_dx12_program* program = m_impl->resGfxPrograms[resolveHandle(m_impl->resGfxPrograms, cmpProgram)].get();
 		cmdListBundleApi.SetPipelineState(program->graphicsPipelineStateIndices[programStateIdx]);
 	}
 
@@ -835,19 +1045,19 @@ public:
 		cmdListBundleApi.SetComputeRootDescriptorTable(slot, activeHeap->GetGPUOffsetSamplers(blockIndex));
 	}
 
-	virtual void CMPSetRootParameterCBV(i32 slot, usize cbv, u64 offset) override
+	virtual void CMPSetRootParameterCBV(i32 slot, gfx_resource_handle cbv, u64 offset) override
 	{
-		cmdListBundleApi.SetComputeRootConstantBufferView(slot, m_impl->gpuCtx.ResourceGetGPUAddress(cbv) + offset);
+		cmdListBundleApi.SetComputeRootConstantBufferView(slot, m_impl->gpuCtx.ResourceGetGPUAddress(resolveResource(m_impl->gpuCtx, cbv)) + offset);
 	}
 
-	virtual void CMPSetRootParameterUAV(i32 slot, usize uav, u64 offset) override
+	virtual void CMPSetRootParameterUAV(i32 slot, gfx_resource_handle uav, u64 offset) override
 	{
-		cmdListBundleApi.SetComputeRootUnorderedAccessView(slot, m_impl->gpuCtx.ResourceGetGPUAddress(uav) + offset);
+		cmdListBundleApi.SetComputeRootUnorderedAccessView(slot, m_impl->gpuCtx.ResourceGetGPUAddress(resolveResource(m_impl->gpuCtx, uav)) + offset);
 	}
 
-	virtual void CMPSetRootParameterSRV(i32 slot, usize srv, u64 offset) override
+	virtual void CMPSetRootParameterSRV(i32 slot, gfx_resource_handle srv, u64 offset) override
 	{
-		cmdListBundleApi.SetComputeRootShaderResourceView(slot, m_impl->gpuCtx.ResourceGetGPUAddress(srv) + offset);
+		cmdListBundleApi.SetComputeRootShaderResourceView(slot, m_impl->gpuCtx.ResourceGetGPUAddress(resolveResource(m_impl->gpuCtx, srv)) + offset);
 	}
 
 	virtual void CMPSetRootParameterConstants(i32 slot, const void* data, u32 sizeInDwords, u32 offsetInDwords = 0) override
@@ -893,6 +1103,12 @@ public:
 		cmdListDirectApi.ResourceBarrier((u32)count, barrierList);
 	}
 
+	virtual void ExecuteTransitionBarrier(gfx_resource_handle resource, u32 stateBefore, u32 stateAfter) override
+	{
+		gpu_resourcebarrier_desc barrier = gpu_resourcebarrier_desc::Transition(resolveResource(m_impl->gpuCtx, resource), stateBefore, stateAfter);
+		cmdListDirectApi.ResourceBarrier(1, &barrier);
+	}
+
 	virtual u32 InsertTimerQuery() override 
 	{
 		const u32 timerQueryIndex = m_impl->gpuTimerQueryIndex.fetch_add(1) % MAX_NUM_GPU_TIMER_QUERIES;
@@ -900,9 +1116,20 @@ public:
 		return timerQueryIndex;
 	}
 
-	virtual void ResolveQueryData(usize queryHeapIdx, cfc::gpu_query_type type, u32 startIndex, u32 numQueries, usize destinationResourceIdx, u64 alignedDestinationBufferOffset) override
+	virtual u32 InsertTimerQueryEnd(u32 startIndex, const char* description) override
 	{
-		cmdListBundleApi.ResolveQueryData(queryHeapIdx, type, startIndex, numQueries, destinationResourceIdx, alignedDestinationBufferOffset);
+		const u32 timerQueryIndex = InsertTimerQuery();
+
+		query_timer_zone& zone = m_impl->gpuTimerQueryZones[timerQueryIndex];
+		zone.StartIndex = startIndex;
+		snprintf(zone.Name, sizeof(zone.Name), "%s", description);
+		zone.IsValid = true;
+		return timerQueryIndex;
+	}
+
+	virtual void ResolveQueryData(usize queryHeapIdx, cfc::gpu_query_type type, u32 startIndex, u32 numQueries, gfx_resource_handle destinationResource, u64 alignedDestinationBufferOffset) override
+	{
+		cmdListBundleApi.ResolveQueryData(queryHeapIdx, type, startIndex, numQueries, resolveResource(m_impl->gpuCtx, destinationResource), alignedDestinationBufferOffset);
 	}
 	// -----------------------------------
 
@@ -913,7 +1140,7 @@ public:
 	gfx_dx12_desc_heap* activeHeap = nullptr;
 
 	_imp_dx12_gfx* m_impl;
-	usize m_index;
+	gfx_command_list_handle m_handle;
 	type m_type;
 };
 
@@ -1081,11 +1308,13 @@ void gfx_dx12::Init(cfc::context& ctx, usize deviceID /*= 0*/, u32 numFrames /*=
 	m_impl->gpuTimerQueryFnc = m_impl->gpuCtx.CreateFence(0, gpu_fenceshare_type::Unshared);
 	m_impl->gpuTimerQueryFnev = m_impl->gpuCtx.CreateFenceEvent();
 	m_impl->gpuTimerQueryResults.resize(MAX_NUM_GPU_TIMER_QUERIES);
+	m_impl->gpuTimerQueryZones.resize(MAX_NUM_GPU_TIMER_QUERIES);
+	memset(&m_impl->gpuTimerQueryZones[0], 0, MAX_NUM_GPU_TIMER_QUERIES * sizeof(query_timer_zone));
 	gfx_resource_stream* resourceStream = GetResourceStream(AddResourceStream());
 	m_impl->gpuTimerQueryReadbackBuffer = resourceStream->AddDynamicResource(gfx_resource_type::CopyDest, MAX_NUM_GPU_TIMER_QUERIES * sizeof(u64), false, true);
 	resourceStream->Flush();
 	resourceStream->WaitForFinish();
-	RemoveResourceStream(resourceStream->GetIndex());
+	RemoveResourceStream(resourceStream->GetHandle());
 
 	m_impl->gpuTimerQueryHeap = m_impl->gpuCtx.CreateQueryHeap(gpu_queryheap_type::TimeStamp, MAX_NUM_GPU_TIMER_QUERIES);
 
@@ -1098,7 +1327,7 @@ void gfx_dx12::Init(cfc::context& ctx, usize deviceID /*= 0*/, u32 numFrames /*=
 
 void gfx_dx12::_Resize()
 {
-	MICROPROFILE_SCOPEI("DX12", "Resize", 0);
+	CFC_PROFILE_SCOPE("DX12 Resize");
 
 	// calculate swapchain buffers
 	u32 swapChainFrames = stl_math_max(2, m_impl->numFrames);
@@ -1136,7 +1365,7 @@ void gfx_dx12::_Resize()
 	{
 		m_impl->resFrameRT[i] = m_impl->gpuCtx.CreateSwapChainResource(m_impl->swapChain, i);
 		stl_assert(m_impl->gpuCtx.CreateDescriptorRTVTexture(m_impl->resFrameRT[i], rtvHeapStart + m_impl->rtvDescriptorSize * i, m_impl->resFrameRT_type));
-		m_impl->gpuCtx.ResourceSetName(GetBackbufferRTResource(i), stl_string_advanced::sprintf("BackbufferRT-%d", i).c_str());
+		m_impl->gpuCtx.ResourceSetName(m_impl->resFrameRT[i], stl_string_advanced::sprintf("BackbufferRT-%d", i).c_str());
 	}
 
 	if(m_impl->resFrameDepth_type != gpu_format_type::Unknown)
@@ -1172,9 +1401,9 @@ gpu_features cfc::gfx_dx12::GetDeviceFeatures() const
 	return m_impl->gpuCtx.DeviceGetFeatures();
 }
 
-usize cfc::gfx_dx12::AddShaderFromMemory(const void* fileData, usize fileDataSize, const char* funcName /*= "main"*/, const char* shaderType /*= "vs_5_0"*/, const char* shaderFilename /*= "unknown.shd"*/, const char* defineData /*=null*/)
+gfx_shader_handle cfc::gfx_dx12::AddShaderFromMemory(const void* fileData, usize fileDataSize, const char* funcName /*= "main"*/, const char* shaderType /*= "vs_5_0"*/, const char* shaderFilename /*= "unknown.shd"*/, const char* defineData /*=null*/)
 {
-	MICROPROFILE_SCOPEI("DX12", "AddShaderFromMemory", 0);
+	CFC_PROFILE_SCOPE("DX12 AddShaderFromMemory");
 
 	// copy defines into the shader
 	char copyBuffer[g_shaderDefineCopyBufferSize];
@@ -1201,12 +1430,12 @@ usize cfc::gfx_dx12::AddShaderFromMemory(const void* fileData, usize fileDataSiz
 		m_impl->ctx->Log->Logf(cfc::logflags::ScpEngine | cfc::logflags::SevError, "Shader compilation failure: %s", shrErrors.c_str());
 	}
 
-	return shaderIdx;
+	return makeShaderHandle(m_impl->gpuCtx, shaderIdx);
 }
 
-usize cfc::gfx_dx12::AddDescriptorHeap(i32 maxCbvSrvUav, i32 maxSamplers)
+gfx_descriptor_heap_handle cfc::gfx_dx12::AddDescriptorHeap(i32 maxCbvSrvUav, i32 maxSamplers)
 {
-	MICROPROFILE_SCOPEI("DX12", "AddDescriptorHeap", 0);
+	CFC_PROFILE_SCOPE("DX12 AddDescriptorHeap");
 
 	stl_unique_ptr<gfx_dx12_desc_heap> ret(new gfx_dx12_desc_heap(m_impl.get()));
 
@@ -1237,20 +1466,20 @@ usize cfc::gfx_dx12::AddDescriptorHeap(i32 maxCbvSrvUav, i32 maxSamplers)
 	}
 
 	usize idx = m_impl->resDescriptorHeaps.insert();
-	ret->m_index = idx;
+	ret->m_handle = makeHandle<gfx_descriptor_heap_tag>(m_impl->resDescriptorHeaps, idx);
 	m_impl->resDescriptorHeaps[idx].swap(ret);
 
-	return idx;
+	return m_impl->resDescriptorHeaps[idx]->m_handle;
 }
 
-usize cfc::gfx_dx12::_AddProgram(usize vertexShader, usize pixelShader, usize geometryShader, usize hullShader, usize domainShader, usize computeShader)
+gfx_program_handle cfc::gfx_dx12::_AddProgram(gfx_shader_handle vertexShader, gfx_shader_handle pixelShader, gfx_shader_handle geometryShader, gfx_shader_handle hullShader, gfx_shader_handle domainShader, gfx_shader_handle computeShader)
 {
-	MICROPROFILE_SCOPEI("DX12", "GfxStateCompile", 0);
+	CFC_PROFILE_SCOPE("DX12 GfxStateCompile");
 
 	stl_unique_ptr<gfx_dx12_program> program(new gfx_dx12_program(m_impl.get()));
 
 	// store shaders in program
-	usize shrIndices[] = { vertexShader, pixelShader, geometryShader, hullShader, domainShader, computeShader };
+	usize shrIndices[] = { resolveShader(m_impl->gpuCtx, vertexShader), resolveShader(m_impl->gpuCtx, pixelShader), resolveShader(m_impl->gpuCtx, geometryShader), resolveShader(m_impl->gpuCtx, hullShader), resolveShader(m_impl->gpuCtx, domainShader), resolveShader(m_impl->gpuCtx, computeShader) };
 	memcpy(&program->shaderIndices[0], shrIndices, sizeof(shrIndices));
 
 	// reflect shaders
@@ -1297,19 +1526,19 @@ usize cfc::gfx_dx12::_AddProgram(usize vertexShader, usize pixelShader, usize ge
 
 	// insert into resource list
 	usize idx = m_impl->resGfxPrograms.insert();
-	program->m_index = idx;
+	program->m_handle = makeHandle<gfx_program_tag>(m_impl->resGfxPrograms, idx);
 	m_impl->resGfxPrograms[idx].swap(program);
-	return idx;
+	return m_impl->resGfxPrograms[idx]->m_handle;
 }
 
-usize cfc::gfx_dx12::AddGraphicsProgram(usize vertexShader /*= cfc::invalid_index*/, usize pixelShader /*= cfc::invalid_index*/, usize geometryShader /*= cfc::invalid_index*/, usize hullShader /*= cfc::invalid_index*/, usize domainShader /*= cfc::invalid_index*/)
+gfx_program_handle cfc::gfx_dx12::AddGraphicsProgram(gfx_shader_handle vertexShader /*= gfx_shader_handle()*/, gfx_shader_handle pixelShader /*= gfx_shader_handle()*/, gfx_shader_handle geometryShader /*= gfx_shader_handle()*/, gfx_shader_handle hullShader /*= gfx_shader_handle()*/, gfx_shader_handle domainShader /*= gfx_shader_handle()*/)
 {
-	return _AddProgram(vertexShader, pixelShader, geometryShader, hullShader, domainShader, cfc::invalid_index);
+	return _AddProgram(vertexShader, pixelShader, geometryShader, hullShader, domainShader, gfx_shader_handle());
 }
 
-usize cfc::gfx_dx12::AddGraphicsProgramPipelineState(usize graphicsProgramIdx, const gfx_gfxprogram_desc& descriptor)
+usize cfc::gfx_dx12::AddGraphicsProgramPipelineState(gfx_program_handle graphicsProgram, const gfx_gfxprogram_desc& descriptor)
 {
-	gfx_dx12_program* program = m_impl->resGfxPrograms[graphicsProgramIdx].get();
+	gfx_dx12_program* program = m_impl->resGfxPrograms[resolveHandle(m_impl->resGfxPrograms, graphicsProgram)].get();
 
 	// copy & update pipeline state descriptor
 	cfc::gpu_graphicspipelinestate_desc pipelineDesc(descriptor.Pipeline);
@@ -1329,14 +1558,14 @@ usize cfc::gfx_dx12::AddGraphicsProgramPipelineState(usize graphicsProgramIdx, c
 	return program->graphicsPipelineStateIndices.size() - 1;
 }
 
-usize cfc::gfx_dx12::AddComputeProgram(usize computeShader /*= cfc::invalid_index*/)
+gfx_program_handle cfc::gfx_dx12::AddComputeProgram(gfx_shader_handle computeShader /*= gfx_shader_handle()*/)
 {
-	return _AddProgram(cfc::invalid_index, cfc::invalid_index, cfc::invalid_index, cfc::invalid_index, cfc::invalid_index, computeShader);
+	return _AddProgram(gfx_shader_handle(), gfx_shader_handle(), gfx_shader_handle(), gfx_shader_handle(), gfx_shader_handle(), computeShader);
 }
 
-usize cfc::gfx_dx12::AddComputeProgramPipelineState(usize computeProgramIdx, const gfx_cmpprogram_desc& descriptor)
+usize cfc::gfx_dx12::AddComputeProgramPipelineState(gfx_program_handle computeProgram, const gfx_cmpprogram_desc& descriptor)
 {
-	gfx_dx12_program* program = m_impl->resGfxPrograms[computeProgramIdx].get();
+	gfx_dx12_program* program = m_impl->resGfxPrograms[resolveHandle(m_impl->resGfxPrograms, computeProgram)].get();
 
 	// copy & update pipeline state descriptor
 	cfc::gpu_computepipelinestate_desc pipelineDesc(descriptor.Pipeline);
@@ -1348,111 +1577,120 @@ usize cfc::gfx_dx12::AddComputeProgramPipelineState(usize computeProgramIdx, con
 	return program->graphicsPipelineStateIndices.size() - 1;
 }
 
-usize cfc::gfx_dx12::AddCommandList()
+gfx_command_list_handle cfc::gfx_dx12::AddCommandList()
 {
 	stl_unique_ptr<gfx_dx12_command_list> obj(new gfx_dx12_command_list(m_impl.get(), gfx_command_list::type::Direct, 0));
 	usize idx = m_impl->resCommandLists.insert();
-	obj->m_index = idx;
+	obj->m_handle = makeHandle<gfx_command_list_tag>(m_impl->resCommandLists, idx);
 	m_impl->resCommandLists[idx].swap(obj);
-	return idx;
+	return m_impl->resCommandLists[idx]->m_handle;
 }
 
-usize cfc::gfx_dx12::AddCommandBundle(usize cmdAllocatorBundleId)
+gfx_command_list_handle cfc::gfx_dx12::AddCommandBundle(gfx_bundle_allocator_handle cmdAllocatorBundle)
 {
-	stl_unique_ptr<gfx_dx12_command_list> obj(new gfx_dx12_command_list(m_impl.get(), gfx_command_list::type::Bundle, cmdAllocatorBundleId));
+	stl_unique_ptr<gfx_dx12_command_list> obj(new gfx_dx12_command_list(m_impl.get(), gfx_command_list::type::Bundle, GetBundleAllocator(cmdAllocatorBundle)));
 	usize idx = m_impl->resCommandBundles.insert();
-	obj->m_index = idx;
+	obj->m_handle = makeHandle<gfx_command_list_tag>(m_impl->resCommandBundles, idx);
 	m_impl->resCommandBundles[idx].swap(obj);
-	return idx;
+	return m_impl->resCommandBundles[idx]->m_handle;
 }
 
-usize cfc::gfx_dx12::AddBundleAllocator()
+gfx_bundle_allocator_handle cfc::gfx_dx12::AddBundleAllocator()
 {
 	usize cmdAllocator = m_impl->gpuCtx.CreateCommandAllocator(gpu_commandlist_type::Bundle);
 	usize idx = m_impl->resBundleCommandAllocator.insert();
 	m_impl->resBundleCommandAllocator[idx] = cmdAllocator;
-	return idx;
+	return makeHandle<gfx_bundle_allocator_tag>(m_impl->resBundleCommandAllocator, idx);
 }
 
-usize cfc::gfx_dx12::AddResourceStream()
+gfx_resource_stream_handle cfc::gfx_dx12::AddResourceStream()
 {
-	MICROPROFILE_SCOPEI("DX12", "AddResourceStream", 0);
+	CFC_PROFILE_SCOPE("DX12 AddResourceStream");
 
 	stl_unique_ptr<gfx_dx12_resource_stream> obj(new gfx_dx12_resource_stream(m_impl.get()));
 	usize idx = m_impl->resResourceStreams.insert();
-	obj->m_index = idx;
+	obj->m_handle = makeHandle<gfx_resource_stream_tag>(m_impl->resResourceStreams, idx);
 	m_impl->resResourceStreams[idx].swap(obj);
-	return idx;
+	return m_impl->resResourceStreams[idx]->m_handle;
 }
 
-usize cfc::gfx_dx12::AddRenderTarget2D(i32 width, i32 height, cfc::gpu_format_type format, cfc::gpu_defaultclear_desc defaultClear /*= cfc::gpu_defaultclear_desc()*/)
+gfx_render_target_handle cfc::gfx_dx12::AddRenderTarget2D(i32 width, i32 height, cfc::gpu_format_type format, cfc::gpu_defaultclear_desc defaultClear /*= cfc::gpu_defaultclear_desc()*/)
 {
 	stl_unique_ptr<dx12_gfx_render_target> obj(new dx12_gfx_render_target(m_impl.get()));
 	usize idx = m_impl->resRenderTargets.insert();
 	obj->m_index = idx;
 	obj->Init(width, height, format, defaultClear);
+	trackResourceMemory(m_impl.get(), obj->m_resourceID, gfx_memory_category::RenderTargets);
 	m_impl->resRenderTargets[idx].swap(obj);
-	return idx;
+	return makeHandle<gfx_render_target_tag>(m_impl->resRenderTargets, idx);
 }
 
-void cfc::gfx_dx12::RemoveResource(usize bufferID)
+void cfc::gfx_dx12::RemoveResource(gfx_resource_handle resource)
 {
-	MICROPROFILE_SCOPEI("DX12", "RemoveResource", 0);
-	m_impl->parent->QueueDestroy(gpu_object_type::Resource, bufferID);
+	CFC_PROFILE_SCOPE("DX12 RemoveResource");
+	m_impl->parent->QueueDestroy(gpu_object_type::Resource, resolveResource(m_impl->gpuCtx, resource));
 }
 
-void cfc::gfx_dx12::RemoveShader(usize shaderID)
+void cfc::gfx_dx12::RemoveShader(gfx_shader_handle shader)
 {
-	MICROPROFILE_SCOPEI("DX12", "RemoveShader", 0);
-	m_impl->parent->QueueDestroy(gpu_object_type::ShaderBlob, shaderID);
+	CFC_PROFILE_SCOPE("DX12 RemoveShader");
+	m_impl->parent->QueueDestroy(gpu_object_type::ShaderBlob, resolveShader(m_impl->gpuCtx, shader));
 }
 
-void cfc::gfx_dx12::RemoveGraphicsProgram(usize gfxProgramID)
+void cfc::gfx_dx12::RemoveGraphicsProgram(gfx_program_handle gfxProgram)
 {
-	m_impl->resGfxPrograms.erase(gfxProgramID);
+	if (gfxProgram.IsValid())
+		m_impl->resGfxPrograms.erase(resolveHandle(m_impl->resGfxPrograms, gfxProgram));
 }
 
-void cfc::gfx_dx12::RemoveComputeProgram(usize cmpProgramIdx)
+void cfc::gfx_dx12::RemoveComputeProgram(gfx_program_handle cmpProgram)
 {
-	m_impl->resGfxPrograms.erase(cmpProgramIdx);
+	if (cmpProgram.IsValid())
+		m_impl->resGfxPrograms.erase(resolveHandle(m_impl->resGfxPrograms, cmpProgram));
 }
 
-void cfc::gfx_dx12::RemoveDescriptorHeap(usize idx)
+void cfc::gfx_dx12::RemoveDescriptorHeap(gfx_descriptor_heap_handle descriptorHeap)
 {
-	m_impl->resDescriptorHeaps.erase(idx);
+	if (descriptorHeap.IsValid())
+		m_impl->resDescriptorHeaps.erase(resolveHandle(m_impl->resDescriptorHeaps, descriptorHeap));
 }
 
-void cfc::gfx_dx12::RemoveCommandList(usize idx)
+void cfc::gfx_dx12::RemoveCommandList(gfx_command_list_handle commandList)
 {
-	m_impl->resCommandLists.erase(idx);
+	if (commandList.IsValid())
+		m_impl->resCommandLists.erase(resolveHandle(m_impl->resCommandLists, commandList));
 }
 
-void cfc::gfx_dx12::RemoveCommandBundle(usize idx)
+void cfc::gfx_dx12::RemoveCommandBundle(gfx_command_list_handle commandBundle)
 {
-	m_impl->resCommandBundles.erase(idx);
+	if (commandBundle.IsValid())
+		m_impl->resCommandBundles.erase(resolveHandle(m_impl->resCommandBundles, commandBundle));
 }
 
-void cfc::gfx_dx12::RemoveBundleAllocator(usize idx)
+void cfc::gfx_dx12::RemoveBundleAllocator(gfx_bundle_allocator_handle bundleAllocator)
 {
-	m_impl->resBundleCommandAllocator.erase(idx);
+	if (bundleAllocator.IsValid())
+		m_impl->resBundleCommandAllocator.erase(resolveHandle(m_impl->resBundleCommandAllocator, bundleAllocator));
 }
 
-void cfc::gfx_dx12::RemoveResourceStream(usize idx)
+void cfc::gfx_dx12::RemoveResourceStream(gfx_resource_stream_handle resourceStream)
 {
-	m_impl->resResourceStreams.erase(idx);
+	if (resourceStream.IsValid())
+		m_impl->resResourceStreams.erase(resolveHandle(m_impl->resResourceStreams, resourceStream));
 }
 
-void cfc::gfx_dx12::RemoveRenderTarget(usize rtID)
+void cfc::gfx_dx12::RemoveRenderTarget(gfx_render_target_handle renderTarget)
 {
-	m_impl->resRenderTargets.erase(rtID);
+	if (renderTarget.IsValid())
+		m_impl->resRenderTargets.erase(resolveHandle(m_impl->resRenderTargets, renderTarget));
 }
 
-void gfx_dx12::ExecuteCommandLists(const usize* commandLists, usize numCommandLists) 
+void gfx_dx12::ExecuteCommandLists(const gfx_command_list_handle* commandLists, usize numCommandLists) 
 {
 	usize* listIndices = (usize*)_alloca(numCommandLists * sizeof(usize));
 	for (usize i = 0; i < numCommandLists; i++)
 	{
-		auto& cmdlist = m_impl->resCommandLists[commandLists[i]];
+		auto& cmdlist = m_impl->resCommandLists[resolveHandle(m_impl->resCommandLists, commandLists[i])];
 		listIndices[i] = cmdlist->GetCommandListIndex();
 	}
 	m_impl->gpuCtx.CommandQueueExecuteCommandLists(m_impl->cmdQueue, (u32)numCommandLists, listIndices);
@@ -1460,7 +1698,7 @@ void gfx_dx12::ExecuteCommandLists(const usize* commandLists, usize numCommandLi
 
 void gfx_dx12::WaitForGpu()
 {
-	MICROPROFILE_SCOPEI("DX12", "WaitForGPU", 0);
+	CFC_PROFILE_SCOPE("DX12 WaitForGPU");
 	m_impl->gpuCtx.CommandQueueSignal(m_impl->cmdQueue, m_impl->fncWaitForGpu, m_impl->fnctrWaitForGpu);				// add a fence after completion of current tasks in queue
 	m_impl->gpuCtx.FenceSetEventOnCompletion(m_impl->fncWaitForGpu, m_impl->fnevWaitForGpu, m_impl->fnctrWaitForGpu++);	// set fence to signal fenceEvent when marker has been reached
 	m_impl->gpuCtx.FenceEventWaitFor(m_impl->fnevWaitForGpu);															// wait for event to be signaled
@@ -1481,7 +1719,7 @@ bool gfx_dx12::Present(u32 swapInterval /*= 1*/, u32 flags /*= 0*/)
 
 	bool ret = false;
 	{
-		MICROPROFILE_SCOPEI("DX12", "Present", 0);
+		CFC_PROFILE_SCOPE("DX12 Present");
 		ret = m_impl->gpuCtx.SwapchainPresent(m_impl->swapChain, swapInterval, flags);
 	}
 
@@ -1491,7 +1729,7 @@ bool gfx_dx12::Present(u32 swapInterval /*= 1*/, u32 flags /*= 0*/)
 		m_impl->gpuCtx.MGPUSwitchToNextNode();
 		m_impl->nodeIndex = m_impl->gpuCtx.MGPUGetCurrentNodeID();
 		
-		MICROPROFILE_SCOPEI("DX12", "PresentNextFrame", 0);
+		CFC_PROFILE_SCOPE("DX12 PresentNextFrame");
 		u64 lastFenceValue = m_impl->frameFenceCtr[m_impl->frameIndex];
 		m_impl->gpuCtx.CommandQueueSignal(m_impl->cmdQueue, m_impl->fncFrame, lastFenceValue);
 
@@ -1500,7 +1738,7 @@ bool gfx_dx12::Present(u32 swapInterval /*= 1*/, u32 flags /*= 0*/)
 
 		if (m_impl->gpuCtx.FenceGetCompletedValue(m_impl->fncFrame) < m_impl->frameFenceCtr[m_impl->frameIndex])
 		{
-			MICROPROFILE_SCOPEI("DX12", "PresentNextFrameWait", 0);
+			CFC_PROFILE_SCOPE("DX12 PresentNextFrameWait");
 			m_impl->gpuCtx.FenceSetEventOnCompletion(m_impl->fncFrame, m_impl->fnevFrame, m_impl->frameFenceCtr[m_impl->frameIndex]);
 			m_impl->gpuCtx.FenceEventWaitFor(m_impl->fnevFrame);
 		}
@@ -1510,13 +1748,13 @@ bool gfx_dx12::Present(u32 swapInterval /*= 1*/, u32 flags /*= 0*/)
 	else
 	{
 		// move to next frame (single GPU)
-		MICROPROFILE_SCOPEI("DX12", "PresentNextFrame", 0);
+		CFC_PROFILE_SCOPE("DX12 PresentNextFrame");
 		u64 lastFenceValue = m_impl->frameFenceCtr[m_impl->frameIndex];
 		m_impl->gpuCtx.CommandQueueSignal(m_impl->cmdQueue, m_impl->fncFrame, lastFenceValue);
 		m_impl->frameIndex = m_impl->gpuCtx.SwapchainGetCurrentBackbufferIndex(m_impl->swapChain);
 		if (m_impl->gpuCtx.FenceGetCompletedValue(m_impl->fncFrame) < m_impl->frameFenceCtr[m_impl->frameIndex])
 		{
-			MICROPROFILE_SCOPEI("DX12", "PresentNextFrameWait", 0);
+			CFC_PROFILE_SCOPE("DX12 PresentNextFrameWait");
 			m_impl->gpuCtx.FenceSetEventOnCompletion(m_impl->fncFrame, m_impl->fnevFrame, m_impl->frameFenceCtr[m_impl->frameIndex]);
 			m_impl->gpuCtx.FenceEventWaitFor(m_impl->fnevFrame);
 		}
@@ -1571,8 +1809,8 @@ void cfc::gfx_dx12::ResolveTimerQueries()
 		currentCmdList->ResolveQueryData(m_impl->gpuTimerQueryHeap, gpu_query_type::Timestamp, timerFrame.StartIndex, numQueriesInFrame, m_impl->gpuTimerQueryReadbackBuffer, timerFrame.StartIndex * sizeof(u64));
 
 		currentCmdList->Close();
-		const usize cmdListIndex = currentCmdList->GetIndex();
-		ExecuteCommandLists(&cmdListIndex, 1);
+		const gfx_command_list_handle cmdList = currentCmdList->GetHandle();
+		ExecuteCommandLists(&cmdList, 1);
 	}
 
 	m_impl->gpuTimerQueryLastResolvedFrame = m_impl->gpuTimerQueryFrameCntr;
@@ -1604,15 +1842,34 @@ void cfc::gfx_dx12::ReadBackTimerQueryResults()
 		// when we loop around, we do an extra query to resolve the values at the beginning of the buffer and resolve the remainder on the back of the buffer
 		if (startQueryIndex > endQueryIndex)
 		{
-			char* gpuAddress = (char*)m_impl->gpuCtx.ResourceMap(m_impl->gpuTimerQueryReadbackBuffer, true, 0, 0, endQueryIndex * sizeof(u64));
+			char* gpuAddress = (char*)m_impl->gpuCtx.ResourceMap(m_impl->gpuTimerQueryReadbackBuffer.GetIndex(), true, 0, 0, endQueryIndex * sizeof(u64));
 			memcpy(&m_impl->gpuTimerQueryResults[0], gpuAddress, endQueryIndex * sizeof(u64));
-			m_impl->gpuCtx.ResourceUnmap(m_impl->gpuTimerQueryReadbackBuffer, false);
+			m_impl->gpuCtx.ResourceUnmap(m_impl->gpuTimerQueryReadbackBuffer.GetIndex(), false);
 
 			numQueriesInFrame = MAX_NUM_GPU_TIMER_QUERIES - startQueryIndex;
 		}
-		char* gpuAddress = (char*)m_impl->gpuCtx.ResourceMap(m_impl->gpuTimerQueryReadbackBuffer, true, 0, startQueryIndex * sizeof(u64), endQueryIndex * sizeof(u64));
+		char* gpuAddress = (char*)m_impl->gpuCtx.ResourceMap(m_impl->gpuTimerQueryReadbackBuffer.GetIndex(), true, 0, startQueryIndex * sizeof(u64), endQueryIndex * sizeof(u64));
 		memcpy(&m_impl->gpuTimerQueryResults[startQueryIndex], gpuAddress + startQueryIndex * sizeof(u64), numQueriesInFrame * sizeof(u64));
-		m_impl->gpuCtx.ResourceUnmap(m_impl->gpuTimerQueryReadbackBuffer, false);
+		m_impl->gpuCtx.ResourceUnmap(m_impl->gpuTimerQueryReadbackBuffer.GetIndex(), false);
+
+		// queries that closed a zone this frame go to the gpu track of the profiler
+		u64 gpuCalibration = 0, cpuCalibrationNs = 0;
+		m_impl->gpuCtx.GetClockCalibration(m_impl->cmdQueue, &gpuCalibration, &cpuCalibrationNs);
+		const f64 nanoSecondsPerTick = 1000000000.0 / (f64)m_impl->gpuTimerQueryTimeStampFrequency;
+
+		const u32 numQueries = (endQueryIndex + MAX_NUM_GPU_TIMER_QUERIES - startQueryIndex) % MAX_NUM_GPU_TIMER_QUERIES;
+		for (u32 i = 0; i < numQueries; ++i)
+		{
+			query_timer_zone& zone = m_impl->gpuTimerQueryZones[(startQueryIndex + i) % MAX_NUM_GPU_TIMER_QUERIES];
+			if (!zone.IsValid)
+				continue;
+			zone.IsValid = false;
+
+			const f64 beginNs = (f64)cpuCalibrationNs + (f64)(i64)(m_impl->gpuTimerQueryResults[zone.StartIndex] - gpuCalibration) * nanoSecondsPerTick;
+			const f64 endNs = (f64)cpuCalibrationNs + (f64)(i64)(m_impl->gpuTimerQueryResults[(startQueryIndex + i) % MAX_NUM_GPU_TIMER_QUERIES] - gpuCalibration) * nanoSecondsPerTick;
+			if (beginNs > 0.0 && endNs >= beginNs)
+				profiling::profiler::AddGpuZone(zone.Name, (u64)beginNs, (u64)endNs);
+		}
 	}
 }
 
@@ -1632,10 +1889,10 @@ f64 cfc::gfx_dx12::GetTimerQueryResultInMS(const gfx_gpu_timer_query& timerQuery
 	return (endTimerQueryTime - startTimerQueryTime);
 }
 
-u32 cfc::gfx_dx12::GetGraphicsProgramBindLocation(usize gfxProgramIdx, const char* name)
+u32 cfc::gfx_dx12::GetGraphicsProgramBindLocation(gfx_program_handle gfxProgram, const char* name)
 {
 	// TODO: fix and improve!
-	stl_unique_ptr<gfx_dx12_program>& program = m_impl->resGfxPrograms[gfxProgramIdx];
+	stl_unique_ptr<gfx_dx12_program>& program = m_impl->resGfxPrograms[resolveHandle(m_impl->resGfxPrograms, gfxProgram)];
 	std::map<stl_string, usize>::iterator it = program->shaderBindings.find(name);
 	if (it != program->shaderBindings.end())
 		return it->second;
@@ -1645,55 +1902,55 @@ u32 cfc::gfx_dx12::GetGraphicsProgramBindLocation(usize gfxProgramIdx, const cha
 	return (u32)cfc::invalid_index;
 }
 
-u32 cfc::gfx_dx12::GetComputeProgramBindLocation(usize cmpProgramIdx, const char* name)
+u32 cfc::gfx_dx12::GetComputeProgramBindLocation(gfx_program_handle cmpProgram, const char* name)
 {
 	// TODO: fix and improve!
-	return GetGraphicsProgramBindLocation(cmpProgramIdx, name);
+	return GetGraphicsProgramBindLocation(cmpProgram, name);
 }
 
-usize cfc::gfx_dx12::GetBackbufferRTResource()
+gfx_resource_handle cfc::gfx_dx12::GetBackbufferRTResource()
 {
-	return m_impl->resFrameRT[m_impl->gpuCtx.SwapchainGetCurrentBackbufferIndex(m_impl->swapChain)];
+	return makeResourceHandle(m_impl->gpuCtx, m_impl->resFrameRT[m_impl->gpuCtx.SwapchainGetCurrentBackbufferIndex(m_impl->swapChain)]);
 }
 
-usize cfc::gfx_dx12::GetBackbufferRTResource(usize index)
+gfx_resource_handle cfc::gfx_dx12::GetBackbufferRTResource(usize index)
 {
-	return m_impl->resFrameRT[index];
+	return makeResourceHandle(m_impl->gpuCtx, m_impl->resFrameRT[index]);
 }
 
-usize cfc::gfx_dx12::GetBackbufferDSResource()
+gfx_resource_handle cfc::gfx_dx12::GetBackbufferDSResource()
 {
-	return m_impl->resFrameDepth;
+	return makeResourceHandle(m_impl->gpuCtx, m_impl->resFrameDepth);
 }
 
-usize cfc::gfx_dx12::GetRenderTargetResource(usize rtID)
+gfx_resource_handle cfc::gfx_dx12::GetRenderTargetResource(gfx_render_target_handle renderTarget)
 {
-	return m_impl->resRenderTargets[rtID]->m_resourceID;
+	return makeResourceHandle(m_impl->gpuCtx, m_impl->resRenderTargets[resolveHandle(m_impl->resRenderTargets, renderTarget)]->m_resourceID);
 }
 
-usize cfc::gfx_dx12::GetRenderTargetDSVOffset(usize rtID)
+usize cfc::gfx_dx12::GetRenderTargetDSVOffset(gfx_render_target_handle renderTarget)
 {
-	return m_impl->resRenderTargets[rtID]->m_dsvOffset;
+	return m_impl->resRenderTargets[resolveHandle(m_impl->resRenderTargets, renderTarget)]->m_dsvOffset;
 }
 
-usize cfc::gfx_dx12::GetRenderTargetRTVOffset(usize rtID)
+usize cfc::gfx_dx12::GetRenderTargetRTVOffset(gfx_render_target_handle renderTarget)
 {
-	return m_impl->resRenderTargets[rtID]->m_rtvOffset;
+	return m_impl->resRenderTargets[resolveHandle(m_impl->resRenderTargets, renderTarget)]->m_rtvOffset;
 }
 
-i32 cfc::gfx_dx12::GetRenderTargetWidth(usize rtID)
+i32 cfc::gfx_dx12::GetRenderTargetWidth(gfx_render_target_handle renderTarget)
 {
-	return m_impl->resRenderTargets[rtID]->m_width;
+	return m_impl->resRenderTargets[resolveHandle(m_impl->resRenderTargets, renderTarget)]->m_width;
 }
 
-i32 cfc::gfx_dx12::GetRenderTargetHeight(usize rtID)
+i32 cfc::gfx_dx12::GetRenderTargetHeight(gfx_render_target_handle renderTarget)
 {
-	return m_impl->resRenderTargets[rtID]->m_height;
+	return m_impl->resRenderTargets[resolveHandle(m_impl->resRenderTargets, renderTarget)]->m_height;
 }
 
-cfc::gpu_format_type cfc::gfx_dx12::GetRenderTargetFormat(usize rtID)
+cfc::gpu_format_type cfc::gfx_dx12::GetRenderTargetFormat(gfx_render_target_handle renderTarget)
 {
-	return m_impl->resRenderTargets[rtID]->m_format;
+	return m_impl->resRenderTargets[resolveHandle(m_impl->resRenderTargets, renderTarget)]->m_format;
 }
 
 i32 cfc::gfx_dx12::GetBackbufferWidth()
@@ -1895,29 +2152,29 @@ void gfx_dx12::_ExtractRootSignatureFromShaders(const cfc::gpu_shaderreflection_
 
 }
 
-gfx_command_list* cfc::gfx_dx12::GetCommandList(usize commandListIdx)
+gfx_command_list* cfc::gfx_dx12::GetCommandList(gfx_command_list_handle commandList)
 {
-	return m_impl->resCommandLists[commandListIdx].get();
+	return m_impl->resCommandLists[resolveHandle(m_impl->resCommandLists, commandList)].get();
 }
 
-gfx_command_list* cfc::gfx_dx12::GetCommandBundle(usize commandBundleIdx)
+gfx_command_list* cfc::gfx_dx12::GetCommandBundle(gfx_command_list_handle commandBundle)
 {
-	return m_impl->resCommandBundles[commandBundleIdx].get();
+	return m_impl->resCommandBundles[resolveHandle(m_impl->resCommandBundles, commandBundle)].get();
 }
 
-usize cfc::gfx_dx12::GetBundleAllocator(usize bundleAllocatorIdx)
+usize cfc::gfx_dx12::GetBundleAllocator(gfx_bundle_allocator_handle bundleAllocator)
 {
-	return m_impl->resBundleCommandAllocator[bundleAllocatorIdx];
+	return m_impl->resBundleCommandAllocator[resolveHandle(m_impl->resBundleCommandAllocator, bundleAllocator)];
 }
 
-gfx_resource_stream* cfc::gfx_dx12::GetResourceStream(usize resourceStreamIdx)
+gfx_resource_stream* cfc::gfx_dx12::GetResourceStream(gfx_resource_stream_handle resourceStream)
 {
-	return m_impl->resResourceStreams[resourceStreamIdx].get();
+	return m_impl->resResourceStreams[resolveHandle(m_impl->resResourceStreams, resourceStream)].get();
 }
 
-gfx_descriptor_heap* cfc::gfx_dx12::GetDescriptorHeap(usize descriptorHeapIdx)
+gfx_descriptor_heap* cfc::gfx_dx12::GetDescriptorHeap(gfx_descriptor_heap_handle descriptorHeap)
 {
-	return m_impl->resDescriptorHeaps[descriptorHeapIdx].get();
+	return m_impl->resDescriptorHeaps[resolveHandle(m_impl->resDescriptorHeaps, descriptorHeap)].get();
 }
 
 void gfx_dx12::_ExtractInputLayoutFromShader(const gpu_shaderreflection_desc& reflectedVS, gpu_graphicspipelinestate_desc& gfxPipeline)
@@ -1996,10 +2253,19 @@ usize cfc::gfx_dx12::GetTimerQueryFrameDelayQuantity()
 	return TIMER_QUERIES_FRAMES_DELAY;
 }
 
+gfx_memory_stats cfc::gfx_dx12::GetMemoryStats(gfx_memory_category category)
+{
+	std::lock_guard<stl_mutex> lock(m_impl->mtxMemoryLedger);
+	return m_impl->memoryLedger[(usize)category];
+}
+
 void cfc::gfx_dx12::QueueDestroy(gpu_object_type objectType, usize index)
 {
 	if (index == cfc::invalid_index)
 		return;
+
+	if (objectType == gpu_object_type::Resource)
+		untrackResourceMemory(m_impl.get(), index);
 	
 	usize numFrames = GetBackbufferFrameQuantity();
 	m_impl->mtxDeletionQueue.lock();
@@ -2012,15 +2278,20 @@ gpu_dx12_context* gfx_dx12::DX12_GetContext()
 	return &m_impl->gpuCtx;
 }
 
-gpu_dx12_cmdlist_direct_api* gfx_dx12::DX12_GetDirectCommandListAPI(usize cmdlistIdx)
+gpu_dx12_cmdlist_direct_api* gfx_dx12::DX12_GetDirectCommandListAPI(gfx_command_list_handle cmdlist)
+{
+	gfx_dx12_command_list* dx12Cmdlist = m_impl->resCommandLists[resolveHandle(m_impl->resCommandLists, cmdlist)].get();
+	return &dx12Cmdlist->cmdListDirectApi;
+}
+
+usize gfx_dx12::DX12_GetRootSignatureIdxFromProgram(gfx_program_handle gfxProgram) const
 {
-	gfx_dx12_command_list* cmdlist = m_impl->resCommandLists[cmdlistIdx].get();
-	return &cmdlist->cmdListDirectApi;
+	return this->m_impl->resGfxPrograms[resolveHandle(m_impl->resGfxPrograms, gfxProgram)]->rootSignatureIndex;
 }
 
-usize gfx_dx12::DX12_GetRootSignatureIdxFromProgram(usize gfxProgramIdx) const
+usize gfx_dx12::DX12_GetResourceIdx(gfx_resource_handle resource) const
 {
-	return this->m_impl->resGfxPrograms[gfxProgramIdx]->rootSignatureIndex;
+	return resolveResource(m_impl->gpuCtx, resource);
 }
 
 void gfx_dx12::DX12_SetStablePowerState(bool stablePowerState)
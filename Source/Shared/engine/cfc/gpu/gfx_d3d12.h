@@ -22,32 +22,32 @@ namespace cfc {
 		virtual void Init(context& ctx, usize deviceID = 0, u32 numFrames = 2, gpu_swapimage_type imgType = gpu_swapimage_type::Rgba8Unorm, gpu_format_type depthType = gpu_format_type::D32Float, gpu_swapflip_type flipType = gpu_swapflip_type::Discard);
 		virtual gpu_features GetDeviceFeatures() const override;
 
-		virtual usize AddCommandList() override;
-		virtual usize AddCommandBundle(usize cmdAllocatorBundleId) override;
-		virtual usize AddBundleAllocator() override;
-		virtual usize AddResourceStream() override;
-		virtual usize AddDescriptorHeap(i32 maxCbvSrvUav, i32 maxSamplers) override;
-		virtual usize AddShaderFromMemory(const void* fileData, usize fileDataSize, const char* funcName = "main", const char* shaderType = "vs_5_0", const char* shaderFilename = "unknown.shd", const char* defineData = nullptr) override;
-		virtual usize AddGraphicsProgram(usize vertexShader = cfc::invalid_index, usize pixelShader = cfc::invalid_index, usize geometryShader = cfc::invalid_index, usize hullShader = cfc::invalid_index, usize domainShader = cfc::invalid_index) override;
-		virtual usize AddGraphicsProgramPipelineState(usize graphicsProgramIdx, const gfx_gfxprogram_desc& descriptor) override;
-		virtual usize AddComputeProgram(usize computeShader = cfc::invalid_index) override;
-		virtual usize AddComputeProgramPipelineState(usize computeProgramIdx, const gfx_cmpprogram_desc& descriptor) override;
-		virtual usize AddRenderTarget2D(i32 width, i32 height, gpu_format_type format, gpu_defaultclear_desc defaultClear = gpu_defaultclear_desc()) override;
-
-		virtual void RemoveShader(usize shaderIdx) override;
-		virtual void RemoveResource(usize bufferIdx) override;
-		virtual void RemoveGraphicsProgram(usize gfxProgramIdx) override;
-		virtual void RemoveComputeProgram(usize cmpProgramIdx) override;
-		virtual void RemoveDescriptorHeap(usize descriptorHeapIdx) override;
-		virtual void RemoveCommandList(usize commandListIdx) override;
-		virtual void RemoveCommandBundle(usize commandBundleIdx) override;
-		virtual void RemoveBundleAllocator(usize bundleAllocatorIdx) override;
-		virtual void RemoveResourceStream(usize resourceStream) override;
-		virtual void RemoveRenderTarget(usize rtID) override;
+		virtual gfx_command_list_handle AddCommandList() override;
+		virtual gfx_command_list_handle AddCommandBundle(gfx_bundle_allocator_handle cmdAllocatorBundle) override;
+		virtual gfx_bundle_allocator_handle AddBundleAllocator() override;
+		virtual gfx_resource_stream_handle AddResourceStream() override;
+		virtual gfx_descriptor_heap_handle AddDescriptorHeap(i32 maxCbvSrvUav, i32 maxSamplers) override;
+		virtual gfx_shader_handle AddShaderFromMemory(const void* fileData, usize fileDataSize, const char* funcName = "main", const char* shaderType = "vs_5_0", const char* shaderFilename = "unknown.shd", const char* defineData = nullptr) override;
+		virtual gfx_program_handle AddGraphicsProgram(gfx_shader_handle vertexShader = gfx_shader_handle(), gfx_shader_handle pixelShader = gfx_shader_handle(), gfx_shader_handle geometryShader = gfx_shader_handle(), gfx_shader_handle hullShader = gfx_shader_handle(), gfx_shader_handle domainShader = gfx_shader_handle()) override;
+		virtual usize AddGraphicsProgramPipelineState(gfx_program_handle graphicsProgram, const gfx_gfxprogram_desc& descriptor) override;
+		virtual gfx_program_handle AddComputeProgram(gfx_shader_handle computeShader = gfx_shader_handle()) override;
+		virtual usize AddComputeProgramPipelineState(gfx_program_handle computeProgram, const gfx_cmpprogram_desc& descriptor) override;
+		virtual gfx_render_target_handle AddRenderTarget2D(i32 width, i32 height, gpu_format_type format, gpu_defaultclear_desc defaultClear = gpu_defaultclear_desc()) override;
+
+		virtual void RemoveShader(gfx_shader_handle shader) override;
+		virtual void RemoveResource(gfx_resource_handle resource) override;
+		virtual void RemoveGraphicsProgram(gfx_program_handle gfxProgram) override;
+		virtual void RemoveComputeProgram(gfx_program_handle cmpProgram) override;
+		virtual void RemoveDescriptorHeap(gfx_descriptor_heap_handle descriptorHeap) override;
+		virtual void RemoveCommandList(gfx_command_list_handle commandList) override;
+		virtual void RemoveCommandBundle(gfx_command_list_handle commandBundle) override;
+		virtual void RemoveBundleAllocator(gfx_bundle_allocator_handle bundleAllocator) override;
+		virtual void RemoveResourceStream(gfx_resource_stream_handle resourceStream) override;
+		virtual void RemoveRenderTarget(gfx_render_target_handle renderTarget) override;
 
 		virtual void WaitForGpu();
 
-		virtual void ExecuteCommandLists(const usize* commandLists, usize numCommandLists) override;
+		virtual void ExecuteCommandLists(const gfx_command_list_handle* commandLists, usize numCommandLists) override;
 		virtual bool Present(u32 swapInterval = 1, u32 flags = 0) override;
 
 		virtual void ResolveTimerQueries() override;
@@ -55,27 +55,27 @@ namespace cfc {
 		virtual f64  GetTimerQueryResultInMS(const u32 index) override;
 		virtual f64  GetTimerQueryResultInMS(const gfx_gpu_timer_query& timerQuery) override;
 
-		virtual gfx_descriptor_heap* GetDescriptorHeap(usize descriptorHeapIdx) override;
-		virtual gfx_resource_stream* GetResourceStream(usize resourceStreamIdx) override;
-		virtual gfx_command_list* GetCommandList(usize commandListIdx) override;
-		virtual gfx_command_list* GetCommandBundle(usize commandBufferIdx) override;
-		virtual usize GetBundleAllocator(usize bundleAllocatorIdx) override;
+		virtual gfx_descriptor_heap* GetDescriptorHeap(gfx_descriptor_heap_handle descriptorHeap) override;
+		virtual gfx_resource_stream* GetResourceStream(gfx_resource_stream_handle resourceStream) override;
+		virtual gfx_command_list* GetCommandList(gfx_command_list_handle commandList) override;
+		virtual gfx_command_list* GetCommandBundle(gfx_command_list_handle commandBundle) override;
+		virtual usize GetBundleAllocator(gfx_bundle_allocator_handle bundleAllocator) override;
 
-		virtual u32 GetGraphicsProgramBindLocation(usize gfxProgramIdx, const char* name) override;
-		virtual u32 GetComputeProgramBindLocation(usize cmpProgramIdx, const char* name) override;
+		virtual u32 GetGraphicsProgramBindLocation(gfx_program_handle gfxProgram, const char* name) override;
+		virtual u32 GetComputeProgramBindLocation(gfx_program_handle cmpProgram, const char* name) override;
 
-		virtual usize GetRenderTargetResource(usize rtID) override;
-		virtual usize GetRenderTargetRTVOffset(usize rtID) override;
-		virtual usize GetRenderTargetDSVOffset(usize rtID) override;
-		virtual i32 GetRenderTargetWidth(usize rtID) override;
-		virtual i32 GetRenderTargetHeight(usize rtID) override;
-		virtual gpu_format_type GetRenderTargetFormat(usize rtID) override;
+		virtual gfx_resource_handle GetRenderTargetResource(gfx_render_target_handle renderTarget) override;
+		virtual usize GetRenderTargetRTVOffset(gfx_render_target_handle renderTarget) override;
+		virtual usize GetRenderTargetDSVOffset(gfx_render_target_handle renderTarget) override;
+		virtual i32 GetRenderTargetWidth(gfx_render_target_handle renderTarget) override;
+		virtual i32 GetRenderTargetHeight(gfx_render_target_handle renderTarget) override;
+		virtual gpu_format_type GetRenderTargetFormat(gfx_render_target_handle renderTarget) override;
 
 		virtual i32 GetBackbufferWidth() override;
 		virtual i32 GetBackbufferHeight() override;
-		virtual usize GetBackbufferRTResource() override;
-		virtual usize GetBackbufferRTResource(usize index) override;
-		virtual usize GetBackbufferDSResource() override;
+		virtual gfx_resource_handle GetBackbufferRTResource() override;
+		virtual gfx_resource_handle GetBackbufferRTResource(usize index) override;
+		virtual gfx_resource_handle GetBackbufferDSResource() override;
 		virtual usize GetBackbufferRTVOffset() override;
 		virtual usize GetBackbufferDSVOffset() override;
 		virtual gpu_format_type GetBackbufferRTVFormat() override;
@@ -89,19 +89,22 @@ namespace cfc {
 		virtual usize GetTimerQueryWriteFrameIndex() override;
 		virtual usize GetTimerQueryFrameDelayQuantity() override;
 
+		virtual gfx_memory_stats GetMemoryStats(gfx_memory_category category) override;
+
 		void QueueDestroy(gpu_object_type objectType, usize index);
 
 		// extensions for gfx layer to DX12 interop
 		gpu_dx12_context* DX12_GetContext();
-		gpu_dx12_cmdlist_direct_api* DX12_GetDirectCommandListAPI(usize cmdlistIdx);
-		usize DX12_GetRootSignatureIdxFromProgram(usize gfxProgramIdx) const;
+		gpu_dx12_cmdlist_direct_api* DX12_GetDirectCommandListAPI(gfx_command_list_handle cmdlist);
+		usize DX12_GetRootSignatureIdxFromProgram(gfx_program_handle gfxProgram) const;
+		usize DX12_GetResourceIdx(gfx_resource_handle resource) const;
 		void DX12_SetStablePowerState(bool stablePowerState);
 
 	protected:
 		void _Resize();
 		void _ExtractInputLayoutFromShader(const gpu_shaderreflection_desc& reflectedVS, gpu_graphicspipelinestate_desc& gfxPipeline);
 		void _ExtractRootSignatureFromShaders(const gpu_shaderreflection_desc** reflectedShaders, gpu_shadervisibility_type* visibilityTypes, int numShaders, gpu_rootsignature_desc& gfxRootSignature);
-		usize _AddProgram(usize vertexShader, usize pixelShader, usize geometryShader, usize hullShader, usize domainShader, usize computeShader);
+		gfx_program_handle _AddProgram(gfx_shader_handle vertexShader, gfx_shader_handle pixelShader, gfx_shader_handle geometryShader, gfx_shader_handle hullShader, gfx_shader_handle domainShader, gfx_shader_handle computeShader);
 
 		stl_pimpl<_imp_dx12_gfx, 8196> m_impl;
 	};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cfc/base.h>
+
+namespace cfc {
+
+	// Typed 64 bit handle to a gfx object, the slot index in the lower 32 bits and the generation of the slot in the upper 32 bits.
+	// Removing an object changes the generation of its slot, a handle that outlived its object no longer matches when the slot
+	// is reused. Lookups validate the generation when CFC_CONF_GFX_HANDLE_VALIDATION is defined and are a plain array access otherwise.
+	// A default constructed handle is invalid (the replacement of cfc::invalid_index).
+	template <class Tag>
+	class gfx_handle
+	{
+	public:
+		gfx_handle() : m_value(~0ULL) {}
+
+		static gfx_handle Make(usize index, u32 generation)
+		{
+			gfx_handle handle;
+			if (index != cfc::invalid_index)
+				handle.m_value = ((u64)generation << 32) | (u32)index;
+			return handle;
+		}
+
+		bool IsValid() const { return m_value != ~0ULL; }
+
+		// slot index without validation, cfc::invalid_index for an invalid handle
+		usize GetIndex() const { return IsValid() ? (usize)(u32)m_value : cfc::invalid_index; }
+		u32 GetGeneration() const { return (u32)(m_value >> 32); }
+		u64 GetValue() const { return m_value; }
+
+		bool operator == (const gfx_handle& o) const { return m_value == o.m_value; }
+		bool operator != (const gfx_handle& o) const { return m_value != o.m_value; }
+
+	private:
+		u64 m_value;
+	};
+
+	struct gfx_resource_tag;
+	struct gfx_shader_tag;
+	struct gfx_program_tag;
+	struct gfx_descriptor_heap_tag;
+	struct gfx_resource_stream_tag;
+	struct gfx_command_list_tag;
+	struct gfx_bundle_allocator_tag;
+	struct gfx_render_target_tag;
+
+	typedef gfx_handle<gfx_resource_tag> gfx_resource_handle;
+	typedef gfx_handle<gfx_shader_tag> gfx_shader_handle;
+	typedef gfx_handle<gfx_program_tag> gfx_program_handle;					// graphics and compute programs
+	typedef gfx_handle<gfx_descriptor_heap_tag> gfx_descriptor_heap_handle;
+	typedef gfx_handle<gfx_resource_stream_tag> gfx_resource_stream_handle;
+	typedef gfx_handle<gfx_command_list_tag> gfx_command_list_handle;		// direct command lists and bundles
+	typedef gfx_handle<gfx_bundle_allocator_tag> gfx_bundle_allocator_handle;
+	typedef gfx_handle<gfx_render_target_tag> gfx_render_target_handle;
+
+}; // end namespace cfc
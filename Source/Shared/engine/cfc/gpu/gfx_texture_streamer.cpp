@@ -0,0 +1,310 @@
+#include "gfx_texture_streamer.h"
+#include "texture_mipgen.h"
+
+#include <cfc/gpu/gfx.h>
+#include <cfc/stl/stl_algorithm.hpp>
+
+#include <math.h>
+
+namespace cfc {
+
+#pragma region Helpers
+// block compressed textures need a top level that is a multiple of the 4x4 block size
+static bool isValidTopMip(gpu_format_type fmt, u32 width, u32 height, u32 mip)
+{
+	if (!gpu_format_type_query::IsCompressedType(fmt))
+		return true;
+
+	u32 w, h;
+	texture_mipgen::GetMipDimensions(width, height, mip, w, h);
+	return (w & 3) == 0 && (h & 3) == 0 && (width >> mip) == w && (height >> mip) == h;
+}
+#pragma endregion
+
+#pragma region gfx_texture_streamer
+void gfx_texture_streamer::Init(gfx& gfx, usize budgetInBytes, gfx_descriptor_heap* descHeap, usize descTableBase, u32 descTableSize, u32 tailSizeInTexels, usize maxUploadBytesPerFrame)
+{
+	m_stream = gfx.GetResourceStream(gfx.AddResourceStream());
+	m_budgetBytes = budgetInBytes;
+	m_tailSizeInTexels = tailSizeInTexels;
+	m_maxUploadBytesPerFrame = maxUploadBytesPerFrame;
+	m_numFramesInFlight = (u32)gfx.GetBackbufferFrameQuantity();
+	m_frameIndex = gfx.GetGlobalFrameIndex();
+
+	// one copy of the table for every frame in flight and one for the frame that is recorded next
+	m_descHeap = descHeap;
+	m_descTableBase = descTableBase;
+	m_descTableSize = descTableSize;
+	m_numTableCopies = m_numFramesInFlight + 1;
+}
+
+void gfx_texture_streamer::Shutdown(gfx& gfx)
+{
+	for (auto& tex : m_textures)
+	{
+		gfx.RemoveResource(tex.Resource);
+		gfx.RemoveResource(tex.RetiringResource);
+		gfx.RemoveResource(tex.PendingResource);
+		gfx.RemoveResource(tex.PendingReadback);
+	}
+	m_textures.resize(0);
+
+	if (m_stream != nullptr)
+	{
+		m_stream->WaitForFinish();
+		gfx.RemoveResourceStream(m_stream->GetHandle());
+		m_stream = nullptr;
+	}
+}
+
+void gfx_texture_streamer::createPendingResource(streamed_texture& tex, u32 topMip)
+{
+	stl_assert(topMip != tex.ResidentMip);
+
+	u32 w, h;
+	texture_mipgen::GetMipDimensions(tex.Width, tex.Height, topMip, w, h);
+
+	// stream in: upload the missing mips, the resident ones are copied from the current texture
+	// evict: copy the mips that stay resident and read the evicted ones back into system memory
+	const bool streamIn = topMip < tex.ResidentMip;
+	cfc::gfx_texture_creation_desc desc(streamIn ? &tex.MipChain[tex.MipOffsets[topMip]] : nullptr, tex.Format, w, h, tex.MipCount - topMip);
+	desc.InitialDataMipmaps = streamIn ? tex.ResidentMip - topMip : 0;
+	desc.CopySource = tex.Resource;
+	desc.CopySourceMip = streamIn ? 0 : topMip - tex.ResidentMip;
+
+	if (!streamIn)
+		tex.PendingReadback = m_stream->AddTextureReadback(tex.Resource, 0, topMip - tex.ResidentMip);
+	tex.PendingResource = m_stream->AddTexture(desc);
+	tex.PendingMip = topMip;
+	tex.PendingReadyFrame = m_frameIndex + m_numFramesInFlight;
+
+	// the uploaded mips now live in the upload heap and on the gpu
+	if (streamIn)
+	{
+		tex.MipChain.resize(tex.MipOffsets[topMip]);
+		tex.MipChain.shrink_to_fit();
+	}
+}
+
+void gfx_texture_streamer::applyPendingResource(gfx& gfx, streamed_texture& tex)
+{
+	if (tex.PendingReadback.IsValid())
+	{
+		tex.MipChain.resize(tex.MipOffsets[tex.PendingMip]);
+		m_stream->ReadTextureReadback(tex.PendingReadback, &tex.MipChain[tex.MipOffsets[tex.ResidentMip]]);
+		gfx.RemoveResource(tex.PendingReadback);
+		tex.PendingReadback = gfx_resource_handle();
+	}
+
+	tex.RetiringResource = tex.Resource;
+	tex.Resource = tex.PendingResource;
+	tex.ResidentMip = tex.PendingMip;
+	tex.PendingResource = gfx_resource_handle();
+}
+
+usize gfx_texture_streamer::AddTexture(gpu_format_type fmt, u32 width, u32 height, u32 mipCount, stl_vector<u8>&& mipChain, u32 descSlot)
+{
+	stl_assert(m_stream != nullptr && mipCount > 0 && descSlot < m_descTableSize);
+
+	m_textures.push_back(streamed_texture());
+	streamed_texture& tex = m_textures.back();
+	tex.Format = fmt;
+	tex.Width = width;
+	tex.Height = height;
+	tex.MipCount = mipCount;
+	tex.MipChain = std::move(mipChain);
+	tex.DescSlot = descSlot;
+
+	// per mip offsets into the chain
+	tex.MipOffsets.resize(mipCount + 1);
+	usize offset = 0;
+	for (u32 i = 0; i < mipCount; ++i)
+	{
+		u32 w, h;
+		texture_mipgen::GetMipDimensions(width, height, i, w, h);
+		tex.MipOffsets[i] = offset;
+		offset += gpu_format_type_query::GetRowBytes(fmt, w) * (gpu_format_type_query::IsCompressedType(fmt) ? (h + 3) / 4 : h);
+	}
+	tex.MipOffsets[mipCount] = offset;
+	stl_assert(offset == tex.MipChain.size());
+
+	// tail: first mip that fits the tail size, limited to mips that can act as top level
+	tex.TailMip = 0;
+	while (tex.TailMip + 1 < mipCount && isValidTopMip(fmt, width, height, tex.TailMip + 1))
+	{
+		u32 w, h;
+		texture_mipgen::GetMipDimensions(width, height, tex.TailMip, w, h);
+		if (w <= m_tailSizeInTexels && h <= m_tailSizeInTexels)
+			break;
+		tex.TailMip++;
+	}
+
+	tex.ResidentMip = tex.TailMip;
+	tex.FrameRequestedMip = ~0u;
+	tex.StickyMip = tex.TailMip;
+	tex.StickyFrame = m_frameIndex;
+	tex.TargetMip = tex.TailMip;
+
+	u32 tailWidth, tailHeight;
+	texture_mipgen::GetMipDimensions(width, height, tex.TailMip, tailWidth, tailHeight);
+	tex.Resource = m_stream->AddTexture(cfc::gfx_texture_creation_desc(&tex.MipChain[tex.MipOffsets[tex.TailMip]], fmt, tailWidth, tailHeight, mipCount - tex.TailMip));
+	m_stream->Flush();
+
+	tex.MipChain.resize(tex.MipOffsets[tex.TailMip]);
+	tex.MipChain.shrink_to_fit();
+
+	// nothing references the slot yet, so every copy can be written directly
+	tex.TableViews.assign(m_numTableCopies, tex.Resource);
+	for (u32 i = 0; i < m_numTableCopies; ++i)
+		m_descHeap->SetSRVTexture(GetDescriptorTableCopy(i) + tex.DescSlot, tex.Resource);
+
+	return m_textures.size() - 1;
+}
+
+void gfx_texture_streamer::BeginFrame()
+{
+	for (auto& tex : m_textures)
+		tex.FrameRequestedMip = ~0u;
+}
+
+void gfx_texture_streamer::RequestMip(usize textureIdx, f32 mip)
+{
+	streamed_texture& tex = m_textures[textureIdx];
+	const u32 mipLevel = mip <= 0.0f ? 0 : (u32)mip;
+	tex.FrameRequestedMip = mipLevel < tex.FrameRequestedMip ? mipLevel : tex.FrameRequestedMip;
+}
+
+void gfx_texture_streamer::RequestMipFromUVDensity(usize textureIdx, f32 uvUnitsPerPixel)
+{
+	const streamed_texture& tex = m_textures[textureIdx];
+	const f32 texelsPerPixel = uvUnitsPerPixel * (f32)(tex.Width > tex.Height ? tex.Width : tex.Height);
+	RequestMip(textureIdx, texelsPerPixel > 1.0f ? log2f(texelsPerPixel) : 0.0f);
+}
+
+void gfx_texture_streamer::Update(gfx& gfx)
+{
+	m_frameIndex = gfx.GetGlobalFrameIndex();
+
+	// take over textures whose stream work is done
+	// NOTE: the readbacks are only read after waiting on the stream, which finished in practice after the frames in flight
+	bool streamFinished = false;
+	for (auto& tex : m_textures)
+	{
+		if (!tex.PendingResource.IsValid() || m_frameIndex < tex.PendingReadyFrame)
+			continue;
+
+		if (tex.PendingReadback.IsValid() && !streamFinished)
+		{
+			m_stream->WaitForFinish();
+			streamFinished = true;
+		}
+		applyPendingResource(gfx, tex);
+	}
+
+	// only the table copy of the next frame is written, the frames in flight use the other copies
+	const u32 tableCopy = (u32)(m_frameIndex % m_numTableCopies);
+	for (auto& tex : m_textures)
+	{
+		if (tex.TableViews[tableCopy] != tex.Resource)
+		{
+			m_descHeap->SetSRVTexture(GetDescriptorTableCopy(tableCopy) + tex.DescSlot, tex.Resource);
+			tex.TableViews[tableCopy] = tex.Resource;
+		}
+
+		// removal is deferred past the frames in flight that still bind a copy referencing it
+		if (tex.RetiringResource.IsValid() && std::find(tex.TableViews.begin(), tex.TableViews.end(), tex.RetiringResource) == tex.TableViews.end())
+		{
+			gfx.RemoveResource(tex.RetiringResource);
+			tex.RetiringResource = gfx_resource_handle();
+		}
+	}
+
+	// apply requests, finer requests are taken immediately, coarser ones only after they persisted for a while
+	usize totalBytes = 0;
+	for (auto& tex : m_textures)
+	{
+		u32 requested = tex.FrameRequestedMip < tex.TailMip ? tex.FrameRequestedMip : tex.TailMip;
+		if (requested <= tex.StickyMip || m_frameIndex - tex.StickyFrame > m_evictionDelayInFrames)
+		{
+			tex.StickyMip = requested;
+			tex.StickyFrame = m_frameIndex;
+		}
+		tex.TargetMip = tex.StickyMip;
+		totalBytes += residentBytes(tex, tex.TargetMip);
+	}
+
+	// over budget: repeatedly drop the finest mip of the largest consumer
+	while (totalBytes > m_budgetBytes)
+	{
+		streamed_texture* largest = nullptr;
+		usize largestBytes = 0;
+		for (auto& tex : m_textures)
+		{
+			const usize bytes = residentBytes(tex, tex.TargetMip);
+			if (tex.TargetMip < tex.TailMip && bytes > largestBytes)
+			{
+				largest = &tex;
+				largestBytes = bytes;
+			}
+		}
+		if (largest == nullptr)
+			break;
+
+		largest->TargetMip++;
+		totalBytes -= largestBytes - residentBytes(*largest, largest->TargetMip);
+	}
+
+	// gather residency changes, evictions first since they free memory, then the largest improvements
+	// NOTE: a texture changes again once every table copy references its current resource
+	stl_vector<streamed_texture*> changes;
+	for (auto& tex : m_textures)
+	{
+		if (!tex.PendingResource.IsValid() && !tex.RetiringResource.IsValid() && tex.TargetMip != tex.ResidentMip)
+			changes.push_back(&tex);
+	}
+	std::sort(changes.begin(), changes.end(), [](const streamed_texture* a, const streamed_texture* b)
+	{
+		const i32 deltaA = (i32)a->ResidentMip - (i32)a->TargetMip;
+		const i32 deltaB = (i32)b->ResidentMip - (i32)b->TargetMip;
+		if ((deltaA < 0) != (deltaB < 0))
+			return deltaA < 0;
+		return deltaA > deltaB;
+	});
+
+	// only the mips that enter or leave the gpu are transferred, uploads and readbacks share the limit
+	usize uploadBytes = 0;
+	for (auto tex : changes)
+	{
+		const usize from = tex->MipOffsets[tex->ResidentMip];
+		const usize to = tex->MipOffsets[tex->TargetMip];
+		const usize bytes = from > to ? from - to : to - from;
+		if (uploadBytes > 0 && uploadBytes + bytes > m_maxUploadBytesPerFrame)
+			break;
+
+		createPendingResource(*tex, tex->TargetMip);
+		uploadBytes += bytes;
+	}
+
+	if (uploadBytes > 0)
+		m_stream->Flush();
+}
+
+gfx_texture_streamer_stats gfx_texture_streamer::GetStats() const
+{
+	gfx_texture_streamer_stats stats;
+	stats.BudgetBytes = m_budgetBytes;
+	stats.NumTextures = (u32)m_textures.size();
+	for (auto& tex : m_textures)
+	{
+		const bool pending = tex.PendingResource.IsValid();
+		stats.ResidentBytes += residentBytes(tex, pending ? tex.PendingMip : tex.ResidentMip);
+		stats.RequestedBytes += residentBytes(tex, tex.StickyMip);
+		stats.FullyResidentBytes += tex.MipOffsets[tex.MipCount];
+		stats.CPUBytes += tex.MipChain.size();
+		stats.NumPendingUploads += pending ? 1 : 0;
+	}
+	return stats;
+}
+#pragma endregion
+
+}; // end namespace cfc
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cfc/base.h>
+#include <cfc/gpu/gpu.h>
+#include <cfc/gpu/gfx_handle.h>
+
+#include <cfc/stl/stl_vector.hpp>
+
+namespace cfc
+{
+	// forward declare
+	class gfx;
+	class gfx_descriptor_heap;
+	class gfx_resource_stream;
+
+	struct gfx_texture_streamer_stats
+	{
+		usize ResidentBytes = 0;		// bytes of all mips currently referenced by descriptors (or pending to be)
+		usize RequestedBytes = 0;		// bytes the current requests would need without a budget
+		usize FullyResidentBytes = 0;	// bytes when every mip of every texture is resident
+		usize CPUBytes = 0;				// mips kept in system memory, only the ones that are not resident
+		usize BudgetBytes = 0;
+		u32 NumTextures = 0;
+		u32 NumPendingUploads = 0;
+	};
+
+	// Streams the finer mips of textures in and out based on per frame mip requests, under a memory budget.
+	// Every texture keeps its tail mips resident. A residency change builds a new texture holding [mip .. tail] on
+	// a dedicated resource stream: only mips that are not resident are uploaded, the others are copied on the gpu.
+	// System memory only holds the mips that are not resident, evicted mips are read back from the gpu.
+	// The views live in a descriptor table with a copy per frame in flight (+1), a frame binds the copy of its frame index and
+	// Update only writes new views into the copy of the next frame, which no frame in flight uses. A replaced texture is removed
+	// once no copy references it anymore, gfx::RemoveResource keeps it alive for the frames in flight.
+	// Multithreading guarantee: None. Call from the render thread, RequestMip and RequestMipFromUVDensity need external
+	// synchronization when called from multiple threads.
+	class CFC_API gfx_texture_streamer
+	{
+	public:
+		// the copies of the descriptor table (descTableSize slots each) follow each other in descHeap from descTableBase on
+		void Init(gfx& gfx, usize budgetInBytes, gfx_descriptor_heap* descHeap, usize descTableBase, u32 descTableSize, u32 tailSizeInTexels = 64, usize maxUploadBytesPerFrame = 8 * 1024 * 1024);
+		void Shutdown(gfx& gfx);
+
+		// takes ownership of the tightly packed mip chain (all mips), the tail mips are made resident and the SRV is written into
+		// descSlot of every copy of the table
+		// NOTE: no frame may reference descSlot yet
+		usize AddTexture(gpu_format_type fmt, u32 width, u32 height, u32 mipCount, stl_vector<u8>&& mipChain, u32 descSlot);
+
+		// first heap index of the table copy to bind for a frame (gfx::GetGlobalFrameIndex while recording it)
+		usize GetDescriptorTable(u64 frameIndex) const { return GetDescriptorTableCopy((u32)(frameIndex % m_numTableCopies)); }
+		usize GetDescriptorTableCopy(u32 copy) const { return m_descTableBase + (usize)copy * m_descTableSize; }
+		u32 GetDescriptorTableCopyQuantity() const { return m_numTableCopies; }
+		usize GetDescriptorTableEnd() const { return GetDescriptorTableCopy(m_numTableCopies); }
+
+		// requests are gathered between BeginFrame and Update, the finest requested mip per texture wins
+		void BeginFrame();
+		void RequestMip(usize textureIdx, f32 mip);
+		void RequestMipFromUVDensity(usize textureIdx, f32 uvUnitsPerPixel);	// uv units covered by one screen pixel
+		void Update(gfx& gfx);
+
+		void SetBudget(usize budgetInBytes) { m_budgetBytes = budgetInBytes; }
+		usize GetBudget() const { return m_budgetBytes; }
+
+		u32 GetResidentMip(usize textureIdx) const { return m_textures[textureIdx].ResidentMip; }
+		u32 GetTailMip(usize textureIdx) const { return m_textures[textureIdx].TailMip; }
+		usize GetTextureQuantity() const { return m_textures.size(); }
+		gfx_texture_streamer_stats GetStats() const;
+
+	private:
+		struct streamed_texture
+		{
+			gpu_format_type Format;
+			u32 Width;
+			u32 Height;
+			u32 MipCount;
+			u32 TailMip;						// coarsest mip that can act as top level, always resident
+			stl_vector<u8> MipChain;			// mips [0 .. ResidentMip), the resident ones only live on the gpu
+			stl_vector<usize> MipOffsets;		// MipCount + 1 entries, offsets in the full chain
+
+			u32 DescSlot;
+			stl_vector<gfx_resource_handle> TableViews;	// per table copy, the texture its view was written for
+
+			gfx_resource_handle Resource;
+			gfx_resource_handle RetiringResource;	// replaced by Resource, still referenced by some table copies
+			u32 ResidentMip;
+
+			gfx_resource_handle PendingResource;
+			gfx_resource_handle PendingReadback;	// evicted mips [ResidentMip .. PendingMip) on their way back to system memory
+			u32 PendingMip;
+			u64 PendingReadyFrame;
+
+			u32 FrameRequestedMip;				// finest mip requested this frame (~0 when not requested)
+			u32 StickyMip;						// requested mip with eviction hysteresis applied
+			u64 StickyFrame;
+			u32 TargetMip;
+		};
+
+		usize residentBytes(const streamed_texture& tex, u32 topMip) const { return tex.MipOffsets[tex.MipCount] - tex.MipOffsets[topMip]; }
+		void createPendingResource(streamed_texture& tex, u32 topMip);
+		void applyPendingResource(gfx& gfx, streamed_texture& tex);
+
+		gfx_resource_stream* m_stream = nullptr;
+		stl_vector<streamed_texture> m_textures;
+
+		gfx_descriptor_heap* m_descHeap = nullptr;
+		usize m_descTableBase = 0;
+		u32 m_descTableSize = 0;
+		u32 m_numTableCopies = 0;
+		usize m_budgetBytes = 0;
+		usize m_maxUploadBytesPerFrame = 0;
+		u32 m_tailSizeInTexels = 64;
+		u32 m_evictionDelayInFrames = 30;
+		u64 m_frameIndex = 0;
+		u32 m_numFramesInFlight = 2;
+	};
+}; // end namespace cfc
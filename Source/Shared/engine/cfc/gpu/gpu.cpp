@@ -164,8 +164,8 @@ namespace cfc
 		case gpu_format_type::BC7Typeless: return true;
 		case gpu_format_type::BC7Unorm: return true;
 		case gpu_format_type::BC7UnormSrgb: return true;
+		default: return false;
 		};
-		return false;
 	}
 
 	i32 gpu_format_type_query::GetBitsPerChannel(gpu_format_type fmt)
@@ -182,7 +182,7 @@ namespace cfc
 
 	i32 gpu_format_type_query::GetCompressedBlockSize(gpu_format_type fmt)
 	{
-		static i32 table[] = { -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,8,8,8,8,8,8,16,16,16,8,8,8,16,16,16,-1,-1,-1,-1,-1,-1,-1,-1,-1,16,16,16,16,16,16,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1 };
+		static i32 table[] = { -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,8,8,8,16,16,16,16,16,16,8,8,8,16,16,16,-1,-1,-1,-1,-1,-1,-1,-1,-1,16,16,16,16,16,16,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1 };
 		return table[(int)fmt];
 	}
 
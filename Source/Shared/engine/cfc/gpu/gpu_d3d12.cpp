@@ -100,6 +100,7 @@ typedef CD3DX12_RESOURCE_BARRIER						CD3DX12_PROXY_RESOURCE_BARRIER;
 
 #include <cfc/gpu/gpu_d3d12.h>
 #include <cfc/core/window.h>
+#include <cfc/core/profiling.h>
 #include <mutex>
 #include <cfc/stl/stl_unique_ptr.hpp>
 #include <cfc/stl/stl_string.hpp>
@@ -157,19 +158,19 @@ struct _imp_gpu_dx12_context
 	ComPtr<ID3D12ProxyDevice> device;
 	ComPtr<IDXGIAdapter> adapter;
 
-	stl_resource_collection<ComPtr<IDXGIProxySwapChain>, stl_mutex> swapChains;
-	stl_resource_collection<ComPtr<ID3D12ProxyCommandQueue>, stl_mutex> commandQueues;
-	stl_resource_collection<ComPtr<ID3D12ProxyCommandAllocator>, stl_mutex> commandAllocators;
-	stl_resource_collection<ComPtr<ID3D12ProxyCommandList>, stl_mutex> commandLists;
-	stl_resource_collection<ComPtr<ID3D12ProxyCommandSignature>, stl_mutex> commandSignatures;
-	stl_resource_collection<ComPtr<ID3D12ProxyFence>, stl_mutex> fences;
-	stl_resource_collection<stl_unique_ptr<_imp_dx12_fence_event>, stl_mutex> fenceEvents;
-	stl_resource_collection<ComPtr<ID3D12ProxyQueryHeap>, stl_mutex> queryHeaps;
-	stl_resource_collection<ComPtr<ID3D12ProxyDescriptorHeap>, stl_mutex> descriptorHeaps;
-	stl_resource_collection<ComPtr<ID3D12ProxyRootSignature>, stl_mutex> rootSignatures;
-	stl_resource_collection<_imp_dx12_shader, stl_mutex> shaderBlobs;
-	stl_resource_collection<ComPtr<ID3D12ProxyPipelineState>, stl_mutex> pipelineStates;
-	stl_resource_collection<_imp_dx12_resource, stl_mutex> resources;
+	stl_resource_collection<ComPtr<IDXGIProxySwapChain>> swapChains;
+	stl_resource_collection<ComPtr<ID3D12ProxyCommandQueue>> commandQueues;
+	stl_resource_collection<ComPtr<ID3D12ProxyCommandAllocator>> commandAllocators;
+	stl_resource_collection<ComPtr<ID3D12ProxyCommandList>> commandLists;
+	stl_resource_collection<ComPtr<ID3D12ProxyCommandSignature>> commandSignatures;
+	stl_resource_collection<ComPtr<ID3D12ProxyFence>> fences;
+	stl_resource_collection<stl_unique_ptr<_imp_dx12_fence_event>> fenceEvents;
+	stl_resource_collection<ComPtr<ID3D12ProxyQueryHeap>> queryHeaps;
+	stl_resource_collection<ComPtr<ID3D12ProxyDescriptorHeap>> descriptorHeaps;
+	stl_resource_collection<ComPtr<ID3D12ProxyRootSignature>> rootSignatures;
+	stl_resource_collection<_imp_dx12_shader> shaderBlobs;
+	stl_resource_collection<ComPtr<ID3D12ProxyPipelineState>> pipelineStates;
+	stl_resource_collection<_imp_dx12_resource> resources;
 
 };
 
@@ -1416,6 +1417,48 @@ void gpu_dx12_context::Destroy(gpu_object_type type, usize idx)
 	}
 }
 
+u32 gpu_dx12_context::GetGeneration(gpu_object_type type, usize idx) const
+{
+	switch (type)
+	{
+		case gpu_object_type::CommandQueue:			return m_impl->commandQueues.get_generation(idx);
+		case gpu_object_type::CommandAllocator:		return m_impl->commandAllocators.get_generation(idx);
+		case gpu_object_type::CommandList:			return m_impl->commandLists.get_generation(idx);
+		case gpu_object_type::Fence:				return m_impl->fences.get_generation(idx);
+		case gpu_object_type::FenceEvent:			return m_impl->fenceEvents.get_generation(idx);
+		case gpu_object_type::DescriptorHeap:		return m_impl->descriptorHeaps.get_generation(idx);
+		case gpu_object_type::QueryHeap:			return m_impl->queryHeaps.get_generation(idx);
+		case gpu_object_type::SwapChain:			return m_impl->swapChains.get_generation(idx);
+		case gpu_object_type::ShaderBlob:			return m_impl->shaderBlobs.get_generation(idx);
+		case gpu_object_type::RootSignature:		return m_impl->rootSignatures.get_generation(idx);
+		case gpu_object_type::PipelineState:		return m_impl->pipelineStates.get_generation(idx);
+		case gpu_object_type::Resource:				return m_impl->resources.get_generation(idx);
+		default:								stl_assert(false); break; // unimplemented
+	}
+	return 0;
+}
+
+bool gpu_dx12_context::IsCurrent(gpu_object_type type, usize idx, u32 generation) const
+{
+	switch (type)
+	{
+		case gpu_object_type::CommandQueue:			return m_impl->commandQueues.is_current(idx, generation);
+		case gpu_object_type::CommandAllocator:		return m_impl->commandAllocators.is_current(idx, generation);
+		case gpu_object_type::CommandList:			return m_impl->commandLists.is_current(idx, generation);
+		case gpu_object_type::Fence:				return m_impl->fences.is_current(idx, generation);
+		case gpu_object_type::FenceEvent:			return m_impl->fenceEvents.is_current(idx, generation);
+		case gpu_object_type::DescriptorHeap:		return m_impl->descriptorHeaps.is_current(idx, generation);
+		case gpu_object_type::QueryHeap:			return m_impl->queryHeaps.is_current(idx, generation);
+		case gpu_object_type::SwapChain:			return m_impl->swapChains.is_current(idx, generation);
+		case gpu_object_type::ShaderBlob:			return m_impl->shaderBlobs.is_current(idx, generation);
+		case gpu_object_type::RootSignature:		return m_impl->rootSignatures.is_current(idx, generation);
+		case gpu_object_type::PipelineState:		return m_impl->pipelineStates.is_current(idx, generation);
+		case gpu_object_type::Resource:				return m_impl->resources.is_current(idx, generation);
+		default:								stl_assert(false); break; // unimplemented
+	}
+	return false;
+}
+
 void* gpu_dx12_context::ResourceMap(usize resourceIdx, bool read, u32 subResource, usize startByteOffset /* = 0 */, usize endByteOffset /* = 0 */)
 {
 	ID3D12ProxyResource* res = m_impl->resources[resourceIdx].resource.Get();
@@ -1590,6 +1633,11 @@ cfc::gpu_heap_type cfc::gpu_dx12_context::ResourceGetHeapType(usize resourceIdx)
 	return m_impl->resources[resourceIdx].heapType;
 }
 
+u64 cfc::gpu_dx12_context::ResourceGetAllocationSize(usize resourceIdx)
+{
+	return m_impl->device->GetResourceAllocationInfo(0, 1, &Convert(m_impl->resources[resourceIdx].desc)).SizeInBytes;
+}
+
 bool cfc::gpu_dx12_context::ResourceSetName(usize resourceIdx, const i8* fenceName)
 {
 	stl_string str = stl_string_advanced::utf16_fromUtf8(fenceName); str.push_back(0);
@@ -1738,6 +1786,25 @@ u64 cfc::gpu_dx12_context::GetTimeStampFrequency(usize cmdQueueIdx)
 	return timeStampFrequencyTicksPerSecond;
 }
 
+void cfc::gpu_dx12_context::GetClockCalibration(usize cmdQueueIdx, u64* gpuTimestamp, u64* cpuTimeNanoSeconds)
+{
+	u64 cpuCounter = 0;
+#ifdef CFC_DX12_MGPU_AFFINITY
+	m_impl->commandQueues[cmdQueueIdx]->GetClockCalibration(gpuTimestamp, &cpuCounter, m_impl->device->GetActiveNodeIndex());
+#else
+	m_impl->commandQueues[cmdQueueIdx]->GetClockCalibration(gpuTimestamp, &cpuCounter);
+#endif
+
+	// the cpu timestamp is a performance counter value, move it to the profiler timeline through a second sample of both clocks
+	LARGE_INTEGER counterNow, counterFrequency;
+	QueryPerformanceCounter(&counterNow);
+	const u64 profilerNow = profiling::profiler::GetTimeNanoSeconds();
+	QueryPerformanceFrequency(&counterFrequency);
+
+	const u64 elapsedNs = (u64)((f64)(counterNow.QuadPart - (i64)cpuCounter) * 1000000000.0 / (f64)counterFrequency.QuadPart);
+	*cpuTimeNanoSeconds = profilerNow > elapsedNs ? profilerNow - elapsedNs : 0;
+}
+
 void* cfc::gpu_dx12_context::DX12_GetDevice()
 {
 	return m_impl->device.Get();
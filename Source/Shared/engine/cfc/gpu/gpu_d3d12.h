@@ -207,6 +207,10 @@ public:
 	bool CreateDescriptorSampler(usize cpuDescriptorOffset, const cfc::gpu_sampler_desc& smpDesc);
 
 	void Destroy(gpu_object_type type, usize idx);
+
+	// generation of an object slot, changes when the object is destroyed so stale indices can be detected by the layers above
+	u32 GetGeneration(gpu_object_type type, usize idx) const;
+	bool IsCurrent(gpu_object_type type, usize idx, u32 generation) const;
 	
 	bool FenceSetName(usize fenceID, const i8* fenceName);
 	bool FenceSetEventOnCompletion(usize fenceID, usize fenceEventID, u64 fenceValue);
@@ -238,6 +242,7 @@ public:
 	bool ResourceEvict(usize resourceIdx) { return ResourceEvict(&resourceIdx, 1); }
 	u64 ResourceGetGPUAddress(usize resourceIdx);
 	gpu_heap_type ResourceGetHeapType(usize resourceIdx);
+	u64 ResourceGetAllocationSize(usize resourceIdx);		// bytes the device reserves for the resource (alignment and padding included)
 	const gpu_resource_desc& ResourceGetDesc(usize resourceIdx);
 	
 	bool ResourceSetName(usize resourceIdx, const i8* fenceName);
@@ -253,6 +258,8 @@ public:
 	// TODO: discuss if these are added to the GFX API?
 	void SetStablePowerState(bool isStablePowerState);
 	u64 GetTimeStampFrequency(usize cmdQueueIdx);
+	// gpu timestamp of the queue and the cpu time of the same moment, in nanoseconds of the profiler timeline
+	void GetClockCalibration(usize cmdQueueIdx, u64* gpuTimestamp, u64* cpuTimeNanoSeconds);
 
 	void* DX12_GetDevice();
 	void* DX12_GetCommandQueue(usize cmdqueue);
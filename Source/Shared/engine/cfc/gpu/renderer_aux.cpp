@@ -120,7 +120,6 @@ void s_initFont()
 
 void geogenerator::AddQuad(const float* xyz, const float* xyzRight, const float* xyzBottom, unsigned int color /*= 0xffffffff*/, float u, float v, float u2, float v2)
 {
-	const float* fcolor = (float*)&color;
 	float xyz2[3] = { xyz[0] + xyzRight[0], xyz[1] + xyzRight[1], xyz[2] + xyzRight[2] };
 	
 	START_ADD_VERTEX(4, gpu_primitive_type::TriangleList);
@@ -142,7 +141,6 @@ void geogenerator::AddRectangleLine(const float* xyz, const float* xyz2, unsigne
 
 void geogenerator::AddQuadLine(const float* xyz, const float* xyzRight, const float* xyzBottom, unsigned int color /*= 0xffffffff*/, float u, float v, float u2, float v2)
 {
-	const float* fcolor = (float*)&color;
 	float xyz2[3] = { xyz[0] + xyzRight[0], xyz[1] + xyzRight[1], xyz[2] + xyzRight[2] };
 
 	START_ADD_VERTEX(4, gpu_primitive_type::LineList);
@@ -160,8 +158,6 @@ void geogenerator::AddQuadLine(const float* xyz, const float* xyzRight, const fl
 
 void geogenerator::AddLine(const float* xyz, const float* xyz1, unsigned int color /*= 0xffffffff*/, float u /*= 0.0f*/, float v /*= 0.0f */, float u2/*=0.0f*/, float v2/*=0.0f*/)
 {
-	const float* fcolor = (float*)&color;
-
 	START_ADD_VERTEX(2, gpu_primitive_type::LineList);
 	ADD_VERTEX(xyz[0], xyz[1], xyz[2], u, v, color);
 	ADD_VERTEX(xyz1[0], xyz1[1], xyz1[2], u2, v2, color);
@@ -172,7 +168,6 @@ void geogenerator::AddLine(const float* xyz, const float* xyz1, unsigned int col
 
 void geogenerator::AddSegmentedLine(const float* xyz, int numVertices, unsigned int color /*= 0xffffffff*/, float u, float v)
 {
-	const float* fcolor = (float*)&color;
 	int numIndices = (numVertices - 1) * 2;
 	int vtx = 0, i = 0;
 
@@ -193,7 +188,6 @@ void geogenerator::AddSegmentedLine(const float* xyz, int numVertices, unsigned
 
 void geogenerator::AddPolygonLine(const float* xyz, int numVertices, unsigned int color /*= 0xffffffff*/, float u /*= 0.0f*/, float v /*= 0.0f*/)
 {
-	const float* fcolor = (float*)&color;
 	int numIndices = (numVertices - 1) * 2;
 	int vtx = 0, i = 0;
 
@@ -362,7 +356,7 @@ void geogenerator::SetCPUMatrixTransform(const float* transformMatrix/*=0*/)
 void geogenerator::_TransformVertices(geogenerator_vtx* vertices, usize numVertices, const float* transformMatrix)
 {
 	float newx, newy, newz;
-	for (int i = 0; i < numVertices; i++)
+	for (usize i = 0; i < numVertices; i++)
 	{
 		// v = m * v (column matrix transformation)
 		float* _vtxData = &vertices[i].x;
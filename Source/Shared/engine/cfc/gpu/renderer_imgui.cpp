@@ -25,14 +25,14 @@ static cfc::gfx_resource_stream* g_resourceStream = nullptr;
 static stl_vector<cfc::gfx_command_list*> g_commandLists;
 
 static bool				g_isInitialized = false;
-static usize			g_vb = cfc::invalid_index;
-static usize			g_ib = cfc::invalid_index;
-static usize			g_shaderProgram = cfc::invalid_index;
-static usize			g_vs = cfc::invalid_index;
-static usize			g_ps = cfc::invalid_index;
+static cfc::gfx_resource_handle	g_vb;
+static cfc::gfx_resource_handle	g_ib;
+static cfc::gfx_program_handle	g_shaderProgram;
+static cfc::gfx_shader_handle	g_vs;
+static cfc::gfx_shader_handle	g_ps;
 static usize			g_pso = cfc::invalid_index;
-static usize			g_constantBuffer = cfc::invalid_index;
-static usize			g_fontTexture = cfc::invalid_index;
+static cfc::gfx_resource_handle	g_constantBuffer;
+static cfc::gfx_resource_handle	g_fontTexture;
 static void*			g_vbCpuStagingMemory = nullptr;
 static void*			g_ibCpuStagingMemory = nullptr;
 static i32              g_VertexBufferSize = 5000;
@@ -63,17 +63,17 @@ void ImGui_ImplGfx_RenderDrawLists(ImDrawData* draw_data)
 	cfc::gfx_command_list& currentCmdList = *g_commandLists[currentFrame];
 	currentCmdList.Reset();
 
-	currentCmdList.ExecuteBarrier(cfc::gpu_resourcebarrier_desc::Transition(g_gfx->GetBackbufferRTResource(), cfc::gpu_resourcestate::Present, cfc::gpu_resourcestate::RenderTarget));
+	currentCmdList.ExecuteTransitionBarrier(g_gfx->GetBackbufferRTResource(), cfc::gpu_resourcestate::Present, cfc::gpu_resourcestate::RenderTarget);
 	
 	currentCmdList.GFXSetRenderTargets(g_gfx->GetBackbufferRTVOffset(), cfc::invalid_index);
 
     // Create and grow vertex/index buffers if needed
-    if (g_vb == cfc::invalid_index || g_VertexBufferSize < draw_data->TotalVtxCount)
+    if (!g_vb.IsValid() || g_VertexBufferSize < draw_data->TotalVtxCount)
     {
-		if (g_vb != cfc::invalid_index)
+		if (g_vb.IsValid())
 		{
 			g_gfx->RemoveResource(g_vb);
-			g_vb = cfc::invalid_index;
+			g_vb = cfc::gfx_resource_handle();
 			delete g_vbCpuStagingMemory;
 		}
 
@@ -82,12 +82,12 @@ void ImGui_ImplGfx_RenderDrawLists(ImDrawData* draw_data)
 		g_resourceStream->Flush();
 		g_vbCpuStagingMemory = new char[g_VertexBufferSize * sizeof(ImDrawVert) * g_gfx->GetBackbufferFrameQuantity()];
 	}
-	if (g_ib == cfc::invalid_index || g_IndexBufferSize < draw_data->TotalIdxCount)
+	if (!g_ib.IsValid() || g_IndexBufferSize < draw_data->TotalIdxCount)
     {
-		if (g_ib != cfc::invalid_index)
+		if (g_ib.IsValid())
 		{
 			g_gfx->RemoveResource(g_ib);
-			g_ib = cfc::invalid_index;
+			g_ib = cfc::gfx_resource_handle();
 			delete g_ibCpuStagingMemory;
 		}
 
@@ -177,11 +177,11 @@ void ImGui_ImplGfx_RenderDrawLists(ImDrawData* draw_data)
         vtx_offset += cmd_list->VtxBuffer.size();
     }
 
-	currentCmdList.ExecuteBarrier(cfc::gpu_resourcebarrier_desc::Transition(g_gfx->GetBackbufferRTResource(), cfc::gpu_resourcestate::RenderTarget, cfc::gpu_resourcestate::Present));
+	currentCmdList.ExecuteTransitionBarrier(g_gfx->GetBackbufferRTResource(), cfc::gpu_resourcestate::RenderTarget, cfc::gpu_resourcestate::Present);
 
 	currentCmdList.Close();
 
-	g_gfx->ExecuteCommandLists(currentCmdList.GetIndex());
+	g_gfx->ExecuteCommandLists(currentCmdList.GetHandle());
 }
 
 static void ImGui_ImplGfx_CreateFontsTexture()
@@ -261,7 +261,7 @@ bool    ImGui_ImplGfx_CreateDeviceObjects()
 
 		g_vs = g_gfx->AddShaderFromMemory(vertexShader, strlen(vertexShader));
 
-		stl_assert(g_vs != cfc::invalid_index);
+		stl_assert(g_vs.IsValid());
 
 		// note that the size of the constant buffer needs to be 256 bytes or bigger
 		g_constantBuffer = g_resourceStream->AddDynamicResource(cfc::gfx_resource_type::ConstantBuffer, CB_ALIGNMENT_IN_BYTES * g_gfx->GetBackbufferFrameQuantity(), true, false);
@@ -289,7 +289,7 @@ bool    ImGui_ImplGfx_CreateDeviceObjects()
 
 		g_ps = g_gfx->AddShaderFromMemory(pixelShader, strlen(pixelShader), "main", "ps_5_0");
 
-		stl_assert(g_ps != cfc::invalid_index);
+		stl_assert(g_ps.IsValid());
     }
 
 	g_shaderProgram = g_gfx->AddGraphicsProgram(g_vs, g_ps);
@@ -346,34 +346,34 @@ void    ImGui_ImplGfx_InvalidateDeviceObjects()
 	g_isInitialized = false; 
 
 	g_gfx->RemoveResource(g_vb);
-	g_vb = cfc::invalid_index;
+	g_vb = cfc::gfx_resource_handle();
 
 	g_gfx->RemoveResource(g_ib);
-	g_ib = cfc::invalid_index;
+	g_ib = cfc::gfx_resource_handle();
 
 	g_gfx->RemoveGraphicsProgram(g_shaderProgram);
-	g_shaderProgram = cfc::invalid_index;
+	g_shaderProgram = cfc::gfx_program_handle();
 
 	g_gfx->RemoveShader(g_vs);
-	g_vs = cfc::invalid_index;
+	g_vs = cfc::gfx_shader_handle();
 
 	g_gfx->RemoveShader(g_ps);
-	g_ps = cfc::invalid_index;
+	g_ps = cfc::gfx_shader_handle();
 
 	g_gfx->RemoveResource(g_constantBuffer);
-	g_constantBuffer = cfc::invalid_index;
+	g_constantBuffer = cfc::gfx_resource_handle();
 
 	g_gfx->RemoveResource(g_fontTexture);
-	g_fontTexture = cfc::invalid_index;
+	g_fontTexture = cfc::gfx_resource_handle();
 
-	g_gfx->RemoveDescriptorHeap(g_descriptorHeap->GetIndex());
+	g_gfx->RemoveDescriptorHeap(g_descriptorHeap->GetHandle());
 	g_descriptorHeap = nullptr;
 
-	g_gfx->RemoveResourceStream(g_resourceStream->GetIndex());
+	g_gfx->RemoveResourceStream(g_resourceStream->GetHandle());
 	g_resourceStream = nullptr;
 
 	for (u32 i = 0; i < g_commandLists.size(); ++i)
-		g_gfx->RemoveCommandList(g_commandLists[i]->GetIndex());
+		g_gfx->RemoveCommandList(g_commandLists[i]->GetHandle());
 	g_commandLists.resize(0);
 }
 
@@ -0,0 +1,234 @@
+#include "texture_compress.h"
+#include "texture_mipgen.h"
+
+#include <cfc/core/io.h>
+#include <cfc/core/hashing.h>
+#include <cfc/stl/jobsystem.h>
+
+#include <dependencies/stb/stb_dxt.h>
+
+#include <string.h>
+
+namespace cfc {
+
+#pragma region Cache container
+#define CFC_TEXTURE_CACHE_MAGIC 0x58544243 // 'CBTX'
+#define CFC_TEXTURE_CACHE_VERSION 2
+
+#pragma pack(push,1)
+struct texture_cache_header
+{
+	u32 Magic;
+	u32 Version;
+	u64 CacheKey;
+	u32 Format;
+	u32 Width;
+	u32 Height;
+	u32 MipCount;
+	u64 DataSizeInBytes;
+};
+#pragma pack(pop)
+#pragma endregion
+
+#pragma region Helpers
+static u32 getBlockSize(gpu_format_type fmt)
+{
+	const i32 blockSize = gpu_format_type_query::GetCompressedBlockSize(fmt);
+	stl_assert(blockSize > 0);
+	return (u32)blockSize;
+}
+
+static bool isAlphaFormat(gpu_format_type fmt)
+{
+	return fmt == gpu_format_type::BC3Unorm || fmt == gpu_format_type::BC3UnormSrgb;
+}
+
+// gathers a 4x4 block, texels outside of the mip are clamped to the edge (mips below 4x4)
+static void gatherBlock(const u8* mip, u32 width, u32 height, u32 blockX, u32 blockY, u8 block[64])
+{
+	for (u32 y = 0; y < 4; ++y)
+	{
+		u32 sy = blockY * 4 + y;
+		sy = sy < height ? sy : height - 1;
+		for (u32 x = 0; x < 4; ++x)
+		{
+			u32 sx = blockX * 4 + x;
+			sx = sx < width ? sx : width - 1;
+			memcpy(block + (y * 4 + x) * 4, mip + ((usize)sy * width + sx) * 4, 4);
+		}
+	}
+}
+
+// a single row of blocks of a single mip, the unit of work of the job system
+struct texture_compress_row
+{
+	const u8* SrcMip;
+	u8* DstRow;
+	u32 Width;
+	u32 Height;
+	u32 BlockY;
+};
+#pragma endregion
+
+#pragma region texture_compress
+bool texture_compress::HasTransparency(const u8* rgba8, usize numTexels)
+{
+	for (usize i = 0; i < numTexels; ++i)
+	{
+		if (rgba8[i * 4 + 3] != 0xFF)
+			return true;
+	}
+	return false;
+}
+
+gpu_format_type texture_compress::SelectBlockFormat(const u8* rgba8Level0, u32 width, u32 height, bool srgb)
+{
+	if (HasTransparency(rgba8Level0, (usize)width * height))
+		return srgb ? gpu_format_type::BC3UnormSrgb : gpu_format_type::BC3Unorm;
+	return srgb ? gpu_format_type::BC1UnormSrgb : gpu_format_type::BC1Unorm;
+}
+
+usize texture_compress::GetMipChainSizeInBytes(gpu_format_type fmt, u32 width, u32 height, u32 mipCount)
+{
+	usize numBytes = 0;
+	for (u32 i = 0; i < mipCount; ++i)
+	{
+		u32 w, h;
+		texture_mipgen::GetMipDimensions(width, height, i, w, h);
+		numBytes += gpu_format_type_query::GetRowBytes(fmt, w) * ((h + 3) / 4);
+	}
+	return numBytes;
+}
+
+void texture_compress::CompressMipChainRGBA8(const u8* srcMipChain, u32 width, u32 height, u32 mipCount, gpu_format_type fmt, u8* dstMipChain, bool highQuality, core::threading::job_system* jobs)
+{
+	const u32 blockSize = getBlockSize(fmt);
+	const int alpha = isAlphaFormat(fmt) ? 1 : 0;
+	const int mode = highQuality ? STB_DXT_HIGHQUAL : STB_DXT_NORMAL;
+
+	// NOTE: only BC1 and BC3 have an encoder (stb_dxt), BC7 is not supported
+	stl_assert(fmt == gpu_format_type::BC1Unorm || fmt == gpu_format_type::BC1UnormSrgb || isAlphaFormat(fmt));
+
+	// build the list of block rows
+	stl_vector<texture_compress_row> rows;
+	const u8* src = srcMipChain;
+	u8* dst = dstMipChain;
+	for (u32 mip = 0; mip < mipCount; ++mip)
+	{
+		u32 w, h;
+		texture_mipgen::GetMipDimensions(width, height, mip, w, h);
+		const usize rowBytes = gpu_format_type_query::GetRowBytes(fmt, w);
+		const u32 numBlockRows = (h + 3) / 4;
+		for (u32 by = 0; by < numBlockRows; ++by)
+		{
+			texture_compress_row row = { src, dst + rowBytes * by, w, h, by };
+			rows.push_back(row);
+		}
+		src += (usize)w * h * 4;
+		dst += rowBytes * numBlockRows;
+	}
+
+	// stb_dxt lazily builds its tables on the first call, make sure that happens before any worker starts
+	u8 block[64] = {};
+	u8 blockOut[16];
+	stb_compress_dxt_block(blockOut, block, alpha, mode);
+
+	auto compressRows = [&rows, blockSize, alpha, mode](u32 first, u32 last)
+	{
+		u8 texels[64];
+		for (u32 i = first; i < last; ++i)
+		{
+			const texture_compress_row& row = rows[i];
+			const u32 numBlocksX = (row.Width + 3) / 4;
+			for (u32 bx = 0; bx < numBlocksX; ++bx)
+			{
+				gatherBlock(row.SrcMip, row.Width, row.Height, bx, row.BlockY, texels);
+				stb_compress_dxt_block(row.DstRow + bx * blockSize, texels, alpha, mode);
+			}
+		}
+	};
+
+	// NOTE: the grain keeps chunks of the small mips from turning into jobs of a few blocks
+	if (jobs != nullptr)
+		jobs->ParallelFor(0, (u32)rows.size(), compressRows, 4);
+	else
+		compressRows(0, (u32)rows.size());
+}
+
+void texture_compress::CompressMipChainRGBA8(const u8* srcMipChain, u32 width, u32 height, u32 mipCount, const texture_compress_settings& settings, texture_compressed_mip_chain& outChain, core::threading::job_system* jobs)
+{
+	const gpu_format_type fmt = settings.Format != gpu_format_type::Unknown ? settings.Format : SelectBlockFormat(srcMipChain, width, height, settings.Srgb);
+
+	outChain.Format = fmt;
+	outChain.Width = width;
+	outChain.Height = height;
+	outChain.MipCount = mipCount;
+	outChain.Data.resize(GetMipChainSizeInBytes(fmt, width, height, mipCount));
+	CompressMipChainRGBA8(srcMipChain, width, height, mipCount, fmt, &outChain.Data[0], settings.HighQuality, jobs);
+}
+
+u64 texture_compress::GetCacheKey(u64 sourceHash, const texture_compress_settings& settings)
+{
+	// NOTE: hashed per field, the padding of the settings is undefined
+	const u32 values[3] = { (u32)settings.Format, settings.Srgb ? 1u : 0u, settings.HighQuality ? 1u : 0u };
+	return Hash64(values, sizeof(values), sourceHash);
+}
+
+bool texture_compress::ReadCache(io& fileIO, const char* path, u64 cacheKey, texture_compressed_mip_chain& outChain)
+{
+	if (!fileIO.Exists(path))
+		return false;
+
+	iobuffer file = fileIO.ReadFileToMemory(path);
+	if (!file)
+		return false;
+	return ReadCacheFromMemory(file.data, file.size, cacheKey, outChain);
+}
+
+bool texture_compress::ReadCacheFromMemory(const u8* data, usize size, u64 cacheKey, texture_compressed_mip_chain& outChain)
+{
+	if (size < sizeof(texture_cache_header))
+		return false;
+
+	texture_cache_header header;
+	memcpy(&header, data, sizeof(header));
+	if (header.Magic != CFC_TEXTURE_CACHE_MAGIC || header.Version != CFC_TEXTURE_CACHE_VERSION || header.CacheKey != cacheKey)
+		return false;
+
+	// NOTE: a corrupt or stale header must not reach the size computation, it loops over the mips and shifts by the level
+	if (header.Width == 0 || header.Height == 0 || header.MipCount == 0 || header.MipCount > texture_mipgen::GetMipLevelQuantity(header.Width, header.Height))
+		return false;
+
+	const gpu_format_type fmt = (gpu_format_type)header.Format;
+	if (!gpu_format_type_query::IsCompressedType(fmt) || header.DataSizeInBytes != GetMipChainSizeInBytes(fmt, header.Width, header.Height, header.MipCount) || size < sizeof(header) + header.DataSizeInBytes)
+		return false;
+
+	outChain.Format = fmt;
+	outChain.Width = header.Width;
+	outChain.Height = header.Height;
+	outChain.MipCount = header.MipCount;
+	outChain.Data.assign(data + sizeof(header), data + sizeof(header) + header.DataSizeInBytes);
+	return true;
+}
+
+bool texture_compress::WriteCache(io& fileIO, const char* path, u64 cacheKey, const texture_compressed_mip_chain& chain)
+{
+	texture_cache_header header;
+	header.Magic = CFC_TEXTURE_CACHE_MAGIC;
+	header.Version = CFC_TEXTURE_CACHE_VERSION;
+	header.CacheKey = cacheKey;
+	header.Format = (u32)chain.Format;
+	header.Width = chain.Width;
+	header.Height = chain.Height;
+	header.MipCount = chain.MipCount;
+	header.DataSizeInBytes = chain.Data.size();
+
+	stl_vector<u8> file(sizeof(header) + chain.Data.size());
+	memcpy(&file[0], &header, sizeof(header));
+	if (!chain.Data.empty())
+		memcpy(&file[sizeof(header)], &chain.Data[0], chain.Data.size());
+	return fileIO.WriteMemoryToFile(path, &file[0], file.size());
+}
+#pragma endregion
+
+}; // end namespace cfc
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cfc/base.h>
+#include <cfc/gpu/gpu.h>
+
+#include <cfc/stl/stl_vector.hpp>
+
+namespace cfc
+{
+	class io;
+	namespace core { namespace threading { class job_system; }; };
+
+	// tightly packed block compressed mip chain, per mip the block rows follow each other (same layout as gfx_resource_stream::AddTexture expects)
+	struct texture_compressed_mip_chain
+	{
+		gpu_format_type Format = gpu_format_type::Unknown;
+		u32 Width = 0;
+		u32 Height = 0;
+		u32 MipCount = 0;
+		stl_vector<u8> Data;
+	};
+
+	// encoder settings, they are part of the cache key so a change of settings does not reuse textures compressed with the old ones
+	struct texture_compress_settings
+	{
+		gpu_format_type Format = gpu_format_type::Unknown;		// Unknown picks BC1 or BC3 per texture (see SelectBlockFormat)
+		bool Srgb = true;										// of the picked format
+		bool HighQuality = true;
+	};
+
+	class CFC_API texture_compress
+	{
+	public:
+		// BC formats require the top level to be a multiple of the 4x4 block size
+		static bool CanCompress(u32 width, u32 height) { return width >= 4 && height >= 4 && (width & 3) == 0 && (height & 3) == 0; }
+		static bool HasTransparency(const u8* rgba8, usize numTexels);
+
+		// picks BC1 for opaque and BC3 for transparent textures
+		static gpu_format_type SelectBlockFormat(const u8* rgba8Level0, u32 width, u32 height, bool srgb);
+
+		static usize GetMipChainSizeInBytes(gpu_format_type fmt, u32 width, u32 height, u32 mipCount);
+
+		// compresses a tightly packed RGBA8 mip chain (see texture_mipgen), the block rows are spread over the job system
+		// NOTE: without a job system the calling thread compresses all blocks
+		static void CompressMipChainRGBA8(const u8* srcMipChain, u32 width, u32 height, u32 mipCount, gpu_format_type fmt, u8* dstMipChain, bool highQuality = true, core::threading::job_system* jobs = nullptr);
+		static void CompressMipChainRGBA8(const u8* srcMipChain, u32 width, u32 height, u32 mipCount, const texture_compress_settings& settings, texture_compressed_mip_chain& outChain, core::threading::job_system* jobs = nullptr);
+
+		// on disk cache, entries are only valid when the stored key matches, the key combines the source hash with the encoder settings
+		static u64 GetCacheKey(u64 sourceHash, const texture_compress_settings& settings);
+		static bool ReadCache(io& fileIO, const char* path, u64 cacheKey, texture_compressed_mip_chain& outChain);
+		static bool ReadCacheFromMemory(const u8* data, usize size, u64 cacheKey, texture_compressed_mip_chain& outChain);
+		static bool WriteCache(io& fileIO, const char* path, u64 cacheKey, const texture_compressed_mip_chain& chain);
+	};
+}; // end namespace cfc
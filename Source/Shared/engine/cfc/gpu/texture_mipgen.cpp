@@ -0,0 +1,665 @@
+#include "texture_mipgen.h"
+
+#include <cfc/core/frame_allocator.h>
+#include <cfc/stl/stl_vector.hpp>
+
+#include <math.h>
+#include <string.h>
+
+#include <emmintrin.h>
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+
+namespace cfc {
+
+#pragma region Conversion
+// sRGB decoding is a 256 entry lookup, encoding a lookup by the float bits: 1024 entries per power of two from 2^-13 up to 1 (the
+// rounding error of a bucket stays below 0.1 of an 8 bit step, every 8 bit value survives a round trip)
+#define TEXTURE_MIPGEN_SRGB_ENCODE_SHIFT 13
+static const u32 g_srgbEncodeMinBits = (127 - 13) << 23;
+static const u32 g_srgbEncodeMaxBits = 0x3F7FFFFF; // largest float below 1
+static const u32 g_srgbEncodeQuantity = ((g_srgbEncodeMaxBits - g_srgbEncodeMinBits) >> TEXTURE_MIPGEN_SRGB_ENCODE_SHIFT) + 1;
+
+struct texture_mipgen_tables
+{
+	float SrgbToLinear[256];
+	u8 LinearToSrgb[g_srgbEncodeQuantity];
+
+	texture_mipgen_tables()
+	{
+		for (u32 i = 0; i < 256; ++i)
+		{
+			const float s = (float)i / 255.0f;
+			SrgbToLinear[i] = s <= 0.04045f ? s / 12.92f : powf((s + 0.055f) / 1.055f, 2.4f);
+		}
+
+		for (u32 i = 0; i < g_srgbEncodeQuantity; ++i)
+		{
+			// the center of the values sharing the bucket
+			const u32 bits = g_srgbEncodeMinBits + (i << TEXTURE_MIPGEN_SRGB_ENCODE_SHIFT) + (1 << (TEXTURE_MIPGEN_SRGB_ENCODE_SHIFT - 1));
+			float l;
+			memcpy(&l, &bits, sizeof(l));
+			const double s = l <= 0.0031308f ? l * 12.92 : 1.055 * pow((double)l, 1.0 / 2.4) - 0.055;
+			LinearToSrgb[i] = (u8)(s * 255.0 + 0.5);
+		}
+	}
+};
+
+static const texture_mipgen_tables& getTables()
+{
+	static const texture_mipgen_tables tables;
+	return tables;
+}
+
+// bucket indices of 4 linear values into LinearToSrgb
+static inline __m128i linearToSrgbIndex(__m128 l)
+{
+	const __m128 clamped = _mm_min_ps(_mm_max_ps(l, _mm_castsi128_ps(_mm_set1_epi32(g_srgbEncodeMinBits))), _mm_castsi128_ps(_mm_set1_epi32(g_srgbEncodeMaxBits)));
+	return _mm_srli_epi32(_mm_sub_epi32(_mm_castps_si128(clamped), _mm_set1_epi32(g_srgbEncodeMinBits)), TEXTURE_MIPGEN_SRGB_ENCODE_SHIFT);
+}
+#pragma endregion
+
+#pragma region Filter kernels
+static const float g_pi = 3.14159265358979323846f;
+
+static float sinc(float x)
+{
+	if (fabsf(x) < 1e-5f)
+		return 1.0f;
+	x *= g_pi;
+	return sinf(x) / x;
+}
+
+static float bessel0(float x)
+{
+	// power series of the zeroth order modified bessel function of the first kind
+	const float xh = x * 0.5f;
+	float sum = 1.0f, term = 1.0f;
+	for (u32 k = 1; k < 32 && term > sum * 1e-8f; ++k)
+	{
+		term *= (xh / (float)k) * (xh / (float)k);
+		sum += term;
+	}
+	return sum;
+}
+
+static float kernelRadius(texture_mipgen_filter_type filter)
+{
+	switch (filter)
+	{
+	case texture_mipgen_filter_type::Kaiser: return 3.0f;
+	case texture_mipgen_filter_type::Lanczos: return 3.0f;
+	default: return 0.5f;
+	}
+}
+
+static float kernelWeight(texture_mipgen_filter_type filter, float x)
+{
+	const float radius = kernelRadius(filter);
+	if (fabsf(x) >= radius)
+		return 0.0f;
+
+	switch (filter)
+	{
+	case texture_mipgen_filter_type::Kaiser:
+	{
+		const float alpha = 4.0f;
+		const float t = x / radius;
+		return sinc(x) * bessel0(alpha * sqrtf(1.0f - t * t)) / bessel0(alpha);
+	}
+	case texture_mipgen_filter_type::Lanczos:
+		return sinc(x) * sinc(x / radius);
+	default:
+		return 1.0f;
+	}
+}
+
+// per destination texel a list of (source texel, weight) taps along one axis
+struct texture_mipgen_taps
+{
+	stl_vector<u32> Offsets;
+	stl_vector<u32> Indices;
+	stl_vector<float> Weights;
+};
+
+static u32 resolveAddress(i32 index, u32 size, texture_mipgen_address_mode mode)
+{
+	if (mode == texture_mipgen_address_mode::Wrap)
+		return (u32)(((index % (i32)size) + (i32)size) % (i32)size);
+	return (u32)(index < 0 ? 0 : (index >= (i32)size ? (i32)size - 1 : index));
+}
+
+static void buildTaps(u32 srcSize, u32 dstSize, const texture_mipgen_desc& desc, texture_mipgen_taps& taps)
+{
+	taps.Offsets.clear();
+	taps.Indices.clear();
+	taps.Weights.clear();
+
+	const float scale = (float)srcSize / (float)dstSize;
+	for (u32 d = 0; d < dstSize; ++d)
+	{
+		const u32 first = (u32)taps.Indices.size();
+		taps.Offsets.push_back(first);
+
+		if (desc.Filter == texture_mipgen_filter_type::Box)
+		{
+			// area coverage of the destination texel footprint, handles odd (non power of two) reductions
+			const float begin = (float)d * scale;
+			const float end = (float)(d + 1) * scale;
+			for (i32 i = (i32)floorf(begin); i < (i32)ceilf(end); ++i)
+			{
+				const float coverage = fminf(end, (float)(i + 1)) - fmaxf(begin, (float)i);
+				if (coverage <= 0.0f)
+					continue;
+				taps.Indices.push_back(resolveAddress(i, srcSize, desc.AddressMode));
+				taps.Weights.push_back(coverage);
+			}
+		}
+		else
+		{
+			// kernel is stretched by the reduction factor so it acts as a low pass at the destination rate
+			const float center = ((float)d + 0.5f) * scale;
+			const float radius = kernelRadius(desc.Filter) * scale;
+			for (i32 i = (i32)floorf(center - radius); i <= (i32)ceilf(center + radius); ++i)
+			{
+				const float w = kernelWeight(desc.Filter, ((float)i + 0.5f - center) / scale);
+				if (w == 0.0f)
+					continue;
+				taps.Indices.push_back(resolveAddress(i, srcSize, desc.AddressMode));
+				taps.Weights.push_back(w);
+			}
+		}
+
+		// normalize
+		float sum = 0.0f;
+		for (usize i = first; i < taps.Weights.size(); ++i)
+			sum += taps.Weights[i];
+		const float invSum = sum != 0.0f ? 1.0f / sum : 0.0f;
+		for (usize i = first; i < taps.Weights.size(); ++i)
+			taps.Weights[i] *= invSum;
+	}
+	taps.Offsets.push_back((u32)taps.Indices.size());
+}
+#pragma endregion
+
+#pragma region SIMD passes
+// linear float4 texel, kept as plain floats so it can live in an stl_vector (attributes on __m128 are dropped as a template argument)
+struct alignas(16) texture_mipgen_texel
+{
+	float V[4];
+};
+
+// 4 texels with a register per channel (r, g, b, a), the layout the conversions and the quad reduction work in
+// NOTE: written out per channel instead of looping over them, the loops were not unrolled and kept the channels in memory
+struct texture_mipgen_texel4
+{
+	__m128 R, G, B, A;
+};
+
+// 4 RGBA8 texels (16 readable bytes) to linear, optionally premultiplying rgb by alpha
+template <bool Srgb, bool Premultiply>
+static inline texture_mipgen_texel4 decodeTexel4(const u8* src, const texture_mipgen_tables& tables)
+{
+	const __m128i texels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+	const __m128i byteMask = _mm_set1_epi32(0xFF);
+	const __m128 unormScale = _mm_set1_ps(1.0f / 255.0f);
+
+	texture_mipgen_texel4 t;
+	if (Srgb)
+	{
+		t.R = _mm_setr_ps(tables.SrgbToLinear[src[0]], tables.SrgbToLinear[src[4]], tables.SrgbToLinear[src[8]], tables.SrgbToLinear[src[12]]);
+		t.G = _mm_setr_ps(tables.SrgbToLinear[src[1]], tables.SrgbToLinear[src[5]], tables.SrgbToLinear[src[9]], tables.SrgbToLinear[src[13]]);
+		t.B = _mm_setr_ps(tables.SrgbToLinear[src[2]], tables.SrgbToLinear[src[6]], tables.SrgbToLinear[src[10]], tables.SrgbToLinear[src[14]]);
+	}
+	else
+	{
+		t.R = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(texels, byteMask)), unormScale);
+		t.G = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texels, 8), byteMask)), unormScale);
+		t.B = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texels, 16), byteMask)), unormScale);
+	}
+	t.A = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(texels, 24)), unormScale);
+
+	if (Premultiply)
+	{
+		t.R = _mm_mul_ps(t.R, t.A);
+		t.G = _mm_mul_ps(t.G, t.A);
+		t.B = _mm_mul_ps(t.B, t.A);
+	}
+	return t;
+}
+
+static inline __m128i encodeUnorm(__m128 c)
+{
+	const __m128 saturated = _mm_min_ps(_mm_max_ps(c, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+	return _mm_cvtps_epi32(_mm_mul_ps(saturated, _mm_set1_ps(255.0f)));
+}
+
+// 4 texels to packed RGBA8, the sRGB lookups go through scalar registers
+template <bool Srgb>
+static inline __m128i encodeTexel4(const texture_mipgen_texel4& t, const texture_mipgen_tables& tables)
+{
+	const __m128i alpha = _mm_slli_epi32(encodeUnorm(t.A), 24);
+	if (!Srgb)
+	{
+		const __m128i rg = _mm_or_si128(encodeUnorm(t.R), _mm_slli_epi32(encodeUnorm(t.G), 8));
+		return _mm_or_si128(_mm_or_si128(rg, _mm_slli_epi32(encodeUnorm(t.B), 16)), alpha);
+	}
+
+	alignas(16) u32 index[12];
+	_mm_store_si128(reinterpret_cast<__m128i*>(index), linearToSrgbIndex(t.R));
+	_mm_store_si128(reinterpret_cast<__m128i*>(index + 4), linearToSrgbIndex(t.G));
+	_mm_store_si128(reinterpret_cast<__m128i*>(index + 8), linearToSrgbIndex(t.B));
+	const u8* linearToSrgb = tables.LinearToSrgb;
+	const u32 rgb0 = linearToSrgb[index[0]] | (linearToSrgb[index[4]] << 8) | (linearToSrgb[index[8]] << 16);
+	const u32 rgb1 = linearToSrgb[index[1]] | (linearToSrgb[index[5]] << 8) | (linearToSrgb[index[9]] << 16);
+	const u32 rgb2 = linearToSrgb[index[2]] | (linearToSrgb[index[6]] << 8) | (linearToSrgb[index[10]] << 16);
+	const u32 rgb3 = linearToSrgb[index[3]] | (linearToSrgb[index[7]] << 8) | (linearToSrgb[index[11]] << 16);
+	return _mm_or_si128(_mm_setr_epi32(rgb0, rgb1, rgb2, rgb3), alpha);
+}
+
+// copies count (at most 4) texels into a zero padded block of 4
+static inline const u8* padRGBA8(const u8* src, usize count, u8 (&padded)[16])
+{
+	if (count >= 4)
+		return src;
+
+	memset(padded, 0, sizeof(padded));
+	memcpy(padded, src, count * 4);
+	return padded;
+}
+
+static inline void storeRGBA8(u8* dst, usize count, __m128i texels)
+{
+	if (count >= 4)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), texels);
+		return;
+	}
+
+	u8 padded[16];
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(padded), texels);
+	memcpy(dst, padded, count * 4);
+}
+
+// stores 4 texels as float4 texels, transposed back from the channel registers
+static inline void storeTexels(texture_mipgen_texel* dst, usize count, texture_mipgen_texel4 t)
+{
+	_MM_TRANSPOSE4_PS(t.R, t.G, t.B, t.A);
+	if (count >= 4)
+	{
+		_mm_store_ps(dst[0].V, t.R);
+		_mm_store_ps(dst[1].V, t.G);
+		_mm_store_ps(dst[2].V, t.B);
+		_mm_store_ps(dst[3].V, t.A);
+		return;
+	}
+
+	const __m128 texels[4] = { t.R, t.G, t.B, t.A };
+	for (usize i = 0; i < count; ++i)
+		_mm_store_ps(dst[i].V, texels[i]);
+}
+
+// decodes RGBA8 into linear float4 texels, 4 texels per iteration
+template <bool Srgb, bool Premultiply>
+static void decodeRGBA8(const u8* src, usize numTexels, texture_mipgen_texel* dst)
+{
+	const texture_mipgen_tables& tables = getTables();
+	u8 padded[16];
+	for (usize i = 0; i < numTexels; i += 4)
+		storeTexels(dst + i, numTexels - i, decodeTexel4<Srgb, Premultiply>(padRGBA8(src + i * 4, numTexels - i, padded), tables));
+}
+
+template <bool Srgb>
+static void encodeRGBA8(const texture_mipgen_texel* src, usize numTexels, u8* dst)
+{
+	const texture_mipgen_tables& tables = getTables();
+	for (usize i = 0; i < numTexels; i += 4)
+	{
+		const usize count = numTexels - i;
+		const __m128 zero = _mm_setzero_ps();
+		texture_mipgen_texel4 t;
+		t.R = _mm_load_ps(src[i].V);
+		t.G = count > 1 ? _mm_load_ps(src[i + 1].V) : zero;
+		t.B = count > 2 ? _mm_load_ps(src[i + 2].V) : zero;
+		t.A = count > 3 ? _mm_load_ps(src[i + 3].V) : zero;
+		_MM_TRANSPOSE4_PS(t.R, t.G, t.B, t.A);
+		storeRGBA8(dst + i * 4, count, encodeTexel4<Srgb>(t, tables));
+	}
+}
+
+static void decodeRGBA8(const u8* src, usize numTexels, const texture_mipgen_desc& desc, texture_mipgen_texel* dst)
+{
+	if (desc.SRGB)
+		desc.PremultiplyAlpha ? decodeRGBA8<true, true>(src, numTexels, dst) : decodeRGBA8<true, false>(src, numTexels, dst);
+	else
+		desc.PremultiplyAlpha ? decodeRGBA8<false, true>(src, numTexels, dst) : decodeRGBA8<false, false>(src, numTexels, dst);
+}
+
+static void encodeRGBA8(const texture_mipgen_texel* src, usize numTexels, const texture_mipgen_desc& desc, u8* dst)
+{
+	desc.SRGB ? encodeRGBA8<true>(src, numTexels, dst) : encodeRGBA8<false>(src, numTexels, dst);
+}
+
+static bool isBoxQuad(const texture_mipgen_desc& desc, u32 srcWidth, u32 srcHeight)
+{
+	return desc.Filter == texture_mipgen_filter_type::Box && (srcWidth & 1) == 0 && (srcHeight & 1) == 0;
+}
+
+// 2:1 box of even dimensions, every destination texel is the mean of a quad of two source rows
+static void boxQuadRow(const texture_mipgen_texel* srcRow0, const texture_mipgen_texel* srcRow1, u32 dstWidth, texture_mipgen_texel* dst)
+{
+	const __m128 quarter = _mm_set1_ps(0.25f);
+	for (u32 x = 0; x < dstWidth; ++x)
+	{
+		const __m128 top = _mm_add_ps(_mm_load_ps(srcRow0[x * 2].V), _mm_load_ps(srcRow0[x * 2 + 1].V));
+		const __m128 bottom = _mm_add_ps(_mm_load_ps(srcRow1[x * 2].V), _mm_load_ps(srcRow1[x * 2 + 1].V));
+		_mm_store_ps(dst[x].V, _mm_mul_ps(_mm_add_ps(top, bottom), quarter));
+	}
+}
+
+static void boxQuad(const texture_mipgen_texel* src, u32 srcWidth, u32 srcHeight, texture_mipgen_texel* dst)
+{
+	const u32 dstWidth = srcWidth / 2;
+	for (u32 y = 0; y < srcHeight / 2; ++y)
+		boxQuadRow(src + (usize)y * 2 * srcWidth, src + ((usize)y * 2 + 1) * srcWidth, dstWidth, dst + (usize)y * dstWidth);
+}
+
+// mean of the even and odd lanes of two blocks of both rows
+static inline __m128 quadChannel(__m128 row0Block0, __m128 row0Block1, __m128 row1Block0, __m128 row1Block1)
+{
+	const __m128 top = _mm_add_ps(_mm_shuffle_ps(row0Block0, row0Block1, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(row0Block0, row0Block1, _MM_SHUFFLE(3, 1, 3, 1)));
+	const __m128 bottom = _mm_add_ps(_mm_shuffle_ps(row1Block0, row1Block1, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(row1Block0, row1Block1, _MM_SHUFFLE(3, 1, 3, 1)));
+	return _mm_mul_ps(_mm_add_ps(top, bottom), _mm_set1_ps(0.25f));
+}
+
+// decodes 4 texels and writes them to level 0, premultiplied when requested
+template <bool Srgb, bool Premultiply>
+static inline texture_mipgen_texel4 decodeBlock(const u8* src, u8* dstLevel0, const texture_mipgen_tables& tables)
+{
+	const texture_mipgen_texel4 t = decodeTexel4<Srgb, Premultiply>(src, tables);
+	const __m128i texels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+
+	// NOTE: premultiplying opaque texels gives back the source (every 8 bit value survives a round trip), only blocks with alpha are encoded
+	const __m128i opaque = _mm_cmpeq_epi32(_mm_or_si128(texels, _mm_set1_epi32(0x00FFFFFF)), _mm_set1_epi32(-1));
+	if (!Premultiply || _mm_movemask_epi8(opaque) == 0xFFFF)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dstLevel0), texels);
+	else
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dstLevel0), encodeTexel4<Srgb>(t, tables));
+	return t;
+}
+
+// 4 destination texels from 8 source texels of two rows (srcRowBytes apart), level 0 is copied (or written premultiplied) from the
+// same loads
+template <bool Srgb, bool Premultiply>
+static inline texture_mipgen_texel4 boxQuadBlock(const u8* srcRow0, usize srcRowBytes, u8* dstLevel0Row0, usize dstRowBytes, const texture_mipgen_tables& tables)
+{
+	const texture_mipgen_texel4 t00 = decodeBlock<Srgb, Premultiply>(srcRow0, dstLevel0Row0, tables);
+	const texture_mipgen_texel4 t01 = decodeBlock<Srgb, Premultiply>(srcRow0 + 16, dstLevel0Row0 + 16, tables);
+	const texture_mipgen_texel4 t10 = decodeBlock<Srgb, Premultiply>(srcRow0 + srcRowBytes, dstLevel0Row0 + dstRowBytes, tables);
+	const texture_mipgen_texel4 t11 = decodeBlock<Srgb, Premultiply>(srcRow0 + srcRowBytes + 16, dstLevel0Row0 + dstRowBytes + 16, tables);
+
+	texture_mipgen_texel4 quad;
+	quad.R = quadChannel(t00.R, t01.R, t10.R, t11.R);
+	quad.G = quadChannel(t00.G, t01.G, t10.G, t11.G);
+	quad.B = quadChannel(t00.B, t01.B, t10.B, t11.B);
+	quad.A = quadChannel(t00.A, t01.A, t10.A, t11.A);
+	return quad;
+}
+
+// a row of level 1 straight from two rows of level 0, written as float4 texels and encoded to dstLevel1
+template <bool Srgb, bool Premultiply>
+static void boxQuadRowRGBA8(const u8* srcRow0, u32 srcWidth, u8* dstLevel0Row0, texture_mipgen_texel* dst, u8* dstLevel1)
+{
+	const texture_mipgen_tables& tables = getTables();
+	const u32 dstWidth = srcWidth / 2;
+	const usize srcRowBytes = (usize)srcWidth * 4;
+
+	u32 x = 0;
+	for (; x + 4 <= dstWidth; x += 4)
+	{
+		const texture_mipgen_texel4 quad = boxQuadBlock<Srgb, Premultiply>(srcRow0 + x * 8, srcRowBytes, dstLevel0Row0 + x * 8, srcRowBytes, tables);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dstLevel1 + x * 4), encodeTexel4<Srgb>(quad, tables));
+		storeTexels(dst + x, 4, quad);
+	}
+
+	// the end of the row goes through zero padded blocks (rows of 32 bytes)
+	if (x < dstWidth)
+	{
+		const usize count = dstWidth - x;
+		u8 padded[2][32] = {};
+		u8 paddedLevel0[2][32];
+		memcpy(padded[0], srcRow0 + x * 8, count * 8);
+		memcpy(padded[1], srcRow0 + srcRowBytes + x * 8, count * 8);
+
+		const texture_mipgen_texel4 quad = boxQuadBlock<Srgb, Premultiply>(padded[0], 32, paddedLevel0[0], 32, tables);
+		memcpy(dstLevel0Row0 + x * 8, paddedLevel0[0], count * 8);
+		memcpy(dstLevel0Row0 + srcRowBytes + x * 8, paddedLevel0[1], count * 8);
+		storeRGBA8(dstLevel1 + x * 4, count, encodeTexel4<Srgb>(quad, tables));
+		storeTexels(dst + x, count, quad);
+	}
+}
+
+// level 0 straight into level 1 and, when level 1 has even dimensions as well, on into level 2: level 1 then only lives in two rows
+// and dst receives level 2, otherwise level 1
+// NOTE: level 0 is copied (or written premultiplied) to dstLevel0 from the same loads, level 1 is encoded to dstLevel1
+template <bool Srgb, bool Premultiply>
+static void boxQuadRGBA8(const u8* src, u32 srcWidth, u32 srcHeight, bool reduceLevel1, u8* dstLevel0, u8* dstLevel1, texture_mipgen_texel* rows, texture_mipgen_texel* dst)
+{
+	const u32 level1Width = srcWidth / 2;
+	const usize srcRowPairBytes = (usize)srcWidth * 8;
+	for (u32 y = 0; y < srcHeight / 2; ++y)
+	{
+		const usize srcOffset = (usize)y * srcRowPairBytes;
+		u8* dstRow1 = dstLevel1 + (usize)y * level1Width * 4;
+		if (reduceLevel1)
+		{
+			boxQuadRowRGBA8<Srgb, Premultiply>(src + srcOffset, srcWidth, dstLevel0 + srcOffset, rows + (usize)(y & 1) * level1Width, dstRow1);
+			if (y & 1)
+				boxQuadRow(rows, rows + level1Width, level1Width / 2, dst + (usize)(y / 2) * (level1Width / 2));
+		}
+		else
+		{
+			boxQuadRowRGBA8<Srgb, Premultiply>(src + srcOffset, srcWidth, dstLevel0 + srcOffset, dst + (usize)y * level1Width, dstRow1);
+		}
+	}
+}
+
+static void boxQuadRGBA8(const u8* src, u32 srcWidth, u32 srcHeight, const texture_mipgen_desc& desc, bool reduceLevel1, u8* dstLevel0, u8* dstLevel1, texture_mipgen_texel* rows, texture_mipgen_texel* dst)
+{
+	if (desc.SRGB)
+		desc.PremultiplyAlpha ? boxQuadRGBA8<true, true>(src, srcWidth, srcHeight, reduceLevel1, dstLevel0, dstLevel1, rows, dst) : boxQuadRGBA8<true, false>(src, srcWidth, srcHeight, reduceLevel1, dstLevel0, dstLevel1, rows, dst);
+	else
+		desc.PremultiplyAlpha ? boxQuadRGBA8<false, true>(src, srcWidth, srcHeight, reduceLevel1, dstLevel0, dstLevel1, rows, dst) : boxQuadRGBA8<false, false>(src, srcWidth, srcHeight, reduceLevel1, dstLevel0, dstLevel1, rows, dst);
+}
+
+// horizontal pass, one float4 texel per SSE register
+static void filterHorizontal(const texture_mipgen_texel* src, u32 srcWidth, u32 height, const texture_mipgen_taps& taps, u32 dstWidth, texture_mipgen_texel* dst)
+{
+	for (u32 y = 0; y < height; ++y)
+	{
+		const texture_mipgen_texel* srcRow = src + (usize)y * srcWidth;
+		texture_mipgen_texel* dstRow = dst + (usize)y * dstWidth;
+		for (u32 x = 0; x < dstWidth; ++x)
+		{
+			__m128 acc = _mm_setzero_ps();
+			for (u32 t = taps.Offsets[x]; t < taps.Offsets[x + 1]; ++t)
+				acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(taps.Weights[t]), _mm_load_ps(srcRow[taps.Indices[t]].V)));
+			_mm_store_ps(dstRow[x].V, acc);
+		}
+	}
+}
+
+// vertical pass, weights are constant along a row so whole rows are accumulated (8 floats per iteration with AVX)
+static void filterVertical(const texture_mipgen_texel* src, u32 width, const texture_mipgen_taps& taps, u32 dstHeight, texture_mipgen_texel* dst)
+{
+	const usize rowFloats = (usize)width * 4;
+	for (u32 y = 0; y < dstHeight; ++y)
+	{
+		float* dstRow = reinterpret_cast<float*>(dst + (usize)y * width);
+		usize x = 0;
+#if defined(__AVX__)
+		for (; x + 8 <= rowFloats; x += 8)
+		{
+			__m256 acc = _mm256_setzero_ps();
+			for (u32 t = taps.Offsets[y]; t < taps.Offsets[y + 1]; ++t)
+			{
+				const float* srcRow = reinterpret_cast<const float*>(src + (usize)taps.Indices[t] * width);
+				acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(taps.Weights[t]), _mm256_loadu_ps(srcRow + x)));
+			}
+			_mm256_storeu_ps(dstRow + x, acc);
+		}
+#endif
+		for (; x < rowFloats; x += 4)
+		{
+			__m128 acc = _mm_setzero_ps();
+			for (u32 t = taps.Offsets[y]; t < taps.Offsets[y + 1]; ++t)
+			{
+				const float* srcRow = reinterpret_cast<const float*>(src + (usize)taps.Indices[t] * width);
+				acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(taps.Weights[t]), _mm_loadu_ps(srcRow + x)));
+			}
+			_mm_storeu_ps(dstRow + x, acc);
+		}
+	}
+}
+#pragma endregion
+
+#pragma region texture_mipgen
+u32 texture_mipgen::GetMipLevelQuantity(u32 width, u32 height)
+{
+	u32 greatest = width > height ? width : height;
+	u32 numLevels = 0;
+	while (greatest > 0)
+	{
+		greatest >>= 1;
+		numLevels++;
+	}
+	return numLevels;
+}
+
+void texture_mipgen::GetMipDimensions(u32 width, u32 height, u32 mipLevel, u32& outWidth, u32& outHeight)
+{
+	outWidth = width >> mipLevel;
+	outHeight = height >> mipLevel;
+	outWidth = outWidth == 0 ? 1 : outWidth;
+	outHeight = outHeight == 0 ? 1 : outHeight;
+}
+
+usize texture_mipgen::GetMipChainSizeInBytes(u32 width, u32 height, u32 mipLevelStart, u32 mipCount)
+{
+	usize numBytes = 0;
+	for (u32 i = mipLevelStart; i < mipLevelStart + mipCount; ++i)
+	{
+		u32 w, h;
+		GetMipDimensions(width, height, i, w, h);
+		numBytes += (usize)w * h * 4;
+	}
+	return numBytes;
+}
+
+void texture_mipgen::GenerateRGBA8(const u8* srcLevel0, u32 width, u32 height, u32 mipCount, u8* dstMipChain, const texture_mipgen_desc& desc)
+{
+	stl_assert(srcLevel0 != nullptr && dstMipChain != nullptr);
+	stl_assert(mipCount > 0 && mipCount <= GetMipLevelQuantity(width, height));
+
+	const usize numTexelsLevel0 = (usize)width * height;
+
+	// level 0 is left untouched unless alpha gets premultiplied, the 2:1 box reduction copies it on the way
+	const bool quadLevel0 = mipCount > 1 && isBoxQuad(desc, width, height);
+	if (!desc.PremultiplyAlpha && !quadLevel0)
+		memcpy(dstMipChain, srcLevel0, numTexelsLevel0 * 4);
+
+	if (mipCount == 1 && !desc.PremultiplyAlpha)
+		return;
+
+	// ping pong between two linear float4 levels, allocated once for the largest level that gets decoded or generated into them
+	// NOTE: the 2:1 box reduction of level 0 decodes its quads on the fly, level 0 is never decoded as a whole
+	// NOTE: the float levels come from the frame allocator of the calling thread, no heap traffic once it has grown
+	frame_allocator_scope transientScope;
+	stl_frame_vector<texture_mipgen_texel> levelCurrent, levelNext, intermediate;
+	texture_mipgen_taps tapsX, tapsY;
+
+	u8* dst = dstMipChain + numTexelsLevel0 * 4;
+	u32 srcWidth = width, srcHeight = height;
+	u32 mip = 1;
+	if (quadLevel0)
+	{
+		u32 level1Width, level1Height;
+		GetMipDimensions(width, height, 1, level1Width, level1Height);
+		const bool reduceLevel1 = mipCount > 2 && isBoxQuad(desc, level1Width, level1Height);
+		const usize numTexelsLevel1 = (usize)level1Width * level1Height;
+		const usize numTexelsLevel2 = numTexelsLevel1 / 4;
+
+		// level 0 into level 1 and straight on into level 2 when possible, the first float level is the last one generated here
+		stl_frame_vector<texture_mipgen_texel> rows(reduceLevel1 ? (usize)level1Width * 2 : 0);
+		levelCurrent.resize(reduceLevel1 ? numTexelsLevel2 : numTexelsLevel1);
+		boxQuadRGBA8(srcLevel0, width, height, desc, reduceLevel1, dstMipChain, dst, rows.empty() ? nullptr : &rows[0], &levelCurrent[0]);
+		dst += numTexelsLevel1 * 4;
+		srcWidth = level1Width;
+		srcHeight = level1Height;
+		mip = 2;
+
+		if (reduceLevel1)
+		{
+			encodeRGBA8(&levelCurrent[0], numTexelsLevel2, desc, dst);
+			dst += numTexelsLevel2 * 4;
+			srcWidth /= 2;
+			srcHeight /= 2;
+			mip = 3;
+		}
+		levelNext.resize(mip < mipCount ? GetMipChainSizeInBytes(width, height, mip, 1) / 4 : 0);
+	}
+	else
+	{
+		levelCurrent.resize(numTexelsLevel0);
+		levelNext.resize(GetMipChainSizeInBytes(width, height, 1, 1) / 4);
+		decodeRGBA8(srcLevel0, numTexelsLevel0, desc, &levelCurrent[0]);
+		if (desc.PremultiplyAlpha)
+			encodeRGBA8(&levelCurrent[0], numTexelsLevel0, desc, dstMipChain);
+	}
+
+	for (; mip < mipCount; ++mip)
+	{
+		u32 dstWidth, dstHeight;
+		GetMipDimensions(width, height, mip, dstWidth, dstHeight);
+
+		if (isBoxQuad(desc, srcWidth, srcHeight))
+		{
+			boxQuad(&levelCurrent[0], srcWidth, srcHeight, &levelNext[0]);
+		}
+		else
+		{
+			// filter each axis separately, skipping axes that have already reached 1 texel
+			const texture_mipgen_texel* horizontal = &levelCurrent[0];
+			if (dstWidth != srcWidth)
+			{
+				if (intermediate.size() < (usize)dstWidth * srcHeight)
+					intermediate.resize((usize)dstWidth * srcHeight);
+				buildTaps(srcWidth, dstWidth, desc, tapsX);
+				filterHorizontal(&levelCurrent[0], srcWidth, srcHeight, tapsX, dstWidth, &intermediate[0]);
+				horizontal = &intermediate[0];
+			}
+
+			if (dstHeight != srcHeight)
+			{
+				buildTaps(srcHeight, dstHeight, desc, tapsY);
+				filterVertical(horizontal, dstWidth, tapsY, dstHeight, &levelNext[0]);
+			}
+			else
+			{
+				memcpy(&levelNext[0], horizontal, (usize)dstWidth * dstHeight * sizeof(texture_mipgen_texel));
+			}
+		}
+
+		const usize numTexels = (usize)dstWidth * dstHeight;
+		encodeRGBA8(&levelNext[0], numTexels, desc, dst);
+		dst += numTexels * 4;
+
+		levelCurrent.swap(levelNext);
+		srcWidth = dstWidth;
+		srcHeight = dstHeight;
+	}
+}
+#pragma endregion
+
+}; // end namespace cfc
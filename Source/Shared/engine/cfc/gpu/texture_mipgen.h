@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cfc/base.h>
+
+namespace cfc
+{
+	enum class texture_mipgen_filter_type
+	{
+		Box,		// area weighted box, exact for non power of two reductions
+		Kaiser,		// kaiser windowed sinc (width 3, alpha 4)
+		Lanczos,	// lanczos 3
+	};
+
+	enum class texture_mipgen_address_mode
+	{
+		Clamp,
+		Wrap,
+	};
+
+	struct texture_mipgen_desc
+	{
+		texture_mipgen_filter_type Filter = texture_mipgen_filter_type::Box;
+		texture_mipgen_address_mode AddressMode = texture_mipgen_address_mode::Wrap;
+		bool SRGB = true;				// source and destination rgb channels are sRGB encoded, filtering happens in linear space
+		bool PremultiplyAlpha = false;	// premultiply rgb by alpha (in linear space) while decoding level 0
+	};
+
+	// generates a tightly packed RGBA8 mip chain (level 0 .. n), matching the subresource layout expected by gfx_resource_stream::AddTexture
+	class CFC_API texture_mipgen
+	{
+	public:
+		static u32 GetMipLevelQuantity(u32 width, u32 height);
+		static void GetMipDimensions(u32 width, u32 height, u32 mipLevel, u32& outWidth, u32& outHeight);
+		static usize GetMipChainSizeInBytes(u32 width, u32 height, u32 mipLevelStart, u32 mipCount);
+
+		// NOTE: dstMipChain must be able to hold GetMipChainSizeInBytes(width, height, 0, mipCount) bytes, level 0 is written as well
+		static void GenerateRGBA8(const u8* srcLevel0, u32 width, u32 height, u32 mipCount, u8* dstMipChain, const texture_mipgen_desc& desc = texture_mipgen_desc());
+	};
+}; // end namespace cfc
@@ -63,9 +63,9 @@ namespace math {
 
 		static vector3f Zero;
 
-		vector3f::vector3f()														{ V[0] = V[1] = V[2] = 0.0f; }
-		vector3f::vector3f(float X, float Y=0.0f, float Z=0.0f) : x(X), y(Y), z(Z)	{ }
-		vector3f::vector3f(const float* XYZ) : x(XYZ[0]), y(XYZ[1]), z(XYZ[2])		{ }
+		vector3f()														{ V[0] = V[1] = V[2] = 0.0f; }
+		vector3f(float X, float Y=0.0f, float Z=0.0f) : x(X), y(Y), z(Z)	{ }
+		vector3f(const float* XYZ) : x(XYZ[0]), y(XYZ[1]), z(XYZ[2])		{ }
 		vector3f(bool DontInitialize) { }
 
 		operator const float*() const { return V; }
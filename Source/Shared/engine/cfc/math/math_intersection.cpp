@@ -1,6 +1,8 @@
 #include <cfc/base.h>
 #include <cfc/math/math_intersection.h>
 
+#include <cfc/stl/stl_algorithm.hpp>
+
 bool cfc::math::intersection::ray::Intersect(aabb& gpu_box, float& fst)
 {
 	fst = 0.0f;
@@ -35,3 +37,97 @@ bool cfc::math::intersection::aabb::Intersect(ray& line, float& depth)
 {
 	return line.Intersect(*this, depth);
 }
+
+template <class F>
+static inline usize intersectAABBs(const cfc::math::intersection::ray& line, const cfc::math::simd::aabb_arrays& boxes, float* depthsOUT, u8* hitsOUT, usize& numHitsInOut, usize i, usize count)
+{
+	using namespace cfc::math;
+
+	const intersection::ray_packet<F> rays = intersection::ray_packet<F>::Set(line);
+	for (; i + F::Width <= count; i += F::Width)
+	{
+		F depth;
+		const simd::vec3xw<F> boxMin = simd::vec3xw<F>::Load(boxes.MinX + i, boxes.MinY + i, boxes.MinZ + i);
+		const simd::vec3xw<F> boxMax = simd::vec3xw<F>::Load(boxes.MaxX + i, boxes.MaxY + i, boxes.MaxZ + i);
+		const u32 hits = simd::MoveMask(intersection::Intersect(rays, boxMin, boxMax, depth));
+		depth.Store(depthsOUT + i);
+
+		for (u32 j = 0; j < F::Width; ++j)
+		{
+			const u8 hit = (hits >> j) & 1;
+			hitsOUT[i + j] = hit;
+			numHitsInOut += hit;
+		}
+	}
+	return i;
+}
+
+usize cfc::math::intersection::IntersectAABBs(const ray& line, const simd::aabb_arrays& boxes, float* depthsOUT, u8* hitsOUT, usize count)
+{
+	usize numHits = 0;
+	const usize i = intersectAABBs<simd::floatxn>(line, boxes, depthsOUT, hitsOUT, numHits, 0, count);
+	intersectAABBs<simd::floatx1>(line, boxes, depthsOUT, hitsOUT, numHits, i, count);
+	return numHits;
+}
+
+void cfc::math::intersection::bvh::Build(const aabb* boxes, u32 count, u32 maxLeafSize)
+{
+	m_boxes.assign(boxes, boxes + count);
+	m_objects.resize(count);
+	for (u32 i = 0; i < count; ++i)
+		m_objects[i] = i;
+
+	m_nodes.clear();
+	if (count == 0)
+		return;
+
+	// NOTE: a binary tree with at least one object per leaf has fewer than 2 * count nodes
+	m_nodes.reserve(2 * count);
+	m_nodes.resize(1);
+	buildNode(0, 0, count, maxLeafSize > 0 ? maxLeafSize : 1);
+}
+
+void cfc::math::intersection::bvh::buildNode(u32 nodeIndex, u32 first, u32 count, u32 maxLeafSize)
+{
+	// bounds of the boxes and of their centers
+	aabb bounds = m_boxes[m_objects[first]];
+	vector3f centerMin = (bounds.min + bounds.max) * 0.5f;
+	vector3f centerMax = centerMin;
+	for (u32 i = first + 1; i < first + count; ++i)
+	{
+		const aabb& box = m_boxes[m_objects[i]];
+		const vector3f center = (box.min + box.max) * 0.5f;
+		for (u32 j = 0; j < 3; ++j)
+		{
+			bounds.min.V[j] = box.min.V[j] < bounds.min.V[j] ? box.min.V[j] : bounds.min.V[j];
+			bounds.max.V[j] = box.max.V[j] > bounds.max.V[j] ? box.max.V[j] : bounds.max.V[j];
+			centerMin.V[j] = center.V[j] < centerMin.V[j] ? center.V[j] : centerMin.V[j];
+			centerMax.V[j] = center.V[j] > centerMax.V[j] ? center.V[j] : centerMax.V[j];
+		}
+	}
+
+	m_nodes[nodeIndex].Bounds = bounds;
+	if (count <= maxLeafSize)
+	{
+		m_nodes[nodeIndex].First = first;
+		m_nodes[nodeIndex].Count = count;
+		return;
+	}
+
+	// the median along the axis the centers spread the most over, identical centers still split in halves
+	const vector3f extent = centerMax - centerMin;
+	const u32 axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+	const u32 half = count / 2;
+	std::nth_element(m_objects.begin() + first, m_objects.begin() + first + half, m_objects.begin() + first + count, [this, axis](u32 a, u32 b)
+	{
+		return m_boxes[a].min.V[axis] + m_boxes[a].max.V[axis] < m_boxes[b].min.V[axis] + m_boxes[b].max.V[axis];
+	});
+
+	const u32 children = (u32)m_nodes.size();
+	m_nodes.resize(children + 2);
+	m_nodes[nodeIndex].First = children;
+	m_nodes[nodeIndex].Count = 0;
+
+	buildNode(children, first, half, maxLeafSize);
+	buildNode(children + 1, first + half, count - half, maxLeafSize);
+}
@@ -1,6 +1,12 @@
 #pragma once
 
 #include "math.h"
+#include "math_simd.h"
+
+#include <cfc/stl/stl_vector.hpp>
+
+// bvh traversal stack, enough for the depth of a median split tree of any object count that fits in u32
+#define CFC_BVH_STACK_SIZE 64
 
 namespace cfc {
 namespace math {
@@ -9,10 +15,11 @@ namespace intersection {
 	struct point;
 	struct ray;
 	struct aabb;
+	struct triangle;
 
 	struct CFC_API point : math::vector3f
 	{};
-			
+
 	struct CFC_API ray
 	{
 		point start, end;
@@ -25,6 +32,209 @@ namespace intersection {
 		bool Intersect(ray& line, float& depth);
 	};
 
+	struct CFC_API triangle
+	{
+		point a, b, c;
+	};
+
+#pragma region Ray Packets
+	// A ray per lane, tested together against the same box or triangle. Depths are fractions of start -> end like
+	// ray::Intersect, hits beyond TMax are ignored, the closest hit queries lower TMax as they go.
+	template <class F>
+	struct ray_packet
+	{
+		simd::vec3xw<F> Start;
+		simd::vec3xw<F> Direction;
+		simd::vec3xw<F> InvDirection;
+		F TMax;
+
+		// F::Width rays
+		static inline ray_packet Load(const ray* rays)
+		{
+			float values[9][F::Width];
+			for (u32 i = 0; i < F::Width; ++i)
+			{
+				for (u32 j = 0; j < 3; ++j)
+				{
+					const float direction = rays[i].end.V[j] - rays[i].start.V[j];
+					values[j][i] = rays[i].start.V[j];
+					values[3 + j][i] = direction;
+					// NOTE: axis aligned rays get a huge instead of an infinite inverse, inf * 0 on a slab plane is a NaN
+					values[6 + j][i] = 1.0f / (fabsf(direction) > 1e-20f ? direction : (direction < 0.0f ? -1e-20f : 1e-20f));
+				}
+			}
+
+			ray_packet r;
+			r.Start = simd::vec3xw<F>::Load(values[0], values[1], values[2]);
+			r.Direction = simd::vec3xw<F>::Load(values[3], values[4], values[5]);
+			r.InvDirection = simd::vec3xw<F>::Load(values[6], values[7], values[8]);
+			r.TMax = F::Set(1.0f);
+			return r;
+		}
+
+		// the same ray in every lane
+		static inline ray_packet Set(const ray& line)
+		{
+			ray lines[F::Width];
+			for (u32 i = 0; i < F::Width; ++i)
+				lines[i] = line;
+			return Load(lines);
+		}
+	};
+
+	typedef ray_packet<simd::floatx4> ray_packet4;
+	typedef ray_packet<simd::floatx8> ray_packet8;
+
+	// slab test against a box per lane, returns the mask of lanes that hit with the entry depth (0 when starting inside)
+	template <class F>
+	inline F Intersect(const ray_packet<F>& rays, const simd::vec3xw<F>& boxMin, const simd::vec3xw<F>& boxMax, F& depthOUT)
+	{
+		const F tx0 = (boxMin.x - rays.Start.x) * rays.InvDirection.x, tx1 = (boxMax.x - rays.Start.x) * rays.InvDirection.x;
+		const F ty0 = (boxMin.y - rays.Start.y) * rays.InvDirection.y, ty1 = (boxMax.y - rays.Start.y) * rays.InvDirection.y;
+		const F tz0 = (boxMin.z - rays.Start.z) * rays.InvDirection.z, tz1 = (boxMax.z - rays.Start.z) * rays.InvDirection.z;
+
+		const F tNear = simd::Max(simd::Max(simd::Min(tx0, tx1), simd::Min(ty0, ty1)), simd::Max(simd::Min(tz0, tz1), F::Set(0.0f)));
+		const F tFar = simd::Min(simd::Min(simd::Max(tx0, tx1), simd::Max(ty0, ty1)), simd::Min(simd::Max(tz0, tz1), rays.TMax));
+		depthOUT = tNear;
+		return simd::CmpLe(tNear, tFar);
+	}
+
+	// the same box for every lane
+	template <class F>
+	inline F Intersect(const ray_packet<F>& rays, const aabb& box, F& depthOUT)
+	{
+		return Intersect(rays, simd::vec3xw<F>::Set(box.min), simd::vec3xw<F>::Set(box.max), depthOUT);
+	}
+
+	// Moller-Trumbore against a triangle per lane, both sides of the triangle hit
+	template <class F>
+	inline F Intersect(const ray_packet<F>& rays, const simd::vec3xw<F>& a, const simd::vec3xw<F>& b, const simd::vec3xw<F>& c, F& depthOUT)
+	{
+		const simd::vec3xw<F> edge1 = b - a;
+		const simd::vec3xw<F> edge2 = c - a;
+
+		const simd::vec3xw<F> p = rays.Direction.Cross(edge2);
+		const F det = edge1.Dot(p);
+		const F invDet = F::Set(1.0f) / det;
+
+		const simd::vec3xw<F> s = rays.Start - a;
+		const F u = s.Dot(p) * invDet;
+		const simd::vec3xw<F> q = s.Cross(edge1);
+		const F v = rays.Direction.Dot(q) * invDet;
+		const F t = edge2.Dot(q) * invDet;
+
+		const F zero = F::Set(0.0f);
+		F hit = simd::CmpLt(F::Set(1e-12f), simd::Abs(det));
+		hit = simd::And(hit, simd::And(simd::CmpLe(zero, u), simd::CmpLe(zero, v)));
+		hit = simd::And(hit, simd::CmpLe(u + v, F::Set(1.0f)));
+		hit = simd::And(hit, simd::And(simd::CmpLe(zero, t), simd::CmpLe(t, rays.TMax)));
+		depthOUT = t;
+		return hit;
+	}
+
+	// the same triangle for every lane
+	template <class F>
+	inline F Intersect(const ray_packet<F>& rays, const triangle& tri, F& depthOUT)
+	{
+		return Intersect(rays, simd::vec3xw<F>::Set(tri.a), simd::vec3xw<F>::Set(tri.b), simd::vec3xw<F>::Set(tri.c), depthOUT);
+	}
+
+	// one ray against count boxes, a lane per box. hitsOUT is 1 for boxes that are hit with their entry depth in depthsOUT,
+	// returns the number of boxes hit
+	CFC_API usize IntersectAABBs(const ray& line, const simd::aabb_arrays& boxes, float* depthsOUT, u8* hitsOUT, usize count);
+#pragma endregion
+
+#pragma region Bounding Volume Hierarchy
+	struct bvh_node
+	{
+		aabb Bounds;
+		u32 First;		// first child of an inner node (the second is First + 1) or the first object of a leaf
+		u32 Count;		// objects in a leaf, 0 for inner nodes
+	};
+
+	// Object level hierarchy over boxes (meshes, instances), split at the median of the largest centroid axis.
+	class CFC_API bvh
+	{
+	public:
+		bvh() {}
+
+		void Build(const aabb* boxes, u32 count, u32 maxLeafSize = 4);
+
+		// calls leafTest(object, rays, activeMask) for every object in a leaf that any lane of the packet reaches,
+		// leafTest can lower rays.TMax to skip what is further away
+		template <class F, class T> void Traverse(ray_packet<F>& rays, const T& leafTest) const;
+
+		// the closest object box per lane, objectsOUT[lane] is the object (invalid_index on a miss), rays.TMax its depth
+		template <class F> void IntersectClosest(ray_packet<F>& rays, usize* objectsOUT) const;
+
+		const stl_vector<bvh_node>& GetNodes() const { return m_nodes; }
+
+	protected:
+		bvh(const bvh&) {}
+		bvh& operator = (const bvh&) { return *this; }
+
+		void buildNode(u32 nodeIndex, u32 first, u32 count, u32 maxLeafSize);
+
+		stl_vector<bvh_node> m_nodes;
+		stl_vector<u32> m_objects; // objects in leaf order
+		stl_vector<aabb> m_boxes; // by object
+	};
+
+	template <class F, class T>
+	void bvh::Traverse(ray_packet<F>& rays, const T& leafTest) const
+	{
+		if (m_nodes.empty())
+			return;
+
+		u32 stack[CFC_BVH_STACK_SIZE];
+		u32 stackSize = 0;
+		stack[stackSize++] = 0;
+		while (stackSize > 0)
+		{
+			const bvh_node& node = m_nodes[stack[--stackSize]];
+
+			F depth;
+			const F active = Intersect(rays, node.Bounds, depth);
+			if (simd::MoveMask(active) == 0)
+				continue;
+
+			if (node.Count > 0)
+			{
+				for (u32 i = 0; i < node.Count; ++i)
+					leafTest(m_objects[node.First + i], rays, active);
+				continue;
+			}
+
+			stl_assert(stackSize + 2 <= CFC_BVH_STACK_SIZE);
+			stack[stackSize++] = node.First + 1;
+			stack[stackSize++] = node.First;
+		}
+	}
+
+	template <class F>
+	void bvh::IntersectClosest(ray_packet<F>& rays, usize* objectsOUT) const
+	{
+		for (u32 i = 0; i < F::Width; ++i)
+			objectsOUT[i] = cfc::invalid_index;
+
+		Traverse(rays, [this, objectsOUT](u32 object, ray_packet<F>& packet, const F& active)
+		{
+			F depth;
+			const F hit = simd::And(active, Intersect(packet, m_boxes[object], depth));
+			const u32 hitMask = simd::MoveMask(hit);
+			if (hitMask == 0)
+				return;
+
+			packet.TMax = simd::Select(hit, depth, packet.TMax);
+			for (u32 i = 0; i < F::Width; ++i)
+			{
+				if (hitMask & (1u << i))
+					objectsOUT[i] = object;
+			}
+		});
+	}
+#pragma endregion
+
 }; // end namespace intersection
 }; // end namespace math
-}; // end namespace cfc
\ No newline at end of file
+}; // end namespace cfc
@@ -0,0 +1,278 @@
+#include <cfc/base.h>
+#include <cfc/math/math_simd.h>
+
+namespace cfc
+{
+namespace math
+{
+namespace simd
+{
+
+// every operation runs its main loop on floatxn and the remainder on floatx1, the kernels return where they stopped
+
+#pragma region Kernels
+template <class F>
+static inline usize transformPoints(const mat4& m, const float* x, const float* y, const float* z, float* xOUT, float* yOUT, float* zOUT, usize i, usize count)
+{
+	for (; i + F::Width <= count; i += F::Width)
+		m.TransformPoint(vec3xw<F>::Load(x + i, y + i, z + i)).Store(xOUT + i, yOUT + i, zOUT + i);
+	return i;
+}
+
+template <class F>
+static inline usize transformVectors(const mat4& m, const float* x, const float* y, const float* z, float* xOUT, float* yOUT, float* zOUT, usize i, usize count)
+{
+	for (; i + F::Width <= count; i += F::Width)
+		m.TransformVector(vec3xw<F>::Load(x + i, y + i, z + i)).Store(xOUT + i, yOUT + i, zOUT + i);
+	return i;
+}
+
+template <class F>
+static inline usize projectPoints(const mat4& m, const float* x, const float* y, const float* z, float* xOUT, float* yOUT, float* zOUT, float* wOUT, usize i, usize count)
+{
+	for (; i + F::Width <= count; i += F::Width)
+	{
+		F w;
+		const vec3xw<F> clip = m.TransformPoint(vec3xw<F>::Load(x + i, y + i, z + i), w);
+		(clip * (F::Set(1.0f) / w)).Store(xOUT + i, yOUT + i, zOUT + i);
+		if (wOUT != nullptr)
+			w.Store(wOUT + i);
+	}
+	return i;
+}
+
+template <class F>
+static inline usize dot(const float* ax, const float* ay, const float* az, const float* bx, const float* by, const float* bz, float* OUT, usize i, usize count)
+{
+	for (; i + F::Width <= count; i += F::Width)
+		vec3xw<F>::Load(ax + i, ay + i, az + i).Dot(vec3xw<F>::Load(bx + i, by + i, bz + i)).Store(OUT + i);
+	return i;
+}
+
+template <class F>
+static inline usize cross(const float* ax, const float* ay, const float* az, const float* bx, const float* by, const float* bz, float* xOUT, float* yOUT, float* zOUT, usize i, usize count)
+{
+	for (; i + F::Width <= count; i += F::Width)
+		vec3xw<F>::Load(ax + i, ay + i, az + i).Cross(vec3xw<F>::Load(bx + i, by + i, bz + i)).Store(xOUT + i, yOUT + i, zOUT + i);
+	return i;
+}
+
+template <class F>
+static inline usize planeDistances(const planef& plane, const float* x, const float* y, const float* z, float* OUT, usize i, usize count)
+{
+	const F a = F::Set(plane.a), b = F::Set(plane.b), c = F::Set(plane.c), d = F::Set(plane.d);
+	for (; i + F::Width <= count; i += F::Width)
+		MulAdd(F::Load(z + i), c, MulAdd(F::Load(y + i), b, MulAdd(F::Load(x + i), a, d))).Store(OUT + i);
+	return i;
+}
+
+template <class F>
+static inline usize transformAABBs(const mat4& m, const aabb_arrays& bounds, const aabb_arrays& boundsOUT, usize i, usize count)
+{
+	const float* const mins[3] = { bounds.MinX, bounds.MinY, bounds.MinZ };
+	const float* const maxs[3] = { bounds.MaxX, bounds.MaxY, bounds.MaxZ };
+	float* const minsOUT[3] = { boundsOUT.MinX, boundsOUT.MinY, boundsOUT.MinZ };
+	float* const maxsOUT[3] = { boundsOUT.MaxX, boundsOUT.MaxY, boundsOUT.MaxZ };
+
+	for (; i + F::Width <= count; i += F::Width)
+	{
+		F boxMin[3], boxMax[3];
+		for (u32 j = 0; j < 3; ++j)
+		{
+			boxMin[j] = F::Load(mins[j] + i);
+			boxMax[j] = F::Load(maxs[j] + i);
+		}
+
+		// per output axis, the translation plus the smaller / larger product of every input axis
+		F resultMin[3], resultMax[3];
+		for (u32 r = 0; r < 3; ++r)
+		{
+			resultMin[r] = resultMax[r] = F::Set(m.M[12 + r]);
+			for (u32 j = 0; j < 3; ++j)
+			{
+				const F element = F::Set(m.M[j * 4 + r]);
+				const F a = element * boxMin[j];
+				const F b = element * boxMax[j];
+				resultMin[r] = resultMin[r] + Min(a, b);
+				resultMax[r] = resultMax[r] + Max(a, b);
+			}
+		}
+
+		// NOTE: all components are loaded before the first store, the output may be the input
+		for (u32 r = 0; r < 3; ++r)
+		{
+			resultMin[r].Store(minsOUT[r] + i);
+			resultMax[r].Store(maxsOUT[r] + i);
+		}
+	}
+	return i;
+}
+
+template <class F>
+static inline usize cullAABBs(const planef* planes, u32 numPlanes, const aabb_arrays& bounds, u8* insideOUT, usize& numInsideInOut, usize i, usize count)
+{
+	for (; i + F::Width <= count; i += F::Width)
+	{
+		u32 outside = 0;
+		for (u32 p = 0; p < numPlanes && outside != (1u << F::Width) - 1; ++p)
+		{
+			// the corner furthest along the normal, picked per plane as the sign is the same for every box
+			const planef& plane = planes[p];
+			const F x = F::Load((plane.a >= 0.0f ? bounds.MaxX : bounds.MinX) + i);
+			const F y = F::Load((plane.b >= 0.0f ? bounds.MaxY : bounds.MinY) + i);
+			const F z = F::Load((plane.c >= 0.0f ? bounds.MaxZ : bounds.MinZ) + i);
+			const F distance = MulAdd(z, F::Set(plane.c), MulAdd(y, F::Set(plane.b), MulAdd(x, F::Set(plane.a), F::Set(plane.d))));
+			outside |= MoveMask(CmpLt(distance, F::Set(0.0f)));
+		}
+
+		for (u32 j = 0; j < F::Width; ++j)
+		{
+			const u8 inside = (outside >> j) & 1 ? 0 : 1;
+			insideOUT[i + j] = inside;
+			numInsideInOut += inside;
+		}
+	}
+	return i;
+}
+
+template <class F>
+static inline usize inverseAffines(const float* matrices, float* matricesOUT, usize i, usize count)
+{
+	for (; i + F::Width <= count; i += F::Width)
+	{
+		// a lane per matrix
+		vec3xw<F> columns[4];
+		for (u32 j = 0; j < 4; ++j)
+		{
+			const float* m = matrices + i * 16 + j * 4;
+			columns[j].x = LoadStrided<F>(m, 16);
+			columns[j].y = LoadStrided<F>(m + 1, 16);
+			columns[j].z = LoadStrided<F>(m + 2, 16);
+		}
+
+		// the rows of the inverse 3x3 are the cross products of the other two columns over the determinant
+		vec3xw<F> rows[3];
+		rows[0] = columns[1].Cross(columns[2]);
+		rows[1] = columns[2].Cross(columns[0]);
+		rows[2] = columns[0].Cross(columns[1]);
+		const F invDet = F::Set(1.0f) / columns[0].Dot(rows[0]);
+		for (u32 j = 0; j < 3; ++j)
+			rows[j] = rows[j] * invDet;
+
+		const F zero = F::Set(0.0f);
+		const F one = F::Set(1.0f);
+		float* m = matricesOUT + i * 16;
+		for (u32 j = 0; j < 3; ++j)
+		{
+			StoreStrided(rows[j].x, m + j, 16);
+			StoreStrided(rows[j].y, m + 4 + j, 16);
+			StoreStrided(rows[j].z, m + 8 + j, 16);
+			StoreStrided(zero, m + j * 4 + 3, 16);
+		}
+
+		// translation, the inverse rotation of the negated translation
+		StoreStrided(zero - rows[0].Dot(columns[3]), m + 12, 16);
+		StoreStrided(zero - rows[1].Dot(columns[3]), m + 13, 16);
+		StoreStrided(zero - rows[2].Dot(columns[3]), m + 14, 16);
+		StoreStrided(one, m + 15, 16);
+	}
+	return i;
+}
+#pragma endregion
+
+#pragma region Array Operations
+void TransformPoints(const mat4& m, const float* x, const float* y, const float* z, float* xOUT, float* yOUT, float* zOUT, usize count)
+{
+	const usize i = transformPoints<floatxn>(m, x, y, z, xOUT, yOUT, zOUT, 0, count);
+	transformPoints<floatx1>(m, x, y, z, xOUT, yOUT, zOUT, i, count);
+}
+
+void TransformVectors(const mat4& m, const float* x, const float* y, const float* z, float* xOUT, float* yOUT, float* zOUT, usize count)
+{
+	const usize i = transformVectors<floatxn>(m, x, y, z, xOUT, yOUT, zOUT, 0, count);
+	transformVectors<floatx1>(m, x, y, z, xOUT, yOUT, zOUT, i, count);
+}
+
+void ProjectPoints(const mat4& viewProjection, const float* x, const float* y, const float* z, float* xOUT, float* yOUT, float* zOUT, float* wOUT, usize count)
+{
+	const usize i = projectPoints<floatxn>(viewProjection, x, y, z, xOUT, yOUT, zOUT, wOUT, 0, count);
+	projectPoints<floatx1>(viewProjection, x, y, z, xOUT, yOUT, zOUT, wOUT, i, count);
+}
+
+void Dot(const float* ax, const float* ay, const float* az, const float* bx, const float* by, const float* bz, float* OUT, usize count)
+{
+	const usize i = dot<floatxn>(ax, ay, az, bx, by, bz, OUT, 0, count);
+	dot<floatx1>(ax, ay, az, bx, by, bz, OUT, i, count);
+}
+
+void Cross(const float* ax, const float* ay, const float* az, const float* bx, const float* by, const float* bz, float* xOUT, float* yOUT, float* zOUT, usize count)
+{
+	const usize i = cross<floatxn>(ax, ay, az, bx, by, bz, xOUT, yOUT, zOUT, 0, count);
+	cross<floatx1>(ax, ay, az, bx, by, bz, xOUT, yOUT, zOUT, i, count);
+}
+
+void PlaneDistances(const planef& plane, const float* x, const float* y, const float* z, float* OUT, usize count)
+{
+	const usize i = planeDistances<floatxn>(plane, x, y, z, OUT, 0, count);
+	planeDistances<floatx1>(plane, x, y, z, OUT, i, count);
+}
+
+void TransformAABBs(const mat4& m, const aabb_arrays& bounds, const aabb_arrays& boundsOUT, usize count)
+{
+	const usize i = transformAABBs<floatxn>(m, bounds, boundsOUT, 0, count);
+	transformAABBs<floatx1>(m, bounds, boundsOUT, i, count);
+}
+
+usize CullAABBs(const planef* planes, u32 numPlanes, const aabb_arrays& bounds, u8* insideOUT, usize count)
+{
+	usize numInside = 0;
+	const usize i = cullAABBs<floatxn>(planes, numPlanes, bounds, insideOUT, numInside, 0, count);
+	cullAABBs<floatx1>(planes, numPlanes, bounds, insideOUT, numInside, i, count);
+	return numInside;
+}
+#pragma endregion
+
+#pragma region Inverses
+mat4 InverseAffine(const mat4& m)
+{
+	mat4 r;
+	inverseAffines<floatx1>(m.M, r.M, 0, 1);
+	return r;
+}
+
+mat4 InversePerspective(const mat4& projection)
+{
+	//     a 0 e 0            1/a   0    0   -e/(a s)
+	// P = 0 b f 0   P^-1 =    0   1/b   0   -f/(b s)
+	//     0 0 c d             0    0    0     1/s
+	//     0 0 s 0             0    0   1/d  -c/(s d)
+	const float* p = projection.M;
+	const float a = p[0], b = p[5], e = p[8], f = p[9], c = p[10], s = p[11], d = p[14];
+
+	mat4 r;
+	memset(r.M, 0, sizeof(r.M));
+	r.M[0] = 1.0f / a;
+	r.M[5] = 1.0f / b;
+	r.M[11] = 1.0f / d;
+	r.M[12] = -e / (a * s);
+	r.M[13] = -f / (b * s);
+	r.M[14] = 1.0f / s;
+	r.M[15] = -c / (s * d);
+	return r;
+}
+
+mat4 InverseViewProjection(const mat4& view, const mat4& projection)
+{
+	return InverseAffine(view) * InversePerspective(projection);
+}
+
+void InverseAffines(const float* matrices, float* matricesOUT, usize count)
+{
+	const usize i = inverseAffines<floatxn>(matrices, matricesOUT, 0, count);
+	inverseAffines<floatx1>(matrices, matricesOUT, i, count);
+}
+#pragma endregion
+
+} // end namespace simd
+} // end namespace math
+} // end namespace cfc
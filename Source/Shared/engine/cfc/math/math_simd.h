@@ -0,0 +1,335 @@
+#pragma once
+
+#include "math.h"
+
+// backend, the widest instruction set the compiler targets (/arch:AVX2 or -mavx2, x64 always has SSE2, arm64 has NEON),
+// other targets use the scalar lanes
+#if defined(__AVX2__)
+#	define CFC_SIMD_AVX2 1
+#	define CFC_SIMD_SSE 1
+#	include <immintrin.h>
+#	if defined(__FMA__) || defined(_MSC_VER)
+#		define CFC_SIMD_FMA 1
+#	endif
+#elif defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#	define CFC_SIMD_SSE 1
+#	include <emmintrin.h>
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+#	define CFC_SIMD_NEON 1
+#	include <arm_neon.h>
+#endif
+
+namespace cfc {
+namespace math {
+namespace simd {
+
+	// Structure of arrays math, a lane per element. floatx4 / floatx8 are a register of 4 or 8 floats (two floatx4 without
+	// AVX2), floatx1 is the scalar lane used for the remainder of arrays so kernels are written once as a template.
+	// Comparisons return a mask (all bits set in lanes where they hold), see Select and MoveMask.
+
+#pragma region floatx1
+	struct floatx1
+	{
+		static const u32 Width = 1;
+		float v;
+
+		static inline floatx1 Load(const float* p)						{ floatx1 r; r.v = *p; return r; }
+		static inline floatx1 Set(float s)								{ floatx1 r; r.v = s; return r; }
+		inline void Store(float* p) const								{ *p = v; }
+	};
+
+	static inline floatx1 operator + (floatx1 a, floatx1 b)				{ return floatx1::Set(a.v + b.v); }
+	static inline floatx1 operator - (floatx1 a, floatx1 b)				{ return floatx1::Set(a.v - b.v); }
+	static inline floatx1 operator * (floatx1 a, floatx1 b)				{ return floatx1::Set(a.v * b.v); }
+	static inline floatx1 operator / (floatx1 a, floatx1 b)				{ return floatx1::Set(a.v / b.v); }
+	static inline floatx1 MulAdd(floatx1 a, floatx1 b, floatx1 c)		{ return floatx1::Set(a.v * b.v + c.v); }
+	static inline floatx1 Min(floatx1 a, floatx1 b)						{ return floatx1::Set(a.v < b.v ? a.v : b.v); }
+	static inline floatx1 Max(floatx1 a, floatx1 b)						{ return floatx1::Set(a.v > b.v ? a.v : b.v); }
+	static inline floatx1 Abs(floatx1 a)								{ return floatx1::Set(fabsf(a.v)); }
+	static inline floatx1 Sqrt(floatx1 a)								{ return floatx1::Set(sqrtf(a.v)); }
+	static inline floatx1 CmpLt(floatx1 a, floatx1 b)					{ u32 m = a.v < b.v ? 0xFFFFFFFFU : 0; floatx1 r; memcpy(&r.v, &m, 4); return r; }
+	static inline floatx1 CmpLe(floatx1 a, floatx1 b)					{ u32 m = a.v <= b.v ? 0xFFFFFFFFU : 0; floatx1 r; memcpy(&r.v, &m, 4); return r; }
+	static inline floatx1 Select(floatx1 mask, floatx1 a, floatx1 b)	{ u32 m; memcpy(&m, &mask.v, 4); return m != 0 ? a : b; }
+	static inline u32 MoveMask(floatx1 mask)							{ u32 m; memcpy(&m, &mask.v, 4); return m >> 31; }
+	static inline floatx1 And(floatx1 a, floatx1 b)						{ u32 ma, mb; memcpy(&ma, &a.v, 4); memcpy(&mb, &b.v, 4); ma &= mb; floatx1 r; memcpy(&r.v, &ma, 4); return r; }
+	static inline floatx1 Or(floatx1 a, floatx1 b)						{ u32 ma, mb; memcpy(&ma, &a.v, 4); memcpy(&mb, &b.v, 4); ma |= mb; floatx1 r; memcpy(&r.v, &ma, 4); return r; }
+#pragma endregion
+
+#pragma region floatx4
+	struct floatx4
+	{
+		static const u32 Width = 4;
+#if defined(CFC_SIMD_SSE)
+		__m128 v;
+		static inline floatx4 Load(const float* p)						{ floatx4 r; r.v = _mm_loadu_ps(p); return r; }
+		static inline floatx4 Set(float s)								{ floatx4 r; r.v = _mm_set1_ps(s); return r; }
+		inline void Store(float* p) const								{ _mm_storeu_ps(p, v); }
+#elif defined(CFC_SIMD_NEON)
+		float32x4_t v;
+		static inline floatx4 Load(const float* p)						{ floatx4 r; r.v = vld1q_f32(p); return r; }
+		static inline floatx4 Set(float s)								{ floatx4 r; r.v = vdupq_n_f32(s); return r; }
+		inline void Store(float* p) const								{ vst1q_f32(p, v); }
+#else
+		floatx1 v[4];
+		static inline floatx4 Load(const float* p)						{ floatx4 r; for (u32 i = 0; i < 4; ++i) r.v[i].v = p[i]; return r; }
+		static inline floatx4 Set(float s)								{ floatx4 r; for (u32 i = 0; i < 4; ++i) r.v[i].v = s; return r; }
+		inline void Store(float* p) const								{ for (u32 i = 0; i < 4; ++i) p[i] = v[i].v; }
+#endif
+	};
+
+#if defined(CFC_SIMD_SSE)
+	static inline floatx4 _x4(__m128 v)									{ floatx4 r; r.v = v; return r; }
+	static inline floatx4 operator + (floatx4 a, floatx4 b)				{ return _x4(_mm_add_ps(a.v, b.v)); }
+	static inline floatx4 operator - (floatx4 a, floatx4 b)				{ return _x4(_mm_sub_ps(a.v, b.v)); }
+	static inline floatx4 operator * (floatx4 a, floatx4 b)				{ return _x4(_mm_mul_ps(a.v, b.v)); }
+	static inline floatx4 operator / (floatx4 a, floatx4 b)				{ return _x4(_mm_div_ps(a.v, b.v)); }
+#	if defined(CFC_SIMD_FMA)
+	static inline floatx4 MulAdd(floatx4 a, floatx4 b, floatx4 c)		{ return _x4(_mm_fmadd_ps(a.v, b.v, c.v)); }
+#	else
+	static inline floatx4 MulAdd(floatx4 a, floatx4 b, floatx4 c)		{ return _x4(_mm_add_ps(_mm_mul_ps(a.v, b.v), c.v)); }
+#	endif
+	static inline floatx4 Min(floatx4 a, floatx4 b)						{ return _x4(_mm_min_ps(a.v, b.v)); }
+	static inline floatx4 Max(floatx4 a, floatx4 b)						{ return _x4(_mm_max_ps(a.v, b.v)); }
+	static inline floatx4 Abs(floatx4 a)								{ return _x4(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)); }
+	static inline floatx4 Sqrt(floatx4 a)								{ return _x4(_mm_sqrt_ps(a.v)); }
+	static inline floatx4 CmpLt(floatx4 a, floatx4 b)					{ return _x4(_mm_cmplt_ps(a.v, b.v)); }
+	static inline floatx4 CmpLe(floatx4 a, floatx4 b)					{ return _x4(_mm_cmple_ps(a.v, b.v)); }
+	static inline floatx4 Select(floatx4 mask, floatx4 a, floatx4 b)	{ return _x4(_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))); }
+	static inline u32 MoveMask(floatx4 mask)							{ return (u32)_mm_movemask_ps(mask.v); }
+	static inline floatx4 And(floatx4 a, floatx4 b)						{ return _x4(_mm_and_ps(a.v, b.v)); }
+	static inline floatx4 Or(floatx4 a, floatx4 b)						{ return _x4(_mm_or_ps(a.v, b.v)); }
+#elif defined(CFC_SIMD_NEON)
+	static inline floatx4 _x4(float32x4_t v)							{ floatx4 r; r.v = v; return r; }
+	static inline floatx4 _x4(uint32x4_t m)								{ floatx4 r; r.v = vreinterpretq_f32_u32(m); return r; }
+	static inline floatx4 operator + (floatx4 a, floatx4 b)				{ return _x4(vaddq_f32(a.v, b.v)); }
+	static inline floatx4 operator - (floatx4 a, floatx4 b)				{ return _x4(vsubq_f32(a.v, b.v)); }
+	static inline floatx4 operator * (floatx4 a, floatx4 b)				{ return _x4(vmulq_f32(a.v, b.v)); }
+	static inline floatx4 operator / (floatx4 a, floatx4 b)				{ return _x4(vdivq_f32(a.v, b.v)); }
+	static inline floatx4 MulAdd(floatx4 a, floatx4 b, floatx4 c)		{ return _x4(vfmaq_f32(c.v, a.v, b.v)); }
+	static inline floatx4 Min(floatx4 a, floatx4 b)						{ return _x4(vminq_f32(a.v, b.v)); }
+	static inline floatx4 Max(floatx4 a, floatx4 b)						{ return _x4(vmaxq_f32(a.v, b.v)); }
+	static inline floatx4 Abs(floatx4 a)								{ return _x4(vabsq_f32(a.v)); }
+	static inline floatx4 Sqrt(floatx4 a)								{ return _x4(vsqrtq_f32(a.v)); }
+	static inline floatx4 CmpLt(floatx4 a, floatx4 b)					{ return _x4(vcltq_f32(a.v, b.v)); }
+	static inline floatx4 CmpLe(floatx4 a, floatx4 b)					{ return _x4(vcleq_f32(a.v, b.v)); }
+	static inline floatx4 Select(floatx4 mask, floatx4 a, floatx4 b)	{ return _x4(vbslq_f32(vreinterpretq_u32_f32(mask.v), a.v, b.v)); }
+	static inline u32 MoveMask(floatx4 mask)
+	{
+		static const int32_t shifts[4] = { 0, 1, 2, 3 };
+		const uint32x4_t bits = vshlq_u32(vshrq_n_u32(vreinterpretq_u32_f32(mask.v), 31), vld1q_s32(shifts));
+		return vaddvq_u32(bits);
+	}
+	static inline floatx4 And(floatx4 a, floatx4 b)						{ return _x4(vandq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(b.v))); }
+	static inline floatx4 Or(floatx4 a, floatx4 b)						{ return _x4(vorrq_u32(vreinterpretq_u32_f32(a.v), vreinterpretq_u32_f32(b.v))); }
+#else
+#	define CFC_SIMD_LANES4(expr) floatx4 r; for (u32 i = 0; i < 4; ++i) r.v[i] = expr; return r
+	static inline floatx4 operator + (floatx4 a, floatx4 b)				{ CFC_SIMD_LANES4(a.v[i] + b.v[i]); }
+	static inline floatx4 operator - (floatx4 a, floatx4 b)				{ CFC_SIMD_LANES4(a.v[i] - b.v[i]); }
+	static inline floatx4 operator * (floatx4 a, floatx4 b)				{ CFC_SIMD_LANES4(a.v[i] * b.v[i]); }
+	static inline floatx4 operator / (floatx4 a, floatx4 b)				{ CFC_SIMD_LANES4(a.v[i] / b.v[i]); }
+	static inline floatx4 MulAdd(floatx4 a, floatx4 b, floatx4 c)		{ CFC_SIMD_LANES4(MulAdd(a.v[i], b.v[i], c.v[i])); }
+	static inline floatx4 Min(floatx4 a, floatx4 b)						{ CFC_SIMD_LANES4(Min(a.v[i], b.v[i])); }
+	static inline floatx4 Max(floatx4 a, floatx4 b)						{ CFC_SIMD_LANES4(Max(a.v[i], b.v[i])); }
+	static inline floatx4 Abs(floatx4 a)								{ CFC_SIMD_LANES4(Abs(a.v[i])); }
+	static inline floatx4 Sqrt(floatx4 a)								{ CFC_SIMD_LANES4(Sqrt(a.v[i])); }
+	static inline floatx4 CmpLt(floatx4 a, floatx4 b)					{ CFC_SIMD_LANES4(CmpLt(a.v[i], b.v[i])); }
+	static inline floatx4 CmpLe(floatx4 a, floatx4 b)					{ CFC_SIMD_LANES4(CmpLe(a.v[i], b.v[i])); }
+	static inline floatx4 Select(floatx4 mask, floatx4 a, floatx4 b)	{ CFC_SIMD_LANES4(Select(mask.v[i], a.v[i], b.v[i])); }
+	static inline u32 MoveMask(floatx4 mask)							{ u32 m = 0; for (u32 i = 0; i < 4; ++i) m |= MoveMask(mask.v[i]) << i; return m; }
+	static inline floatx4 And(floatx4 a, floatx4 b)						{ CFC_SIMD_LANES4(And(a.v[i], b.v[i])); }
+	static inline floatx4 Or(floatx4 a, floatx4 b)						{ CFC_SIMD_LANES4(Or(a.v[i], b.v[i])); }
+#	undef CFC_SIMD_LANES4
+#endif
+#pragma endregion
+
+#pragma region floatx8
+	struct floatx8
+	{
+		static const u32 Width = 8;
+#if defined(CFC_SIMD_AVX2)
+		__m256 v;
+		static inline floatx8 Load(const float* p)						{ floatx8 r; r.v = _mm256_loadu_ps(p); return r; }
+		static inline floatx8 Set(float s)								{ floatx8 r; r.v = _mm256_set1_ps(s); return r; }
+		inline void Store(float* p) const								{ _mm256_storeu_ps(p, v); }
+#else
+		floatx4 lo, hi;
+		static inline floatx8 Load(const float* p)						{ floatx8 r; r.lo = floatx4::Load(p); r.hi = floatx4::Load(p + 4); return r; }
+		static inline floatx8 Set(float s)								{ floatx8 r; r.lo = r.hi = floatx4::Set(s); return r; }
+		inline void Store(float* p) const								{ lo.Store(p); hi.Store(p + 4); }
+#endif
+	};
+
+#if defined(CFC_SIMD_AVX2)
+	static inline floatx8 _x8(__m256 v)									{ floatx8 r; r.v = v; return r; }
+	static inline floatx8 operator + (floatx8 a, floatx8 b)				{ return _x8(_mm256_add_ps(a.v, b.v)); }
+	static inline floatx8 operator - (floatx8 a, floatx8 b)				{ return _x8(_mm256_sub_ps(a.v, b.v)); }
+	static inline floatx8 operator * (floatx8 a, floatx8 b)				{ return _x8(_mm256_mul_ps(a.v, b.v)); }
+	static inline floatx8 operator / (floatx8 a, floatx8 b)				{ return _x8(_mm256_div_ps(a.v, b.v)); }
+#	if defined(CFC_SIMD_FMA)
+	static inline floatx8 MulAdd(floatx8 a, floatx8 b, floatx8 c)		{ return _x8(_mm256_fmadd_ps(a.v, b.v, c.v)); }
+#	else
+	static inline floatx8 MulAdd(floatx8 a, floatx8 b, floatx8 c)		{ return _x8(_mm256_add_ps(_mm256_mul_ps(a.v, b.v), c.v)); }
+#	endif
+	static inline floatx8 Min(floatx8 a, floatx8 b)						{ return _x8(_mm256_min_ps(a.v, b.v)); }
+	static inline floatx8 Max(floatx8 a, floatx8 b)						{ return _x8(_mm256_max_ps(a.v, b.v)); }
+	static inline floatx8 Abs(floatx8 a)								{ return _x8(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)); }
+	static inline floatx8 Sqrt(floatx8 a)								{ return _x8(_mm256_sqrt_ps(a.v)); }
+	static inline floatx8 CmpLt(floatx8 a, floatx8 b)					{ return _x8(_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)); }
+	static inline floatx8 CmpLe(floatx8 a, floatx8 b)					{ return _x8(_mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ)); }
+	static inline floatx8 Select(floatx8 mask, floatx8 a, floatx8 b)	{ return _x8(_mm256_blendv_ps(b.v, a.v, mask.v)); }
+	static inline u32 MoveMask(floatx8 mask)							{ return (u32)_mm256_movemask_ps(mask.v); }
+	static inline floatx8 And(floatx8 a, floatx8 b)						{ return _x8(_mm256_and_ps(a.v, b.v)); }
+	static inline floatx8 Or(floatx8 a, floatx8 b)						{ return _x8(_mm256_or_ps(a.v, b.v)); }
+#else
+#	define CFC_SIMD_HALVES(f) floatx8 r; r.lo = f(a.lo, b.lo); r.hi = f(a.hi, b.hi); return r
+	static inline floatx8 operator + (floatx8 a, floatx8 b)				{ floatx8 r; r.lo = a.lo + b.lo; r.hi = a.hi + b.hi; return r; }
+	static inline floatx8 operator - (floatx8 a, floatx8 b)				{ floatx8 r; r.lo = a.lo - b.lo; r.hi = a.hi - b.hi; return r; }
+	static inline floatx8 operator * (floatx8 a, floatx8 b)				{ floatx8 r; r.lo = a.lo * b.lo; r.hi = a.hi * b.hi; return r; }
+	static inline floatx8 operator / (floatx8 a, floatx8 b)				{ floatx8 r; r.lo = a.lo / b.lo; r.hi = a.hi / b.hi; return r; }
+	static inline floatx8 MulAdd(floatx8 a, floatx8 b, floatx8 c)		{ floatx8 r; r.lo = MulAdd(a.lo, b.lo, c.lo); r.hi = MulAdd(a.hi, b.hi, c.hi); return r; }
+	static inline floatx8 Min(floatx8 a, floatx8 b)						{ CFC_SIMD_HALVES(Min); }
+	static inline floatx8 Max(floatx8 a, floatx8 b)						{ CFC_SIMD_HALVES(Max); }
+	static inline floatx8 Abs(floatx8 a)								{ floatx8 r; r.lo = Abs(a.lo); r.hi = Abs(a.hi); return r; }
+	static inline floatx8 Sqrt(floatx8 a)								{ floatx8 r; r.lo = Sqrt(a.lo); r.hi = Sqrt(a.hi); return r; }
+	static inline floatx8 CmpLt(floatx8 a, floatx8 b)					{ CFC_SIMD_HALVES(CmpLt); }
+	static inline floatx8 CmpLe(floatx8 a, floatx8 b)					{ CFC_SIMD_HALVES(CmpLe); }
+	static inline floatx8 Select(floatx8 mask, floatx8 a, floatx8 b)	{ floatx8 r; r.lo = Select(mask.lo, a.lo, b.lo); r.hi = Select(mask.hi, a.hi, b.hi); return r; }
+	static inline u32 MoveMask(floatx8 mask)							{ return MoveMask(mask.lo) | (MoveMask(mask.hi) << 4); }
+	static inline floatx8 And(floatx8 a, floatx8 b)						{ CFC_SIMD_HALVES(And); }
+	static inline floatx8 Or(floatx8 a, floatx8 b)						{ CFC_SIMD_HALVES(Or); }
+#	undef CFC_SIMD_HALVES
+#endif
+
+	// widest register of the target, array operations run their main loop on it
+#if defined(CFC_SIMD_AVX2)
+	typedef floatx8 floatxn;
+#else
+	typedef floatx4 floatxn;
+#endif
+
+	// lanes from every stride'th float, used to load the same element of consecutive matrices into one register
+	template <class F> static inline F LoadStrided(const float* p, usize stride)	{ float v[F::Width]; for (u32 i = 0; i < F::Width; ++i) v[i] = p[i * stride]; return F::Load(v); }
+	template <class F> static inline void StoreStrided(const F& a, float* p, usize stride)	{ float v[F::Width]; a.Store(v); for (u32 i = 0; i < F::Width; ++i) p[i * stride] = v[i]; }
+#pragma endregion
+
+#pragma region Vectors and Matrices
+	template <class F>
+	struct vec3xw
+	{
+		F x, y, z;
+
+		static inline vec3xw Load(const float* xs, const float* ys, const float* zs)	{ vec3xw r; r.x = F::Load(xs); r.y = F::Load(ys); r.z = F::Load(zs); return r; }
+		static inline vec3xw Set(const vector3f& v)										{ vec3xw r; r.x = F::Set(v.x); r.y = F::Set(v.y); r.z = F::Set(v.z); return r; }
+		inline void Store(float* xs, float* ys, float* zs) const						{ x.Store(xs); y.Store(ys); z.Store(zs); }
+
+		inline vec3xw operator + (const vec3xw& o) const								{ vec3xw r; r.x = x + o.x; r.y = y + o.y; r.z = z + o.z; return r; }
+		inline vec3xw operator - (const vec3xw& o) const								{ vec3xw r; r.x = x - o.x; r.y = y - o.y; r.z = z - o.z; return r; }
+		inline vec3xw operator * (const F& s) const										{ vec3xw r; r.x = x * s; r.y = y * s; r.z = z * s; return r; }
+
+		inline F Dot(const vec3xw& o) const												{ return MulAdd(z, o.z, MulAdd(y, o.y, x * o.x)); }
+		inline vec3xw Cross(const vec3xw& o) const
+		{
+			vec3xw r;
+			r.x = y * o.z - z * o.y;
+			r.y = z * o.x - x * o.z;
+			r.z = x * o.y - y * o.x;
+			return r;
+		}
+		inline F LengthSq() const														{ return Dot(*this); }
+		inline F Length() const															{ return Sqrt(Dot(*this)); }
+	};
+
+	typedef vec3xw<floatx4> vec3x4;
+	typedef vec3xw<floatx8> vec3x8;
+
+	// column major like matrix4f (M[column * 4 + row]), elements are broadcast to the lanes where they are used
+	struct mat4
+	{
+		float M[16];
+
+		mat4() {}
+		explicit mat4(const matrix4f& m)												{ memcpy(M, m.M, sizeof(M)); }
+		explicit mat4(const float* columnMajor)											{ memcpy(M, columnMajor, sizeof(M)); }
+		inline void Store(float* columnMajor) const										{ memcpy(columnMajor, M, sizeof(M)); }
+
+		// (a * b) transforms by b first, like matrix4f, a column of the product at a time
+		inline mat4 operator * (const mat4& o) const
+		{
+			const floatx4 c0 = floatx4::Load(M), c1 = floatx4::Load(M + 4), c2 = floatx4::Load(M + 8), c3 = floatx4::Load(M + 12);
+			mat4 r;
+			for (u32 j = 0; j < 4; ++j)
+			{
+				const float* b = o.M + j * 4;
+				MulAdd(c3, floatx4::Set(b[3]), MulAdd(c2, floatx4::Set(b[2]), MulAdd(c1, floatx4::Set(b[1]), c0 * floatx4::Set(b[0])))).Store(r.M + j * 4);
+			}
+			return r;
+		}
+
+		template <class F> inline vec3xw<F> TransformPoint(const vec3xw<F>& p) const
+		{
+			vec3xw<F> r;
+			r.x = MulAdd(p.z, F::Set(M[8]), MulAdd(p.y, F::Set(M[4]), MulAdd(p.x, F::Set(M[0]), F::Set(M[12]))));
+			r.y = MulAdd(p.z, F::Set(M[9]), MulAdd(p.y, F::Set(M[5]), MulAdd(p.x, F::Set(M[1]), F::Set(M[13]))));
+			r.z = MulAdd(p.z, F::Set(M[10]), MulAdd(p.y, F::Set(M[6]), MulAdd(p.x, F::Set(M[2]), F::Set(M[14]))));
+			return r;
+		}
+		template <class F> inline vec3xw<F> TransformPoint(const vec3xw<F>& p, F& wOUT) const
+		{
+			wOUT = MulAdd(p.z, F::Set(M[11]), MulAdd(p.y, F::Set(M[7]), MulAdd(p.x, F::Set(M[3]), F::Set(M[15]))));
+			return TransformPoint(p);
+		}
+		// directions, without the translation
+		template <class F> inline vec3xw<F> TransformVector(const vec3xw<F>& v) const
+		{
+			vec3xw<F> r;
+			r.x = MulAdd(v.z, F::Set(M[8]), MulAdd(v.y, F::Set(M[4]), v.x * F::Set(M[0])));
+			r.y = MulAdd(v.z, F::Set(M[9]), MulAdd(v.y, F::Set(M[5]), v.x * F::Set(M[1])));
+			r.z = MulAdd(v.z, F::Set(M[10]), MulAdd(v.y, F::Set(M[6]), v.x * F::Set(M[2])));
+			return r;
+		}
+	};
+
+	// bounds as separate arrays per component, inputs are only read
+	struct aabb_arrays
+	{
+		float* MinX; float* MinY; float* MinZ;
+		float* MaxX; float* MaxY; float* MaxZ;
+	};
+#pragma endregion
+
+#pragma region Inverses
+	// Closed form inverses for the matrices the general matrix4f::Inverse is mostly used on.
+	// NOTE: the input has to have the expected form, singular matrices give non-finite elements instead of failing
+
+	// rotation, scale (also non-uniform) and translation, the last row is 0 0 0 1
+	CFC_API mat4 InverseAffine(const mat4& m);
+	// perspective projections like matrix4f::Projection, off-center and either handedness
+	CFC_API mat4 InversePerspective(const mat4& projection);
+	// inverse of (projection * view) for an affine view
+	CFC_API mat4 InverseViewProjection(const mat4& view, const mat4& projection);
+	// count column major matrices (matrix4f, mat4_simple) inverted as InverseAffine, in place when matricesOUT == matrices
+	CFC_API void InverseAffines(const float* matrices, float* matricesOUT, usize count);
+#pragma endregion
+
+#pragma region Array Operations
+	// NOTE: arrays hold count floats each, outputs may alias the inputs of the same component
+	CFC_API void TransformPoints(const mat4& m, const float* x, const float* y, const float* z, float* xOUT, float* yOUT, float* zOUT, usize count);
+	CFC_API void TransformVectors(const mat4& m, const float* x, const float* y, const float* z, float* xOUT, float* yOUT, float* zOUT, usize count);
+	// clip space and perspective divide, wOUT (optional) keeps w so points behind the eye (w <= 0) can be rejected
+	CFC_API void ProjectPoints(const mat4& viewProjection, const float* x, const float* y, const float* z, float* xOUT, float* yOUT, float* zOUT, float* wOUT, usize count);
+
+	CFC_API void Dot(const float* ax, const float* ay, const float* az, const float* bx, const float* by, const float* bz, float* OUT, usize count);
+	CFC_API void Cross(const float* ax, const float* ay, const float* az, const float* bx, const float* by, const float* bz, float* xOUT, float* yOUT, float* zOUT, usize count);
+	// signed distances (a*x + b*y + c*z + d), the plane is expected to be normalized for euclidean distances
+	CFC_API void PlaneDistances(const planef& plane, const float* x, const float* y, const float* z, float* OUT, usize count);
+
+	// bounds of the transformed boxes (Arvo), in and out can be the same arrays
+	CFC_API void TransformAABBs(const mat4& m, const aabb_arrays& bounds, const aabb_arrays& boundsOUT, usize count);
+	// insideOUT is 1 for boxes on the inner side of all planes (the corner furthest along the plane normal is in front of
+	// or on it), 0 otherwise, returns the number of boxes inside
+	CFC_API usize CullAABBs(const planef* planes, u32 numPlanes, const aabb_arrays& bounds, u8* insideOUT, usize count);
+#pragma endregion
+
+}; // end namespace simd
+}; // end namespace math
+}; // end namespace cfc
@@ -0,0 +1,402 @@
+#pragma once
+
+#include <cfc/base.h>
+#include <cfc/core/context.h>
+#include <cfc/core/logging.h>
+#include <cfc/core/io.h>
+#include <cfc/core/hashing.h>
+#include <cfc/core/random.h>
+#include <cfc/core/timing.h>
+#include <cfc/core/window.h>
+
+#include <cfc/stl/stl_vector.hpp>
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// NOTE: gcc and clang define linux as 1 in the gnu language modes, it would replace the namespace name
+#undef linux
+
+// files smaller than this are read, the page faults and the unmap of a mapping cost more than the copy
+#define CFC_LINUX_IO_MAP_THRESHOLD (64 * 1024)
+
+CFC_NAMESPACE3(cfc, platform, linux)
+
+// Headless window, there is no display on the build and test machines. Input and resizes come from a script that is played
+// back frame by frame (one frame per Update), the events reach the same handlers as those of a real window.
+//
+// Script, a command per line, '#' starts a comment:
+//   <frame> resize <width> <height>
+//   <frame> keydown <key>            key is a character ('W', ' ' is space) or a virtual key code
+//   <frame> keyup <key>
+//   <frame> char <key>
+//   <frame> move <x> <y>
+//   <frame> down <x> <y> <button>    button as in cfc::window::cursorButton (1 left, 2 right, 3 middle)
+//   <frame> up <x> <y> <button>
+//   <frame> scroll <delta>
+//   <frame> quit
+class window : public cfc::window
+{
+public:
+	window(cfc::context& context, int width = 1280, int height = 720, cfc::window::fullscreenMode fsMode = cfc::window::fullscreenMode::Windowed, const char* windowTitle = "CfcWindow") :
+		m_context(context)
+	{
+		m_width = width;
+		m_height = height;
+		m_fullscreenMode = fsMode;
+		snprintf(m_title, sizeof(m_title), "%s", windowTitle);
+	}
+	~window()
+	{
+
+	}
+
+	// replaces the current script, frames are relative to the next Update
+	bool LoadScript(const char* path)
+	{
+		cfc::iobuffer script = m_context.IO->ReadFileToMemory(path);
+		if (!script)
+			return false;
+		return ParseScript((const char*)script.data, script.size);
+	}
+
+	bool ParseScript(const char* text, usize size)
+	{
+		m_commands.clear();
+		m_nextCommand = 0;
+		m_frame = 0;
+
+		const char* end = text + size;
+		u32 lineNumber = 0;
+		while (text < end)
+		{
+			const char* lineEnd = text;
+			while (lineEnd < end && *lineEnd != '\n')
+				lineEnd++;
+
+			char line[256];
+			const usize length = (usize)(lineEnd - text) < sizeof(line) - 1 ? (usize)(lineEnd - text) : sizeof(line) - 1;
+			memcpy(line, text, length);
+			line[length] = 0;
+			text = lineEnd + 1;
+			lineNumber++;
+
+			if (char* comment = strchr(line, '#'))
+				*comment = 0;
+
+			script_command cmd;
+			if (!_parseCommand(line, cmd))
+			{
+				if (!_isEmpty(line) && m_context.Log != nullptr)
+					m_context.Log->Logf(cfc::logflags::ScpEngine | cfc::logflags::SevError, "Window script, line %u is not a command (%s).", lineNumber, line);
+				continue;
+			}
+			m_commands.push_back(cmd);
+		}
+
+		// commands of a frame are played back in the order of the script
+		for (usize i = 1; i < m_commands.size(); ++i)
+		{
+			script_command cmd = m_commands[i];
+			usize j = i;
+			for (; j > 0 && m_commands[j - 1].Frame > cmd.Frame; --j)
+				m_commands[j] = m_commands[j - 1];
+			m_commands[j] = cmd;
+		}
+		return true;
+	}
+
+	bool IsScriptFinished() const							{ return m_nextCommand >= m_commands.size(); }
+	u64 GetFrame() const									{ return m_frame; }
+
+	virtual void UpdateTitle(const char* title)
+	{
+		snprintf(m_title, sizeof(m_title), "%s", title);
+	}
+
+	virtual void Update()
+	{
+		_updateDeltas();
+
+		while (m_nextCommand < m_commands.size() && m_commands[m_nextCommand].Frame <= m_frame)
+			_execute(m_commands[m_nextCommand++]);
+		m_frame++;
+	}
+
+	virtual void* GetPlatformSpecificHandle() { return nullptr; }
+
+	virtual void SetCursorXY(int x, int y)
+	{
+		_doCursorMove(0, (float)x, (float)y);
+	}
+
+protected:
+	enum class script_command_type
+	{
+		Resize,
+		KeyDown,
+		KeyUp,
+		Char,
+		CursorMove,
+		CursorDown,
+		CursorUp,
+		Scroll,
+		Quit,
+	};
+
+	struct script_command
+	{
+		u64 Frame;
+		script_command_type Type;
+		f32 Args[3];
+	};
+
+	static bool _isEmpty(const char* line)
+	{
+		for (; *line != 0; ++line)
+		{
+			if (!isspace((unsigned char)*line))
+				return false;
+		}
+		return true;
+	}
+
+	// a single character is the key itself (upper case, like the virtual key codes of letters), a number is a key code
+	static bool _parseKey(const char* token, f32& keyOUT)
+	{
+		if (token[0] == 0)
+			return false;
+		if (token[1] == 0 && !isdigit((unsigned char)token[0]))
+		{
+			keyOUT = (f32)toupper((unsigned char)token[0]);
+			return true;
+		}
+		if (strcmp(token, "space") == 0)
+		{
+			keyOUT = (f32)' ';
+			return true;
+		}
+		char* tokenEnd;
+		keyOUT = (f32)strtol(token, &tokenEnd, 0);
+		return *tokenEnd == 0;
+	}
+
+	static bool _parseCommand(const char* line, script_command& cmdOUT)
+	{
+		unsigned long long frame;
+		char name[32];
+		char args[3][32] = {};
+		const int numTokens = sscanf(line, "%llu %31s %31s %31s %31s", &frame, name, args[0], args[1], args[2]);
+		if (numTokens < 2)
+			return false;
+
+		struct command_desc { const char* Name; script_command_type Type; int NumArgs; };
+		static const command_desc commands[] =
+		{
+			{ "resize", script_command_type::Resize, 2 },
+			{ "keydown", script_command_type::KeyDown, 1 },
+			{ "keyup", script_command_type::KeyUp, 1 },
+			{ "char", script_command_type::Char, 1 },
+			{ "move", script_command_type::CursorMove, 2 },
+			{ "down", script_command_type::CursorDown, 3 },
+			{ "up", script_command_type::CursorUp, 3 },
+			{ "scroll", script_command_type::Scroll, 1 },
+			{ "quit", script_command_type::Quit, 0 },
+		};
+
+		for (const command_desc& desc : commands)
+		{
+			if (strcmp(desc.Name, name) != 0)
+				continue;
+			if (numTokens - 2 < desc.NumArgs)
+				return false;
+
+			cmdOUT.Frame = frame;
+			cmdOUT.Type = desc.Type;
+			for (int i = 0; i < 3; ++i)
+				cmdOUT.Args[i] = 0.0f;
+
+			const bool isKey = desc.Type == script_command_type::KeyDown || desc.Type == script_command_type::KeyUp || desc.Type == script_command_type::Char;
+			for (int i = 0; i < desc.NumArgs; ++i)
+			{
+				if (isKey)
+				{
+					if (!_parseKey(args[i], cmdOUT.Args[i]))
+						return false;
+					continue;
+				}
+
+				char* argEnd;
+				cmdOUT.Args[i] = strtof(args[i], &argEnd);
+				if (*argEnd != 0)
+					return false;
+			}
+			return true;
+		}
+		return false;
+	}
+
+	void _execute(const script_command& cmd)
+	{
+		switch (cmd.Type)
+		{
+		case script_command_type::Resize:		_doResize((int)cmd.Args[0], (int)cmd.Args[1]); break;
+		case script_command_type::KeyDown:		_doKeyDown(0, (int)cmd.Args[0]); break;
+		case script_command_type::KeyUp:		_doKeyUp(0, (int)cmd.Args[0]); break;
+		case script_command_type::Char:			_doKeyChar(0, (int)cmd.Args[0]); break;
+		case script_command_type::CursorMove:	_doCursorMove(0, cmd.Args[0], cmd.Args[1]); break;
+		case script_command_type::CursorDown:	_doCursorDown(0, cmd.Args[0], cmd.Args[1], (int)cmd.Args[2]); break;
+		case script_command_type::CursorUp:		_doCursorUp(0, cmd.Args[0], cmd.Args[1], (int)cmd.Args[2]); break;
+		case script_command_type::Scroll:		m_scroll += cmd.Args[0]; _doCursorScroll(0, m_scroll); break;
+		case script_command_type::Quit:			m_requestStop = true; break;
+		}
+	}
+
+	float m_scroll = 0.0f;
+	char m_title[256];
+	stl_vector<script_command> m_commands;
+	usize m_nextCommand = 0;
+	u64 m_frame = 0;
+	cfc::context& m_context;
+};
+
+class timing : public cfc::timing
+{
+public:
+	virtual double GetTimeSeconds()
+	{
+		return (double)GetTimeNanoSeconds() / 1000000000.0;
+	}
+	virtual u64 GetTimeNanoSeconds()
+	{
+		// monotonic, unaffected by changes of the wall clock
+		timespec ts;
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (u64)ts.tv_sec * 1000000000ULL + (u64)ts.tv_nsec;
+	}
+};
+
+class io : public cfc::io
+{
+	virtual u32_64 GetFileSize(const char* path)
+	{
+		struct stat st;
+		if (stat(path, &st) != 0)
+			return 0;
+		return (u32_64)st.st_size;
+	}
+	virtual bool Exists(const char* path)
+	{
+		struct stat st;
+		return stat(path, &st) == 0 && S_ISREG(st.st_mode);
+	}
+	// Files from CFC_LINUX_IO_MAP_THRESHOLD up are mapped, the buffer is a view of the page cache and is unmapped when it is
+	// released. The mapping is private, writes to the buffer stay in the process like they do with a read file.
+	virtual cfc::iobuffer ReadFileToMemory(const char* path)
+	{
+		cfc::iobuffer outBuffer;
+		const int fd = open(path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			return outBuffer;
+
+		struct stat st;
+		if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+		{
+			close(fd);
+			return outBuffer;
+		}
+
+		const usize size = (usize)st.st_size;
+		if (size >= CFC_LINUX_IO_MAP_THRESHOLD)
+		{
+			void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+			if (mapped != MAP_FAILED)
+			{
+				// readers go front to back, the kernel reads ahead aggressively and drops pages behind the reader
+				madvise(mapped, size, MADV_SEQUENTIAL);
+				madvise(mapped, size, MADV_WILLNEED);
+				close(fd);
+
+				outBuffer.data = (u8*)mapped;
+				outBuffer.size = size;
+				outBuffer.release = [](u8* data, usize size) { munmap(data, size); };
+				return outBuffer;
+			}
+		}
+
+		outBuffer.data = (u8*)malloc(size > 0 ? size : 1);
+		outBuffer.size = size;
+		usize numRead = 0;
+		while (numRead < size)
+		{
+			const ssize_t ret = read(fd, outBuffer.data + numRead, size - numRead);
+			if (ret < 0 && errno == EINTR)
+				continue;
+			if (ret <= 0)
+				break;
+			numRead += (usize)ret;
+		}
+		close(fd);
+
+		// the file shrunk while reading
+		if (numRead != size)
+			outBuffer = cfc::iobuffer();
+		return outBuffer;
+	}
+	virtual bool ReadFileRange(const char* path, u64 offset, void* destination, usize size, usize& numReadOUT)
+	{
+		numReadOUT = 0;
+		const int fd = open(path, O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			return false;
+
+		// pread has no file position, the io workers read concurrently
+		bool failed = false;
+		while (numReadOUT < size)
+		{
+			const ssize_t ret = pread(fd, (u8*)destination + numReadOUT, size - numReadOUT, (off_t)(offset + numReadOUT));
+			if (ret < 0 && errno == EINTR)
+				continue;
+			failed = ret < 0;
+			if (ret <= 0)
+				break;
+			numReadOUT += (usize)ret;
+		}
+		close(fd);
+		return !failed;
+	}
+	virtual bool WriteMemoryToFile(const char* path, const void* data, usize size)
+	{
+		const int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (fd < 0)
+			return false;
+
+		usize numWritten = 0;
+		while (numWritten < size)
+		{
+			const ssize_t ret = write(fd, (const u8*)data + numWritten, size - numWritten);
+			if (ret < 0 && errno == EINTR)
+				continue;
+			if (ret <= 0)
+				break;
+			numWritten += (usize)ret;
+		}
+		return close(fd) == 0 && numWritten == size;
+	}
+	virtual bool ShowOpenFileDialog(const char* filter, char* destination, i32 destinationBufferSize)
+	{
+		// headless, there is no one to pick a file
+		return false;
+	}
+};
+
+CFC_END_NAMESPACE3(cfc, platform, linux)
+
@@ -13,6 +13,9 @@
 #include <cfc/stl/stl_string.hpp>
 #include <cfc/stl/stl_string_advanced.hpp>
 
+// files smaller than this are read, the page faults and the unmap of a view cost more than the copy
+#define CFC_WIN32_IO_MAP_THRESHOLD (64 * 1024)
+
 CFC_NAMESPACE3(cfc, platform, win32)
 
 class window : public cfc::window
@@ -233,10 +236,35 @@ class io : public cfc::io
 		}
 		return false;
 	}
+	// Files from CFC_WIN32_IO_MAP_THRESHOLD up are mapped, the buffer is a view of the file cache and is unmapped when it is
+	// released. The view is copy on write, writes to the buffer stay in the process like they do with a read file.
 	virtual cfc::iobuffer ReadFileToMemory(const char* path)
 	{
 		cfc::iobuffer outBuffer;
 		usize size = GetFileSize(path);
+		if (size >= CFC_WIN32_IO_MAP_THRESHOLD)
+		{
+			HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (file != INVALID_HANDLE_VALUE)
+			{
+				HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+				void* view = mapping != nullptr ? MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, size) : nullptr;
+
+				// the view keeps the mapping and the file open
+				if (mapping != nullptr)
+					CloseHandle(mapping);
+				CloseHandle(file);
+
+				if (view != nullptr)
+				{
+					outBuffer.data = (u8*)view;
+					outBuffer.size = size;
+					outBuffer.release = [](u8* data, usize size) { UnmapViewOfFile(data); };
+					return outBuffer;
+				}
+			}
+		}
+
 		FILE* f = fopen(path, "rb");
 		if (f)
 		{
@@ -248,6 +276,15 @@ class io : public cfc::io
 		}
 		return outBuffer;
 	}
+	virtual bool WriteMemoryToFile(const char* path, const void* data, usize size)
+	{
+		FILE* f = fopen(path, "wb");
+		if (!f)
+			return false;
+		usize written = fwrite(data, 1, size, f);
+		fclose(f);
+		return written == size;
+	}
 	virtual bool ShowOpenFileDialog(const char* filter, char* destination, i32 destinationBufferSize) 
 	{ 
 		OPENFILENAMEA ofn;       // common dialog gpu_box structure
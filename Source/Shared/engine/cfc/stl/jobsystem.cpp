@@ -0,0 +1,593 @@
+#include "jobsystem.h"
+
+#include <cfc/core/profiling.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+#ifdef _MSC_VER
+#	include <intrin.h>
+#	define CFC_JOB_PAUSE() _mm_pause()
+#elif defined(__i386__) || defined(__x86_64__)
+#	include <immintrin.h>
+#	define CFC_JOB_PAUSE() _mm_pause()
+#else
+#	define CFC_JOB_PAUSE() std::this_thread::yield()
+#endif
+
+// jobs a single worker can have in flight, a full deque executes new jobs inline
+#define CFC_JOB_QUEUE_CAPACITY 2048
+
+// failed find attempts before an idle worker goes to sleep
+#define CFC_JOB_IDLE_SPIN_QUANTITY 64
+
+namespace cfc {
+namespace core {
+namespace threading {
+
+#pragma region Job Deque
+
+struct _job_entry
+{
+	stl_function<void(), CFC_JOB_LAMBDA_SIZE> Func;
+	job_function Function = nullptr;
+	void* Data = nullptr;
+	job_counter* Counter = nullptr;
+
+	void Execute()
+	{
+		if (Function != nullptr)
+			Function(Data);
+		else
+			Func();
+	}
+};
+
+struct _job : public _job_entry
+{
+	std::atomic<u32> InUse;
+};
+
+// Chase-Lev deque with the memory orders from "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al. 2013)
+// NOTE: fixed capacity, the owner checks IsFull before pushing
+class _job_deque
+{
+public:
+	_job_deque()
+	{
+		m_top.store(0, std::memory_order_relaxed);
+		m_bottom.store(0, std::memory_order_relaxed);
+		for (u32 i = 0; i < CFC_JOB_QUEUE_CAPACITY; ++i)
+			m_buffer[i].store(nullptr, std::memory_order_relaxed);
+	}
+
+	// owner only
+	bool IsFull() const
+	{
+		const i64 b = m_bottom.load(std::memory_order_relaxed);
+		const i64 t = m_top.load(std::memory_order_acquire);
+		return b - t >= CFC_JOB_QUEUE_CAPACITY;
+	}
+
+	// any thread, might be outdated the moment it returns
+	bool IsEmpty() const
+	{
+		const i64 t = m_top.load(std::memory_order_acquire);
+		const i64 b = m_bottom.load(std::memory_order_acquire);
+		return b <= t;
+	}
+
+	// owner only
+	void Push(_job* job)
+	{
+		const i64 b = m_bottom.load(std::memory_order_relaxed);
+		m_buffer[b & (CFC_JOB_QUEUE_CAPACITY - 1)].store(job, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		m_bottom.store(b + 1, std::memory_order_relaxed);
+	}
+
+	// owner only
+	_job* Pop()
+	{
+		const i64 b = m_bottom.load(std::memory_order_relaxed) - 1;
+		m_bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		i64 t = m_top.load(std::memory_order_relaxed);
+
+		if (t > b)
+		{
+			m_bottom.store(b + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		_job* job = m_buffer[b & (CFC_JOB_QUEUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+		if (t == b)
+		{
+			// last job, race against the thieves
+			if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				job = nullptr;
+			m_bottom.store(b + 1, std::memory_order_relaxed);
+		}
+		return job;
+	}
+
+	// any thread
+	_job* Steal()
+	{
+		i64 t = m_top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const i64 b = m_bottom.load(std::memory_order_acquire);
+
+		if (t >= b)
+			return nullptr;
+
+		_job* job = m_buffer[t & (CFC_JOB_QUEUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+		if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return nullptr;
+		return job;
+	}
+
+private:
+	// NOTE: top is written by thieves, bottom by the owner, keep them on separate cache lines
+	std::atomic<i64> m_top;
+	char m_pad0[64 - sizeof(std::atomic<i64>)];
+	std::atomic<i64> m_bottom;
+	char m_pad1[64 - sizeof(std::atomic<i64>)];
+	std::atomic<_job*> m_buffer[CFC_JOB_QUEUE_CAPACITY];
+};
+
+#pragma endregion
+#pragma region Job System
+
+struct _job_worker
+{
+	_job_deque Queue;
+
+	// ring of job slots, only the owner allocates from it
+	_job Jobs[CFC_JOB_QUEUE_CAPACITY];
+	u32 NextJob = 0;
+
+	// victim selection
+	u32 RandomState = 0;
+
+	std::thread Thread;
+};
+
+class _imp_job_system
+{
+public:
+	std::vector<_job_worker*> m_workers;
+
+	// submissions from threads that are not workers
+	std::mutex m_injectLock;
+	std::deque<_job_entry> m_injectQueue;
+	std::atomic<u32> m_injectQuantity;
+
+	// sleeping workers are woken when the epoch changes
+	std::mutex m_sleepLock;
+	std::condition_variable m_sleepCondition;
+	std::atomic<u32> m_sleepEpoch;
+	std::atomic<u32> m_numSleeping;
+
+	std::atomic<bool> m_quit;
+
+	usize GetWorkerIndex() const;
+	void Submit(_job_entry&& entry);
+	bool ExecuteOne(usize workerIndex);
+	bool HasWork() const;
+	void Wake();
+	void WorkerMain(u32 workerIndex);
+};
+
+static CFC_THREAD_LOCAL_STORAGE _imp_job_system* g_tlsJobSystem = nullptr;
+static CFC_THREAD_LOCAL_STORAGE u32 g_tlsJobWorkerIndex = 0;
+
+static void finishJob(_job_entry& entry)
+{
+	entry.Execute();
+	if (entry.Counter != nullptr)
+		entry.Counter->Done();
+}
+
+static void finishJob(_job* job)
+{
+	// NOTE: the slot is released before the counter, a waiter might submit into it right away
+	job_counter* counter = job->Counter;
+	job->Execute();
+	job->Func = nullptr;
+	job->InUse.store(0, std::memory_order_release);
+	if (counter != nullptr)
+		counter->Done();
+}
+
+usize _imp_job_system::GetWorkerIndex() const
+{
+	return g_tlsJobSystem == this ? g_tlsJobWorkerIndex : invalid_index;
+}
+
+void _imp_job_system::Submit(_job_entry&& entry)
+{
+	if (entry.Counter != nullptr)
+		entry.Counter->Add(1);
+
+	const usize workerIndex = GetWorkerIndex();
+	if (workerIndex == invalid_index)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_injectLock);
+			m_injectQueue.push_back(std::move(entry));
+		}
+		m_injectQuantity.fetch_add(1, std::memory_order_seq_cst);
+		Wake();
+		return;
+	}
+
+	_job_worker* worker = m_workers[workerIndex];
+
+	// slots of running jobs stay taken (nested jobs run on top of them), skip to the next free one
+	_job* job = nullptr;
+	if (!worker->Queue.IsFull())
+	{
+		for (u32 i = 0; i < CFC_JOB_QUEUE_CAPACITY && job == nullptr; ++i)
+		{
+			_job* slot = &worker->Jobs[worker->NextJob++ & (CFC_JOB_QUEUE_CAPACITY - 1)];
+			if (slot->InUse.load(std::memory_order_acquire) == 0)
+				job = slot;
+		}
+	}
+
+	// the caller is producing faster than anyone consumes, execute inline
+	if (job == nullptr)
+	{
+		finishJob(entry);
+		return;
+	}
+
+	static_cast<_job_entry&>(*job) = std::move(entry);
+	job->InUse.store(1, std::memory_order_relaxed);
+	worker->Queue.Push(job);
+
+	// pairs with the increment in WorkerMain, either the sleeper sees the job or we see the sleeper
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	Wake();
+}
+
+void _imp_job_system::Wake()
+{
+	if (m_numSleeping.load(std::memory_order_seq_cst) == 0)
+		return;
+
+	m_sleepEpoch.fetch_add(1, std::memory_order_seq_cst);
+	{
+		std::lock_guard<std::mutex> lock(m_sleepLock);
+	}
+	m_sleepCondition.notify_one();
+}
+
+bool _imp_job_system::ExecuteOne(usize workerIndex)
+{
+	const u32 numWorkers = (u32)m_workers.size();
+
+	// own work first, newest job is the most likely to be in cache
+	if (workerIndex != invalid_index)
+	{
+		_job* job = m_workers[workerIndex]->Queue.Pop();
+		if (job != nullptr)
+		{
+			finishJob(job);
+			return true;
+		}
+	}
+
+	// submissions from outside
+	if (m_injectQuantity.load(std::memory_order_acquire) > 0)
+	{
+		_job_entry entry;
+		bool found = false;
+		{
+			std::lock_guard<std::mutex> lock(m_injectLock);
+			if (!m_injectQueue.empty())
+			{
+				entry = std::move(m_injectQueue.front());
+				m_injectQueue.pop_front();
+				m_injectQuantity.fetch_sub(1, std::memory_order_relaxed);
+				found = true;
+			}
+		}
+
+		if (found)
+		{
+			finishJob(entry);
+			return true;
+		}
+	}
+
+	// steal, start at a random victim so thieves spread out
+	u32 start = 0;
+	if (workerIndex != invalid_index)
+	{
+		u32& state = m_workers[workerIndex]->RandomState;
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		start = state;
+	}
+
+	for (u32 i = 0; i < numWorkers; ++i)
+	{
+		const u32 victim = (start + i) % numWorkers;
+		if (victim == workerIndex)
+			continue;
+
+		_job* job = m_workers[victim]->Queue.Steal();
+		if (job != nullptr)
+		{
+			finishJob(job);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool _imp_job_system::HasWork() const
+{
+	if (m_injectQuantity.load(std::memory_order_seq_cst) > 0)
+		return true;
+
+	for (usize i = 0; i < m_workers.size(); ++i)
+	{
+		if (!m_workers[i]->Queue.IsEmpty())
+			return true;
+	}
+	return false;
+}
+
+void _imp_job_system::WorkerMain(u32 workerIndex)
+{
+	g_tlsJobSystem = this;
+	g_tlsJobWorkerIndex = workerIndex;
+
+#ifdef CFC_CONF_PROFILING_ENABLED
+	char threadName[32];
+	snprintf(threadName, sizeof(threadName), "Job Worker %u", workerIndex);
+	CFC_PROFILE_THREAD_NAME(threadName);
+#endif
+
+	u32 idleQuantity = 0;
+	while (true)
+	{
+		if (ExecuteOne(workerIndex))
+		{
+			idleQuantity = 0;
+			continue;
+		}
+
+		if (m_quit.load(std::memory_order_acquire))
+			break;
+
+		if (++idleQuantity < CFC_JOB_IDLE_SPIN_QUANTITY)
+		{
+			CFC_JOB_PAUSE();
+			continue;
+		}
+
+		// announce before the final check, a pusher either sees us sleeping or we see its job
+		const u32 epoch = m_sleepEpoch.load(std::memory_order_seq_cst);
+		m_numSleeping.fetch_add(1, std::memory_order_seq_cst);
+		if (!HasWork() && !m_quit.load(std::memory_order_seq_cst))
+		{
+			std::unique_lock<std::mutex> lock(m_sleepLock);
+			m_sleepCondition.wait(lock, [this, epoch]() { return m_sleepEpoch.load(std::memory_order_seq_cst) != epoch || m_quit.load(std::memory_order_seq_cst); });
+		}
+		m_numSleeping.fetch_sub(1, std::memory_order_seq_cst);
+		idleQuantity = 0;
+	}
+
+	g_tlsJobSystem = nullptr;
+}
+
+job_system::job_system()
+{
+	m_impl = nullptr;
+}
+
+job_system::~job_system()
+{
+	Shutdown();
+}
+
+void job_system::Init(u32 numWorkers)
+{
+	stl_assert(m_impl == nullptr);
+
+	if (numWorkers == 0)
+		numWorkers = thread::GetHardwareThreadCount();
+	if (numWorkers == 0)
+		numWorkers = 1;
+
+	m_impl = new _imp_job_system();
+	m_impl->m_injectQuantity.store(0);
+	m_impl->m_sleepEpoch.store(0);
+	m_impl->m_numSleeping.store(0);
+	m_impl->m_quit.store(false);
+
+	m_impl->m_workers.resize(numWorkers);
+	for (u32 i = 0; i < numWorkers; ++i)
+	{
+		_job_worker* worker = new _job_worker();
+		for (u32 j = 0; j < CFC_JOB_QUEUE_CAPACITY; ++j)
+			worker->Jobs[j].InUse.store(0, std::memory_order_relaxed);
+		worker->RandomState = 0x9E3779B9u * (i + 1);
+		m_impl->m_workers[i] = worker;
+	}
+
+	// the calling thread is worker 0, it executes jobs while waiting
+	g_tlsJobSystem = m_impl;
+	g_tlsJobWorkerIndex = 0;
+
+	for (u32 i = 1; i < numWorkers; ++i)
+	{
+		_imp_job_system* impl = m_impl;
+		m_impl->m_workers[i]->Thread = std::thread([impl, i]() { impl->WorkerMain(i); });
+	}
+}
+
+void job_system::Shutdown()
+{
+	if (m_impl == nullptr)
+		return;
+
+	// NOTE: workers drain the pending jobs before they exit
+	m_impl->m_quit.store(true, std::memory_order_seq_cst);
+	{
+		std::lock_guard<std::mutex> lock(m_impl->m_sleepLock);
+	}
+	m_impl->m_sleepCondition.notify_all();
+
+	for (usize i = 1; i < m_impl->m_workers.size(); ++i)
+		m_impl->m_workers[i]->Thread.join();
+
+	// the main worker might still own jobs that were never waited on
+	while (m_impl->ExecuteOne(m_impl->GetWorkerIndex())) {}
+
+	for (usize i = 0; i < m_impl->m_workers.size(); ++i)
+		delete m_impl->m_workers[i];
+
+	if (g_tlsJobSystem == m_impl)
+		g_tlsJobSystem = nullptr;
+
+	delete m_impl;
+	m_impl = nullptr;
+}
+
+void job_system::Run(stl_function<void(), CFC_JOB_LAMBDA_SIZE> func, job_counter* counter)
+{
+	_job_entry entry;
+	entry.Func = std::move(func);
+	entry.Counter = counter;
+	m_impl->Submit(std::move(entry));
+}
+
+void job_system::Run(job_function func, void* data, job_counter* counter)
+{
+	_job_entry entry;
+	entry.Function = func;
+	entry.Data = data;
+	entry.Counter = counter;
+	m_impl->Submit(std::move(entry));
+}
+
+void job_system::Wait(job_counter& counter)
+{
+	const usize workerIndex = m_impl->GetWorkerIndex();
+	while (!counter.IsDone())
+	{
+		if (!m_impl->ExecuteOne(workerIndex))
+			CFC_JOB_PAUSE();
+	}
+}
+
+bool job_system::ExecuteOne()
+{
+	return m_impl->ExecuteOne(m_impl->GetWorkerIndex());
+}
+
+u32 job_system::GetWorkerQuantity() const
+{
+	return m_impl != nullptr ? (u32)m_impl->m_workers.size() : 0;
+}
+
+usize job_system::GetCurrentWorkerIndex() const
+{
+	return m_impl != nullptr ? m_impl->GetWorkerIndex() : invalid_index;
+}
+
+#pragma endregion
+#pragma region Task Graph
+
+static const u32 g_noTaskNode = ~0u;
+
+task_graph::task_graph()
+{
+	m_jobs = nullptr;
+}
+
+u32 task_graph::AddNode(stl_function<void(), CFC_JOB_LAMBDA_SIZE> func)
+{
+	m_nodes.push_back(node());
+	m_nodes.back().Func = std::move(func);
+	return (u32)m_nodes.size() - 1;
+}
+
+void task_graph::AddDependency(u32 node, u32 dependsOnNode)
+{
+	stl_assert(node < m_nodes.size() && dependsOnNode < m_nodes.size() && node != dependsOnNode);
+
+	m_nodes[dependsOnNode].Successors.push_back(node);
+	m_nodes[node].NumDependencies++;
+}
+
+void task_graph::Clear()
+{
+	m_nodes.clear();
+}
+
+void task_graph::Execute(job_system& jobs)
+{
+	m_jobs = jobs.GetWorkerQuantity() > 0 ? &jobs : nullptr;
+
+	for (usize i = 0; i < m_nodes.size(); ++i)
+		m_nodes[i].NumPendingDependencies.store((int)m_nodes[i].NumDependencies);
+
+	for (u32 i = 0; i < (u32)m_nodes.size(); ++i)
+	{
+		if (m_nodes[i].NumDependencies != 0)
+			continue;
+
+		if (m_jobs != nullptr)
+			m_jobs->Run([this, i]() { executeNode(i); }, &m_counter);
+		else
+			executeNode(i);
+	}
+
+	if (m_jobs != nullptr)
+		m_jobs->Wait(m_counter);
+}
+
+void task_graph::executeNode(u32 index)
+{
+	while (index != g_noTaskNode)
+	{
+		node& current = m_nodes[index];
+		current.Func();
+
+		// the first successor that became ready continues on this thread, the others are kicked as jobs
+		u32 next = g_noTaskNode;
+		for (usize i = 0; i < current.Successors.size(); ++i)
+		{
+			const u32 successor = current.Successors[i];
+			if (m_nodes[successor].NumPendingDependencies.fetch_add(-1) != 1)
+				continue;
+
+			if (next == g_noTaskNode)
+				next = successor;
+			else if (m_jobs != nullptr)
+				m_jobs->Run([this, successor]() { executeNode(successor); }, &m_counter);
+			else
+				executeNode(successor);
+		}
+		index = next;
+	}
+}
+
+#pragma endregion
+
+}; // end namespace threading
+}; // end namespace core
+}; // end namespace cfc
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cfc/base.h>
+#include "stl_function.hpp"
+#include "threading.h"
+#include "stl_vector.hpp"
+
+CFC_NAMESPACE3(cfc, core, threading)
+
+class _imp_job_system;
+
+// inline capture size of a job, larger captures are stored in a pooled heap block
+#define CFC_JOB_LAMBDA_SIZE 48
+
+// ParallelFor splits a range in this many chunks per worker, enough to even out uneven chunks without splitting further
+#define CFC_PARALLEL_FOR_CHUNKS_PER_WORKER 4
+
+typedef void(*job_function)(void* data);
+
+// fork / join counter, incremented when a job is kicked and decremented when it finished
+// NOTE: a counter has to outlive the jobs that reference it, wait on it before it goes out of scope
+class CFC_API job_counter
+{
+public:
+	job_counter() : m_count(0) {}
+
+	bool IsDone() const { return m_count.load() == 0; }
+	int GetPendingQuantity() const { return m_count.load(); }
+
+	void Add(int n) { m_count.fetch_add(n); }
+	void Done() { m_count.fetch_add(-1); }
+
+protected:
+	job_counter(const job_counter& o) {}
+	void operator = (const job_counter& o) {}
+
+private:
+	atomic_int m_count;
+};
+
+// Work stealing job system, every worker owns a Chase-Lev deque: the owner pushes and pops at the bottom (LIFO, cache warm),
+// idle workers steal from the top (FIFO, oldest and usually largest work). The thread that calls Init becomes worker 0 and
+// participates while waiting on a counter, other threads that are not workers submit through a shared injection queue.
+class CFC_API job_system
+{
+public:
+	job_system();
+	~job_system();
+
+	// numWorkers includes the calling thread, 0 uses all hardware threads
+	void Init(u32 numWorkers = 0);
+	void Shutdown();
+
+	void Run(stl_function<void(), CFC_JOB_LAMBDA_SIZE> func, job_counter* counter = nullptr);
+	void Run(job_function func, void* data, job_counter* counter = nullptr);
+
+	// executes pending jobs until the counter reaches zero (help while waiting)
+	void Wait(job_counter& counter);
+
+	// executes a single pending job, returns false when no job could be found
+	bool ExecuteOne();
+
+	u32 GetWorkerQuantity() const;
+
+	// worker index of the calling thread, invalid_index when the thread is not a worker of this system
+	usize GetCurrentWorkerIndex() const;
+
+	// calls func(first, last) for chunks of [begin, end), the grain size follows from the range and the worker quantity
+	// NOTE: the calling thread takes part and the call returns once every chunk finished, ranges below minGrainSize run inline
+	template <class T> void ParallelFor(u32 begin, u32 end, const T& func, u32 minGrainSize = 64);
+
+protected:
+	job_system(const job_system& o) {}
+	void operator = (const job_system& o) {}
+
+private:
+	template <class T> struct parallel_for_range
+	{
+		const T* Func;
+		u32 Begin;
+		u32 End;
+		u32 GrainSize;
+		u32 NumChunks;
+		atomic_int NextChunk;
+
+		// chunks are claimed, not assigned, a worker that finishes early takes the next one
+		static void Execute(parallel_for_range* range)
+		{
+			int chunk;
+			while ((chunk = range->NextChunk.fetch_add(1)) < (int)range->NumChunks)
+			{
+				const u32 first = range->Begin + (u32)chunk * range->GrainSize;
+				const u32 last = range->End - first < range->GrainSize ? range->End : first + range->GrainSize;
+				(*range->Func)(first, last);
+			}
+		}
+	};
+
+	_imp_job_system* m_impl;
+};
+
+// Graph of jobs that is built once and executed as often as needed (every frame), a node starts as soon as all nodes
+// it depends on finished. Executing does not allocate, nodes keep their function between executions.
+// NOTE: the graph has to be acyclic
+class CFC_API task_graph
+{
+public:
+	task_graph();
+
+	u32 AddNode(stl_function<void(), CFC_JOB_LAMBDA_SIZE> func);
+	void AddDependency(u32 node, u32 dependsOnNode);
+	void Clear();
+
+	// runs every node once and returns when all nodes finished, without a job system (not initialized) the nodes run serially
+	void Execute(job_system& jobs);
+
+	u32 GetNodeQuantity() const { return (u32)m_nodes.size(); }
+
+protected:
+	task_graph(const task_graph& o) {}
+	void operator = (const task_graph& o) {}
+
+private:
+	struct node
+	{
+		stl_function<void(), CFC_JOB_LAMBDA_SIZE> Func;
+		stl_vector<u32> Successors;
+		u32 NumDependencies = 0;
+		atomic_int NumPendingDependencies;
+	};
+
+	void executeNode(u32 index);
+
+	stl_vector<node> m_nodes;
+	job_system* m_jobs;
+	job_counter m_counter;
+};
+
+template <class T>
+void job_system::ParallelFor(u32 begin, u32 end, const T& func, u32 minGrainSize)
+{
+	if (end <= begin)
+		return;
+
+	const u32 numWorkers = GetWorkerQuantity();
+	const u32 count = end - begin;
+
+	u32 grainSize = numWorkers > 0 ? count / (numWorkers * CFC_PARALLEL_FOR_CHUNKS_PER_WORKER) : count;
+	if (grainSize < minGrainSize)
+		grainSize = minGrainSize;
+	if (grainSize == 0)
+		grainSize = 1;
+
+	const u32 numChunks = (count + grainSize - 1) / grainSize;
+	if (numChunks <= 1 || numWorkers <= 1)
+	{
+		func(begin, end);
+		return;
+	}
+
+	parallel_for_range<T> range;
+	range.Func = &func;
+	range.Begin = begin;
+	range.End = end;
+	range.GrainSize = grainSize;
+	range.NumChunks = numChunks;
+	range.NextChunk.store(0);
+
+	// one helper per extra worker, the calling thread is the last one
+	const u32 numHelpers = (numChunks < numWorkers ? numChunks : numWorkers) - 1;
+	parallel_for_range<T>* rangePtr = &range;
+
+	job_counter counter;
+	for (u32 i = 0; i < numHelpers; ++i)
+		Run([rangePtr]() { parallel_for_range<T>::Execute(rangePtr); }, &counter);
+
+	parallel_for_range<T>::Execute(rangePtr);
+	Wait(counter);
+}
+
+CFC_END_NAMESPACE3(cfc, core, threading)
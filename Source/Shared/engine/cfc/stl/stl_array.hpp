@@ -22,7 +22,7 @@ public:
 	T& operator [] (usize v) { stl_assert(v<count); return arr[v];}
 	const T& operator [] (usize v) const { stl_assert(v<count); return arr[v];}
 
-	void push_back(const T& elem) { stl_assert(count < Size); arr[count++] = v;}
+	void push_back(const T& elem) { stl_assert(count < Size); arr[count++] = elem;}
 	void resize(usize sz) { stl_assert(sz <= Size); count = sz; }
 	usize size() const { return count; }
 	usize capacity() const { return Size; }
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "stl_common.hpp"
+#include "stl_threading.hpp"
+
+#include <deque>
+#include <condition_variable>
+
+// Blocking multi producer / multi consumer queue with a fixed capacity.
+// Push blocks while the queue is full (back pressure), Pop blocks while it is empty.
+// After Close, Push fails and Pop drains the remaining items before failing.
+template<class T>
+class stl_bounded_queue
+{
+public:
+	explicit stl_bounded_queue(usize capacity = 64) : m_capacity(capacity > 0 ? capacity : 1) {}
+
+	bool Push(const T& item)
+	{
+		T copy(item);
+		return Push(std::move(copy));
+	}
+
+	bool Push(T&& item)
+	{
+		std::unique_lock<stl_mutex> lock(m_mtx);
+		m_cvNotFull.wait(lock, [this]() { return m_closed || m_items.size() < m_capacity; });
+		if (m_closed)
+			return false;
+
+		m_items.push_back(std::move(item));
+		lock.unlock();
+		m_cvNotEmpty.notify_one();
+		return true;
+	}
+
+	bool Pop(T& itemOUT)
+	{
+		std::unique_lock<stl_mutex> lock(m_mtx);
+		m_cvNotEmpty.wait(lock, [this]() { return m_closed || !m_items.empty(); });
+		return popLocked(lock, itemOUT);
+	}
+
+	bool TryPop(T& itemOUT)
+	{
+		std::unique_lock<stl_mutex> lock(m_mtx);
+		return popLocked(lock, itemOUT);
+	}
+
+	// wakes all waiting threads, queued items can still be popped
+	void Close()
+	{
+		m_mtx.lock();
+		m_closed = true;
+		m_mtx.unlock();
+		m_cvNotFull.notify_all();
+		m_cvNotEmpty.notify_all();
+	}
+
+	// drops all queued items and reopens the queue
+	void Reset()
+	{
+		m_mtx.lock();
+		m_items.clear();
+		m_closed = false;
+		m_mtx.unlock();
+	}
+
+	usize Size() const
+	{
+		std::lock_guard<stl_mutex> lock(m_mtx);
+		return m_items.size();
+	}
+
+	bool IsClosed() const
+	{
+		std::lock_guard<stl_mutex> lock(m_mtx);
+		return m_closed;
+	}
+
+	usize GetCapacity() const { return m_capacity; }
+
+private:
+	bool popLocked(std::unique_lock<stl_mutex>& lock, T& itemOUT)
+	{
+		if (m_items.empty())
+			return false;
+
+		itemOUT = std::move(m_items.front());
+		m_items.pop_front();
+		lock.unlock();
+		m_cvNotFull.notify_one();
+		return true;
+	}
+
+	stl_bounded_queue(const stl_bounded_queue& o) = delete;
+	void operator = (const stl_bounded_queue& o) = delete;
+
+private:
+	mutable stl_mutex m_mtx;
+	std::condition_variable m_cvNotFull;
+	std::condition_variable m_cvNotEmpty;
+	std::deque<T> m_items;
+	usize m_capacity;
+	bool m_closed = false;
+};
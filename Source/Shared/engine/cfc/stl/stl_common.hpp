@@ -57,7 +57,8 @@ public:
 #ifdef _DEBUG
 #define stl_assert(x)  { bool assert_cmp_value = (x); if (assert_cmp_value == false) { __debugbreak(); } }
 #else
-#define stl_assert(x) {(x);}
+// NOTE: still evaluated for its side effects, the value is discarded
+#define stl_assert(x) { (void)(x); }
 #endif
 
 #ifndef stl_math_pi
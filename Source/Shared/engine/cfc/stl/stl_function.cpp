@@ -0,0 +1,117 @@
+#include "stl_function.hpp"
+
+#include <mutex>
+
+// pooled block sizes are 64, 128, 256 and 512 bytes, larger callables go to the heap directly
+#define STL_FUNCTION_POOL_CLASS_QUANTITY 4
+#define STL_FUNCTION_POOL_MIN_BLOCK_SIZE 64
+
+// blocks a thread keeps per size class, half of them move to the shared pool when the cache is full
+#define STL_FUNCTION_POOL_CACHE_QUANTITY 64
+
+struct stl_function_block
+{
+	stl_function_block* Next;
+};
+
+static int getBlockClass(usize size)
+{
+	usize blockSize = STL_FUNCTION_POOL_MIN_BLOCK_SIZE;
+	for (int i = 0; i < STL_FUNCTION_POOL_CLASS_QUANTITY; ++i, blockSize *= 2)
+	{
+		if (size <= blockSize)
+			return i;
+	}
+	return -1;
+}
+
+// NOTE: blocks are usually allocated by the thread that submits a function and freed by the one that executed it, the shared
+// pool hands the blocks back in batches so a producer does not have to go to the heap every time
+static std::mutex g_functionPoolLock;
+static stl_function_block* g_functionPool[STL_FUNCTION_POOL_CLASS_QUANTITY] = {};
+
+// NOTE: trivially destructible so it can still be read while the thread exits, after the cache itself was destroyed
+static thread_local bool g_functionCacheReleased = false;
+
+struct stl_function_cache
+{
+	~stl_function_cache()
+	{
+		// functions destroyed after this point (statics of other translation units) bypass the cache
+		g_functionCacheReleased = true;
+
+		std::lock_guard<std::mutex> lock(g_functionPoolLock);
+		for (int i = 0; i < STL_FUNCTION_POOL_CLASS_QUANTITY; ++i)
+		{
+			while (FreeList[i] != nullptr)
+			{
+				stl_function_block* block = FreeList[i];
+				FreeList[i] = block->Next;
+				block->Next = g_functionPool[i];
+				g_functionPool[i] = block;
+			}
+		}
+	}
+
+	stl_function_block* FreeList[STL_FUNCTION_POOL_CLASS_QUANTITY] = {};
+	u32 NumFree[STL_FUNCTION_POOL_CLASS_QUANTITY] = {};
+};
+
+static thread_local stl_function_cache g_functionCache;
+
+void* stl_function_allocate(usize size)
+{
+	const int blockClass = getBlockClass(size);
+	if (blockClass < 0 || g_functionCacheReleased)
+		return ::operator new(size);
+
+	stl_function_cache& cache = g_functionCache;
+	if (cache.FreeList[blockClass] == nullptr)
+	{
+		// refill with everything the shared pool has of this size
+		std::lock_guard<std::mutex> lock(g_functionPoolLock);
+		cache.FreeList[blockClass] = g_functionPool[blockClass];
+		g_functionPool[blockClass] = nullptr;
+		for (stl_function_block* block = cache.FreeList[blockClass]; block != nullptr; block = block->Next)
+			cache.NumFree[blockClass]++;
+	}
+
+	stl_function_block* block = cache.FreeList[blockClass];
+	if (block == nullptr)
+		return ::operator new((usize)STL_FUNCTION_POOL_MIN_BLOCK_SIZE << blockClass);
+
+	cache.FreeList[blockClass] = block->Next;
+	cache.NumFree[blockClass]--;
+	return block;
+}
+
+void stl_function_free(void* ptr, usize size)
+{
+	const int blockClass = getBlockClass(size);
+	if (blockClass < 0 || g_functionCacheReleased)
+	{
+		::operator delete(ptr);
+		return;
+	}
+
+	stl_function_cache& cache = g_functionCache;
+	stl_function_block* block = static_cast<stl_function_block*>(ptr);
+	block->Next = cache.FreeList[blockClass];
+	cache.FreeList[blockClass] = block;
+	cache.NumFree[blockClass]++;
+
+	if (cache.NumFree[blockClass] < STL_FUNCTION_POOL_CACHE_QUANTITY)
+		return;
+
+	// the cache is full, hand half of it to the shared pool
+	stl_function_block* first = cache.FreeList[blockClass];
+	stl_function_block* last = first;
+	for (u32 i = 1; i < STL_FUNCTION_POOL_CACHE_QUANTITY / 2; ++i)
+		last = last->Next;
+	cache.FreeList[blockClass] = last->Next;
+	cache.NumFree[blockClass] -= STL_FUNCTION_POOL_CACHE_QUANTITY / 2;
+
+	std::lock_guard<std::mutex> lock(g_functionPoolLock);
+	last->Next = g_functionPool[blockClass];
+	g_functionPool[blockClass] = first;
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "stl_common.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// blocks for callables that do not fit inline, small blocks are recycled through a cache per thread
+STL_API void* stl_function_allocate(usize size);
+STL_API void stl_function_free(void* ptr, usize size);
+
+template <class Signature, usize InlineSize = 32> class stl_function;
+
+// Move-only function wrapper, the callable is stored inline when it fits in InlineSize bytes and in a pooled heap block
+// otherwise, a capture that grows never fails to compile. Callables that are trivially copyable (captures of pointers,
+// references and plain values) are moved with a memcpy and have nothing to destroy.
+// NOTE: calling an empty function is a no-op that returns R()
+template <class R, class... Args, usize InlineSize>
+class stl_function<R(Args...), InlineSize>
+{
+public:
+	typedef stl_function SelfType;
+
+	stl_function() : m_ops(nullptr) {}
+	stl_function(std::nullptr_t) : m_ops(nullptr) {}
+	template <class T, class = typename std::enable_if<!std::is_same<typename std::decay<T>::type, SelfType>::value>::type> stl_function(T&& func) : m_ops(nullptr) { Set(std::forward<T>(func)); }
+	stl_function(SelfType&& o) noexcept : m_ops(nullptr) { moveFrom(o); }
+	~stl_function() { Reset(); }
+
+	SelfType& operator = (SelfType&& o) noexcept { if (this != &o) { Reset(); moveFrom(o); } return *this; }
+	SelfType& operator = (std::nullptr_t) { Reset(); return *this; }
+	template <class T, class = typename std::enable_if<!std::is_same<typename std::decay<T>::type, SelfType>::value>::type> SelfType& operator = (T&& func) { Set(std::forward<T>(func)); return *this; }
+
+	stl_function(const SelfType& o) = delete;
+	SelfType& operator = (const SelfType& o) = delete;
+
+	R operator ()(Args... args) const
+	{
+		if (m_ops == nullptr)
+			return R();
+		return m_ops->Invoke(const_cast<void*>(static_cast<const void*>(&m_storage)), std::forward<Args>(args)...);
+	}
+
+	explicit operator bool() const { return m_ops != nullptr; }
+	bool IsEmpty() const { return m_ops == nullptr; }
+	// true when the callable lives in a heap block
+	bool IsHeapAllocated() const { return m_ops != nullptr && m_ops->Heap; }
+
+	template <class T> void Set(T&& func)
+	{
+		typedef typename std::decay<T>::type F;
+		Reset();
+
+		void* storage = &m_storage;
+		if (fitsInline<F>::value)
+		{
+			::new (storage) F(std::forward<T>(func));
+			m_ops = &inline_ops<F>::Ops;
+		}
+		else
+		{
+			static_assert(alignof(F) <= alignof(std::max_align_t), "over aligned callables are not supported");
+			*static_cast<F**>(storage) = ::new (stl_function_allocate(sizeof(F))) F(std::forward<T>(func));
+			m_ops = &heap_ops<F>::Ops;
+		}
+	}
+
+	void Reset()
+	{
+		if (m_ops != nullptr && m_ops->Destroy != nullptr)
+			m_ops->Destroy(&m_storage);
+		m_ops = nullptr;
+	}
+
+private:
+	static_assert(InlineSize >= sizeof(void*), "the inline buffer holds the pointer to a heap block");
+
+	struct ops
+	{
+		R (*Invoke)(void* storage, Args&&... args);
+		void (*Relocate)(void* dst, void* src);				// nullptr: the storage is moved with a memcpy
+		void (*Destroy)(void* storage);						// nullptr: nothing to destroy
+		bool Heap;
+	};
+
+	template <class F> struct fitsInline
+	{
+		static const bool value = sizeof(F) <= InlineSize && alignof(F) <= alignof(std::max_align_t);
+	};
+
+	// trivially copyable callables are relocated by copying their bytes
+	template <class F> struct inline_ops
+	{
+		static const bool trivial = std::is_trivially_copyable<F>::value && std::is_trivially_destructible<F>::value;
+
+		static R Invoke(void* storage, Args&&... args) { return (*static_cast<F*>(storage))(std::forward<Args>(args)...); }
+		static void Relocate(void* dst, void* src) { F* f = static_cast<F*>(src); ::new (dst) F(std::move(*f)); f->~F(); }
+		static void Destroy(void* storage) { static_cast<F*>(storage)->~F(); }
+
+		static const ops Ops;
+	};
+
+	// the storage holds a pointer to the block, moving it is a memcpy regardless of the callable
+	template <class F> struct heap_ops
+	{
+		static R Invoke(void* storage, Args&&... args) { return (**static_cast<F**>(storage))(std::forward<Args>(args)...); }
+		static void Destroy(void* storage) { F* f = *static_cast<F**>(storage); f->~F(); stl_function_free(f, sizeof(F)); }
+
+		static const ops Ops;
+	};
+
+	void moveFrom(SelfType& o)
+	{
+		if (o.m_ops == nullptr)
+			return;
+
+		if (o.m_ops->Relocate == nullptr)
+			memcpy(&m_storage, &o.m_storage, sizeof(m_storage));
+		else
+			o.m_ops->Relocate(&m_storage, &o.m_storage);
+		m_ops = o.m_ops;
+		o.m_ops = nullptr;
+	}
+
+	const ops* m_ops;
+	typename std::aligned_storage<InlineSize, alignof(std::max_align_t)>::type m_storage;
+};
+
+template <class R, class... Args, usize InlineSize>
+template <class F>
+const typename stl_function<R(Args...), InlineSize>::ops stl_function<R(Args...), InlineSize>::inline_ops<F>::Ops =
+{
+	&inline_ops<F>::Invoke,
+	inline_ops<F>::trivial ? nullptr : &inline_ops<F>::Relocate,
+	inline_ops<F>::trivial ? nullptr : &inline_ops<F>::Destroy,
+	false
+};
+
+template <class R, class... Args, usize InlineSize>
+template <class F>
+const typename stl_function<R(Args...), InlineSize>::ops stl_function<R(Args...), InlineSize>::heap_ops<F>::Ops =
+{
+	&heap_ops<F>::Invoke,
+	nullptr,
+	&heap_ops<F>::Destroy,
+	true
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utility>
+
 template <class T>
 class stl_node
 {
@@ -10,6 +12,7 @@ public:
 	stl_node(const stl_node& o) : m_data(o.m_data), m_next(nullptr), m_prev(nullptr) { ((stl_node&)o).add(*this); }
 	stl_node& operator = (const stl_node& o) { m_data = o.m_data; ((stl_node&)o).add(*this); return *this; }
 	stl_node& operator = (const T& o) { m_data = o; return *this; }
+	stl_node& operator = (T&& o) { m_data = std::move(o); return *this; }
 	operator T&() { return m_data; }
 	operator const T&() const { return m_data; }
 
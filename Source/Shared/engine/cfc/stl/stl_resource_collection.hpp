@@ -1,48 +1,170 @@
 #pragma once
 
 #include "stl_common.hpp"
-#include "stl_vector.hpp"
 
-#include <concurrent_vector.h>
+#include <atomic>
 
-template <class T, class Lock=stl_no_mutex, class Key = usize>
+// slots are allocated in chunks that never move, an index stays valid until erased
+#define STL_RESOURCE_COLLECTION_CHUNK_SIZE 256
+#define STL_RESOURCE_COLLECTION_MAX_CHUNKS 2048
+
+// Slot map that can be used from multiple threads without locking: insert and erase go through a lock-free free list,
+// new slots are appended with an atomic counter and the chunk that holds them is installed with a compare exchange.
+// Every slot has a generation that is incremented on insert and erase (odd while the slot is in use), with it a stale
+// index can be detected.
+// NOTE: a slot that is erased while another thread still accesses it is a race, as with any container
+template <class T>
 class stl_resource_collection
 {
 public:
-	usize insert() 
-	{ 
-		m_lock.lock();
-		if (m_freelist.empty())
-		{			
-			m_lock.unlock();
-
-			// return new object
-			auto it = m_objects.push_back(T());
-			return it-m_objects.begin();
+	// NOTE: the chunk table lives on the heap, collections are embedded in pimpl buffers of a fixed size
+	stl_resource_collection() : m_chunks(new std::atomic<slot*>[STL_RESOURCE_COLLECTION_MAX_CHUNKS]), m_freeHead(packFreeHead(invalid_slot, 0)), m_size(0)
+	{
+		for (u32 i = 0; i < STL_RESOURCE_COLLECTION_MAX_CHUNKS; ++i)
+			m_chunks[i].store(nullptr, std::memory_order_relaxed);
+	}
+	~stl_resource_collection()
+	{
+		for (u32 i = 0; i < STL_RESOURCE_COLLECTION_MAX_CHUNKS; ++i)
+			delete[] m_chunks[i].load(std::memory_order_relaxed);
+		delete[] m_chunks;
+	}
+
+	usize insert()
+	{
+		u32 index = popFree();
+		if (index == invalid_slot)
+		{
+			// free list is empty, append
+			index = m_size.fetch_add(1, std::memory_order_relaxed);
+			stl_assert(index < STL_RESOURCE_COLLECTION_CHUNK_SIZE * STL_RESOURCE_COLLECTION_MAX_CHUNKS);
+			ensureChunk(index / STL_RESOURCE_COLLECTION_CHUNK_SIZE);
 		}
 
-		// return from freelist
-		Key idx = m_freelist.back();
-		m_freelist.pop_back();
-		m_lock.unlock();
-		return idx;
+		slot& s = getSlot(index);
+#ifdef _DEBUG
+		stl_assert((s.Generation.load(std::memory_order_relaxed) & 1) == 0);
+#endif
+		s.Generation.fetch_add(1, std::memory_order_release);
+		return index;
 	}
 	void erase(usize index)
 	{
-		stl_assert(index < m_objects.size());
-		m_objects[index] = T();
-		m_lock.lock();
-		m_freelist.push_back(index);
-		m_lock.unlock();
+		slot& s = getSlot(index);
+#ifdef _DEBUG
+		stl_assert(isAlive(s));
+#endif
+
+		s.Value = T();
+		s.Generation.fetch_add(1, std::memory_order_release);
+		pushFree((u32)index);
 	}
 
-	T& operator [] (usize index) { stl_assert(index < m_objects.size()); return m_objects[index]; }
-	const T& operator [] (usize index) const { stl_assert(index < m_objects.size()); return m_objects[index]; }
+	// generation of the slot at the time of the call, compare it later with is_current to detect an erase (and reuse)
+	u32 get_generation(usize index) const { return getSlot(index).Generation.load(std::memory_order_acquire); }
+	bool is_current(usize index, u32 generation) const
+	{
+		if (index >= m_size.load(std::memory_order_acquire))
+			return false;
+		// appended by another thread that did not install the chunk yet
+		const slot* chunk = m_chunks[index / STL_RESOURCE_COLLECTION_CHUNK_SIZE].load(std::memory_order_acquire);
+		if (chunk == nullptr)
+			return false;
+		const u32 current = chunk[index % STL_RESOURCE_COLLECTION_CHUNK_SIZE].Generation.load(std::memory_order_acquire);
+		return current == generation && (current & 1) != 0;
+	}
+
+	T& operator [] (usize index)
+	{
+		slot& s = getSlot(index);
+#ifdef _DEBUG
+		stl_assert(isAlive(s));
+#endif
+		return s.Value;
+	}
+	const T& operator [] (usize index) const
+	{
+		const slot& s = getSlot(index);
+#ifdef _DEBUG
+		stl_assert(isAlive(s));
+#endif
+		return s.Value;
+	}
+
+	// slots ever appended, including erased ones
+	usize size() const { return m_size.load(std::memory_order_acquire); }
 
-	auto begin() { return m_objects.begin(); }
-	auto end()  { return m_objects.end(); }
 protected:
-	Lock m_lock;
-	concurrency::concurrent_vector<T> m_objects;
-	stl_vector<Key> m_freelist;
-};
\ No newline at end of file
+	stl_resource_collection(const stl_resource_collection& o) {}
+	void operator = (const stl_resource_collection& o) {}
+
+private:
+	static const u32 invalid_slot = 0xFFFFFFFF;
+
+	struct slot
+	{
+		T Value;
+		std::atomic<u32> Generation { 0 };
+		std::atomic<u32> NextFree { invalid_slot };
+	};
+
+	// free list head is an index with a tag in the upper half, the tag changes on every pop so a head that was popped
+	// and pushed again in between (ABA) fails the compare exchange
+	static u64 packFreeHead(u32 index, u32 tag) { return ((u64)tag << 32) | index; }
+	static u32 freeHeadIndex(u64 head) { return (u32)head; }
+	static u32 freeHeadTag(u64 head) { return (u32)(head >> 32); }
+
+	static bool isAlive(const slot& s) { return (s.Generation.load(std::memory_order_relaxed) & 1) != 0; }
+
+	// NOTE: the validation loads atomics, release builds skip it (stl_assert still evaluates its argument there)
+	slot& getSlot(usize index) const
+	{
+#ifdef _DEBUG
+		stl_assert(index < m_size.load(std::memory_order_relaxed));
+#endif
+		slot* chunk = m_chunks[index / STL_RESOURCE_COLLECTION_CHUNK_SIZE].load(std::memory_order_acquire);
+		return chunk[index % STL_RESOURCE_COLLECTION_CHUNK_SIZE];
+	}
+
+	void ensureChunk(u32 chunkIndex)
+	{
+		if (m_chunks[chunkIndex].load(std::memory_order_acquire) != nullptr)
+			return;
+
+		// several threads can append into a new chunk at once, one of them installs it
+		slot* chunk = new slot[STL_RESOURCE_COLLECTION_CHUNK_SIZE];
+		slot* expected = nullptr;
+		if (!m_chunks[chunkIndex].compare_exchange_strong(expected, chunk, std::memory_order_acq_rel, std::memory_order_acquire))
+			delete[] chunk;
+	}
+
+	u32 popFree()
+	{
+		u64 head = m_freeHead.load(std::memory_order_acquire);
+		for (;;)
+		{
+			const u32 index = freeHeadIndex(head);
+			if (index == invalid_slot)
+				return invalid_slot;
+
+			// NOTE: the slot can be popped by another thread in the meantime, the read is harmless because the tag makes the exchange fail
+			const u32 next = getSlot(index).NextFree.load(std::memory_order_relaxed);
+			if (m_freeHead.compare_exchange_weak(head, packFreeHead(next, freeHeadTag(head) + 1), std::memory_order_acquire, std::memory_order_acquire))
+				return index;
+		}
+	}
+
+	void pushFree(u32 index)
+	{
+		slot& s = getSlot(index);
+		u64 head = m_freeHead.load(std::memory_order_relaxed);
+		do
+		{
+			s.NextFree.store(freeHeadIndex(head), std::memory_order_relaxed);
+		} while (!m_freeHead.compare_exchange_weak(head, packFreeHead(index, freeHeadTag(head)), std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	std::atomic<slot*>* m_chunks;
+	std::atomic<u64> m_freeHead;
+	std::atomic<u32> m_size;
+};
@@ -1,8 +1,10 @@
 #include "stl_string_advanced.hpp"
 #include "stl_unique_ptr.hpp"
+#include <cfc/core/frame_allocator.h>
 #include <dependencies/utf8dec.h>
 
 #include <stdarg.h>  // For va_start, etc.
+#include <string.h>
 
 int stl_string_advanced::split_array(const stl_string& target, const char* seperator, stl_string* outArray, int outArrayMaxSize)
 {
@@ -18,28 +20,28 @@ int stl_string_advanced::split_array(const stl_string& target, const char* seper
 }
 
 stl_string stl_string_advanced::sprintf(const stl_string fmt_str, ...) {
-	int final_n, n = ((int)fmt_str.size()) * 2; /* Reserve two times as much as the length of the fmt_str */
-	stl_string str;
-	stl_unique_ptr<char[]> formatted;
+	// most strings fit on the stack, longer ones are formatted once more into the frame allocator of this thread
+	char stackBuffer[256];
 	va_list ap;
-	while (1) {
-		formatted.reset(new char[n]); /* Wrap the plain char array into the unique_ptr */
-		strcpy(&formatted[0], fmt_str.c_str());
-		va_start(ap, fmt_str);
-		final_n = vsnprintf(&formatted[0], n, fmt_str.c_str(), ap);
-		va_end(ap);
-		if (final_n < 0 || final_n >= n)
-			n += abs(final_n - n + 1);
-		else
-			break;
-	}
-	return stl_string(formatted.get());
+	va_start(ap, fmt_str);
+	const int n = vsnprintf(stackBuffer, sizeof(stackBuffer), fmt_str.c_str(), ap);
+	va_end(ap);
+	if (n < 0)
+		return stl_string();
+	if (n < (int)sizeof(stackBuffer))
+		return stl_string(stackBuffer, n);
+
+	cfc::frame_allocator_scope transientScope;
+	char* formatted = (char*)cfc::frame_allocator::GetThreadAllocator().Allocate(n + 1, 1);
+	va_start(ap, fmt_str);
+	vsnprintf(formatted, n + 1, fmt_str.c_str(), ap);
+	va_end(ap);
+	return stl_string(formatted, n);
 }
 
 stl_string stl_string_advanced::replace(const stl_string& target, const stl_string& find, const stl_string& replaceBy)
 {
 	size_t findLength = find.size();
-	size_t replaceByLength = replaceBy.size();
 	const char* c = target.c_str();
 	const char* cEnd = target.c_str() + target.size();
 	const char* cFind = find.c_str();
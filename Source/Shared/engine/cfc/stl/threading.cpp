@@ -1,6 +1,7 @@
 #define CFC_CONF_CPP11_THREADING
 
 #include "threading.h"
+#include "stl_concurrentqueue.hpp"
 #include <vector>
 
 // CPP11 includes
@@ -114,25 +115,50 @@ void spinlock::Unlock()
 #pragma endregion
 #pragma region Invoker
 
+// functions are dequeued in batches of this size, the batch lives on the stack of the consumer
+#define CFC_INVOKER_BATCH_SIZE 64
+
 class _imp_invoker
 {
 public:
 	struct fpObject
 	{
-		stl_lambda0<> func;
+		stl_function<void()> func;
 	};
 
-	mutex m_invokeLock;
-	std::vector<fpObject> m_queue;
-	std::vector<fpObject> m_queueBack;
-	int m_queueBackIndex;
+	_imp_invoker() : m_consumerToken(m_queue) {}
+
+	// NOTE: every producer thread gets its own sub queue, producers do not contend with each other
+	stl_concurrentqueue<fpObject> m_queue;
+	moodycamel::ConsumerToken m_consumerToken;
+
+	u32 Execute(usize maxQuantity)
+	{
+		fpObject batch[CFC_INVOKER_BATCH_SIZE];
+
+		usize numExecuted = 0;
+		while (numExecuted < maxQuantity)
+		{
+			const usize numRequested = maxQuantity - numExecuted < CFC_INVOKER_BATCH_SIZE ? maxQuantity - numExecuted : CFC_INVOKER_BATCH_SIZE;
+			const usize numDequeued = m_queue.try_dequeue_bulk(m_consumerToken, batch, numRequested);
+			if (numDequeued == 0)
+				break;
+
+			for (usize i = 0; i < numDequeued; ++i)
+			{
+				batch[i].func();
+				batch[i].func = nullptr;
+			}
+			numExecuted += numDequeued;
+		}
+		return (u32)numExecuted;
+	}
 };
 
 
 invoker::invoker()
 {
 	m_impl = new _imp_invoker();
-	m_impl->m_queueBackIndex = 0;
 }
 
 invoker::~invoker()
@@ -140,65 +166,41 @@ invoker::~invoker()
 	delete m_impl;
 }
 
-void invoker::Add(const stl_lambda0<>& func)
+void invoker::Add(stl_function<void()> func)
 {
-	_imp_invoker::fpObject obj = { func };
-	m_impl->m_invokeLock.Lock();
-	m_impl->m_queue.push_back(obj);
-	m_impl->m_invokeLock.Unlock();
+	_imp_invoker::fpObject obj;
+	obj.func = std::move(func);
+	m_impl->m_queue.enqueue(std::move(obj));
 }
 
 void invoker::ExecuteAll()
 {
-	// fetch data
-	if (m_impl->m_queue.size() == 0)
+	// NOTE: bounded by the size at the start, a function that re-adds itself would otherwise never return
+	const usize numQueued = m_impl->m_queue.size_approx();
+	if (numQueued == 0)
 		return;
 
-	std::vector<_imp_invoker::fpObject> queueSelf;
-	m_impl->m_invokeLock.Lock();
-	m_impl->m_queue.swap(queueSelf);
-	m_impl->m_invokeLock.Unlock();
-
-	for (auto it : queueSelf)
-	{
-		it.func();
-	}
-
+	m_impl->Execute(numQueued);
 }
 
-
-void invoker::ExecuteOne()
+bool invoker::ExecuteOne()
 {
-	// early out
-	if (m_impl->m_queue.size() == 0)
-		return;
-
-	_imp_invoker::fpObject obj;
-	{
-		scopedlock<mutex> invokeLock(m_impl->m_invokeLock);
-
-		// another time, this time safely
-		if (m_impl->m_queue.size() == 0)
-			return;
-
-		obj = m_impl->m_queue.front();
-
-		// TODO: erasing first element in a std::vector is very inefficient when there are a large quantity of objects in the vector - change container type when this becomes a problem
-		m_impl->m_queue.erase(m_impl->m_queue.begin());
-	}
-
-	obj.func();
+	return m_impl->Execute(1) == 1;
+}
 
+u32 invoker::ExecuteBatch(u32 maxQuantity)
+{
+	return m_impl->Execute(maxQuantity);
 }
 
 
 #pragma endregion
 #pragma region Thread
 
-void thread::CreateThreadDetached(const stl_lambda0<>& func)
+void thread::CreateThreadDetached(stl_function<void()> func)
 {
 #ifdef CFC_CONF_CPP11_THREADING
-	std::thread th([func]() { func(); });
+	std::thread th(std::move(func));
 	th.detach();
 #else 
 #error threading not implemented for this compiler
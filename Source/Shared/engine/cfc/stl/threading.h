@@ -1,7 +1,7 @@
 #pragma once
 
 #include <cfc/base.h>
-#include "stl_lambda0.hpp"
+#include "stl_function.hpp"
 
 CFC_NAMESPACE3(cfc, core, threading)
 
@@ -10,15 +10,19 @@ class _imp_kernelsemaphore;									// kernelsemaphore and lightsemaphore are ba
 class _imp_lightsemaphore;
 class _imp_benaphore;
 
+// queue of functions posted by any thread and executed by a single consumer thread (lock-free, multiple producer single consumer)
 class CFC_API invoker
 {
 public:
 	invoker();
 	~invoker();
 
+	// executes the functions that were queued when the call started, functions added while executing run on the next call
 	void ExecuteAll();
-	void ExecuteOne();
-	void Add(const stl_lambda0<>& func);
+	bool ExecuteOne();
+	// executes at most maxQuantity functions, returns the quantity executed
+	u32 ExecuteBatch(u32 maxQuantity);
+	void Add(stl_function<void()> func);
 protected:
 	_imp_invoker *m_impl;
 };
@@ -58,7 +62,7 @@ protected:
 class CFC_API thread
 {
 public:
-	static void CreateThreadDetached(const stl_lambda0<>& func);
+	static void CreateThreadDetached(stl_function<void()> func);
 	static unsigned int GetHardwareThreadCount();
 	static size_t GetCurrentThreadID();
 };
@@ -0,0 +1,140 @@
+// Packs a content directory into an archive that io_archive reads in place.
+//
+//   CFC.Tool.Archive <content directory> <archive> [--alignment <bytes>] [--store]
+//
+// Paths in the archive are relative to the content directory, the app runs from that directory and finds them by the
+// same relative paths. Archives (CFC_ARCHIVE_EXTENSION) inside the directory are skipped.
+
+#ifdef _WIN32
+#include <cfc/platform/platform_win32.hpp>
+#else
+#include <cfc/platform/platform_linux.hpp>
+#include <dirent.h>
+#endif
+
+#include <cfc/core/io_archive.h>
+#include <cfc/stl/stl_string.hpp>
+#include <cfc/stl/stl_vector.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+typedef cfc::platform::win32::io platform_io;
+#else
+typedef cfc::platform::linux::io platform_io;
+#endif
+
+static bool hasExtension(const stl_string& path, const char* extension)
+{
+	const usize length = strlen(extension);
+	return path.size() >= length && path.compare(path.size() - length, length, extension) == 0;
+}
+
+// relative paths of all files below root, directories are separated by '/'
+static void collectFiles(const stl_string& root, const stl_string& relative, stl_vector<stl_string>& filesOUT)
+{
+#ifdef _WIN32
+	WIN32_FIND_DATAA findData;
+	HANDLE find = FindFirstFileA((root + relative + "*").c_str(), &findData);
+	if (find == INVALID_HANDLE_VALUE)
+		return;
+	do
+	{
+		const stl_string name = findData.cFileName;
+		if (name == "." || name == "..")
+			continue;
+		if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			collectFiles(root, relative + name + "/", filesOUT);
+		else
+			filesOUT.push_back(relative + name);
+	} while (FindNextFileA(find, &findData));
+	FindClose(find);
+#else
+	DIR* dir = opendir((root + relative).c_str());
+	if (dir == nullptr)
+		return;
+	while (dirent* dirEntry = readdir(dir))
+	{
+		const stl_string name = dirEntry->d_name;
+		if (name == "." || name == "..")
+			continue;
+
+		struct stat st;
+		if (stat((root + relative + name).c_str(), &st) != 0)
+			continue;
+		if (S_ISDIR(st.st_mode))
+			collectFiles(root, relative + name + "/", filesOUT);
+		else if (S_ISREG(st.st_mode))
+			filesOUT.push_back(relative + name);
+	}
+	closedir(dir);
+#endif
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		printf("usage: %s <content directory> <archive> [--alignment <bytes>] [--store]\n", argv[0]);
+		return 1;
+	}
+
+	u32 alignment = CFC_ARCHIVE_DEFAULT_ALIGNMENT;
+	bool compress = true;
+	for (int i = 3; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--alignment") == 0 && i + 1 < argc)
+			alignment = (u32)strtoul(argv[++i], nullptr, 0);
+		else if (strcmp(argv[i], "--store") == 0)
+			compress = false;
+		else
+		{
+			printf("unknown option %s\n", argv[i]);
+			return 1;
+		}
+	}
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+	{
+		printf("alignment %u is not a power of two\n", alignment);
+		return 1;
+	}
+
+	stl_string root = argv[1];
+	if (!root.empty() && root.back() != '/' && root.back() != '\\')
+		root += "/";
+
+	stl_vector<stl_string> files;
+	collectFiles(root, "", files);
+
+	platform_io platformIO;
+	cfc::io& fileIO = platformIO;
+	cfc::io_archive_builder builder(alignment, compress);
+	for (usize i = 0; i < files.size(); ++i)
+	{
+		if (hasExtension(files[i], CFC_ARCHIVE_EXTENSION))
+			continue;
+
+		cfc::iobuffer file = fileIO.ReadFileToMemory((root + files[i]).c_str());
+		if (!file)
+		{
+			printf("could not read %s\n", files[i].c_str());
+			return 1;
+		}
+		if (!builder.AddFile(files[i].c_str(), file.data, file.size))
+		{
+			printf("could not add %s\n", files[i].c_str());
+			return 1;
+		}
+	}
+
+	if (!builder.Write(fileIO, argv[2]))
+	{
+		printf("could not write %s\n", argv[2]);
+		return 1;
+	}
+
+	printf("%s: %u files, %.2f MB, %.2f MB stored\n", argv[2], (u32)builder.GetFileQuantity(), builder.GetSize() / (1024.0 * 1024.0), builder.GetStoredSize() / (1024.0 * 1024.0));
+	return 0;
+}
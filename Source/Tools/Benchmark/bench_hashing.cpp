@@ -0,0 +1,86 @@
+#include "benchmark.h"
+
+#include <cfc/core/hashing.h>
+#include <cfc/stl/stl_vector.hpp>
+
+#include <dependencies/stb/stb_hash.h>
+
+#include <stdio.h>
+
+#define BENCHMARK_HASHING_RUNS 5
+#define BENCHMARK_HASHING_BYTES_PER_RUN (64u << 20)
+
+void benchmarkHashing()
+{
+#if defined(__AVX2__)
+	printf("accumulate path: avx2\n");
+#elif defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+	printf("accumulate path: sse2\n");
+#else
+	printf("accumulate path: scalar\n");
+#endif
+
+	stl_vector<u8> data(16u << 20);
+	u32 seed = 1234;
+	for (usize i = 0; i < data.size(); ++i)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		data[i] = (u8)(seed >> 24);
+	}
+
+	// every size hashes the same amount of data per run, so small keys measure the per call overhead
+	const usize sizes[] = { 16, 64, 256, 4096, 1u << 20, 16u << 20 };
+	printf("%-10s %-20s %10s %10s\n", "bytes", "function", "ns/call", "GB/s");
+	for (u32 s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+	{
+		const usize size = sizes[s];
+		const usize calls = BENCHMARK_HASHING_BYTES_PER_RUN / size;
+
+		const double hash64Ms = benchmarkBestOf(BENCHMARK_HASHING_RUNS, [&]()
+		{
+			u64 h = 0;
+			for (usize i = 0; i < calls; ++i)
+				h += cfc::Hash64(&data[(i * 64) % (data.size() - size + 1)], size, i);
+			g_benchmarkSink += h;
+		});
+
+		const double streamMs = benchmarkBestOf(BENCHMARK_HASHING_RUNS, [&]()
+		{
+			// fed in 4 KB pieces like a file read loop
+			u64 h = 0;
+			for (usize i = 0; i < calls; ++i)
+			{
+				const u8* src = &data[(i * 64) % (data.size() - size + 1)];
+				cfc::hash_stream stream(i);
+				for (usize offset = 0; offset < size; offset += 4096)
+					stream.Update(src + offset, size - offset < 4096 ? size - offset : 4096);
+				h += stream.Finalize();
+			}
+			g_benchmarkSink += h;
+		});
+
+		const double crcMs = benchmarkBestOf(BENCHMARK_HASHING_RUNS, [&]()
+		{
+			u64 h = 0;
+			for (usize i = 0; i < calls; ++i)
+				h += stb::crc64(&data[(i * 64) % (data.size() - size + 1)], size);
+			g_benchmarkSink += h;
+		});
+
+		const double gigabytes = (double)(calls * size) / 1e9;
+		printf("%-10u %-20s %10.1f %10.2f\n", (u32)size, "Hash64", hash64Ms * 1e6 / calls, gigabytes / (hash64Ms / 1000.0));
+		printf("%-10u %-20s %10.1f %10.2f\n", (u32)size, "hash_stream", streamMs * 1e6 / calls, gigabytes / (streamMs / 1000.0));
+		printf("%-10u %-20s %10.1f %10.2f\n", (u32)size, "stb::crc64", crcMs * 1e6 / calls, gigabytes / (crcMs / 1000.0));
+	}
+
+	const char* names[] = { "albedo", "Textures/sponza_curtain_diff.png", "scene.cull.frustum" };
+	const u32 nameCalls = 1000000;
+	const double nameMs = benchmarkBestOf(BENCHMARK_HASHING_RUNS, [&]()
+	{
+		u64 h = 0;
+		for (u32 i = 0; i < nameCalls; ++i)
+			h += cfc::HashName(names[i % 3]);
+		g_benchmarkSink += h;
+	});
+	printf("HashName (6-32 chars): %.1f ns/call\n", nameMs * 1e6 / nameCalls);
+}
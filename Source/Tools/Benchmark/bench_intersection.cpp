@@ -0,0 +1,194 @@
+#include "benchmark.h"
+
+#include <cfc/math/math_intersection.h>
+#include <cfc/stl/stl_vector.hpp>
+
+#include <math.h>
+#include <stdio.h>
+
+#define BENCHMARK_INTERSECTION_RUNS 5
+#define BENCHMARK_INTERSECTION_BOXES 4096
+#define BENCHMARK_INTERSECTION_RAYS 1024
+#define BENCHMARK_INTERSECTION_TRIANGLES 4096
+
+using namespace cfc::math;
+using namespace cfc::math::intersection;
+
+static point makePoint(float x, float y, float z)
+{
+	point p;
+	p.x = x; p.y = y; p.z = z;
+	return p;
+}
+
+static point randomPoint(u32& seed, float range)
+{
+	return makePoint(benchmarkRandom(seed, range), benchmarkRandom(seed, range), benchmarkRandom(seed, range));
+}
+
+// Mrays/s of IntersectClosest over rays, a packet of F::Width rays at a time
+template <class F>
+static double closestRaysPerSecond(const bvh& tree, const stl_vector<ray>& rays)
+{
+	const double ms = benchmarkBestOf(BENCHMARK_INTERSECTION_RUNS, [&]()
+	{
+		for (usize i = 0; i < rays.size(); i += F::Width)
+		{
+			ray_packet<F> packet = ray_packet<F>::Load(&rays[i]);
+			usize objects[F::Width];
+			tree.IntersectClosest(packet, objects);
+			g_benchmarkSink += objects[0];
+		}
+	});
+	return (double)rays.size() / (ms * 1000.0);
+}
+
+void benchmarkIntersection()
+{
+	printf("backend: %s, %u boxes, %u rays\n", benchmarkSimdBackend(), BENCHMARK_INTERSECTION_BOXES, BENCHMARK_INTERSECTION_RAYS);
+
+	u32 seed = 1234;
+	stl_vector<aabb> boxes(BENCHMARK_INTERSECTION_BOXES);
+	stl_vector<float> bounds[6];
+	for (u32 k = 0; k < 6; ++k)
+		bounds[k].resize(BENCHMARK_INTERSECTION_BOXES);
+	for (u32 i = 0; i < BENCHMARK_INTERSECTION_BOXES; ++i)
+	{
+		const point center = randomPoint(seed, 100.0f);
+		const float size = 1.0f + fabsf(benchmarkRandom(seed, 3.0f));
+		boxes[i].min = makePoint(center.x - size, center.y - size, center.z - size);
+		boxes[i].max = makePoint(center.x + size, center.y + size * 0.5f, center.z + size * 2.0f);
+		for (u32 k = 0; k < 3; ++k)
+		{
+			bounds[k][i] = boxes[i].min.V[k];
+			bounds[3 + k][i] = boxes[i].max.V[k];
+		}
+	}
+	const simd::aabb_arrays boxArrays = { &bounds[0][0], &bounds[1][0], &bounds[2][0], &bounds[3][0], &bounds[4][0], &bounds[5][0] };
+
+	// incoherent: random segments through the scene, coherent: 8 rays from one eye in neighbouring directions
+	stl_vector<ray> rays(BENCHMARK_INTERSECTION_RAYS), coherentRays(BENCHMARK_INTERSECTION_RAYS);
+	for (u32 i = 0; i < BENCHMARK_INTERSECTION_RAYS; ++i)
+	{
+		rays[i].start = randomPoint(seed, 120.0f);
+		rays[i].end = randomPoint(seed, 120.0f);
+	}
+	for (u32 i = 0; i < BENCHMARK_INTERSECTION_RAYS; i += 8)
+	{
+		const point eye = randomPoint(seed, 50.0f);
+		const vector3f direction(benchmarkRandom(seed, 1.0f), benchmarkRandom(seed, 1.0f), benchmarkRandom(seed, 1.0f));
+		for (u32 j = 0; j < 8; ++j)
+		{
+			const vector3f jitter(benchmarkRandom(seed, 0.02f), benchmarkRandom(seed, 0.02f), benchmarkRandom(seed, 0.02f));
+			const vector3f end = eye + (direction + jitter) * 300.0f;
+			coherentRays[i + j].start = eye;
+			coherentRays[i + j].end = makePoint(end.x, end.y, end.z);
+		}
+	}
+
+	// one ray against all boxes, SoA against ray::Intersect
+	stl_vector<float> depths(BENCHMARK_INTERSECTION_BOXES);
+	stl_vector<u8> hits(BENCHMARK_INTERSECTION_BOXES);
+	usize boxMismatches = 0;
+	for (u32 r = 0; r < 64; ++r)
+	{
+		IntersectAABBs(rays[r], boxArrays, &depths[0], &hits[0], BENCHMARK_INTERSECTION_BOXES);
+		for (u32 i = 0; i < BENCHMARK_INTERSECTION_BOXES; ++i)
+		{
+			float depth;
+			boxMismatches += rays[r].Intersect(boxes[i], depth) != (hits[i] != 0) ? 1 : 0;
+		}
+	}
+
+	const u32 numBoxRays = 64;
+	const double soaMs = benchmarkBestOf(BENCHMARK_INTERSECTION_RUNS, [&]()
+	{
+		for (u32 r = 0; r < numBoxRays; ++r)
+			g_benchmarkSink += IntersectAABBs(rays[r], boxArrays, &depths[0], &hits[0], BENCHMARK_INTERSECTION_BOXES);
+	});
+	const double scalarMs = benchmarkBestOf(BENCHMARK_INTERSECTION_RUNS, [&]()
+	{
+		for (u32 r = 0; r < numBoxRays; ++r)
+		{
+			for (u32 i = 0; i < BENCHMARK_INTERSECTION_BOXES; ++i)
+				hits[i] = rays[r].Intersect(boxes[i], depths[i]) ? 1 : 0;
+			g_benchmarkSink += hits[r];
+		}
+	});
+	const double numBoxTests = (double)numBoxRays * BENCHMARK_INTERSECTION_BOXES;
+	printf("ray vs box (%u mismatches)         IntersectAABBs %6.0f M/s, ray::Intersect %6.0f M/s\n", (u32)boxMismatches, numBoxTests / (soaMs * 1000.0), numBoxTests / (scalarMs * 1000.0));
+
+	// packet against a triangle per lane and against one triangle for all lanes
+	stl_vector<float> triangleData[9];
+	for (u32 k = 0; k < 9; ++k)
+		triangleData[k].resize(BENCHMARK_INTERSECTION_TRIANGLES);
+	for (u32 i = 0; i < BENCHMARK_INTERSECTION_TRIANGLES; ++i)
+		for (u32 k = 0; k < 9; ++k)
+			triangleData[k][i] = benchmarkRandom(seed, 10.0f);
+
+	const ray_packet8 trianglePacket = ray_packet8::Load(&rays[0]);
+	const double perLaneMs = benchmarkBestOf(BENCHMARK_INTERSECTION_RUNS, [&]()
+	{
+		u32 numHits = 0;
+		for (u32 i = 0; i < BENCHMARK_INTERSECTION_TRIANGLES; i += 8)
+		{
+			const simd::vec3x8 a = simd::vec3x8::Load(&triangleData[0][i], &triangleData[1][i], &triangleData[2][i]);
+			const simd::vec3x8 b = simd::vec3x8::Load(&triangleData[3][i], &triangleData[4][i], &triangleData[5][i]);
+			const simd::vec3x8 c = simd::vec3x8::Load(&triangleData[6][i], &triangleData[7][i], &triangleData[8][i]);
+			simd::floatx8 depth;
+			numHits += simd::MoveMask(Intersect(trianglePacket, a, b, c, depth));
+		}
+		g_benchmarkSink += numHits;
+	});
+	const double broadcastMs = benchmarkBestOf(BENCHMARK_INTERSECTION_RUNS, [&]()
+	{
+		u32 numHits = 0;
+		for (u32 i = 0; i < BENCHMARK_INTERSECTION_TRIANGLES; ++i)
+		{
+			triangle tri;
+			tri.a = makePoint(triangleData[0][i], triangleData[1][i], triangleData[2][i]);
+			tri.b = makePoint(triangleData[3][i], triangleData[4][i], triangleData[5][i]);
+			tri.c = makePoint(triangleData[6][i], triangleData[7][i], triangleData[8][i]);
+			simd::floatx8 depth;
+			numHits += simd::MoveMask(Intersect(trianglePacket, tri, depth));
+		}
+		g_benchmarkSink += numHits;
+	});
+	const double perLaneTests = (double)BENCHMARK_INTERSECTION_TRIANGLES;
+	const double broadcastTests = (double)BENCHMARK_INTERSECTION_TRIANGLES * 8.0;
+	printf("x8 packet vs triangles             per lane %6.0f M/s, broadcast %6.0f M/s\n", perLaneTests / (perLaneMs * 1000.0), broadcastTests / (broadcastMs * 1000.0));
+
+	// closest object box through the hierarchy against brute force
+	bvh tree;
+	tree.Build(&boxes[0], BENCHMARK_INTERSECTION_BOXES);
+	usize bvhMismatches = 0;
+	for (u32 r = 0; r < 64; r += 8)
+	{
+		ray_packet8 packet = ray_packet8::Load(&rays[r]);
+		usize objects[8];
+		tree.IntersectClosest(packet, objects);
+		float closest[8];
+		packet.TMax.Store(closest);
+		for (u32 j = 0; j < 8; ++j)
+		{
+			float best = 2.0f;
+			usize bestObject = cfc::invalid_index;
+			for (u32 i = 0; i < BENCHMARK_INTERSECTION_BOXES; ++i)
+			{
+				float depth;
+				if (rays[r + j].Intersect(boxes[i], depth) && depth < best)
+				{
+					best = depth;
+					bestObject = i;
+				}
+			}
+			// boxes at the same depth can win either way
+			const bool sameDepth = bestObject != cfc::invalid_index && objects[j] != cfc::invalid_index && fabsf(closest[j] - best) < 1e-5f;
+			bvhMismatches += bestObject != objects[j] && !sameDepth ? 1 : 0;
+		}
+	}
+
+	printf("bvh closest (%u nodes, %u mismatches)\n", (u32)tree.GetNodes().size(), (u32)bvhMismatches);
+	printf("  incoherent rays                  x8 %6.2f, x4 %6.2f, single %6.2f Mrays/s\n", closestRaysPerSecond<simd::floatx8>(tree, rays), closestRaysPerSecond<simd::floatx4>(tree, rays), closestRaysPerSecond<simd::floatx1>(tree, rays));
+	printf("  coherent rays                    x8 %6.2f, x4 %6.2f, single %6.2f Mrays/s\n", closestRaysPerSecond<simd::floatx8>(tree, coherentRays), closestRaysPerSecond<simd::floatx4>(tree, coherentRays), closestRaysPerSecond<simd::floatx1>(tree, coherentRays));
+}
@@ -0,0 +1,188 @@
+#include "benchmark.h"
+
+#include <cfc/math/math.h>
+#include <cfc/math/math_simd.h>
+#include <cfc/stl/stl_vector.hpp>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define BENCHMARK_INVERSE_RUNS 5
+#define BENCHMARK_INVERSE_SAMPLES 10000
+#define BENCHMARK_INVERSE_CALLS 200000
+#define BENCHMARK_INVERSE_BATCH 1027
+#define BENCHMARK_INVERSE_BATCH_REPEATS 200
+
+using namespace cfc::math;
+
+// largest element error relative to the element (absolute below 1)
+static double relativeError(const double* reference, const float* m)
+{
+	double error = 0.0;
+	for (u32 i = 0; i < 16; ++i)
+		error = fmax(error, fabs(reference[i] - m[i]) / fmax(1.0, fabs(reference[i])));
+	return error;
+}
+
+static double relativeError(const float* reference, const float* m)
+{
+	double referenceD[16];
+	for (u32 i = 0; i < 16; ++i)
+		referenceD[i] = reference[i];
+	return relativeError(referenceD, m);
+}
+
+// gauss jordan with partial pivoting in double precision, column major in and out
+static void inverseDouble(const float* m, double* mOUT)
+{
+	double a[4][8];
+	for (u32 r = 0; r < 4; ++r)
+	{
+		for (u32 c = 0; c < 4; ++c)
+		{
+			a[r][c] = m[c * 4 + r];
+			a[r][4 + c] = r == c ? 1.0 : 0.0;
+		}
+	}
+
+	for (u32 c = 0; c < 4; ++c)
+	{
+		u32 pivot = c;
+		for (u32 r = c + 1; r < 4; ++r)
+			pivot = fabs(a[r][c]) > fabs(a[pivot][c]) ? r : pivot;
+		for (u32 k = 0; k < 8; ++k)
+		{
+			const double t = a[c][k];
+			a[c][k] = a[pivot][k];
+			a[pivot][k] = t;
+		}
+
+		const double d = a[c][c];
+		for (u32 k = 0; k < 8; ++k)
+			a[c][k] /= d;
+		for (u32 r = 0; r < 4; ++r)
+		{
+			if (r == c)
+				continue;
+			const double f = a[r][c];
+			for (u32 k = 0; k < 8; ++k)
+				a[r][k] -= f * a[c][k];
+		}
+	}
+
+	for (u32 r = 0; r < 4; ++r)
+		for (u32 c = 0; c < 4; ++c)
+			mOUT[c * 4 + r] = a[r][4 + c];
+}
+
+static matrix4f randomView(u32& seed, float range)
+{
+	const vector3f eye(benchmarkRandom(seed, range), benchmarkRandom(seed, range), benchmarkRandom(seed, range));
+	const vector3f target(benchmarkRandom(seed, range), benchmarkRandom(seed, range), benchmarkRandom(seed, range));
+	return matrix4f::View(eye, target, vector3f(0.0f, 1.0f, 0.0f));
+}
+
+void benchmarkInverse()
+{
+	printf("backend: %s\n", benchmarkSimdBackend());
+
+	// precision over random views and projections
+	u32 seed = 1234;
+	double affineError = 0.0, perspectiveError = 0.0, closedFormError = 0.0, generalError = 0.0;
+	for (u32 i = 0; i < BENCHMARK_INVERSE_SAMPLES; ++i)
+	{
+		const matrix4f view = randomView(seed, 500.0f);
+		const matrix4f projection = matrix4f::Projection(75.0f + benchmarkRandom(seed, 45.0f), 1.5f + benchmarkRandom(seed, 1.0f), 0.1f, 1000.0f);
+		const matrix4f viewProjection = projection * view;
+
+		affineError = fmax(affineError, relativeError(view.Inverted().M, simd::InverseAffine(simd::mat4(view)).M));
+		perspectiveError = fmax(perspectiveError, relativeError(projection.Inverted().M, simd::InversePerspective(simd::mat4(projection)).M));
+
+		double reference[16];
+		inverseDouble(viewProjection.M, reference);
+		closedFormError = fmax(closedFormError, relativeError(reference, simd::InverseViewProjection(simd::mat4(view), simd::mat4(projection)).M));
+		generalError = fmax(generalError, relativeError(reference, viewProjection.Inverted().M));
+	}
+	printf("max relative error against matrix4f::Inverted: affine %.1e, perspective %.1e\n", affineError, perspectiveError);
+	printf("view projection against a double inverse: InverseViewProjection %.1e, matrix4f::Inverted %.1e\n", closedFormError, generalError);
+
+	// scaled and rotated instance matrices for the batch
+	stl_vector<matrix4f> instances(BENCHMARK_INVERSE_BATCH);
+	for (u32 i = 0; i < BENCHMARK_INVERSE_BATCH; ++i)
+	{
+		matrix4f scale;
+		scale.MM[0][0] = 1.5f + benchmarkRandom(seed, 0.4f);
+		scale.MM[1][1] = 1.5f + benchmarkRandom(seed, 1.0f);
+		scale.MM[2][2] = 2.0f + benchmarkRandom(seed, 1.0f);
+		instances[i] = randomView(seed, 100.0f) * scale;
+	}
+	stl_vector<float> inverses(BENCHMARK_INVERSE_BATCH * 16);
+	simd::InverseAffines(instances[0].M, &inverses[0], BENCHMARK_INVERSE_BATCH);
+	double batchError = 0.0;
+	for (u32 i = 0; i < BENCHMARK_INVERSE_BATCH; ++i)
+		batchError = fmax(batchError, relativeError(instances[i].Inverted().M, &inverses[i * 16]));
+	printf("max relative error of InverseAffines: %.1e\n", batchError);
+
+	// timings
+	matrix4f view = instances[3];
+	const matrix4f projection = matrix4f::Projection(60.0f, 1.7f, 0.1f, 1000.0f);
+	const double generalViewProjection = benchmarkBestOf(BENCHMARK_INVERSE_RUNS, [&]()
+	{
+		float sum = 0.0f;
+		for (u32 i = 0; i < BENCHMARK_INVERSE_CALLS; ++i)
+		{
+			view.M[12] += 1e-6f;
+			sum += (projection * view).Inverted().M[5];
+		}
+		g_benchmarkSink += (u64)sum;
+	});
+	const double closedFormViewProjection = benchmarkBestOf(BENCHMARK_INVERSE_RUNS, [&]()
+	{
+		float sum = 0.0f;
+		for (u32 i = 0; i < BENCHMARK_INVERSE_CALLS; ++i)
+		{
+			view.M[12] += 1e-6f;
+			sum += simd::InverseViewProjection(simd::mat4(view), simd::mat4(projection)).M[5];
+		}
+		g_benchmarkSink += (u64)sum;
+	});
+	printf("%-44s %10s\n", "ns per inverse", "ns");
+	printf("%-44s %10.1f\n", "view projection, (p * v).Inverted()", generalViewProjection * 1e6 / BENCHMARK_INVERSE_CALLS);
+	printf("%-44s %10.1f\n", "view projection, InverseViewProjection", closedFormViewProjection * 1e6 / BENCHMARK_INVERSE_CALLS);
+
+	const double perMatrix = 1e6 / ((double)BENCHMARK_INVERSE_BATCH_REPEATS * BENCHMARK_INVERSE_BATCH);
+	const double generalAffine = benchmarkBestOf(BENCHMARK_INVERSE_RUNS, [&]()
+	{
+		for (u32 r = 0; r < BENCHMARK_INVERSE_BATCH_REPEATS; ++r)
+		{
+			for (u32 i = 0; i < BENCHMARK_INVERSE_BATCH; ++i)
+			{
+				matrix4f m = instances[i];
+				m.Inverse();
+				memcpy(&inverses[i * 16], m.M, sizeof(m.M));
+			}
+			g_benchmarkSink += (u64)inverses[r % inverses.size()];
+		}
+	});
+	const double singleAffine = benchmarkBestOf(BENCHMARK_INVERSE_RUNS, [&]()
+	{
+		for (u32 r = 0; r < BENCHMARK_INVERSE_BATCH_REPEATS; ++r)
+		{
+			for (u32 i = 0; i < BENCHMARK_INVERSE_BATCH; ++i)
+				simd::InverseAffine(simd::mat4(instances[i])).Store(&inverses[i * 16]);
+			g_benchmarkSink += (u64)inverses[r % inverses.size()];
+		}
+	});
+	const double batchAffine = benchmarkBestOf(BENCHMARK_INVERSE_RUNS, [&]()
+	{
+		for (u32 r = 0; r < BENCHMARK_INVERSE_BATCH_REPEATS; ++r)
+		{
+			simd::InverseAffines(instances[0].M, &inverses[0], BENCHMARK_INVERSE_BATCH);
+			g_benchmarkSink += (u64)inverses[r % inverses.size()];
+		}
+	});
+	printf("%-44s %10.1f\n", "instance matrix, matrix4f::Inverse", generalAffine * perMatrix);
+	printf("%-44s %10.1f\n", "instance matrix, InverseAffine", singleAffine * perMatrix);
+	printf("%-44s %10.1f\n", "instance matrix, InverseAffines batch", batchAffine * perMatrix);
+}
@@ -0,0 +1,168 @@
+#include "benchmark.h"
+
+#include <cfc/stl/jobsystem.h>
+#include <cfc/stl/stl_vector.hpp>
+
+#include <stdio.h>
+
+#define BENCHMARK_JOBSYSTEM_RUNS 5
+
+using namespace cfc::core::threading;
+
+struct fib_job
+{
+	job_system* Jobs;
+	u32 N;
+	u64 Result;
+};
+
+// nested fork / join, every level forks one half and computes the other itself
+static void fibJob(void* data)
+{
+	fib_job* job = (fib_job*)data;
+	if (job->N < 2)
+	{
+		job->Result = job->N;
+		return;
+	}
+
+	fib_job left = { job->Jobs, job->N - 1, 0 };
+	fib_job right = { job->Jobs, job->N - 2, 0 };
+	job_counter counter;
+	job->Jobs->Run(fibJob, &left, &counter);
+	fibJob(&right);
+	job->Jobs->Wait(counter);
+	job->Result = left.Result + right.Result;
+}
+
+void benchmarkJobSystem()
+{
+	job_system jobs;
+	jobs.Init();
+	printf("workers: %u\n", jobs.GetWorkerQuantity());
+
+	// many tiny jobs, measures submit + execute overhead
+	const u32 numJobs = 1000000;
+	atomic_int executed(0);
+	const double jobsMs = benchmarkBestOf(BENCHMARK_JOBSYSTEM_RUNS, [&]()
+	{
+		job_counter counter;
+		for (u32 i = 0; i < numJobs; ++i)
+			jobs.Run([&executed]() { executed.fetch_add(1); }, &counter);
+		jobs.Wait(counter);
+	});
+	printf("%-40s %10.2f ms %8.1f ns/job\n", "1M jobs, Run + Wait", jobsMs, jobsMs * 1e6 / numJobs);
+
+	// the queue the job system replaced for asynchronous work
+	const double invokerMs = benchmarkBestOf(BENCHMARK_JOBSYSTEM_RUNS, [&]()
+	{
+		invoker queue;
+		for (u32 i = 0; i < numJobs; ++i)
+			queue.Add([&executed]() { executed.fetch_add(1); });
+		queue.ExecuteAll();
+	});
+	printf("%-40s %10.2f ms %8.1f ns/job\n", "1M functions, invoker Add + ExecuteAll", invokerMs, invokerMs * 1e6 / numJobs);
+	g_benchmarkSink += executed.load();
+
+	const u32 fibN = 27;
+	u64 fibResult = 0;
+	const double fibMs = benchmarkBestOf(BENCHMARK_JOBSYSTEM_RUNS, [&]()
+	{
+		fib_job root = { &jobs, fibN, 0 };
+		fibJob(&root);
+		fibResult = root.Result;
+	});
+	printf("%-40s %10.2f ms (fib = %llu)\n", "fib(27) nested fork / join", fibMs, (unsigned long long)fibResult);
+
+	// latency of one asynchronous task, a thread per task against a job
+	const u32 numRoundTrips = 1000;
+	const double threadMs = benchmarkBestOf(BENCHMARK_JOBSYSTEM_RUNS, [&]()
+	{
+		lightsemaphore done;
+		for (u32 i = 0; i < numRoundTrips; ++i)
+		{
+			thread::CreateThreadDetached([&done]() { done.Signal(); });
+			done.Wait();
+		}
+	});
+	printf("%-40s %10.2f ms\n", "1000 thread::CreateThreadDetached", threadMs);
+
+	const double roundTripMs = benchmarkBestOf(BENCHMARK_JOBSYSTEM_RUNS, [&]()
+	{
+		for (u32 i = 0; i < numRoundTrips; ++i)
+		{
+			job_counter counter;
+			jobs.Run([&executed]() { executed.fetch_add(1); }, &counter);
+			jobs.Wait(counter);
+		}
+	});
+	printf("%-40s %10.2f ms\n", "1000 Run + Wait round trips", roundTripMs);
+
+	jobs.Shutdown();
+}
+
+void benchmarkParallelFor()
+{
+	job_system jobs;
+	jobs.Init();
+	printf("workers: %u\n", jobs.GetWorkerQuantity());
+
+	// a per element cost in the range of a bounds transform + plane test
+	const u32 count = 1u << 20;
+	stl_vector<float> input(count), output(count);
+	for (u32 i = 0; i < count; ++i)
+		input[i] = (float)i * 0.001f;
+
+	const auto work = [&input, &output](u32 first, u32 last)
+	{
+		for (u32 i = first; i < last; ++i)
+		{
+			float x = input[i];
+			for (u32 j = 0; j < 8; ++j)
+				x = x * 0.999f + 0.5f / (x + 1.0f);
+			output[i] = x;
+		}
+	};
+
+	const double serialMs = benchmarkBestOf(BENCHMARK_JOBSYSTEM_RUNS, [&]() { work(0, count); });
+	const double parallelMs = benchmarkBestOf(BENCHMARK_JOBSYSTEM_RUNS, [&]() { jobs.ParallelFor(0, count, work); });
+	g_benchmarkSink += (u64)output[count - 1];
+	printf("%-40s %10.2f ms\n", "1M elements, serial loop", serialMs);
+	printf("%-40s %10.2f ms\n", "1M elements, ParallelFor", parallelMs);
+
+	// every index exactly once, whatever the grain size
+	stl_vector<atomic_int> visits(count);
+	jobs.ParallelFor(0, count, [&visits](u32 first, u32 last)
+	{
+		for (u32 i = first; i < last; ++i)
+			visits[i].fetch_add(1);
+	}, 1);
+	u32 wrongVisits = 0;
+	for (u32 i = 0; i < count; ++i)
+		wrongVisits += visits[i].load() != 1 ? 1 : 0;
+	printf("%-40s %10u\n", "indices not visited exactly once", wrongVisits);
+
+	// diamond: a -> (b, c) -> d, the shape of the frame graph (cull -> mip requests + draw list)
+	atomic_int step(0);
+	atomic_int orderErrors(0);
+	task_graph graph;
+	const u32 a = graph.AddNode([&step]() { step.store(1); });
+	const u32 b = graph.AddNode([&step, &orderErrors]() { if (step.load() < 1) orderErrors.fetch_add(1); step.fetch_add(1); });
+	const u32 c = graph.AddNode([&step, &orderErrors]() { if (step.load() < 1) orderErrors.fetch_add(1); step.fetch_add(1); });
+	const u32 d = graph.AddNode([&step, &orderErrors]() { if (step.load() != 3) orderErrors.fetch_add(1); });
+	graph.AddDependency(b, a);
+	graph.AddDependency(c, a);
+	graph.AddDependency(d, b);
+	graph.AddDependency(d, c);
+
+	const u32 numExecutions = 100000;
+	const double graphMs = benchmarkBestOf(BENCHMARK_JOBSYSTEM_RUNS, [&]()
+	{
+		for (u32 i = 0; i < numExecutions; ++i)
+			graph.Execute(jobs);
+	});
+	printf("%-40s %10.2f ms %8.1f ns/execute\n", "100k executions of a 4 node diamond", graphMs, graphMs * 1e6 / numExecutions);
+	printf("%-40s %10u\n", "dependency order violations", (u32)orderErrors.load());
+
+	jobs.Shutdown();
+}
@@ -0,0 +1,98 @@
+#include "benchmark.h"
+
+#include <cfc/gpu/texture_mipgen.h>
+#include <cfc/stl/stl_vector.hpp>
+
+#include <dependencies/stb/stb_image.h>
+#include <dependencies/stb/stb_image_mipmap.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define BENCHMARK_MIPGEN_RUNS 5
+
+// the scene loader before texture_mipgen: byte space premultiply, then stbi_mipmap_image per level
+static void generateMipsStb(const u8* srcLevel0, u32 width, u32 height, bool premultiplyAlpha, u8* dstMipChain)
+{
+	const usize numTexels = (usize)width * height;
+	memcpy(dstMipChain, srcLevel0, numTexels * 4);
+	if (premultiplyAlpha)
+	{
+		for (usize i = 0; i < numTexels; ++i)
+		{
+			u8* texel = dstMipChain + i * 4;
+			const float alpha = (float)texel[3] / 255.0f;
+			for (u32 c = 0; c < 3; ++c)
+				texel[c] = (u8)(((float)texel[c] / 255.0f) * alpha * 255.0f);
+		}
+	}
+
+	const int mipLevels = stbi_mipmap_info_quantity(width, height);
+	for (int i = 1; i < mipLevels; i++)
+	{
+		int w, h;
+		stbi_mipmap_info_dimensions(width, height, i - 1, &w, &h);
+		const int offsetSource = stbi_mipmap_info_bytes(width, height, 4, 0, i - 1);
+		const int offsetDest = offsetSource + stbi_mipmap_info_bytes(width, height, 4, i - 1, 1);
+		stbi_mipmap_image(&dstMipChain[offsetSource], w, h, 4, &dstMipChain[offsetDest], 2, 2);
+	}
+}
+
+void benchmarkMipgen()
+{
+	const u32 sizes[] = { 256, 1024, 2048 };
+
+	printf("%-10s %-22s %10s %12s\n", "size", "path", "ms", "MTexel/s");
+	for (u32 s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
+	{
+		const u32 size = sizes[s];
+		const usize numTexels = (usize)size * size;
+
+		// noise with a gradient alpha, the content does not change the work of either path
+		u32 seed = 1234;
+		stl_vector<u8> image(numTexels * 4);
+		for (usize i = 0; i < numTexels; ++i)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			image[i * 4 + 0] = (u8)(seed >> 24);
+			image[i * 4 + 1] = (u8)(seed >> 16);
+			image[i * 4 + 2] = (u8)(seed >> 8);
+			image[i * 4 + 3] = (u8)((i % size) * 255 / size);
+		}
+
+		const u32 mipLevels = cfc::texture_mipgen::GetMipLevelQuantity(size, size);
+		stl_vector<u8> chain(cfc::texture_mipgen::GetMipChainSizeInBytes(size, size, 0, mipLevels));
+
+		char label[32];
+		sprintf(label, "%ux%u", size, size);
+
+		for (u32 premultiply = 0; premultiply < 2; ++premultiply)
+		{
+			const double stbMs = benchmarkBestOf(BENCHMARK_MIPGEN_RUNS, [&]()
+			{
+				generateMipsStb(&image[0], size, size, premultiply != 0, &chain[0]);
+				g_benchmarkSink += chain.back();
+			});
+			printf("%-10s %-22s %10.2f %12.1f\n", label, premultiply ? "stbi_mipmap premul" : "stbi_mipmap", stbMs, numTexels / (stbMs * 1000.0));
+
+			const cfc::texture_mipgen_filter_type filters[] = { cfc::texture_mipgen_filter_type::Box, cfc::texture_mipgen_filter_type::Kaiser, cfc::texture_mipgen_filter_type::Lanczos };
+			const char* filterNames[] = { "box", "kaiser", "lanczos" };
+			for (u32 f = 0; f < 3; ++f)
+			{
+				cfc::texture_mipgen_desc desc;
+				desc.Filter = filters[f];
+				desc.PremultiplyAlpha = premultiply != 0;
+
+				const double ms = benchmarkBestOf(BENCHMARK_MIPGEN_RUNS, [&]()
+				{
+					cfc::texture_mipgen::GenerateRGBA8(&image[0], size, size, mipLevels, &chain[0], desc);
+					g_benchmarkSink += chain.back();
+				});
+
+				char path[32];
+				sprintf(path, "mipgen %s%s", filterNames[f], premultiply ? " premul" : "");
+				printf("%-10s %-22s %10.2f %12.1f\n", label, path, ms, numTexels / (ms * 1000.0));
+			}
+		}
+	}
+}
@@ -0,0 +1,104 @@
+#include "benchmark.h"
+
+#include <cfc/stl/stl_resource_collection.hpp>
+#include <cfc/stl/stl_unique_ptr.hpp>
+#include <cfc/stl/stl_vector.hpp>
+#include <cfc/stl/threading.h>
+
+#include <stdio.h>
+
+#define BENCHMARK_RESOURCE_COLLECTION_RUNS 3
+#define BENCHMARK_RESOURCE_COLLECTION_PAIRS 16
+#define BENCHMARK_RESOURCE_COLLECTION_ITERATIONS 20000
+#define BENCHMARK_RESOURCE_COLLECTION_MAX_THREADS 8
+
+using namespace cfc::core::threading;
+
+// the design before the slot map: a locked free list, appends went to concurrency::concurrent_vector which is MSVC only,
+// here they go to a vector that is reserved up front (so it never moves) under the same lock
+template <class T>
+class locked_resource_collection
+{
+public:
+	explicit locked_resource_collection(usize capacity) { m_objects.reserve(capacity); }
+
+	usize insert()
+	{
+		scopedlock<mutex> lock(m_lock);
+		if (m_freelist.empty())
+		{
+			m_objects.push_back(T());
+			return m_objects.size() - 1;
+		}
+		const usize index = m_freelist.back();
+		m_freelist.pop_back();
+		return index;
+	}
+	void erase(usize index)
+	{
+		m_objects[index] = T();
+		scopedlock<mutex> lock(m_lock);
+		m_freelist.push_back(index);
+	}
+	T& operator [] (usize index) { return m_objects[index]; }
+
+private:
+	mutex m_lock;
+	stl_vector<T> m_objects;
+	stl_vector<usize> m_freelist;
+};
+
+// every thread inserts a batch, fills it with a heap payload (like the gfx / gpu resources) and erases it again
+template <class C>
+static double runContention(u32 numThreads)
+{
+	return benchmarkBestOf(BENCHMARK_RESOURCE_COLLECTION_RUNS, [numThreads]()
+	{
+		C* collection = new C();
+		lightsemaphore done;
+		for (u32 t = 0; t < numThreads; ++t)
+		{
+			thread::CreateThreadDetached([collection, &done]()
+			{
+				usize indices[BENCHMARK_RESOURCE_COLLECTION_PAIRS];
+				for (u32 i = 0; i < BENCHMARK_RESOURCE_COLLECTION_ITERATIONS; ++i)
+				{
+					for (u32 j = 0; j < BENCHMARK_RESOURCE_COLLECTION_PAIRS; ++j)
+					{
+						indices[j] = collection->Collection.insert();
+						collection->Collection[indices[j]].reset(new u32(j));
+					}
+					for (u32 j = 0; j < BENCHMARK_RESOURCE_COLLECTION_PAIRS; ++j)
+						collection->Collection.erase(indices[j]);
+				}
+				done.Signal();
+			});
+		}
+		for (u32 t = 0; t < numThreads; ++t)
+			done.Wait();
+		delete collection;
+	});
+}
+
+struct slot_map_collection
+{
+	stl_resource_collection<stl_unique_ptr<u32>> Collection;
+};
+
+struct locked_collection
+{
+	locked_collection() : Collection(BENCHMARK_RESOURCE_COLLECTION_MAX_THREADS * BENCHMARK_RESOURCE_COLLECTION_PAIRS) {}
+	locked_resource_collection<stl_unique_ptr<u32>> Collection;
+};
+
+void benchmarkResourceCollection()
+{
+	printf("hardware threads: %u, %u insert / erase pairs x %u iterations per thread\n", thread::GetHardwareThreadCount(), BENCHMARK_RESOURCE_COLLECTION_PAIRS, BENCHMARK_RESOURCE_COLLECTION_ITERATIONS);
+	printf("%-10s %14s %14s\n", "threads", "slot map ms", "locked ms");
+	for (u32 numThreads = 1; numThreads <= BENCHMARK_RESOURCE_COLLECTION_MAX_THREADS; numThreads *= 2)
+	{
+		const double slotMapMs = runContention<slot_map_collection>(numThreads);
+		const double lockedMs = runContention<locked_collection>(numThreads);
+		printf("%-10u %14.2f %14.2f\n", numThreads, slotMapMs, lockedMs);
+	}
+}
@@ -0,0 +1,212 @@
+#include "benchmark.h"
+
+#include <cfc/math/math.h>
+#include <cfc/math/math_simd.h>
+#include <cfc/stl/stl_vector.hpp>
+
+#include <math.h>
+#include <stdio.h>
+
+#define BENCHMARK_SIMD_RUNS 5
+#define BENCHMARK_SIMD_REPEATS 200
+// not a multiple of the lane width, so the scalar tail is part of the measurement
+#define BENCHMARK_SIMD_ELEMENTS 4099
+
+using namespace cfc::math;
+
+const char* benchmarkSimdBackend()
+{
+#if defined(CFC_SIMD_AVX2) && defined(CFC_SIMD_FMA)
+	return "avx2 + fma";
+#elif defined(CFC_SIMD_AVX2)
+	return "avx2";
+#elif defined(CFC_SIMD_SSE)
+	return "sse";
+#elif defined(CFC_SIMD_NEON)
+	return "neon";
+#else
+	return "scalar";
+#endif
+}
+
+float benchmarkRandom(u32& seed, float range)
+{
+	seed = seed * 1664525u + 1013904223u;
+	return ((float)(seed >> 8) / 16777216.0f * 2.0f - 1.0f) * range;
+}
+
+// p-vertex test of PrimAABB::Test(PrimPlane), the reference for CullAABBs
+static bool insidePlanes(const planef* planes, u32 numPlanes, const float* minXYZ, const float* maxXYZ)
+{
+	for (u32 p = 0; p < numPlanes; ++p)
+	{
+		const vector3f v(planes[p].a >= 0.0f ? maxXYZ[0] : minXYZ[0], planes[p].b >= 0.0f ? maxXYZ[1] : minXYZ[1], planes[p].c >= 0.0f ? maxXYZ[2] : minXYZ[2]);
+		if (planes[p].ClassifyPoint(v) < 0.0f)
+			return false;
+	}
+	return true;
+}
+
+void benchmarkSimd()
+{
+	printf("backend: %s, %u elements\n", benchmarkSimdBackend(), BENCHMARK_SIMD_ELEMENTS);
+
+	const usize n = BENCHMARK_SIMD_ELEMENTS;
+	u32 seed = 1234;
+	stl_vector<float> x(n), y(n), z(n), ox(n), oy(n), oz(n), o(n);
+	stl_vector<float> bounds[6], boundsOut[6];
+	for (u32 k = 0; k < 6; ++k)
+	{
+		bounds[k].resize(n);
+		boundsOut[k].resize(n);
+	}
+	for (usize i = 0; i < n; ++i)
+	{
+		x[i] = benchmarkRandom(seed, 100.0f);
+		y[i] = benchmarkRandom(seed, 100.0f);
+		z[i] = benchmarkRandom(seed, 100.0f);
+		bounds[0][i] = x[i]; bounds[1][i] = y[i]; bounds[2][i] = z[i];
+		bounds[3][i] = x[i] + fabsf(benchmarkRandom(seed, 5.0f)); bounds[4][i] = y[i] + 5.0f; bounds[5][i] = z[i] + 5.0f;
+	}
+	const simd::aabb_arrays boxes = { &bounds[0][0], &bounds[1][0], &bounds[2][0], &bounds[3][0], &bounds[4][0], &bounds[5][0] };
+	const simd::aabb_arrays boxesOut = { &boundsOut[0][0], &boundsOut[1][0], &boundsOut[2][0], &boundsOut[3][0], &boundsOut[4][0], &boundsOut[5][0] };
+
+	matrix4f m;
+	for (u32 i = 0; i < 16; ++i)
+		m.M[i] = benchmarkRandom(seed, 1.0f);
+	m.M[3] = m.M[7] = m.M[11] = 0.0f;
+	m.M[15] = 1.0f;
+	const simd::mat4 sm(m);
+
+	planef planes[6];
+	for (u32 p = 0; p < 6; ++p)
+	{
+		vector3f normal(benchmarkRandom(seed, 1.0f), benchmarkRandom(seed, 1.0f), benchmarkRandom(seed, 1.0f));
+		normal = normal * (1.0f / sqrtf(normal.Dot(normal)));
+		planes[p].a = normal.x; planes[p].b = normal.y; planes[p].c = normal.z; planes[p].d = 60.0f + benchmarkRandom(seed, 0.5f);
+	}
+	stl_vector<u8> inside(n);
+
+	// results against the scalar vector3f / matrix4f math
+	float transformError = 0.0f, dotError = 0.0f, boundsError = 0.0f;
+	simd::TransformPoints(sm, &x[0], &y[0], &z[0], &ox[0], &oy[0], &oz[0], n);
+	simd::Dot(&x[0], &y[0], &z[0], &z[0], &x[0], &y[0], &o[0], n);
+	simd::TransformAABBs(sm, boxes, boxesOut, n);
+	const usize numInside = simd::CullAABBs(planes, 6, boxes, &inside[0], n);
+	usize cullMismatches = 0;
+	for (usize i = 0; i < n; ++i)
+	{
+		const vector3f p = m * vector3f(x[i], y[i], z[i]);
+		transformError = fmaxf(transformError, fabsf(p.x - ox[i]) + fabsf(p.y - oy[i]) + fabsf(p.z - oz[i]));
+		dotError = fmaxf(dotError, fabsf(vector3f(x[i], y[i], z[i]).Dot(vector3f(z[i], x[i], y[i])) - o[i]));
+
+		float minXYZ[3] = { 1e30f, 1e30f, 1e30f }, maxXYZ[3] = { -1e30f, -1e30f, -1e30f };
+		for (u32 c = 0; c < 8; ++c)
+		{
+			const vector3f corner = m * vector3f(bounds[c & 1 ? 3 : 0][i], bounds[c & 2 ? 4 : 1][i], bounds[c & 4 ? 5 : 2][i]);
+			for (u32 k = 0; k < 3; ++k)
+			{
+				minXYZ[k] = fminf(minXYZ[k], corner.V[k]);
+				maxXYZ[k] = fmaxf(maxXYZ[k], corner.V[k]);
+			}
+		}
+		for (u32 k = 0; k < 3; ++k)
+			boundsError = fmaxf(boundsError, fmaxf(fabsf(minXYZ[k] - boundsOut[k][i]), fabsf(maxXYZ[k] - boundsOut[3 + k][i])));
+
+		const float boxMin[3] = { bounds[0][i], bounds[1][i], bounds[2][i] }, boxMax[3] = { bounds[3][i], bounds[4][i], bounds[5][i] };
+		cullMismatches += insidePlanes(planes, 6, boxMin, boxMax) != (inside[i] != 0) ? 1 : 0;
+	}
+	printf("max error: transform %g, dot %g, bounds %g, cull mismatches %u (%u inside)\n", transformError, dotError, boundsError, (u32)cullMismatches, (u32)numInside);
+
+	const double perElement = 1e6 / ((double)BENCHMARK_SIMD_REPEATS * n);
+	printf("%-24s %14s %14s\n", "ns per element", "scalar", "simd");
+
+	const double transformScalar = benchmarkBestOf(BENCHMARK_SIMD_RUNS, [&]()
+	{
+		for (u32 r = 0; r < BENCHMARK_SIMD_REPEATS; ++r)
+		{
+			for (usize i = 0; i < n; ++i)
+			{
+				const vector3f p = m * vector3f(x[i], y[i], z[i]);
+				ox[i] = p.x; oy[i] = p.y; oz[i] = p.z;
+			}
+			g_benchmarkSink += (u64)ox[r % n];
+		}
+	});
+	const double transformSimd = benchmarkBestOf(BENCHMARK_SIMD_RUNS, [&]()
+	{
+		for (u32 r = 0; r < BENCHMARK_SIMD_REPEATS; ++r)
+		{
+			simd::TransformPoints(sm, &x[0], &y[0], &z[0], &ox[0], &oy[0], &oz[0], n);
+			g_benchmarkSink += (u64)ox[r % n];
+		}
+	});
+	printf("%-24s %14.2f %14.2f\n", "transform points", transformScalar * perElement, transformSimd * perElement);
+
+	const double boundsScalar = benchmarkBestOf(BENCHMARK_SIMD_RUNS, [&]()
+	{
+		// 8 transformed corners, what a transformed box costs without Arvo
+		for (u32 r = 0; r < BENCHMARK_SIMD_REPEATS; ++r)
+		{
+			for (usize i = 0; i < n; ++i)
+			{
+				vector3f lo(1e30f, 1e30f, 1e30f), hi(-1e30f, -1e30f, -1e30f);
+				for (u32 c = 0; c < 8; ++c)
+				{
+					const vector3f corner = m * vector3f(bounds[c & 1 ? 3 : 0][i], bounds[c & 2 ? 4 : 1][i], bounds[c & 4 ? 5 : 2][i]);
+					lo = vector3f(fminf(lo.x, corner.x), fminf(lo.y, corner.y), fminf(lo.z, corner.z));
+					hi = vector3f(fmaxf(hi.x, corner.x), fmaxf(hi.y, corner.y), fmaxf(hi.z, corner.z));
+				}
+				boundsOut[0][i] = lo.x; boundsOut[3][i] = hi.x;
+			}
+			g_benchmarkSink += (u64)boundsOut[0][r % n];
+		}
+	});
+	const double boundsSimd = benchmarkBestOf(BENCHMARK_SIMD_RUNS, [&]()
+	{
+		for (u32 r = 0; r < BENCHMARK_SIMD_REPEATS; ++r)
+		{
+			simd::TransformAABBs(sm, boxes, boxesOut, n);
+			g_benchmarkSink += (u64)boundsOut[0][r % n];
+		}
+	});
+	printf("%-24s %14.2f %14.2f\n", "transform aabbs", boundsScalar * perElement, boundsSimd * perElement);
+
+	const double cullScalar = benchmarkBestOf(BENCHMARK_SIMD_RUNS, [&]()
+	{
+		for (u32 r = 0; r < BENCHMARK_SIMD_REPEATS; ++r)
+		{
+			for (usize i = 0; i < n; ++i)
+			{
+				const float boxMin[3] = { bounds[0][i], bounds[1][i], bounds[2][i] }, boxMax[3] = { bounds[3][i], bounds[4][i], bounds[5][i] };
+				inside[i] = insidePlanes(planes, 6, boxMin, boxMax) ? 1 : 0;
+			}
+			g_benchmarkSink += inside[r % n];
+		}
+	});
+	const double cullSimd = benchmarkBestOf(BENCHMARK_SIMD_RUNS, [&]()
+	{
+		for (u32 r = 0; r < BENCHMARK_SIMD_REPEATS; ++r)
+			g_benchmarkSink += simd::CullAABBs(planes, 6, boxes, &inside[0], n);
+	});
+	printf("%-24s %14.2f %14.2f\n", "6 plane aabb cull", cullScalar * perElement, cullSimd * perElement);
+
+	const double dotScalar = benchmarkBestOf(BENCHMARK_SIMD_RUNS, [&]()
+	{
+		for (u32 r = 0; r < BENCHMARK_SIMD_REPEATS; ++r)
+		{
+			for (usize i = 0; i < n; ++i)
+				o[i] = vector3f(x[i], y[i], z[i]).Dot(vector3f(z[i], x[i], y[i]));
+			g_benchmarkSink += (u64)o[r % n];
+		}
+	});
+	const double dotSimd = benchmarkBestOf(BENCHMARK_SIMD_RUNS, [&]()
+	{
+		for (u32 r = 0; r < BENCHMARK_SIMD_REPEATS; ++r)
+		{
+			simd::Dot(&x[0], &y[0], &z[0], &z[0], &x[0], &y[0], &o[0], n);
+			g_benchmarkSink += (u64)o[r % n];
+		}
+	});
+	printf("%-24s %14.2f %14.2f\n", "dot", dotScalar * perElement, dotSimd * perElement);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cfc/base.h>
+#include <cfc/core/timing.h>
+
+// written by benchmarks so the optimizer can not drop the measured work
+extern volatile u64 g_benchmarkSink;
+
+// best of runs calls to fn in milliseconds, the best run is the least disturbed by the rest of the system
+template <class T>
+double benchmarkBestOf(u32 runs, const T& fn)
+{
+	cfc::timing timer;
+	double best = 1e30;
+	for (u32 i = 0; i < runs; ++i)
+	{
+		const u64 start = timer.GetTimeNanoSeconds();
+		fn();
+		const double elapsed = (double)(timer.GetTimeNanoSeconds() - start) / 1000000.0;
+		best = elapsed < best ? elapsed : best;
+	}
+	return best;
+}
+
+// shared by the math benchmarks
+const char* benchmarkSimdBackend();
+float benchmarkRandom(u32& seed, float range);
+
+void benchmarkMipgen();
+void benchmarkHashing();
+void benchmarkJobSystem();
+void benchmarkParallelFor();
+void benchmarkResourceCollection();
+void benchmarkSimd();
+void benchmarkInverse();
+void benchmarkIntersection();
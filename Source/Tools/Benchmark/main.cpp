@@ -0,0 +1,63 @@
+// Micro benchmarks for engine systems, the numbers quoted when these systems were changed come from here.
+//
+//   CFC.Tool.Benchmark [name ...]
+//
+// Runs the named benchmarks, or all of them without arguments. Only Release numbers mean anything.
+
+#include "benchmark.h"
+
+#include <stdio.h>
+#include <string.h>
+
+volatile u64 g_benchmarkSink = 0;
+
+struct benchmark_entry
+{
+	const char* Name;
+	const char* Description;
+	void (*Run)();
+};
+
+static const benchmark_entry g_benchmarks[] =
+{
+	{ "mipgen", "texture_mipgen against the stbi_mipmap path it replaced", benchmarkMipgen },
+	{ "hashing", "Hash64, hash_stream and the stb::crc64 texture cache key it replaced", benchmarkHashing },
+	{ "jobsystem", "job_system submit, fork / join and round trip overhead", benchmarkJobSystem },
+	{ "parallelfor", "job_system::ParallelFor against a serial loop, task_graph execute overhead", benchmarkParallelFor },
+	{ "resourcecollection", "stl_resource_collection insert / erase contention against a locked free list", benchmarkResourceCollection },
+	{ "simd", "SoA batch math (math_simd) against the scalar vector3f / matrix4f loops", benchmarkSimd },
+	{ "inverse", "closed form affine / view projection inverses, precision and timings against matrix4f", benchmarkInverse },
+	{ "intersection", "packet ray casting and the object bvh against single rays", benchmarkIntersection },
+};
+
+int main(int argc, char** argv)
+{
+	const usize numBenchmarks = sizeof(g_benchmarks) / sizeof(g_benchmarks[0]);
+	for (int i = 1; i < argc; ++i)
+	{
+		bool found = false;
+		for (usize j = 0; j < numBenchmarks; ++j)
+			found |= strcmp(argv[i], g_benchmarks[j].Name) == 0;
+		if (!found)
+		{
+			printf("usage: %s [name ...]\n", argv[0]);
+			for (usize j = 0; j < numBenchmarks; ++j)
+				printf("  %-20s %s\n", g_benchmarks[j].Name, g_benchmarks[j].Description);
+			return 1;
+		}
+	}
+
+	for (usize i = 0; i < numBenchmarks; ++i)
+	{
+		bool selected = argc == 1;
+		for (int j = 1; j < argc; ++j)
+			selected |= strcmp(argv[j], g_benchmarks[i].Name) == 0;
+		if (!selected)
+			continue;
+
+		printf("== %s: %s\n", g_benchmarks[i].Name, g_benchmarks[i].Description);
+		g_benchmarks[i].Run();
+		printf("\n");
+	}
+	return 0;
+}
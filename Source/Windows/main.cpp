@@ -4,6 +4,9 @@
 #include <cfc/platform/platform_win32.hpp>
 #include <cfc/gpu/gpu_d3d12.h>
 #include <cfc/stl/threading.h>
+#include <cfc/stl/jobsystem.h>
+#include <cfc/core/counters.h>
+#include <cfc/core/io_archive.h>
 #include <thread>
 #include <omp.h>
 #include "cfc/math/math.h"
@@ -27,6 +30,20 @@ void init(int argc, char** argv)
 	context.Random = &random;
 	context.IO = &io;
 
+	// * Content packed with CFC.Tool.Archive is read from the archive, files that are not in it from disk.
+	cfc::io_archive archiveIO(io);
+	if (archiveIO.Open("content" CFC_ARCHIVE_EXTENSION))
+		context.IO = &archiveIO;
+
+	// * The main thread becomes job worker 0, it executes jobs while it waits on a counter.
+	cfc::core::threading::job_system jobs;
+	jobs.Init();
+	context.Jobs = &jobs;
+
+	// * Per-frame counters, the app and the scene report into it and the app ends the frame.
+	cfc::profiling::counter_registry counters;
+	context.Counters = &counters;
+
 	app_main(&context);
 }
 
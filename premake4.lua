@@ -14,6 +14,11 @@ newoption {
 	description = "Generate windows projects."
 }
 
+newoption {
+	trigger 	= "platform-linux",
+	description = "Generate linux projects (headless, no renderer)."
+}
+
 newoption {
 	trigger     = "no-dx12",
 	description = "Disable DirectX 12 renderer."
@@ -54,6 +59,9 @@ function ext_build_ident()
 	if _OPTIONS["platform-windows"] then
 		ident = ident .. "windows"
 	end
+	if _OPTIONS["platform-linux"] then
+		ident = ident .. "linux"
+	end
 
 	if _OPTIONS["64bit"] then
 		ident = ident .. "-64"
@@ -84,12 +92,16 @@ function ext_add_include_markers(folder)
 	end
 end
 
+-- NOTE: users before the libraries they use, gnu ld resolves static libraries in link order
 function ext_add_libraries()
-	links { "CFC.Core.Dependencies"}
-	links { "CFC.Core.Engine"}
 	if _OPTIONS["platform-windows"] then
 		links { "CFC.Platform.Windows" }
 	end
+	if _OPTIONS["platform-linux"] then
+		links { "CFC.Platform.Linux" }
+	end
+	links { "CFC.Core.Engine"}
+	links { "CFC.Core.Dependencies"}
 end
 
 function ext_set_project_defaults()
@@ -119,6 +131,9 @@ function ext_set_project_defaults()
 
 	configuration "windows"
 		links       { "ole32", "ws2_32" }
+
+	configuration "linux"
+		links       { "pthread" }
 end
 
 -- clean option
@@ -148,6 +163,10 @@ solution "CFC"
 		defines 	"PLATFORM_WINDOWS"
 		defines		{ "WIN32" }
 
+	configuration "linux"
+		defines 	"PLATFORM_LINUX"
+		buildoptions { "-std=c++14" }
+
 	configuration "Debug"
 		defines		"PLATFORM_DEBUG"
 
@@ -168,6 +187,9 @@ solution "CFC"
 		ext_add_cpp_files "Source/Shared/dependencies"
 		ext_set_project_defaults()
 
+		configuration "linux"
+			excludes { "Source/Shared/dependencies/d3dxaffinity/**" }
+
 	project "CFC.Core.Engine"
 		targetname  "CFC.Core.Engine"
 		language    "C++"
@@ -179,6 +201,10 @@ solution "CFC"
 		ext_add_cpp_files "Source/Shared/engine"
 		ext_set_project_defaults()
 
+		-- the renderer is direct3d 12, linux builds the core, culling and the asset pipeline
+		configuration "linux"
+			excludes { "Source/Shared/engine/cfc/gpu/*d3d12*", "Source/Shared/engine/cfc/gpu/renderer_imgui.*" }
+
 if _OPTIONS["platform-windows"] then
 	project "CFC.Platform.Windows"
 		targetname  "CFC.Platform.Windows"
@@ -190,6 +216,39 @@ if _OPTIONS["platform-windows"] then
 		ext_set_project_defaults()
 end
 
+if _OPTIONS["platform-linux"] then
+	project "CFC.Platform.Linux"
+		targetname  "CFC.Platform.Linux"
+		language    "C++"
+		kind        "StaticLib"
+		flags       { "No64BitChecks", "StaticRuntime" } -- disabled: "ExtraWarnings",
+
+		ext_add_cpp_files "Source/Linux"
+		ext_set_project_defaults()
+end
+
+-- command line tools, they link the engine only
+group "Tools"
+	project "CFC.Tool.Archive"
+		targetname  "CFC.Tool.Archive"
+		language    "C++"
+		kind        "ConsoleApp"
+		flags       { "No64BitChecks", "StaticRuntime" } -- disabled: "ExtraWarnings",
+		links       { "CFC.Core.Engine", "CFC.Core.Dependencies" }
+
+		ext_add_cpp_files "Source/Tools/Archive"
+		ext_set_project_defaults()
+
+	project "CFC.Tool.Benchmark"
+		targetname  "CFC.Tool.Benchmark"
+		language    "C++"
+		kind        "ConsoleApp"
+		flags       { "No64BitChecks", "StaticRuntime" } -- disabled: "ExtraWarnings",
+		links       { "CFC.Core.Engine", "CFC.Core.Dependencies" }
+
+		ext_add_cpp_files "Source/Tools/Benchmark"
+		ext_set_project_defaults()
+
 -- Execute modules
 group "Modules"
 local subprojects = os.matchfiles("Buildscripts/Modules/**.lua");